@@ -21,6 +21,7 @@
 QDiscord::QDiscord(QObject* parent) : QObject(parent)
 {
 	connectComponents();
+	connectResponseCache();
 	_signalsConnected = false;
 
 	if(QDiscordUtilities::debugMode)
@@ -44,6 +45,7 @@ void QDiscord::login(const QString& token)
 void QDiscord::logout()
 {
 	_ws.close();
+	_state.clear();
 	_rest.logout();
 }
 
@@ -107,14 +109,72 @@ void QDiscord::connectComponents()
 	connect(&_ws, &QDiscordWsComponent::channelUpdateReceived,
 			&_state, &QDiscordStateComponent::channelUpdateReceived);
 	connect(&_ws, &QDiscordWsComponent::disconnected,
-			&_state, &QDiscordStateComponent::clear);
+			&_state, &QDiscordStateComponent::connectionLost);
 	connect(&_ws, &QDiscordWsComponent::error,
-			&_state, &QDiscordStateComponent::clear);
+			&_state, &QDiscordStateComponent::connectionLost);
 	connect(&_state, &QDiscordStateComponent::selfCreated,
 			&_rest, &QDiscordRestComponent::selfCreated);
 
 }
 
+void QDiscord::connectResponseCache()
+{
+	//Keeps REST responses from outliving the state the gateway reports. The
+	//gateway's signals are used rather than the state's events, so that the
+	//state can keep skipping events nothing subscribes to.
+	connect(&_ws, &QDiscordWsComponent::readyReceived,
+			this, [this](const QJsonObject&){
+		//Changes missed while disconnected are not reported one by one.
+		_rest.pipeline()->responseCache()->clear();
+	});
+	connect(&_ws, &QDiscordWsComponent::channelUpdateReceived,
+			this, [this](const QJsonObject& object){
+		invalidateResponses(QDiscordUtilities::endPoints.channels,
+							object["id"].toString(""));
+	});
+	connect(&_ws, &QDiscordWsComponent::channelDeleteReceived,
+			this, [this](const QJsonObject& object){
+		invalidateResponses(QDiscordUtilities::endPoints.channels,
+							object["id"].toString(""));
+	});
+	connect(&_ws, &QDiscordWsComponent::guildUpdateReceived,
+			this, [this](const QJsonObject& object){
+		invalidateResponses(QDiscordUtilities::endPoints.servers,
+							object["id"].toString(""));
+	});
+	connect(&_ws, &QDiscordWsComponent::guildDeleteReceived,
+			this, [this](const QJsonObject& object){
+		invalidateResponses(QDiscordUtilities::endPoints.servers,
+							object["id"].toString(""));
+	});
+	connect(&_ws, &QDiscordWsComponent::guildMemberUpdateReceived,
+			this, &QDiscord::invalidateMember);
+	connect(&_ws, &QDiscordWsComponent::guildMemberRemoveReceived,
+			this, &QDiscord::invalidateMember);
+}
+
+void QDiscord::invalidateResponses(const QString& endPoint, const QString& id)
+{
+	QDiscordResponseCache* cache = _rest.pipeline()->responseCache();
+	if(id.isEmpty() || cache->count() == 0)
+		return;
+	cache->invalidate(QUrl(endPoint + "/" + id));
+}
+
+void QDiscord::invalidateMember(const QJsonObject& object)
+{
+	QString userId = object["user"].toObject()["id"].toString("");
+	if(userId.isEmpty())
+		return;
+	invalidateResponses(QDiscordUtilities::endPoints.users, userId);
+	QString guildId = object["guild_id"].toString("");
+	if(!guildId.isEmpty())
+	{
+		invalidateResponses(QDiscordUtilities::endPoints.servers,
+							guildId + "/members/" + userId);
+	}
+}
+
 void QDiscord::connectDiscordSignals()
 {
 	connect(&_rest, &QDiscordRestComponent::tokenVerified,
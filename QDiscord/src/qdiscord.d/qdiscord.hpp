@@ -21,9 +21,11 @@
 
 #include <QObject>
 #include <QDebug>
+#include "qdiscordcoroutine.hpp"
 #include "qdiscordrestcomponent.hpp"
 #include "qdiscordwscomponent.hpp"
 #include "qdiscordstatecomponent.hpp"
+#include "qdiscordtrace.hpp"
 
 /*!
  * \brief This class represents a single connection to the Discord API.
@@ -68,6 +70,48 @@ public:
 	QDiscordWsComponent* ws() {return &_ws;}
 	///\brief Returns a pointer to the state component.
 	QDiscordStateComponent* state() {return &_state;}
+	///\brief Returns the policy selecting which information the state component stores.
+	QDiscordCachePolicy cachePolicy() const {return _state.cachePolicy();}
+	/*!
+	 * \brief Sets the policy selecting which information the state component stores.
+	 *
+	 * This should be called before logging in, as the policy only applies to
+	 * information received afterwards.
+	 * \see QDiscordStateComponent::setCachePolicy
+	 */
+	void setCachePolicy(const QDiscordCachePolicy& policy) {
+		_state.setCachePolicy(policy);
+	}
+	/*!
+	 * \brief Subscribes a callable to a state event.
+	 *
+	 * For example `discord.on<QDiscordEvent::MessageCreate>(callable)`, where
+	 * the callable takes a `const QDiscordEvent::MessageCreate&`.
+	 * \see QDiscordEventBus::on
+	 */
+	template<typename Event, typename Callable>
+	QDiscordEventBus::Subscription on(Callable&& callable) {
+		return _state.events()->on<Event>(std::forward<Callable>(callable));
+	}
+	///\brief Removes a subscription made with on().
+	bool off(QDiscordEventBus::Subscription subscription) {
+		return _state.events()->off(subscription);
+	}
+#ifdef QDISCORD_COROUTINES
+	/*!
+	 * \brief Returns an awaiter for the next state event accepted by the
+	 * filter.
+	 *
+	 * For example
+	 * `co_await discord.nextEvent<QDiscordEvent::MessageCreate>(filter)`,
+	 * where the filter takes a `const QDiscordEvent::MessageCreate&` and
+	 * returns whether to stop waiting. See QDiscordTask.
+	 */
+	template<typename Event, typename Filter = QDiscordAnyEvent>
+	QDiscordEventAwaiter<Event, Filter> nextEvent(Filter filter = Filter()) {
+		return qDiscordNextEvent<Event>(_state.events(), std::move(filter));
+	}
+#endif
 signals:
 	/*!
 	 * \brief Emitted when logging in has failed.
@@ -89,6 +133,9 @@ private:
 	void tokenVerfified(const QString& token);
 	void endpointAcquired(const QString& endpoint);
 	void connectComponents();
+	void connectResponseCache();
+	void invalidateResponses(const QString& endPoint, const QString& id);
+	void invalidateMember(const QJsonObject& object);
 	void connectDiscordSignals();
 	void disconnectDiscordSignals();
 	void logoutFinished();
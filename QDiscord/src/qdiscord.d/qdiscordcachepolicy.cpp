@@ -0,0 +1,65 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordcachepolicy.hpp"
+
+QDiscordCachePolicy::QDiscordCachePolicy()
+{
+	_memberPolicy = MemberPolicy::All;
+	_recentMemberTimeout = 30*60*1000;
+	_cachePrivateChannels = true;
+	_cacheUsers = true;
+	_indexMembers = false;
+}
+
+bool QDiscordCachePolicy::usesRecentMembers() const
+{
+	if(_memberPolicy == MemberPolicy::Recent)
+		return true;
+	for(MemberPolicy item : _guildMemberPolicies)
+	{
+		if(item == MemberPolicy::Recent)
+			return true;
+	}
+	return false;
+}
+
+bool QDiscordCachePolicy::cachesMember(const QString& guildId,
+									   const QString& userId,
+									   const QString& selfId) const
+{
+	switch(memberPolicy(guildId))
+	{
+	case MemberPolicy::All:
+		return true;
+	case MemberPolicy::Recent:
+	case MemberPolicy::SelfOnly:
+		return !selfId.isEmpty() && userId == selfId;
+	default:
+		return false;
+	}
+}
+
+bool QDiscordCachePolicy::cachesActiveMember(const QString& guildId,
+											 const QString& userId,
+											 const QString& selfId) const
+{
+	if(memberPolicy(guildId) == MemberPolicy::Recent)
+		return true;
+	return cachesMember(guildId, userId, selfId);
+}
@@ -0,0 +1,130 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDCACHEPOLICY_HPP
+#define QDISCORDCACHEPOLICY_HPP
+
+#include <QHash>
+#include <QString>
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief Selects which information QDiscordStateComponent stores.
+ *
+ * By default, everything received from Discord is stored. Bots which only need
+ * part of the state can use this to skip storing the rest, which happens while
+ * events are parsed rather than after the objects have been built.\n
+ * Changing the policy only affects data received afterwards.
+ * \see QDiscord::setCachePolicy
+ */
+class QDISCORD_API QDiscordCachePolicy
+{
+public:
+	///\brief An enumerator holding all possible ways of storing guild members.
+	enum class MemberPolicy
+	{
+		///\brief Stores all members.
+		All,
+		/*!
+		 * \brief Stores the current user and members who were active within
+		 * recentMemberTimeout().
+		 *
+		 * Members become active when they join, are updated or send a message.
+		 */
+		Recent,
+		///\brief Only stores the member of the current user.
+		SelfOnly,
+		///\brief Does not store any members.
+		None
+	};
+	///\brief Creates a policy which stores everything.
+	QDiscordCachePolicy();
+	///\brief Returns the member policy used for guilds without their own policy.
+	MemberPolicy memberPolicy() const {return _memberPolicy;}
+	///\brief Sets the member policy used for guilds without their own policy.
+	void setMemberPolicy(MemberPolicy policy) {_memberPolicy = policy;}
+	///\brief Returns the member policy used for the guild with the provided ID.
+	MemberPolicy memberPolicy(const QString& guildId) const {
+		return _guildMemberPolicies.value(guildId, _memberPolicy);
+	}
+	///\brief Sets the member policy used for the guild with the provided ID.
+	void setGuildMemberPolicy(const QString& guildId, MemberPolicy policy) {
+		_guildMemberPolicies.insert(guildId, policy);
+	}
+	///\brief Makes the guild with the provided ID use memberPolicy().
+	void resetGuildMemberPolicy(const QString& guildId) {
+		_guildMemberPolicies.remove(guildId);
+	}
+	/*!
+	 * \brief Returns whether any guild uses MemberPolicy::Recent.
+	 */
+	bool usesRecentMembers() const;
+	/*!
+	 * \brief Returns how long members stay stored after their last activity
+	 * when using MemberPolicy::Recent, in milliseconds.
+	 */
+	int recentMemberTimeout() const {return _recentMemberTimeout;}
+	///\brief Sets how long members stay stored when using MemberPolicy::Recent.
+	void setRecentMemberTimeout(int timeout) {_recentMemberTimeout = timeout;}
+	///\brief Returns whether private channels are stored.
+	bool cachePrivateChannels() const {return _cachePrivateChannels;}
+	///\brief Sets whether private channels are stored.
+	void setCachePrivateChannels(bool cache) {_cachePrivateChannels = cache;}
+	/*!
+	 * \brief Returns whether the details of member users are stored.
+	 *
+	 * If this is false, the users of stored members only contain their ID. This
+	 * includes the members provided by the member signals of
+	 * QDiscordStateComponent.
+	 */
+	bool cacheUsers() const {return _cacheUsers;}
+	///\brief Sets whether the details of member users are stored.
+	void setCacheUsers(bool cache) {_cacheUsers = cache;}
+	/*!
+	 * \brief Returns whether guilds keep a QDiscordMemberIndex of their members.
+	 * \see QDiscordGuild::memberIndex
+	 */
+	bool indexMembers() const {return _indexMembers;}
+	///\brief Sets whether guilds keep a QDiscordMemberIndex of their members.
+	void setIndexMembers(bool index) {_indexMembers = index;}
+	/*!
+	 * \brief Returns whether a member received while parsing a guild should be
+	 * stored.
+	 * \param guildId The ID of the member's guild.
+	 * \param userId The ID of the member's user.
+	 * \param selfId The ID of the current user.
+	 */
+	bool cachesMember(const QString& guildId, const QString& userId,
+					  const QString& selfId) const;
+	/*!
+	 * \brief Returns whether an active member should be stored.
+	 *
+	 * Unlike cachesMember(), this also returns `true` for MemberPolicy::Recent.
+	 */
+	bool cachesActiveMember(const QString& guildId, const QString& userId,
+							const QString& selfId) const;
+private:
+	MemberPolicy _memberPolicy;
+	QHash<QString, MemberPolicy> _guildMemberPolicies;
+	int _recentMemberTimeout;
+	bool _cachePrivateChannels;
+	bool _cacheUsers;
+	bool _indexMembers;
+};
+
+#endif // QDISCORDCACHEPOLICY_HPP
@@ -18,58 +18,119 @@
 
 #include "qdiscordguild.hpp"
 #include "qdiscordchannel.hpp"
+#include "qdiscordtrace.hpp"
+#include "qdiscordstringpool.hpp"
 
 QDiscordChannel::QDiscordChannel(const QJsonObject& object,
-								 QSharedPointer<QDiscordGuild> guild)
+								 QSharedPointer<QDiscordGuild> guild):
+	d(new QDiscordChannelData)
 {
-	_id = object["id"].toString("");
-	_isPrivate = object["is_private"].toBool(false);
-	_lastMessageId = object["last_message_id"].toString("");
-	_name = object["name"].toString("");
-	_position = object["position"].toInt(0);
-	_topic = object["topic"].toString("");
+	d->_id = object["id"].toString("");
+	d->_isPrivate = object["is_private"].toBool(false);
+	d->_lastMessageId = object["last_message_id"].toString("");
+	d->_name = QDiscordStringPool::intern(object["name"].toString(""));
+	d->_position = object["position"].toInt(0);
+	d->_topic = object["topic"].toString("");
 	QString type = object["type"].toString("text");
 	if(type == "text")
-		_type = ChannelType::Text;
+		d->_type = ChannelType::Text;
 	else if(type == "voice")
-		_type = ChannelType::Voice;
+		d->_type = ChannelType::Voice;
 	else
-		_type = ChannelType::UnknownType;
-	_guild = guild;
-	_recipient = _isPrivate ?
+		d->_type = ChannelType::UnknownType;
+	d->_guild = guild;
+	d->_recipient = d->_isPrivate ?
 				QSharedPointer<QDiscordUser>(
 					new QDiscordUser(object["recipient"].toObject())
 				) : QSharedPointer<QDiscordUser>();
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordChannel("<<this<<") constructed";
+	QDISCORD_TRACE(Model, Verbose, "QDiscordChannel constructed", quintptr(this));
 }
 
-QDiscordChannel::QDiscordChannel()
+QDiscordChannel::QDiscordChannel():
+	d(new QDiscordChannelData)
 {
-	_id = "";
-	_isPrivate = false;
-	_lastMessageId = "";
-	_name = "";
-	_position = 0;
-	_topic = "";
-	_type = ChannelType::UnknownType;
-	_guild = QSharedPointer<QDiscordGuild>();
-	_recipient = QSharedPointer<QDiscordUser>();
+	d->_id = "";
+	d->_isPrivate = false;
+	d->_lastMessageId = "";
+	d->_name = "";
+	d->_position = 0;
+	d->_topic = "";
+	d->_type = ChannelType::UnknownType;
+	d->_guild = QSharedPointer<QDiscordGuild>();
+	d->_recipient = QSharedPointer<QDiscordUser>();
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordChannel("<<this<<") constructed";
+	QDISCORD_TRACE(Model, Verbose, "QDiscordChannel constructed", quintptr(this));
 }
 
-QDiscordChannel::QDiscordChannel(const QDiscordChannel& other)
+QDiscordChannel::QDiscordChannel(const QDiscordChannel& other) = default;
+
+QDiscordChannel::QDiscordChannel(QDiscordChannel&& other) Q_DECL_NOTHROW = default;
+
+QDiscordChannel::~QDiscordChannel() = default;
+
+QDiscordChannel&
+QDiscordChannel::operator =(const QDiscordChannel& other) = default;
+
+QDiscordChannel&
+QDiscordChannel::operator =(QDiscordChannel&& other) Q_DECL_NOTHROW = default;
+
+void QDiscordChannel::setGuild(QSharedPointer<QDiscordGuild> guild)
+{
+	d->_guild = guild;
+}
+
+void QDiscordChannel::update(const QJsonObject& object)
+{
+	if(object.contains("is_private"))
+		d->_isPrivate = object["is_private"].toBool(false);
+	if(object.contains("last_message_id"))
+		d->_lastMessageId = object["last_message_id"].toString("");
+	if(object.contains("name"))
+		d->_name = QDiscordStringPool::intern(object["name"].toString(""));
+	if(object.contains("position"))
+		d->_position = object["position"].toInt(0);
+	if(object.contains("topic"))
+		d->_topic = object["topic"].toString("");
+	if(object.contains("type"))
+	{
+		QString type = object["type"].toString("text");
+		if(type == "text")
+			d->_type = ChannelType::Text;
+		else if(type == "voice")
+			d->_type = ChannelType::Voice;
+		else
+			d->_type = ChannelType::UnknownType;
+	}
+	if(d->_recipient && object.contains("recipient"))
+		d->_recipient->update(object["recipient"].toObject());
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordChannel updated", quintptr(this));
+}
+
+QJsonObject QDiscordChannel::toJson() const
 {
-	_id = other.id();
-	_isPrivate = other.isPrivate();
-	_lastMessageId = other.lastMessageId();
-	_name = other.name();
-	_position = other.position();
-	_topic = other.topic();
-	_type = other.type();
-	_guild = other.guild();
-	_recipient = other.recipient();
+	QJsonObject object;
+	object["id"] = d->_id;
+	object["is_private"] = d->_isPrivate;
+	object["last_message_id"] = d->_lastMessageId;
+	object["name"] = d->_name;
+	object["position"] = d->_position;
+	object["topic"] = d->_topic;
+	switch(d->_type)
+	{
+	case ChannelType::Text:
+		object["type"] = QString("text");
+		break;
+	case ChannelType::Voice:
+		object["type"] = QString("voice");
+		break;
+	default:
+		object["type"] = QString("unknown");
+	}
+	if(d->_recipient)
+		object["recipient"] = d->_recipient->toJson();
+	if(d->_guild)
+		object["guild_id"] = d->_guild->id();
+	return object;
 }
@@ -20,11 +20,18 @@
 #define QDISCORDCHANNEL_HPP
 
 #include <QJsonObject>
+#include <QSharedData>
 #include "qdiscorduser.hpp"
 
 class QDiscordGuild;
+class QDiscordChannelData;
 
-///\brief Represents either a private or guild channel in the Discord API.
+/*!
+ * \brief Represents either a private or guild channel in the Discord API.
+ *
+ * Channels are implicitly shared, so copying one only increments a reference
+ * count.
+ */
 class QDISCORD_API QDiscordChannel
 {
 public:
@@ -41,8 +48,21 @@ public:
 			);
 	///\brief Default public constructor.
 	QDiscordChannel();
-	///\brief Deep copies the provided object.
+	///\brief Shares the provided object's data until either of them is modified.
 	QDiscordChannel(const QDiscordChannel& other);
+	///\brief Takes over the provided object's data.
+	QDiscordChannel(QDiscordChannel&& other) Q_DECL_NOTHROW;
+	~QDiscordChannel();
+	QDiscordChannel& operator =(const QDiscordChannel& other);
+	QDiscordChannel& operator =(QDiscordChannel&& other) Q_DECL_NOTHROW;
+	/*!
+	 * \brief Updates the current instance from the provided parameters.
+	 *
+	 * Only properties contained in the object are changed.
+	 */
+	void update(const QJsonObject& object);
+	///\brief Serializes this object into the JSON format used by the Discord API.
+	QJsonObject toJson() const;
 	/*!
 	 * \brief An enumerator holding all possible types of channels.
 	 *
@@ -53,54 +73,77 @@ public:
 		Voice, Text, UnknownType
 	};
 	///\brief Returns the channel's ID.
-	QString id() const {return _id;}
+	QString id() const;
+	///\brief Returns the date this channel was created, derived from its ID.
+	QDateTime createdAt() const;
 	///\brief Returns the channel's name.
-	QString name() const {return _name;}
+	QString name() const;
 	///\brief Returns the channel's position in the channel list.
-	int position() const {return _position;}
+	int position() const;
 	///\brief Returns the channel's topic.
-	QString topic() const {return _topic;}
+	QString topic() const;
 	/*!
 	 * \brief Returns the channel's type.
 	 *
 	 * Possible types specified in `ChannelType`.
 	 */
-	ChannelType type() const {return _type;}
+	ChannelType type() const;
 	/*!
 	 * \brief Returns whether the channel is a private or a guild channel.
 	 *
 	 * Some parameters may not be set depending on this value.
 	 */
-	bool isPrivate() const {return _isPrivate;}
+	bool isPrivate() const;
 	///\brief Returns the ID of the last sent message.
-	QString lastMessageId() const {return _lastMessageId;}
+	QString lastMessageId() const;
 	///\brief Returns a pointer to this channel's parent guild.
-	QSharedPointer<QDiscordGuild> guild() const {return _guild;}
+	QSharedPointer<QDiscordGuild> guild() const;
 	/*!
 	 * \brief Returns a pointer to this channel's recipient, if this is a private channel.
 	 *
 	 * The recipient object will be deleted when this object is deleted.
 	 */
-	QSharedPointer<QDiscordUser> recipient() const {return _recipient;}
+	QSharedPointer<QDiscordUser> recipient() const;
 	/*!
 	 * \brief Sets this object's parent guild.
 	 * \param guild A pointer to this object's new parent guild.
 	 */
-	void setGuild(QSharedPointer<QDiscordGuild> guild) {_guild = guild;}
+	void setGuild(QSharedPointer<QDiscordGuild> guild);
 	///\brief Returns a string which allows you to mention this channel.
-	QString mention() const {return QString("<#"+_id+">");}
+	QString mention() const;
 private:
+	QSharedDataPointer<QDiscordChannelData> d;
+};
+
+///\brief The data shared between copies of a QDiscordChannel.
+class QDiscordChannelData : public QSharedData
+{
+public:
 	QString _id;
 	QString _name;
 	int _position;
 	QString _topic;
-	ChannelType _type;
+	QDiscordChannel::ChannelType _type;
 	bool _isPrivate;
 	QString _lastMessageId;
 	QSharedPointer<QDiscordUser> _recipient;
 	QSharedPointer<QDiscordGuild> _guild;
 };
 
+inline QString QDiscordChannel::id() const {return d->_id;}
+inline QDateTime QDiscordChannel::createdAt() const
+{return QDiscordUtilities::timestampToDateTime(
+			QDiscordUtilities::snowflakeTimestamp(d->_id));}
+inline QString QDiscordChannel::name() const {return d->_name;}
+inline int QDiscordChannel::position() const {return d->_position;}
+inline QString QDiscordChannel::topic() const {return d->_topic;}
+inline QDiscordChannel::ChannelType QDiscordChannel::type() const {return d->_type;}
+inline bool QDiscordChannel::isPrivate() const {return d->_isPrivate;}
+inline QString QDiscordChannel::lastMessageId() const {return d->_lastMessageId;}
+inline QSharedPointer<QDiscordGuild> QDiscordChannel::guild() const {return d->_guild;}
+inline QSharedPointer<QDiscordUser> QDiscordChannel::recipient() const {return d->_recipient;}
+inline QString QDiscordChannel::mention() const {return QString("<#"+d->_id+">");}
+
 Q_DECLARE_METATYPE(QDiscordChannel)
 
 #endif // QDISCORDCHANNEL_HPP
@@ -0,0 +1,225 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDCOROUTINE_HPP
+#define QDISCORDCOROUTINE_HPP
+
+#ifdef QDISCORD_COROUTINES
+
+#if !defined(__cpp_impl_coroutine)
+#	error "QDISCORD_COROUTINES requires a compiler with C++20 coroutine support"
+#endif
+
+#include <QObject>
+#include <QPointer>
+#include <QThread>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include "qdiscordeventbus.hpp"
+#include "qdiscordfuture.hpp"
+
+/*!
+ * \brief The return type of coroutines awaiting REST requests and events.
+ *
+ * A task starts running as soon as it is called and destroys itself once it
+ * has finished, so it does not need to be stored. For example
+ * \code
+ * QDiscordTask Bot::greet(QString channelId)
+ * {
+ *     QDiscordFuture<QDiscordMessage> sent =
+ *             co_await _discord.rest()->sendMessageFuture("Hi", channelId);
+ *     if(!sent.isSucceeded())
+ *         co_return;
+ *     co_await _discord.nextEvent<QDiscordEvent::MessageCreate>();
+ *     co_await _discord.rest()->deleteMessageFuture(sent.result().id(),
+ *                                                   channelId);
+ * }
+ * \endcode
+ * A task is owned by a QObject: the object a member coroutine is called on,
+ * or the QObject pointer passed as a free coroutine's first argument. It is
+ * resumed in that object's thread, and destroyed instead of resumed if the
+ * object has been deleted while it was waiting. Tasks without an owner are
+ * resumed wherever the awaited result arrives.\n
+ * Awaiting does not allocate anything beyond the coroutine's frame.
+ * Exceptions escaping a task terminate the program.\n
+ * This is only available when QDiscord and the application are built with
+ * `CONFIG += qdiscord_coroutines`, which requires C++20.
+ */
+class QDiscordTask
+{
+public:
+	struct promise_type
+	{
+		promise_type() : bound(false) {}
+		template<typename First, typename... Rest>
+		promise_type(First&& first, Rest&&...) {
+			context = contextOf(first);
+			bound = !context.isNull();
+		}
+		QDiscordTask get_return_object() {return QDiscordTask();}
+		std::suspend_never initial_suspend() noexcept {return {};}
+		std::suspend_never final_suspend() noexcept {return {};}
+		void return_void() {}
+		void unhandled_exception() {std::terminate();}
+		QPointer<QObject> context;
+		bool bound;
+	private:
+		template<typename T>
+		static QObject* contextOf(T& value) {
+			typedef std::remove_cvref_t<T> Type;
+			if constexpr(std::is_base_of_v<QObject, Type>)
+				return const_cast<QObject*>(static_cast<const QObject*>(&value));
+			else if constexpr(std::is_convertible_v<Type, const QObject*>)
+				return const_cast<QObject*>(static_cast<const QObject*>(value));
+			else
+				return nullptr;
+		}
+	};
+	typedef std::coroutine_handle<promise_type> Handle;
+	/*!
+	 * \brief Resumes a suspended task in its owner's thread, or destroys it if
+	 * its owner has been deleted.
+	 */
+	static void resume(Handle handle) {
+		promise_type& promise = handle.promise();
+		if(promise.bound && !promise.context)
+			handle.destroy();
+		else if(promise.bound &&
+				promise.context->thread() != QThread::currentThread())
+		{
+			QMetaObject::invokeMethod(promise.context, [handle](){
+				resume(handle);
+			}, Qt::QueuedConnection);
+		}
+		else
+			handle.resume();
+	}
+};
+
+/*!
+ * \brief Suspends a QDiscordTask until a QDiscordFuture has finished.
+ *
+ * Returned by `co_await future`, which results in the finished future.
+ * Canceled and failed futures resume the task as well, so the result should
+ * be checked with QDiscordFuture::isSucceeded.\n
+ * Any number of tasks may await the same future. The first one waits without
+ * allocating, every further one falls back to a continuation. Tasks awaiting
+ * the same future are resumed in no particular order.
+ */
+template<typename T>
+class QDiscordFutureAwaiter
+{
+public:
+	explicit QDiscordFutureAwaiter(const QDiscordFuture<T>& future) :
+		_future(future) {}
+	bool await_ready() const noexcept {
+		//Invalid futures never finish, so they are not waited for.
+		return !_future.isValid() || _future.isFinished();
+	}
+	void await_suspend(QDiscordTask::Handle handle) {
+		_handle = handle;
+		if(_future.state()->hasWaiter())
+		{
+			//Another task already holds the single waiter slot.
+			QDiscordFutureAwaiter* awaiter = this;
+			_future.state()->onFinished([awaiter](){finished(awaiter);});
+		}
+		else
+			_future.state()->setWaiter(&QDiscordFutureAwaiter::finished, this);
+	}
+	QDiscordFuture<T> await_resume() {return _future;}
+private:
+	static void finished(void* data) {
+		QDiscordTask::resume(static_cast<QDiscordFutureAwaiter*>(data)->_handle);
+	}
+	QDiscordFuture<T> _future;
+	QDiscordTask::Handle _handle;
+};
+
+template<typename T>
+QDiscordFutureAwaiter<T> operator co_await(const QDiscordFuture<T>& future)
+{
+	return QDiscordFutureAwaiter<T>(future);
+}
+
+///\brief A filter accepting every event, used by default by QDiscordEventAwaiter.
+struct QDiscordAnyEvent
+{
+	template<typename Event>
+	bool operator()(const Event&) const {return true;}
+};
+
+/*!
+ * \brief Suspends a QDiscordTask until the next event of a type accepted by a
+ * filter is published on a QDiscordEventBus.
+ *
+ * Returned by QDiscord::nextEvent. Awaiting it results in a copy of the
+ * event. The subscription only exists while the task is waiting.
+ */
+template<typename Event, typename Filter = QDiscordAnyEvent>
+class QDiscordEventAwaiter
+{
+public:
+	QDiscordEventAwaiter(QDiscordEventBus* bus, Filter filter) :
+		_bus(bus), _filter(std::move(filter)), _subscription(0) {}
+	QDiscordEventAwaiter(const QDiscordEventAwaiter& other) :
+		_bus(other._bus), _filter(other._filter), _subscription(0) {}
+	~QDiscordEventAwaiter() {
+		//The task was destroyed while waiting.
+		if(_subscription != 0)
+			_bus->off(_subscription);
+	}
+	bool await_ready() const noexcept {return false;}
+	void await_suspend(QDiscordTask::Handle handle) {
+		_handle = handle;
+		//Capturing a single pointer keeps the callback out of the heap.
+		_subscription = _bus->on<Event>([this](const Event& event){
+			received(event);
+		});
+	}
+	Event await_resume() {return std::move(*_event);}
+private:
+	QDiscordEventAwaiter& operator =(const QDiscordEventAwaiter&) = delete;
+	void received(const Event& event) {
+		if(!_filter(event))
+			return;
+		_bus->off(_subscription);
+		_subscription = 0;
+		_event.emplace(event);
+		QDiscordTask::resume(_handle);
+	}
+	QDiscordEventBus* _bus;
+	Filter _filter;
+	QDiscordEventBus::Subscription _subscription;
+	std::optional<Event> _event;
+	QDiscordTask::Handle _handle;
+};
+
+///\brief Returns an awaiter for the next event of a type on the bus.
+template<typename Event, typename Filter = QDiscordAnyEvent>
+QDiscordEventAwaiter<Event, Filter> qDiscordNextEvent(QDiscordEventBus* bus,
+													   Filter filter = Filter())
+{
+	return QDiscordEventAwaiter<Event, Filter>(bus, std::move(filter));
+}
+
+#endif // QDISCORD_COROUTINES
+
+#endif // QDISCORDCOROUTINE_HPP
@@ -0,0 +1,188 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDebug>
+#include <algorithm>
+#include "qdiscordeventbus.hpp"
+
+QDiscordEventCallback::QDiscordEventCallback()
+{
+	_invoke = nullptr;
+	_manage = nullptr;
+	_inline = true;
+}
+
+QDiscordEventCallback::QDiscordEventCallback(QDiscordEventCallback&& other)
+Q_DECL_NOTHROW
+{
+	_invoke = other._invoke;
+	_manage = other._manage;
+	_inline = other._inline;
+	if(_manage)
+		_manage(Operation::Move, &_storage, &other._storage);
+	other._invoke = nullptr;
+	other._manage = nullptr;
+}
+
+QDiscordEventCallback&
+QDiscordEventCallback::operator =(QDiscordEventCallback&& other) Q_DECL_NOTHROW
+{
+	if(this == &other)
+		return *this;
+	if(_manage)
+		_manage(Operation::Destroy, &_storage, nullptr);
+	_invoke = other._invoke;
+	_manage = other._manage;
+	_inline = other._inline;
+	if(_manage)
+		_manage(Operation::Move, &_storage, &other._storage);
+	other._invoke = nullptr;
+	other._manage = nullptr;
+	return *this;
+}
+
+QDiscordEventCallback::~QDiscordEventCallback()
+{
+	if(_manage)
+		_manage(Operation::Destroy, &_storage, nullptr);
+}
+
+QDiscordEventBus::QDiscordEventBus()
+{
+	std::fill(_counts, _counts + eventCount, 0);
+	_dispatching = 0;
+	_removed = false;
+	_nextSubscription = 1;
+}
+
+QDiscordEventBus::~QDiscordEventBus()
+{
+	if(_dispatching > 0)
+		qWarning()<<"QDiscordEventBus destroyed while publishing an event";
+}
+
+bool QDiscordEventBus::off(Subscription subscription)
+{
+	//The lower byte of a subscription holds its event.
+	const int event = static_cast<int>(subscription & 0xff);
+	if(subscription == 0 || event >= eventCount)
+		return false;
+	std::vector<Handler>& handlers = _handlers[event];
+	for(std::vector<Handler>::iterator i = handlers.begin();
+		i != handlers.end(); ++i)
+	{
+		if(i->subscription != subscription)
+			continue;
+		if(_dispatching > 0)
+		{
+			i->subscription = 0;
+			_removed = true;
+		}
+		else
+			handlers.erase(i);
+		_counts[event]--;
+		return true;
+	}
+	for(std::vector<std::pair<int, Handler>>::iterator i = _pending.begin();
+		i != _pending.end(); ++i)
+	{
+		if(i->second.subscription != subscription)
+			continue;
+		i->second.subscription = 0;
+		_counts[event]--;
+		return true;
+	}
+	return false;
+}
+
+void QDiscordEventBus::clear()
+{
+	if(_dispatching > 0)
+	{
+		for(std::vector<Handler>& handlers : _handlers)
+		{
+			for(Handler& handler : handlers)
+				handler.subscription = 0;
+		}
+		for(std::pair<int, Handler>& pending : _pending)
+			pending.second.subscription = 0;
+		_removed = true;
+	}
+	else
+	{
+		for(std::vector<Handler>& handlers : _handlers)
+			handlers.clear();
+		_pending.clear();
+	}
+	std::fill(_counts, _counts + eventCount, 0);
+}
+
+QDiscordEventBus::Subscription
+QDiscordEventBus::add(int event, QDiscordEventCallback&& callback)
+{
+	Subscription subscription = (_nextSubscription++ << 8) | quint64(event);
+	if(_dispatching > 0)
+	{
+		_pending.push_back(std::make_pair(event,
+										  Handler(subscription,
+												  std::move(callback))));
+	}
+	else
+		_handlers[event].push_back(Handler(subscription, std::move(callback)));
+	_counts[event]++;
+	return subscription;
+}
+
+void QDiscordEventBus::dispatch(int event, const void* data)
+{
+	std::vector<Handler>& handlers = _handlers[event];
+	_dispatching++;
+	//Indexing instead of iterating, as nested dispatches may mark handlers as
+	//removed but never reallocate the vector.
+	for(std::size_t i = 0; i < handlers.size(); i++)
+	{
+		if(handlers[i].subscription != 0)
+			handlers[i].callback(data);
+	}
+	if(--_dispatching == 0)
+		flush();
+}
+
+void QDiscordEventBus::flush()
+{
+	if(_removed)
+	{
+		_removed = false;
+		for(std::vector<Handler>& handlers : _handlers)
+		{
+			handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+										  [](const Handler& handler)
+			{
+				return handler.subscription == 0;
+			}), handlers.end());
+		}
+	}
+	if(_pending.empty())
+		return;
+	for(std::pair<int, Handler>& pending : _pending)
+	{
+		if(pending.second.subscription != 0)
+			_handlers[pending.first].push_back(std::move(pending.second));
+	}
+	_pending.clear();
+}
@@ -0,0 +1,222 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDEVENTBUS_HPP
+#define QDISCORDEVENTBUS_HPP
+
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "qdiscordevents.hpp"
+
+/*!
+ * \brief A move-only callable receiving a single event.
+ *
+ * Callables of up to three pointers in size, such as lambdas capturing `this`
+ * and a few other pointers, are stored inline instead of on the heap.
+ */
+class QDISCORD_API QDiscordEventCallback
+{
+public:
+	///\brief Wraps a callable taking a `const Event&`.
+	template<typename Event, typename Callable>
+	static QDiscordEventCallback create(Callable&& callable);
+	QDiscordEventCallback(QDiscordEventCallback&& other) Q_DECL_NOTHROW;
+	QDiscordEventCallback& operator =(QDiscordEventCallback&& other) Q_DECL_NOTHROW;
+	~QDiscordEventCallback();
+	///\brief Calls the wrapped callable with the event pointed to.
+	void operator()(const void* event) {_invoke(&_storage, event);}
+	///\brief Returns whether the callable is stored without a heap allocation.
+	bool isInline() const {return _inline;}
+private:
+	enum class Operation
+	{
+		Move, Destroy
+	};
+	typedef std::aligned_storage<3*sizeof(void*)>::type Storage;
+	typedef void (*Invoke)(Storage* storage, const void* event);
+	typedef void (*Manage)(Operation operation, Storage* destination,
+						   Storage* source);
+	QDiscordEventCallback();
+	Q_DISABLE_COPY(QDiscordEventCallback)
+	template<typename Event, typename Functor, typename Callable>
+	void store(Callable&& callable, std::true_type);
+	template<typename Event, typename Functor, typename Callable>
+	void store(Callable&& callable, std::false_type);
+	template<typename Event, typename Functor>
+	static void invokeInline(Storage* storage, const void* event) {
+		(*reinterpret_cast<Functor*>(storage))(*static_cast<const Event*>(event));
+	}
+	template<typename Event, typename Functor>
+	static void invokeHeap(Storage* storage, const void* event) {
+		(**reinterpret_cast<Functor**>(storage))(*static_cast<const Event*>(event));
+	}
+	template<typename Functor>
+	static void manageInline(Operation operation, Storage* destination,
+							 Storage* source);
+	template<typename Functor>
+	static void manageHeap(Operation operation, Storage* destination,
+						   Storage* source);
+	Storage _storage;
+	Invoke _invoke;
+	Manage _manage;
+	bool _inline;
+};
+
+/*!
+ * \brief Delivers events to callables subscribed by event type.
+ *
+ * Subscribe with on(), for example
+ * `bus.on<QDiscordEvent::MessageCreate>([](const QDiscordEvent::MessageCreate& event){})`.
+ * The event type is resolved at compile time, so publishing an event is an
+ * array lookup followed by direct calls, without moc, argument copies or
+ * string comparisons.\n
+ * Since the amount of subscribers of each event is known, publishers can skip
+ * building an event's models entirely when nobody would receive them. See
+ * hasSubscribers().\n
+ * Subscribing and unsubscribing from within a callback is allowed. Changes
+ * made while an event is being published take effect once publishing has
+ * finished. The bus is not thread-safe and must only be used from the thread
+ * of its owner.
+ */
+class QDISCORD_API QDiscordEventBus
+{
+public:
+	/*!
+	 * \brief Identifies a subscription so it can be removed with off().
+	 *
+	 * A valid subscription is never 0.
+	 */
+	typedef quint64 Subscription;
+	QDiscordEventBus();
+	~QDiscordEventBus();
+	/*!
+	 * \brief Subscribes a callable to an event.
+	 * \param callable A callable taking a `const Event&`.
+	 * \returns The subscription, which can be passed to off().
+	 */
+	template<typename Event, typename Callable>
+	Subscription on(Callable&& callable) {
+		return add(QDiscordEvent::Index<Event>::value,
+				   QDiscordEventCallback::create<Event>(
+					   std::forward<Callable>(callable)));
+	}
+	/*!
+	 * \brief Removes a subscription.
+	 * \returns `false` if the subscription did not exist.
+	 */
+	bool off(Subscription subscription);
+	///\brief Removes all subscriptions.
+	void clear();
+	///\brief Returns the amount of subscriptions to an event.
+	template<typename Event>
+	int subscriberCount() const {
+		return _counts[QDiscordEvent::Index<Event>::value];
+	}
+	///\brief Returns whether an event has any subscriptions.
+	template<typename Event>
+	bool hasSubscribers() const {return subscriberCount<Event>() != 0;}
+	///\brief Calls all callables subscribed to the event's type.
+	template<typename Event>
+	void publish(const Event& event) {
+		const int index = QDiscordEvent::Index<Event>::value;
+		if(_counts[index] != 0)
+			dispatch(index, &event);
+	}
+private:
+	Q_DISABLE_COPY(QDiscordEventBus)
+	struct Handler
+	{
+		Handler(Subscription subscription, QDiscordEventCallback&& callback):
+			subscription(subscription), callback(std::move(callback)) {}
+		//Set to 0 once removed while dispatching.
+		Subscription subscription;
+		QDiscordEventCallback callback;
+	};
+	static const int eventCount = QDiscordEvent::List::size;
+	Subscription add(int event, QDiscordEventCallback&& callback);
+	void dispatch(int event, const void* data);
+	void flush();
+	std::vector<Handler> _handlers[eventCount];
+	//Handlers added while dispatching, appended once dispatching has finished
+	//so the vectors are never reallocated under a running callback.
+	std::vector<std::pair<int, Handler>> _pending;
+	int _counts[eventCount];
+	int _dispatching;
+	bool _removed;
+	quint64 _nextSubscription;
+};
+
+template<typename Event, typename Callable>
+QDiscordEventCallback QDiscordEventCallback::create(Callable&& callable)
+{
+	typedef typename std::decay<Callable>::type Functor;
+	typedef std::integral_constant<bool,
+			sizeof(Functor) <= sizeof(Storage) &&
+			alignof(Storage)%alignof(Functor) == 0 &&
+			std::is_nothrow_move_constructible<Functor>::value> Fits;
+	QDiscordEventCallback callback;
+	callback.store<Event, Functor>(std::forward<Callable>(callable), Fits());
+	return callback;
+}
+
+template<typename Event, typename Functor, typename Callable>
+void QDiscordEventCallback::store(Callable&& callable, std::true_type)
+{
+	new (&_storage) Functor(std::forward<Callable>(callable));
+	_invoke = &invokeInline<Event, Functor>;
+	_manage = &manageInline<Functor>;
+	_inline = true;
+}
+
+template<typename Event, typename Functor, typename Callable>
+void QDiscordEventCallback::store(Callable&& callable, std::false_type)
+{
+	*reinterpret_cast<Functor**>(&_storage) =
+			new Functor(std::forward<Callable>(callable));
+	_invoke = &invokeHeap<Event, Functor>;
+	_manage = &manageHeap<Functor>;
+	_inline = false;
+}
+
+template<typename Functor>
+void QDiscordEventCallback::manageInline(Operation operation,
+										 Storage* destination, Storage* source)
+{
+	if(operation == Operation::Move)
+	{
+		Functor* moved = reinterpret_cast<Functor*>(source);
+		new (destination) Functor(std::move(*moved));
+		moved->~Functor();
+	}
+	else
+		reinterpret_cast<Functor*>(destination)->~Functor();
+}
+
+template<typename Functor>
+void QDiscordEventCallback::manageHeap(Operation operation,
+									   Storage* destination, Storage* source)
+{
+	if(operation == Operation::Move)
+		*reinterpret_cast<Functor**>(destination) = *reinterpret_cast<Functor**>(source);
+	else
+		delete *reinterpret_cast<Functor**>(destination);
+}
+
+#endif // QDISCORDEVENTBUS_HPP
@@ -0,0 +1,205 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDEVENTS_HPP
+#define QDISCORDEVENTS_HPP
+
+#include <QDateTime>
+#include <QSharedPointer>
+#include <type_traits>
+#include "qdiscordchannel.hpp"
+#include "qdiscordguild.hpp"
+#include "qdiscordmember.hpp"
+#include "qdiscordmessage.hpp"
+#include "qdiscorduser.hpp"
+#include "qdiscordvoicestate.hpp"
+
+///\brief A compile-time list of event types.
+template<typename... Events>
+struct QDiscordEventList
+{
+	///\brief The amount of events in the list.
+	static const int size = sizeof...(Events);
+};
+
+/*!
+ * \brief Provides the position of an event type within a QDiscordEventList
+ * as `value`.
+ *
+ * Using an event which is not part of the list fails to compile.
+ */
+template<typename Event, typename List>
+struct QDiscordEventIndex;
+
+template<typename Event>
+struct QDiscordEventIndex<Event, QDiscordEventList<>>
+{
+	static_assert(!std::is_same<Event, Event>::value,
+				  "The type is not a QDiscord event.");
+	static const int value = -1;
+};
+
+template<typename Event, typename... Rest>
+struct QDiscordEventIndex<Event, QDiscordEventList<Event, Rest...>>
+{
+	static const int value = 0;
+};
+
+template<typename Event, typename First, typename... Rest>
+struct QDiscordEventIndex<Event, QDiscordEventList<First, Rest...>>
+{
+	static const int value =
+			1 + QDiscordEventIndex<Event, QDiscordEventList<Rest...>>::value;
+};
+
+/*!
+ * \brief Contains the events published through QDiscordEventBus.
+ *
+ * Each event corresponds to a signal of QDiscordStateComponent and carries
+ * that signal's arguments.
+ */
+namespace QDiscordEvent
+{
+	///\see QDiscordStateComponent::selfCreated
+	struct SelfCreate
+	{
+		QSharedPointer<QDiscordUser> self;
+	};
+	///\see QDiscordStateComponent::guildCreated
+	struct GuildCreate
+	{
+		QSharedPointer<QDiscordGuild> guild;
+	};
+	///\see QDiscordStateComponent::guildAvailable
+	struct GuildAvailable
+	{
+		QSharedPointer<QDiscordGuild> guild;
+	};
+	///\see QDiscordStateComponent::guildDeleted
+	struct GuildDelete
+	{
+		QDiscordGuild guild;
+	};
+	///\see QDiscordStateComponent::guildUpdated
+	struct GuildUpdate
+	{
+		QSharedPointer<QDiscordGuild> guild;
+	};
+	///\see QDiscordStateComponent::guildMemberAdded
+	struct GuildMemberAdd
+	{
+		QSharedPointer<QDiscordMember> member;
+	};
+	///\see QDiscordStateComponent::guildMemberRemoved
+	struct GuildMemberRemove
+	{
+		QDiscordMember member;
+	};
+	///\see QDiscordStateComponent::guildMemberUpdated
+	struct GuildMemberUpdate
+	{
+		QSharedPointer<QDiscordMember> member;
+	};
+	///\see QDiscordStateComponent::channelCreated
+	struct ChannelCreate
+	{
+		QSharedPointer<QDiscordChannel> channel;
+	};
+	///\see QDiscordStateComponent::channelDeleted
+	struct ChannelDelete
+	{
+		QDiscordChannel channel;
+	};
+	///\see QDiscordStateComponent::channelUpdated
+	struct ChannelUpdate
+	{
+		QSharedPointer<QDiscordChannel> channel;
+	};
+	///\see QDiscordStateComponent::privateChannelCreated
+	struct PrivateChannelCreate
+	{
+		QSharedPointer<QDiscordChannel> channel;
+	};
+	///\see QDiscordStateComponent::privateChannelDeleted
+	struct PrivateChannelDelete
+	{
+		QDiscordChannel channel;
+	};
+	///\see QDiscordStateComponent::privateChannelUpdated
+	struct PrivateChannelUpdate
+	{
+		QSharedPointer<QDiscordChannel> channel;
+	};
+	///\see QDiscordStateComponent::messageCreated
+	struct MessageCreate
+	{
+		QDiscordMessage message;
+	};
+	///\see QDiscordStateComponent::messageDeleted
+	struct MessageDelete
+	{
+		QDiscordMessage message;
+	};
+	///\see QDiscordStateComponent::messageUpdated
+	struct MessageUpdate
+	{
+		QDiscordMessage message;
+		QDateTime editedTimestamp;
+	};
+	///\see QDiscordStateComponent::cachedMessageUpdated
+	struct CachedMessageUpdate
+	{
+		QDiscordMessage previous;
+		QDiscordMessage current;
+	};
+	///\see QDiscordStateComponent::voiceStateUpdated
+	struct VoiceStateUpdate
+	{
+		QSharedPointer<QDiscordVoiceState> voiceState;
+		QString previousChannelId;
+	};
+
+	///\brief All events which can be subscribed to.
+	typedef QDiscordEventList<
+		SelfCreate,
+		GuildCreate,
+		GuildAvailable,
+		GuildDelete,
+		GuildUpdate,
+		GuildMemberAdd,
+		GuildMemberRemove,
+		GuildMemberUpdate,
+		ChannelCreate,
+		ChannelDelete,
+		ChannelUpdate,
+		PrivateChannelCreate,
+		PrivateChannelDelete,
+		PrivateChannelUpdate,
+		MessageCreate,
+		MessageDelete,
+		MessageUpdate,
+		CachedMessageUpdate,
+		VoiceStateUpdate
+	> List;
+
+	///\brief Provides the position of an event within QDiscordEvent::List.
+	template<typename Event>
+	struct Index : QDiscordEventIndex<Event, List> {};
+}
+
+#endif // QDISCORDEVENTS_HPP
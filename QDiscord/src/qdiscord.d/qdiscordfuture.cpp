@@ -0,0 +1,101 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordfuture.hpp"
+
+QDiscordFutureState::QDiscordFutureState()
+{
+	_error = QNetworkReply::NoError;
+	_finished = false;
+	_canceled = false;
+	_waiter = nullptr;
+	_waiterData = nullptr;
+}
+
+QDiscordFutureState::~QDiscordFutureState()
+{
+
+}
+
+void QDiscordFutureState::onFinished(const std::function<void()>& function)
+{
+	if(_finished)
+		function();
+	else
+		_continuations.append(function);
+}
+
+void QDiscordFutureState::setWaiter(void (*function)(void*), void* data)
+{
+	if(_finished)
+	{
+		function(data);
+		return;
+	}
+	_waiter = function;
+	_waiterData = data;
+}
+
+void QDiscordFutureState::onCanceled(const std::function<void()>& function)
+{
+	if(!_finished)
+		_cancelHandlers.append(function);
+}
+
+bool QDiscordFutureState::finish(QNetworkReply::NetworkError error)
+{
+	if(_finished)
+		return false;
+	_finished = true;
+	_error = error;
+	_reply.clear();
+	_cancelHandlers.clear();
+	runContinuations();
+	return true;
+}
+
+void QDiscordFutureState::cancel()
+{
+	if(_finished)
+		return;
+	_finished = true;
+	_canceled = true;
+	_error = QNetworkReply::OperationCanceledError;
+	QList<std::function<void()>> handlers;
+	handlers.swap(_cancelHandlers);
+	//Aborting finishes the reply right away, whose result is then dropped.
+	QPointer<QNetworkReply> reply = _reply;
+	_reply.clear();
+	if(reply)
+		reply->abort();
+	for(const std::function<void()>& handler : handlers)
+		handler();
+	runContinuations();
+}
+
+void QDiscordFutureState::runContinuations()
+{
+	QList<std::function<void()>> continuations;
+	continuations.swap(_continuations);
+	for(const std::function<void()>& continuation : continuations)
+		continuation();
+	void (*waiter)(void*) = _waiter;
+	_waiter = nullptr;
+	if(waiter)
+		waiter(_waiterData);
+}
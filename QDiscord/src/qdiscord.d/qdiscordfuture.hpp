@@ -0,0 +1,359 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDFUTURE_HPP
+#define QDISCORDFUTURE_HPP
+
+#include <QList>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QSharedPointer>
+#include <functional>
+#include <type_traits>
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief The shared state of a QDiscordFuture, independent of its result's
+ * type.
+ *
+ * This is used by QDiscordRequestPipeline to skip or abort the request of a
+ * canceled future and is not needed otherwise.
+ */
+class QDISCORD_API QDiscordFutureState
+{
+public:
+	QDiscordFutureState();
+	virtual ~QDiscordFutureState();
+	///\brief Returns whether the future has a result, an error or was canceled.
+	bool isFinished() const {return _finished;}
+	///\brief Returns whether the future was canceled.
+	bool isCanceled() const {return _canceled;}
+	/*!
+	 * \brief Returns the error of a failed future.
+	 *
+	 * Canceled futures report QNetworkReply::OperationCanceledError.
+	 */
+	QNetworkReply::NetworkError error() const {return _error;}
+	///\brief Sets the reply to abort if the future is canceled.
+	void setReply(QNetworkReply* reply) {_reply = reply;}
+	/*!
+	 * \brief Calls the function once the future has finished.
+	 *
+	 * The function is called right away if the future has already finished.
+	 */
+	void onFinished(const std::function<void()>& function);
+	/*!
+	 * \brief Calls the function if the future is canceled before it has
+	 * finished.
+	 */
+	void onCanceled(const std::function<void()>& function);
+	/*!
+	 * \brief Calls the function with the provided data once the future has
+	 * finished, after the functions passed to onFinished().
+	 *
+	 * Unlike onFinished(), this never allocates, but only a single waiter can
+	 * be set. It is used to resume coroutines awaiting the future.
+	 * \see hasWaiter
+	 */
+	void setWaiter(void (*function)(void*), void* data);
+	///\brief Returns whether a waiter has been set and not been called yet.
+	bool hasWaiter() const {return _waiter != nullptr;}
+	/*!
+	 * \brief Finishes the future with the provided error.
+	 * \returns `false` if the future had already finished.
+	 */
+	bool finish(QNetworkReply::NetworkError error);
+	///\brief Cancels the future unless it has already finished.
+	void cancel();
+private:
+	Q_DISABLE_COPY(QDiscordFutureState)
+	void runContinuations();
+	QPointer<QNetworkReply> _reply;
+	void (*_waiter)(void*);
+	void* _waiterData;
+	QList<std::function<void()>> _continuations;
+	QList<std::function<void()>> _cancelHandlers;
+	QNetworkReply::NetworkError _error;
+	bool _finished;
+	bool _canceled;
+};
+
+///\brief The shared state of a QDiscordFuture, holding its result.
+template<typename T>
+struct QDiscordFutureValue : public QDiscordFutureState
+{
+	T value;
+};
+
+template<typename T>
+class QDiscordFuture;
+
+template<typename T>
+class QDiscordPromise;
+
+/*!
+ * \brief Determines the future returned by QDiscordFuture::then for a
+ * function returning `R`.
+ *
+ * Functions returning a value resolve to that value, functions returning a
+ * QDiscordFuture resolve to that future's result and functions returning
+ * `void` pass the original result on.
+ */
+template<typename T, typename R>
+struct QDiscordFutureChain;
+
+/*!
+ * \brief Holds the result of an asynchronous operation, such as a REST
+ * request sent by QDiscordRestComponent.
+ *
+ * Results are received by chaining functions with then() and fail(), for
+ * example
+ * `rest.sendMessageFuture("Hi", channelId).then([](const QDiscordMessage& m){})`.
+ * A function is called exactly once, either when the result arrives or right
+ * away if it already has. Failures skip every function passed to then() and
+ * reach the ones passed to fail().\n
+ * Canceling a future drops its result without calling any functions. The
+ * cancellation spreads to the futures it was chained from and the ones
+ * chained from it, and a REST request which has not been sent yet is
+ * dropped, or aborted if it has.\n
+ * Copies of a future share the same state. Futures are not thread-safe and
+ * must only be used from the thread which created them.
+ */
+template<typename T>
+class QDiscordFuture
+{
+	template<typename> friend class QDiscordPromise;
+public:
+	///\brief The type of the future's result.
+	typedef T ValueType;
+	///\brief Creates an invalid future, which never finishes.
+	QDiscordFuture() {}
+	///\brief Creates a future which has already succeeded.
+	static QDiscordFuture<T> resolved(const T& value);
+	///\brief Creates a future which has already failed.
+	static QDiscordFuture<T> rejected(QNetworkReply::NetworkError error);
+	///\brief Returns whether the future belongs to an operation.
+	bool isValid() const {return !_state.isNull();}
+	///\brief Returns whether the future has a result, an error or was canceled.
+	bool isFinished() const {return _state && _state->isFinished();}
+	///\brief Returns whether the future was canceled.
+	bool isCanceled() const {return _state && _state->isCanceled();}
+	///\brief Returns whether the future has finished with a result.
+	bool isSucceeded() const {
+		return isFinished() && _state->error() == QNetworkReply::NoError;
+	}
+	///\brief Returns the error of a failed future.
+	QNetworkReply::NetworkError error() const {
+		return _state?_state->error():QNetworkReply::NoError;
+	}
+	/*!
+	 * \brief Returns the future's result, or a default-constructed value if it
+	 * has not succeeded.
+	 */
+	T result() const {return isSucceeded()?_state->value:T();}
+	///\brief Returns the state shared with the promise, if the future is valid.
+	QSharedPointer<QDiscordFutureState> state() const {return _state;}
+	///\brief Cancels the future. See QDiscordFuture.
+	void cancel() {
+		if(_state)
+			_state->cancel();
+	}
+	/*!
+	 * \brief Calls the function with the result once the future has
+	 * succeeded.
+	 * \returns A future for the function's result. See QDiscordFutureChain.
+	 */
+	template<typename F>
+	typename QDiscordFutureChain<T, typename std::result_of<F(const T&)>::type>::Future
+	then(F function) const;
+	/*!
+	 * \brief Calls the function with the error if the future fails.
+	 * \returns This future, so further functions can be chained.
+	 */
+	QDiscordFuture<T>
+	fail(const std::function<void(QNetworkReply::NetworkError)>& function) const;
+private:
+	QSharedPointer<QDiscordFutureValue<T>> _state;
+};
+
+/*!
+ * \brief Finishes a QDiscordFuture.
+ *
+ * Only the first call to resolve(), reject() or cancel() has any effect, so a
+ * result arriving for a canceled future is simply dropped.
+ */
+template<typename T>
+class QDiscordPromise
+{
+public:
+	///\brief Creates a promise with an unfinished future.
+	QDiscordPromise() : _state(new QDiscordFutureValue<T>()) {}
+	///\brief Returns the future finished by this promise.
+	QDiscordFuture<T> future() const {
+		QDiscordFuture<T> future;
+		future._state = _state;
+		return future;
+	}
+	///\brief Returns the state shared with the future.
+	QSharedPointer<QDiscordFutureState> state() const {return _state;}
+	///\brief Returns whether the future was canceled.
+	bool isCanceled() const {return _state->isCanceled();}
+	///\brief Finishes the future with a result.
+	void resolve(const T& value) {
+		if(_state->isFinished())
+			return;
+		_state->value = value;
+		_state->finish(QNetworkReply::NoError);
+	}
+	///\brief Finishes the future with an error.
+	void reject(QNetworkReply::NetworkError error) {_state->finish(error);}
+	///\brief Cancels the future.
+	void cancel() {_state->cancel();}
+	/*!
+	 * \brief Finishes the future the same way as the provided one, which is
+	 * canceled along with it.
+	 */
+	void follow(const QDiscordFuture<T>& future);
+private:
+	QSharedPointer<QDiscordFutureValue<T>> _state;
+};
+
+template<typename T, typename R>
+struct QDiscordFutureChain
+{
+	typedef QDiscordFuture<typename std::decay<R>::type> Future;
+	template<typename F>
+	static void run(F& function, const T& value,
+					QDiscordPromise<typename Future::ValueType>& promise) {
+		promise.resolve(function(value));
+	}
+};
+
+template<typename T>
+struct QDiscordFutureChain<T, void>
+{
+	typedef QDiscordFuture<T> Future;
+	template<typename F>
+	static void run(F& function, const T& value, QDiscordPromise<T>& promise) {
+		function(value);
+		promise.resolve(value);
+	}
+};
+
+template<typename T, typename U>
+struct QDiscordFutureChain<T, QDiscordFuture<U>>
+{
+	typedef QDiscordFuture<U> Future;
+	template<typename F>
+	static void run(F& function, const T& value, QDiscordPromise<U>& promise) {
+		promise.follow(function(value));
+	}
+};
+
+template<typename T>
+QDiscordFuture<T> QDiscordFuture<T>::resolved(const T& value)
+{
+	QDiscordPromise<T> promise;
+	promise.resolve(value);
+	return promise.future();
+}
+
+template<typename T>
+QDiscordFuture<T>
+QDiscordFuture<T>::rejected(QNetworkReply::NetworkError error)
+{
+	QDiscordPromise<T> promise;
+	promise.reject(error);
+	return promise.future();
+}
+
+template<typename T>
+template<typename F>
+typename QDiscordFutureChain<T, typename std::result_of<F(const T&)>::type>::Future
+QDiscordFuture<T>::then(F function) const
+{
+	typedef QDiscordFutureChain<T, typename std::result_of<F(const T&)>::type>
+			Chain;
+	typedef typename Chain::Future::ValueType Result;
+	if(!_state)
+		return typename Chain::Future();
+	QDiscordPromise<Result> promise;
+	//The chained future does not keep this one alive, only the other way
+	//around, so nothing leaks if the result never arrives.
+	QWeakPointer<QDiscordFutureValue<T>> weak = _state;
+	promise.state()->onCanceled([weak](){
+		QSharedPointer<QDiscordFutureValue<T>> source = weak.toStrongRef();
+		if(source)
+			source->cancel();
+	});
+	//Continuations are only ever called by the state itself.
+	QDiscordFutureValue<T>* source = _state.data();
+	_state->onFinished([source, promise, function]() mutable {
+		if(source->isCanceled())
+			promise.cancel();
+		else if(source->error() != QNetworkReply::NoError)
+			promise.reject(source->error());
+		else if(!promise.isCanceled())
+			Chain::run(function, source->value, promise);
+	});
+	return promise.future();
+}
+
+template<typename T>
+QDiscordFuture<T> QDiscordFuture<T>::fail(
+		const std::function<void(QNetworkReply::NetworkError)>& function) const
+{
+	if(_state && function)
+	{
+		QDiscordFutureValue<T>* source = _state.data();
+		_state->onFinished([source, function](){
+			if(!source->isCanceled() &&
+			   source->error() != QNetworkReply::NoError)
+				function(source->error());
+		});
+	}
+	return *this;
+}
+
+template<typename T>
+void QDiscordPromise<T>::follow(const QDiscordFuture<T>& future)
+{
+	if(!future._state)
+	{
+		cancel();
+		return;
+	}
+	QWeakPointer<QDiscordFutureValue<T>> weak = future._state;
+	_state->onCanceled([weak](){
+		QSharedPointer<QDiscordFutureValue<T>> source = weak.toStrongRef();
+		if(source)
+			source->cancel();
+	});
+	QDiscordFutureValue<T>* source = future._state.data();
+	QDiscordPromise<T> promise = *this;
+	future._state->onFinished([source, promise]() mutable {
+		if(source->isCanceled())
+			promise.cancel();
+		else if(source->error() != QNetworkReply::NoError)
+			promise.reject(source->error());
+		else
+			promise.resolve(source->value);
+	});
+}
+
+#endif // QDISCORDFUTURE_HPP
@@ -17,35 +17,46 @@
  */
 
 #include "qdiscordgame.hpp"
+#include "qdiscordtrace.hpp"
+#include "qdiscordstringpool.hpp"
 
 QDiscordGame::QDiscordGame(QString name,
 						   QString url,
 						   QDiscordGame::GameType type)
 {
-	_name = name;
-	_url = url;
-	_type = type;
+	d->_name = QDiscordStringPool::intern(name);
+	d->_url = url;
+	d->_type = type;
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordGame("<<this<<") constructed";
+	QDISCORD_TRACE(Model, Verbose, "QDiscordGame constructed", quintptr(this));
 }
 
-QDiscordGame::QDiscordGame(const QJsonObject& object)
+QDiscordGame::QDiscordGame(const QJsonObject& object):
+	d(new QDiscordGameData)
 {
-	_name = object["name"].toString("");
-	_url = object["url"].toString("");
+	d->_name = QDiscordStringPool::intern(object["name"].toString(""));
+	d->_url = object["url"].toString("");
 	switch(object["type"].toInt(-1))
 	{
 		case 1:
-			_type = GameType::Streaming;
+			d->_type = GameType::Streaming;
 		break;
 		case 0:
-			_type = GameType::None;
+			d->_type = GameType::None;
 		break;
 		default:
-			_type = GameType::UnknownType;
+			d->_type = GameType::UnknownType;
 	}
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordGame("<<this<<") constructed";
+	QDISCORD_TRACE(Model, Verbose, "QDiscordGame constructed", quintptr(this));
 }
+
+QDiscordGame::QDiscordGame(const QDiscordGame& other) = default;
+
+QDiscordGame::QDiscordGame(QDiscordGame&& other) Q_DECL_NOTHROW = default;
+
+QDiscordGame::~QDiscordGame() = default;
+
+QDiscordGame& QDiscordGame::operator =(const QDiscordGame& other) = default;
+
+QDiscordGame& QDiscordGame::operator =(QDiscordGame&& other) Q_DECL_NOTHROW = default;
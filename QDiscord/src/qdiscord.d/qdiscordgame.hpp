@@ -21,9 +21,17 @@
 
 #include <QJsonObject>
 #include <QDebug>
+#include <QSharedData>
 #include "qdiscordutilities.hpp"
 
-///\brief Represents a game. Used in statuses.
+class QDiscordGameData;
+
+/*!
+ * \brief Represents a game. Used in statuses.
+ *
+ * Games are implicitly shared, so copying one only increments a reference
+ * count.
+ */
 class QDISCORD_API QDiscordGame
 {
 public:
@@ -47,18 +55,36 @@ public:
 	QDiscordGame(QString name = "", QString url = "", GameType type = GameType::None);
 	///\brief Creates an instance from the provided JSON object.
 	QDiscordGame(const QJsonObject& object);
+	///\brief Shares the provided object's data until either of them is modified.
+	QDiscordGame(const QDiscordGame& other);
+	///\brief Takes over the provided object's data.
+	QDiscordGame(QDiscordGame&& other) Q_DECL_NOTHROW;
+	~QDiscordGame();
+	QDiscordGame& operator =(const QDiscordGame& other);
+	QDiscordGame& operator =(QDiscordGame&& other) Q_DECL_NOTHROW;
 	///\brief Returns the game name of this object.
-	QString name() const {return _name;}
+	QString name() const;
 	///\brief Returns the URL of this game object.
-	QString url() const {return _url;}
+	QString url() const;
 	///\brief Returns the type of this game object.
-	GameType type() const {return _type;}
+	GameType type() const;
 private:
+	QSharedDataPointer<QDiscordGameData> d;
+};
+
+///\brief The data shared between copies of a QDiscordGame.
+class QDiscordGameData : public QSharedData
+{
+public:
 	QString _name;
 	QString _url;
-	GameType _type;
+	QDiscordGame::GameType _type;
 };
 
+inline QString QDiscordGame::name() const {return d->_name;}
+inline QString QDiscordGame::url() const {return d->_url;}
+inline QDiscordGame::GameType QDiscordGame::type() const {return d->_type;}
+
 Q_DECLARE_METATYPE(QDiscordGame)
 
 #endif // QDISCORDGAME_HPP
@@ -16,89 +16,172 @@
  * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include "qdiscordchannel.hpp"
 #include "qdiscordguild.hpp"
+#include "qdiscordtrace.hpp"
 
-QDiscordGuild::QDiscordGuild(const QJsonObject& object)
+QDiscordGuildData::QDiscordGuildData(const QDiscordGuildData& other):
+	QSharedData(other),
+	_id(other._id),
+	_name(other._name),
+	_unavailable(other._unavailable),
+	_verificationLevel(other._verificationLevel),
+	_afkTimeout(other._afkTimeout),
+	_memberCount(other._memberCount),
+	_joinedAt(other._joinedAt),
+	_contents(other._contents),
+	_voiceStates(other._voiceStates),
+	_voiceChannelOccupants(other._voiceChannelOccupants)
 {
-	_id = object["id"].toString("");
-	_unavailable = object["unavailable"].toBool(false);
-	_name = object["name"].toString("");
-	_verificationLevel = object["verification_level"].toInt(0);
-	_afkTimeout = object["afk_timeout"].toInt(0);
-	_memberCount = object["member_count"].toInt(1);
-	_joinedAt = QDateTime::fromString(object["joined_at"].toString(""),
-			Qt::ISODate);
+
+}
+
+QDiscordGuild::QDiscordGuild(const QJsonObject& object,
+							 const QDiscordCachePolicy& policy,
+							 const QString& selfId):
+	d(new QDiscordGuildData)
+{
+	d->_id = object["id"].toString("");
+	d->_unavailable = object["unavailable"].toBool(false);
+	d->_name = object["name"].toString("");
+	d->_verificationLevel = object["verification_level"].toInt(0);
+	d->_afkTimeout = object["afk_timeout"].toInt(0);
+	d->_memberCount = object["member_count"].toInt(1);
+	d->_joinedAt = QDiscordUtilities::parseTimestamp(
+			object["joined_at"].toString(""));
 	for(QJsonValue item : object["members"].toArray())
 	{
+		QJsonObject memberObject = item.toObject();
+		QString userId = memberObject["user"].toObject()["id"].toString("");
+		if(!policy.cachesMember(d->_id, userId, selfId))
+			continue;
+		if(!policy.cacheUsers())
+			memberObject["user"] = QJsonObject({{"id", userId}});
 		QSharedPointer<QDiscordMember> member =
 				QSharedPointer<QDiscordMember>(
-						new QDiscordMember(item.toObject(), sharedFromThis())
+						new QDiscordMember(memberObject, sharedFromThis())
 					);
-		_members.insert(member->user()->id(), member);
+		d->_contents->_members.insert(member->user()->id(), member);
+		d->_contents->_memoryUsage += QDiscordMemoryUsage::of(*member);
 	}
+	if(policy.indexMembers())
+		setMemberIndexEnabled(true);
 	for(QJsonValue item : object["channels"].toArray())
 	{
 		QSharedPointer<QDiscordChannel> channel =
 				QSharedPointer<QDiscordChannel>(
 						new QDiscordChannel(item.toObject(), sharedFromThis())
 					);
-		_channels.insert(channel->id(), channel);
+		addChannel(channel);
 	}
+	for(QJsonValue item : object["voice_states"].toArray())
+	{
+		updateVoiceState(QSharedPointer<QDiscordVoiceState>(
+							 new QDiscordVoiceState(item.toObject(), d->_id)
+							 ));
+	}
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordGuild constructed", quintptr(this));
+}
+
+QDiscordGuild::QDiscordGuild(const QDiscordGuild& other) = default;
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordGuild("<<this<<") constructed";
+QDiscordGuild::QDiscordGuild(QDiscordGuild&& other) = default;
+
+QDiscordGuild::~QDiscordGuild() = default;
+
+QDiscordGuild& QDiscordGuild::operator =(const QDiscordGuild& other) = default;
+
+QDiscordGuild& QDiscordGuild::operator =(QDiscordGuild&& other) = default;
+
+QDiscordGuild::QDiscordGuild():
+	d(new QDiscordGuildData)
+{
+	d->_id = "";
+	d->_unavailable = false;
+	d->_name = "";
+	d->_verificationLevel = 0;
+	d->_afkTimeout = 0;
+	d->_memberCount = 0;
+	d->_joinedAt = QDiscordUtilities::invalidTimestamp;
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordGuild constructed", quintptr(this));
 }
 
-QDiscordGuild::QDiscordGuild(const QDiscordGuild& other):
-	QEnableSharedFromThis<QDiscordGuild>()
+void QDiscordGuild::update(const QJsonObject& object)
 {
-	_id = other.id();
-	_unavailable = other.unavailable();
-	_name = other.name();
-	_verificationLevel = other.verificationLevel();
-	_afkTimeout = other.afkTimeout();
-	_memberCount = other.memberCount();
-	_joinedAt = other.joinedAt();
-	for(QSharedPointer<QDiscordChannel> item : other.channels())
+	if(object.contains("unavailable"))
+		d->_unavailable = object["unavailable"].toBool(false);
+	if(object.contains("name"))
+		d->_name = object["name"].toString("");
+	if(object.contains("verification_level"))
+		d->_verificationLevel = object["verification_level"].toInt(0);
+	if(object.contains("afk_timeout"))
+		d->_afkTimeout = object["afk_timeout"].toInt(0);
+	if(object.contains("member_count"))
+		d->_memberCount = object["member_count"].toInt(1);
+	if(object.contains("joined_at"))
 	{
-		QSharedPointer<QDiscordChannel> newChannel =
-				QSharedPointer<QDiscordChannel>(
-						new QDiscordChannel(*item)
-					);
-		newChannel->setGuild(sharedFromThis());
-		_channels.insert(other.channels().key(item), newChannel);
+		d->_joinedAt = QDiscordUtilities::parseTimestamp(
+				object["joined_at"].toString(""));
 	}
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordGuild updated", quintptr(this));
 }
 
-QDiscordGuild::QDiscordGuild()
+QJsonObject QDiscordGuild::toJson() const
 {
-	_id = "";
-	_unavailable = false;
-	_name = "";
-	_verificationLevel = 0;
-	_afkTimeout = 0;
-	_memberCount = 0;
-	_joinedAt = QDateTime();
-
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordGuild("<<this<<") constructed";
+	QJsonObject object;
+	object["id"] = d->_id;
+	object["name"] = d->_name;
+	object["unavailable"] = d->_unavailable;
+	object["verification_level"] = d->_verificationLevel;
+	object["afk_timeout"] = d->_afkTimeout;
+	object["member_count"] = d->_memberCount;
+	object["joined_at"] = d->_joinedAt != QDiscordUtilities::invalidTimestamp ?
+				QJsonValue(joinedAt().toString(Qt::ISODateWithMs)) : QJsonValue();
+	QJsonArray members;
+	for(const QSharedPointer<QDiscordMember>& item : d->_contents->_members)
+		members.append(item->toJson());
+	object["members"] = members;
+	QJsonArray channels;
+	for(const QSharedPointer<QDiscordChannel>& item : d->_contents->_channels)
+		channels.append(item->toJson());
+	object["channels"] = channels;
+	QJsonArray voiceStates;
+	for(const QSharedPointer<QDiscordVoiceState>& item : d->_voiceStates)
+		voiceStates.append(item->toJson());
+	object["voice_states"] = voiceStates;
+	return object;
 }
 
 void QDiscordGuild::addChannel(QSharedPointer<QDiscordChannel> channel)
 {
 	if(!channel)
 		return;
-	 _channels.insert(channel->id(), channel);
+	QSharedPointer<QDiscordChannel> previous =
+			d->_contents->_channels.value(channel->id());
+	if(previous)
+	{
+		d->_contents->_memoryUsage -= QDiscordMemoryUsage::of(*previous);
+		unindexChannel(channel->id());
+	}
+	d->_contents->_channels.insert(channel->id(), channel);
+	d->_contents->_memoryUsage += QDiscordMemoryUsage::of(*channel);
+	indexChannel(channel);
 }
 
 bool QDiscordGuild::removeChannel(QSharedPointer<QDiscordChannel> channel)
 {
 	if(!channel)
 		return false;
-	if(!_channels.keys().contains(channel->id()))
+	QSharedPointer<QDiscordChannel> stored =
+			d->_contents->_channels.take(channel->id());
+	if(!stored)
 		return false;
-	_channels.remove(channel->id());
+	d->_contents->_memoryUsage -= QDiscordMemoryUsage::of(*stored);
+	unindexChannel(stored->id());
 	return true;
 }
 
@@ -106,15 +189,176 @@ void QDiscordGuild::addMember(QSharedPointer<QDiscordMember> member)
 {
 	if(!member)
 		return;
-	_members.insert(member->user()->id(), member);
+	QSharedPointer<QDiscordMember> previous =
+			d->_contents->_members.value(member->user()->id());
+	if(previous)
+		d->_contents->_memoryUsage -= QDiscordMemoryUsage::of(*previous);
+	d->_contents->_members.insert(member->user()->id(), member);
+	d->_contents->_memoryUsage += QDiscordMemoryUsage::of(*member);
+	if(d->_contents->_memberIndex)
+		d->_contents->_memberIndex->insert(member);
 }
 
 bool QDiscordGuild::removeMember(QSharedPointer<QDiscordMember> member)
 {
 	if(!member)
 		return false;
-	if(!_members.keys().contains(member->user()->id()))
+	QSharedPointer<QDiscordMember> stored =
+			d->_contents->_members.take(member->user()->id());
+	if(!stored)
 		return false;
-	_members.remove(member->user()->id());
+	d->_contents->_memoryUsage -= QDiscordMemoryUsage::of(*stored);
+	if(d->_contents->_memberIndex)
+		d->_contents->_memberIndex->remove(member->user()->id());
 	return true;
 }
+
+void QDiscordGuild::updateMember(QSharedPointer<QDiscordMember> member,
+								 const QJsonObject& object)
+{
+	if(!member)
+		return;
+	bool stored = member->user() &&
+			d->_contents->_members.contains(member->user()->id());
+	if(stored)
+		d->_contents->_memoryUsage -= QDiscordMemoryUsage::of(*member);
+	member->update(object, sharedFromThis());
+	if(stored)
+	{
+		d->_contents->_memoryUsage += QDiscordMemoryUsage::of(*member);
+		if(d->_contents->_memberIndex)
+			d->_contents->_memberIndex->insert(member);
+	}
+}
+
+void QDiscordGuild::setMemberIndexEnabled(bool enabled)
+{
+	if(!enabled)
+	{
+		d->_contents->_memberIndex.reset();
+		return;
+	}
+	if(d->_contents->_memberIndex)
+		return;
+	d->_contents->_memberIndex =
+			QSharedPointer<QDiscordMemberIndex>(new QDiscordMemberIndex);
+	for(const QSharedPointer<QDiscordMember>& item : d->_contents->_members)
+		d->_contents->_memberIndex->insert(item);
+}
+
+void QDiscordGuild::updateChannel(QSharedPointer<QDiscordChannel> channel,
+								  const QJsonObject& object)
+{
+	if(!channel)
+		return;
+	bool stored = d->_contents->_channels.value(channel->id()) == channel;
+	if(stored)
+	{
+		d->_contents->_memoryUsage -= QDiscordMemoryUsage::of(*channel);
+		unindexChannel(channel->id());
+	}
+	channel->update(object);
+	if(stored)
+	{
+		d->_contents->_memoryUsage += QDiscordMemoryUsage::of(*channel);
+		indexChannel(channel);
+	}
+}
+
+int QDiscordGuild::indexOf(const QString& channelId) const
+{
+	const QDiscordGuildData::Contents& contents = *d->_contents;
+	QHash<QString, ChannelKey>::const_iterator key =
+			contents._channelKeys.constFind(channelId);
+	if(key == contents._channelKeys.constEnd())
+		return -1;
+	QVector<ChannelKey>::const_iterator position =
+			std::lower_bound(contents._channelOrder.constBegin(),
+							 contents._channelOrder.constEnd(), *key);
+	return position - contents._channelOrder.constBegin();
+}
+
+QDiscordGuild::ChannelKey
+QDiscordGuild::channelKey(const QDiscordChannel& channel)
+{
+	ChannelKey key;
+	switch(channel.type())
+	{
+	case QDiscordChannel::ChannelType::Text:
+		key.type = 0;
+		break;
+	case QDiscordChannel::ChannelType::Voice:
+		key.type = 1;
+		break;
+	default:
+		key.type = 2;
+	}
+	key.position = channel.position();
+	key.id = channel.id().toULongLong();
+	return key;
+}
+
+void QDiscordGuild::indexChannel(QSharedPointer<QDiscordChannel> channel)
+{
+	ChannelKey key = channelKey(*channel);
+	QVector<ChannelKey>& order = d->_contents->_channelOrder;
+	int index = std::lower_bound(order.begin(), order.end(), key) - order.begin();
+	d->_contents->_channelOrder.insert(index, key);
+	d->_contents->_orderedChannels.insert(index, channel);
+	d->_contents->_channelKeys.insert(channel->id(), key);
+}
+
+void QDiscordGuild::unindexChannel(const QString& id)
+{
+	int index = indexOf(id);
+	if(index < 0)
+		return;
+	d->_contents->_channelOrder.remove(index);
+	d->_contents->_orderedChannels.removeAt(index);
+	d->_contents->_channelKeys.remove(id);
+}
+
+QList<QSharedPointer<QDiscordVoiceState>>
+QDiscordGuild::voiceChannelOccupants(const QString& channelId) const
+{
+	QList<QSharedPointer<QDiscordVoiceState>> occupants;
+	QHash<QString, QSet<QString>>::const_iterator userIds =
+			d->_voiceChannelOccupants.find(channelId);
+	if(userIds == d->_voiceChannelOccupants.end())
+		return occupants;
+	occupants.reserve(userIds->size());
+	for(const QString& userId : *userIds)
+		occupants.append(d->_voiceStates.value(userId));
+	return occupants;
+}
+
+QSharedPointer<QDiscordVoiceState>
+QDiscordGuild::updateVoiceState(QSharedPointer<QDiscordVoiceState> voiceState)
+{
+	if(!voiceState)
+		return QSharedPointer<QDiscordVoiceState>();
+	QSharedPointer<QDiscordVoiceState> previous =
+			removeVoiceState(voiceState->userId());
+	if(voiceState->channelId().isEmpty())
+		return previous;
+	d->_voiceStates.insert(voiceState->userId(), voiceState);
+	d->_voiceChannelOccupants[voiceState->channelId()].insert(voiceState->userId());
+	return previous;
+}
+
+QSharedPointer<QDiscordVoiceState>
+QDiscordGuild::removeVoiceState(const QString& userId)
+{
+	QSharedPointer<QDiscordVoiceState> voiceState = d->_voiceStates.take(userId);
+	if(!voiceState)
+		return voiceState;
+	QHash<QString, QSet<QString>>::iterator userIds =
+			d->_voiceChannelOccupants.find(voiceState->channelId());
+	if(userIds != d->_voiceChannelOccupants.end())
+	{
+		userIds->remove(userId);
+		if(userIds->isEmpty())
+			d->_voiceChannelOccupants.erase(userIds);
+	}
+	return voiceState;
+}
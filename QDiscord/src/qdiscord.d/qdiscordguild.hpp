@@ -21,56 +21,175 @@
 
 #include <QDateTime>
 #include <QDebug>
+#include <QHash>
+#include <QSet>
+#include <QSharedData>
 #include <QJsonObject>
 #include <QJsonArray>
 #include "qdiscordmember.hpp"
+#include "qdiscordmemberindex.hpp"
 #include "qdiscordchannel.hpp"
+#include "qdiscordcachepolicy.hpp"
+#include "qdiscordmemoryusage.hpp"
+#include "qdiscordvoicestate.hpp"
 #include "qdiscordutilities.hpp"
 
-///\brief Represents a guild in the Discord API.
+///\brief The data shared between copies of a QDiscordGuild.
+class QDISCORD_API QDiscordGuildData : public QSharedData
+{
+public:
+	struct ChannelKey
+	{
+		int type;
+		int position;
+		quint64 id;
+		bool operator <(const ChannelKey& other) const {
+			if(type != other.type)
+				return type < other.type;
+			if(position != other.position)
+				return position < other.position;
+			return id < other.id;
+		}
+	};
+	/*!
+	 * \brief The channels and members of a guild.
+	 *
+	 * They are kept together with the indexes and the memory accounting built
+	 * from them, so that all of these are updated at once.
+	 */
+	struct Contents
+	{
+		QMap<QString, QSharedPointer<QDiscordMember> > _members;
+		QMap<QString, QSharedPointer<QDiscordChannel> > _channels;
+		//Channels sorted by their ChannelKey, with the keys kept in a parallel
+		//vector for binary searches.
+		QList<QSharedPointer<QDiscordChannel>> _orderedChannels;
+		QVector<ChannelKey> _channelOrder;
+		QHash<QString, ChannelKey> _channelKeys;
+		QDiscordMemoryUsage _memoryUsage;
+		QSharedPointer<QDiscordMemberIndex> _memberIndex;
+	};
+	QDiscordGuildData(): _contents(new Contents) {}
+	/*!
+	 * \brief Copies the provided data.
+	 *
+	 * The guild's contents are shared with the copy, so pointers handed out
+	 * before a guild detaches keep pointing at its live objects, and the member
+	 * index and memory usage of both copies stay in sync with those objects.
+	 */
+	QDiscordGuildData(const QDiscordGuildData& other);
+	QString _id;
+	QString _name;
+	bool _unavailable;
+	int _verificationLevel;
+	int _afkTimeout;
+	int _memberCount;
+	qint64 _joinedAt;
+	QSharedPointer<Contents> _contents;
+	QHash<QString, QSharedPointer<QDiscordVoiceState>> _voiceStates;
+	//User IDs of the occupants of each voice channel, by channel ID.
+	QHash<QString, QSet<QString>> _voiceChannelOccupants;
+};
+
+/*!
+ * \brief Represents a guild in the Discord API.
+ *
+ * Guilds are implicitly shared, so copying one only increments a reference
+ * count. The guild's own properties are copied once either copy is modified,
+ * while its channels and members stay shared between all copies.
+ */
 class QDISCORD_API QDiscordGuild : public QEnableSharedFromThis<QDiscordGuild>
 {
 public:
 	/*!
 	 * \brief Creates an instance from the provided parameters.
 	 * \param object A JSON object of a Discord guild.
+	 * \param policy The policy selecting which of the guild's members are stored.
+	 * Members which are not stored are skipped before being parsed.
+	 * \param selfId The ID of the current user, used by the policy.
 	 */
-	QDiscordGuild(const QJsonObject& object);
-	///\brief Deep copies the provided object.
+	QDiscordGuild(const QJsonObject& object,
+				  const QDiscordCachePolicy& policy = QDiscordCachePolicy(),
+				  const QString& selfId = QString());
+	///\brief Shares the provided object's data until either of them is modified.
 	QDiscordGuild(const QDiscordGuild& other);
+	///\brief Takes over the provided object's data.
+	QDiscordGuild(QDiscordGuild&& other);
+	~QDiscordGuild();
+	QDiscordGuild& operator =(const QDiscordGuild& other);
+	QDiscordGuild& operator =(QDiscordGuild&& other);
 	///\brief Default public constructor.
 	QDiscordGuild();
+	/*!
+	 * \brief Updates the guild's own properties from the provided parameters.
+	 *
+	 * Only properties contained in the object are changed. Members and channels
+	 * are left untouched.
+	 */
+	void update(const QJsonObject& object);
+	/*!
+	 * \brief Serializes this object into the JSON format used by the Discord API.
+	 *
+	 * The resulting object contains all members and channels of the guild.
+	 */
+	QJsonObject toJson() const;
 	///\brief Returns the guild's ID.
-	QString id() const {return _id;}
+	QString id() const {return d->_id;}
 	///\brief Returns the guild's name.
-	QString name() const {return _name;}
+	QString name() const {return d->_name;}
 	/*!
 	 * \brief Returns whether the guild is unavailable.
 	 *
 	 * If this is true, most members will not be set to anything.
 	 */
-	bool unavailable() const {return _unavailable;}
+	bool unavailable() const {return d->_unavailable;}
 	///\brief Returns the guild's verification level.
-	int verificationLevel() const {return _verificationLevel;}
+	int verificationLevel() const {return d->_verificationLevel;}
 	///\brief Returns the guild's AFK time needed to move a user to the AFK channel.
-	int afkTimeout() const {return _afkTimeout;}
+	int afkTimeout() const {return d->_afkTimeout;}
 	///\brief Returns the guild's member count.
-	int memberCount() const {return _memberCount;}
+	int memberCount() const {return d->_memberCount;}
 	///\brief Returns the date the current user joined this guild.
-	QDateTime joinedAt() const {return _joinedAt;}
+	QDateTime joinedAt() const
+	{return QDiscordUtilities::timestampToDateTime(d->_joinedAt);}
+	/*!
+	 * \brief Returns the milliseconds since the Unix epoch at which the
+	 * current user joined this guild, or QDiscordUtilities::invalidTimestamp.
+	 */
+	qint64 joinedAtMSecs() const {return d->_joinedAt;}
+	///\brief Returns the date this guild was created, derived from its ID.
+	QDateTime createdAt() const
+	{return QDiscordUtilities::timestampToDateTime(
+				QDiscordUtilities::snowflakeTimestamp(d->_id));}
 	///\brief Returns a map of pointers to the guild's channels and their IDs.
 	QMap<QString, QSharedPointer<QDiscordChannel> >
-	channels() const {return _channels;}
+	channels() const {return d->_contents->_channels;}
+	/*!
+	 * \brief Returns the guild's channels in the order they are displayed in.
+	 *
+	 * Channels are sorted by type, text channels first, then by position and
+	 * finally by ID. The order is maintained as channels are added, removed or
+	 * updated, so this does not sort or copy anything.
+	 */
+	QList<QSharedPointer<QDiscordChannel>>
+	orderedChannels() const {return d->_contents->_orderedChannels;}
+	/*!
+	 * \brief Returns the index of the channel with the provided ID in
+	 * orderedChannels().
+	 * \returns -1 if the channel was not found.
+	 */
+	int indexOf(const QString& channelId) const;
 	///\brief Returns a map of pointers to the guild's members and their IDs.
 	QMap<QString, QSharedPointer<QDiscordMember> >
-	members() const {return _members;}
+	members() const {return d->_contents->_members;}
 	/*!
 	 * \brief Returns a pointer to a guild channel that has the provided ID.
 	 * May return `nullptr` if the channel was not found.
 	 */
 	QSharedPointer<QDiscordChannel>
 	channel(const QString& id) const {
-		return _channels.value(id, QSharedPointer<QDiscordChannel>());
+		return d->_contents->_channels.value(id,
+				QSharedPointer<QDiscordChannel>());
 	}
 	/*!
 	 * \brief Returns a pointer to a guild member that has the provided ID.
@@ -78,7 +197,8 @@ public:
 	 */
 	QSharedPointer<QDiscordMember>
 	member(const QString& id) const {
-		return _members.value(id, QSharedPointer<QDiscordMember>());
+		return d->_contents->_members.value(id,
+				QSharedPointer<QDiscordMember>());
 	}
 	/*!
 	 * \brief Adds the provided channel to the guild.
@@ -109,16 +229,90 @@ public:
 	 * passed or the member was not found.
 	 */
 	bool removeMember(QSharedPointer<QDiscordMember> member);
+	/*!
+	 * \brief Updates the provided member of this guild from a JSON object.
+	 *
+	 * Unlike calling QDiscordMember::update directly, this keeps memoryUsage()
+	 * up to date.
+	 */
+	void updateMember(QSharedPointer<QDiscordMember> member,
+					  const QJsonObject& object);
+	/*!
+	 * \brief Updates the provided channel of this guild from a JSON object.
+	 *
+	 * Unlike calling QDiscordChannel::update directly, this keeps memoryUsage()
+	 * up to date.
+	 */
+	void updateChannel(QSharedPointer<QDiscordChannel> channel,
+					   const QJsonObject& object);
+	/*!
+	 * \brief Returns the approximate memory used by the guild's members,
+	 * their users and the guild's channels.
+	 *
+	 * This is updated incrementally as members and channels are added, removed
+	 * or updated, so it is cheap to call.
+	 */
+	QDiscordMemoryUsage memoryUsage() const
+	{return d->_contents->_memoryUsage;}
+	///\brief Returns whether the guild keeps a search index of its members.
+	bool memberIndexEnabled() const
+	{return !d->_contents->_memberIndex.isNull();}
+	/*!
+	 * \brief Enables or disables the guild's member search index.
+	 *
+	 * Enabling the index builds it from the currently stored members. Afterwards
+	 * it is updated by addMember(), removeMember() and updateMember().
+	 */
+	void setMemberIndexEnabled(bool enabled);
+	/*!
+	 * \brief Returns the guild's member search index.
+	 * May return `nullptr` if the index is not enabled.
+	 */
+	QSharedPointer<const QDiscordMemberIndex>
+	memberIndex() const {return d->_contents->_memberIndex;}
+	///\brief Returns a hash of pointers to the guild's voice states and their user IDs.
+	QHash<QString, QSharedPointer<QDiscordVoiceState>>
+	voiceStates() const {return d->_voiceStates;}
+	/*!
+	 * \brief Returns a pointer to the voice state of the user with the provided ID.
+	 * May return `nullptr` if the user is not connected to a voice channel.
+	 */
+	QSharedPointer<QDiscordVoiceState>
+	voiceState(const QString& userId) const {
+		return d->_voiceStates.value(userId);
+	}
+	/*!
+	 * \brief Returns the voice states of all users connected to the voice
+	 * channel with the provided ID.
+	 *
+	 * This only visits the channel's occupants.
+	 */
+	QList<QSharedPointer<QDiscordVoiceState>>
+	voiceChannelOccupants(const QString& channelId) const;
+	///\brief Returns the IDs of all users connected to the provided voice channel.
+	QSet<QString> voiceChannelUserIds(const QString& channelId) const {
+		return d->_voiceChannelOccupants.value(channelId);
+	}
+	/*!
+	 * \brief Stores the provided voice state, replacing the user's previous one.
+	 *
+	 * If the voice state does not have a channel ID, the user has disconnected
+	 * and their voice state is removed instead.
+	 * \returns The user's previous voice state or `nullptr` if there was none.
+	 */
+	QSharedPointer<QDiscordVoiceState>
+	updateVoiceState(QSharedPointer<QDiscordVoiceState> voiceState);
+	/*!
+	 * \brief Removes the voice state of the user with the provided ID.
+	 * \returns The removed voice state or `nullptr` if there was none.
+	 */
+	QSharedPointer<QDiscordVoiceState> removeVoiceState(const QString& userId);
 private:
-	QString _id;
-	QString _name;
-	bool _unavailable;
-	int _verificationLevel;
-	int _afkTimeout;
-	int _memberCount;
-	QDateTime _joinedAt;
-	QMap<QString, QSharedPointer<QDiscordMember> > _members;
-	QMap<QString, QSharedPointer<QDiscordChannel> > _channels;
+	typedef QDiscordGuildData::ChannelKey ChannelKey;
+	static ChannelKey channelKey(const QDiscordChannel& channel);
+	void indexChannel(QSharedPointer<QDiscordChannel> channel);
+	void unindexChannel(const QString& id);
+	QSharedDataPointer<QDiscordGuildData> d;
 };
 
 Q_DECLARE_METATYPE(QDiscordGuild)
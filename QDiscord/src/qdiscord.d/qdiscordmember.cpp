@@ -17,86 +17,114 @@
  */
 
 #include "qdiscordmember.hpp"
+#include "qdiscordtrace.hpp"
 #include "qdiscordguild.hpp"
+#include "qdiscordstringpool.hpp"
 
 QDiscordMember::QDiscordMember(const QJsonObject& object,
-							   QSharedPointer<QDiscordGuild> guild)
+							   QSharedPointer<QDiscordGuild> guild):
+	d(new QDiscordMemberData)
 {
-	_deaf = object["deaf"].toBool(false);
-	_mute = object["mute"].toBool(false);
-	_nickname = object["nick"].toString("");
-	_joinedAt = QDateTime::fromString(object["joined_at"].toString(""),
-			Qt::ISODate);
-	_guild = guild;
-	_user = object["user"].isObject() ?
+	d->_deaf = object["deaf"].toBool(false);
+	d->_mute = object["mute"].toBool(false);
+	d->_nickname = QDiscordStringPool::intern(object["nick"].toString(""));
+	d->_joinedAt = QDiscordUtilities::parseTimestamp(
+			object["joined_at"].toString(""));
+	d->_guild = guild;
+	d->_user = object["user"].isObject() ?
 				QSharedPointer<QDiscordUser>(
 					new QDiscordUser(object["user"].toObject())
 				) :
 				QSharedPointer<QDiscordUser>();
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordMember("<<this<<") constructed";
+	QDISCORD_TRACE(Model, Verbose, "QDiscordMember constructed", quintptr(this));
 }
 
-QDiscordMember::QDiscordMember()
+QDiscordMember::QDiscordMember():
+	d(new QDiscordMemberData)
 {
-	_deaf = false;
-	_mute = false;
-	_nickname = "";
-	_joinedAt = QDateTime();
-	_user = QSharedPointer<QDiscordUser>();
-	_guild = QSharedPointer<QDiscordGuild>();
+	d->_deaf = false;
+	d->_mute = false;
+	d->_nickname = "";
+	d->_joinedAt = QDiscordUtilities::invalidTimestamp;
+	d->_user = QSharedPointer<QDiscordUser>();
+	d->_guild = QSharedPointer<QDiscordGuild>();
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordMember("<<this<<") constructed";
+	QDISCORD_TRACE(Model, Verbose, "QDiscordMember constructed", quintptr(this));
 }
 
-QDiscordMember::QDiscordMember(const QDiscordMember& other)
-{
-	_deaf = other.deaf();
-	_mute = other.mute();
-	_joinedAt = other.joinedAt();
-	_user = other.user() ?
-				QSharedPointer<QDiscordUser>(new QDiscordUser(*other.user())) :
-				QSharedPointer<QDiscordUser>();
-	_guild = other.guild();
-}
+QDiscordMember::QDiscordMember(const QDiscordMember& other) = default;
+
+QDiscordMember::QDiscordMember(QDiscordMember&& other) Q_DECL_NOTHROW = default;
+
+QDiscordMember::~QDiscordMember() = default;
+
+QDiscordMember&
+QDiscordMember::operator =(const QDiscordMember& other) = default;
+
+QDiscordMember&
+QDiscordMember::operator =(QDiscordMember&& other) Q_DECL_NOTHROW = default;
 
 void QDiscordMember::update(const QJsonObject& object,
 							QSharedPointer<QDiscordGuild> guild)
 {
 	if(object.contains("deaf"))
-		_deaf = object["deaf"].toBool(false);
+		d->_deaf = object["deaf"].toBool(false);
 	if(object.contains("mute"))
-		_mute = object["mute"].toBool(false);
+		d->_mute = object["mute"].toBool(false);
 	if(object.contains("nick"))
-		_nickname = object["nick"].toString("");
+		d->_nickname = QDiscordStringPool::intern(object["nick"].toString(""));
 	if(object.contains("joined_at"))
 	{
-		_joinedAt = QDateTime::fromString(object["joined_at"].toString(""),
-				Qt::ISODate);
+		d->_joinedAt = QDiscordUtilities::parseTimestamp(
+				object["joined_at"].toString(""));
 	}
 	if(guild)
-		_guild = guild;
-	if(_user)
-		_user->update(object["user"].toObject());
+		d->_guild = guild;
+	if(object["user"].isObject())
+	{
+		QJsonObject user = object["user"].toObject();
+		//The user is shared with copies of this member, so it is only
+		//replaced if the payload is about a different user.
+		if(!d->_user || (user.contains("id") &&
+						 user["id"].toString("") != d->_user->id()))
+		{
+			d->_user = QSharedPointer<QDiscordUser>(new QDiscordUser(user));
+		}
+		else
+			d->_user->update(user);
+	}
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordMember("<<this<<") updated";
+	QDISCORD_TRACE(Model, Verbose, "QDiscordMember updated", quintptr(this));
+}
+
+QJsonObject QDiscordMember::toJson() const
+{
+	QJsonObject object;
+	object["deaf"] = d->_deaf;
+	object["mute"] = d->_mute;
+	object["nick"] = d->_nickname;
+	object["joined_at"] = d->_joinedAt != QDiscordUtilities::invalidTimestamp ?
+				QJsonValue(joinedAt().toString(Qt::ISODateWithMs)) : QJsonValue();
+	if(d->_user)
+		object["user"] = d->_user->toJson();
+	if(d->_guild)
+		object["guild_id"] = d->_guild->id();
+	return object;
 }
 
 bool QDiscordMember::operator ==(const QDiscordMember& other) const
 {
-	if(!_user)
+	if(!d->_user)
 		return false;
 	if(!other.user())
 		return false;
-	if(!_guild)
+	if(!d->_guild)
 		return false;
 	if(!other.guild())
 		return false;
-	if(*_user == *other.user() &&
-			_guild->id() == other.guild()->id())
+	if(*d->_user == *other.user() &&
+			d->_guild->id() == other.guild()->id())
 	{
 		return true;
 	}
@@ -105,16 +133,16 @@ bool QDiscordMember::operator ==(const QDiscordMember& other) const
 
 bool QDiscordMember::operator !=(const QDiscordMember& other) const
 {
-	if(!_user)
+	if(!d->_user)
 		return true;
 	if(!other.user())
 		return true;
-	if(!_guild)
+	if(!d->_guild)
 		return true;
 	if(!other.guild())
 		return true;
-	if(*_user == *other.user() &&
-			_guild->id() == other.guild()->id())
+	if(*d->_user == *other.user() &&
+			d->_guild->id() == other.guild()->id())
 	{
 		return false;
 	}
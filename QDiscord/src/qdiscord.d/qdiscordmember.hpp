@@ -21,16 +21,44 @@
 
 #include <QDebug>
 #include <QDateTime>
+#include <QSharedData>
 #include <QSharedPointer>
 #include "qdiscorduser.hpp"
 
 class QDiscordGuild;
 
+///\brief The data shared between copies of a QDiscordMember.
+class QDiscordMemberData : public QSharedData
+{
+public:
+	QDiscordMemberData() {}
+	//The user is shared with the copy, so pointers acquired through
+	//QDiscordMember::user() keep receiving updates.
+	QDiscordMemberData(const QDiscordMemberData& other):
+		QSharedData(other),
+		_deaf(other._deaf),
+		_joinedAt(other._joinedAt),
+		_mute(other._mute),
+		_nickname(other._nickname),
+		_user(other._user),
+		_guild(other._guild)
+	{}
+	bool _deaf;
+	qint64 _joinedAt;
+	bool _mute;
+	QString _nickname;
+	QSharedPointer<QDiscordUser> _user;
+	QSharedPointer<QDiscordGuild> _guild;
+};
+
 /*!
  * \brief Represents a guild member in the Discord API.
  *
  * This class contains a QDiscordUser object which provides more information about the guild member.
- * You may acquire a pointer to it using QDiscordMember::user().
+ * You may acquire a pointer to it using QDiscordMember::user().\n
+ * Members are implicitly shared, so copying one only increments a reference
+ * count. Copies keep sharing the same user object after either of them is
+ * modified, unless an update replaces it with a different user.
  */
 class QDISCORD_API QDiscordMember
 {
@@ -43,26 +71,39 @@ public:
 	QDiscordMember(const QJsonObject& object, QSharedPointer<QDiscordGuild> guild);
 	///\brief Default public constructor.
 	QDiscordMember();
-	///\brief Deep copies the provided object.
+	///\brief Shares the provided object's data until either of them is modified.
 	QDiscordMember(const QDiscordMember& other);
+	///\brief Takes over the provided object's data.
+	QDiscordMember(QDiscordMember&& other) Q_DECL_NOTHROW;
+	~QDiscordMember();
+	QDiscordMember& operator =(const QDiscordMember& other);
+	QDiscordMember& operator =(QDiscordMember&& other) Q_DECL_NOTHROW;
 	///\brief Updates the current instance from the provided parameters.
 	void update(const QJsonObject& object, QSharedPointer<QDiscordGuild> guild);
+	///\brief Serializes this object into the JSON format used by the Discord API.
+	QJsonObject toJson() const;
 	///\brief Returns whether the member has disabled their speakers.
-	bool deaf() const {return _deaf;}
+	bool deaf() const {return d->_deaf;}
 	///\brief Returns whether the member has muted their microphone.
-	bool mute() const {return _mute;}
+	bool mute() const {return d->_mute;}
 	///\brief Returns the date at which the member has joined the guild.
-	QDateTime joinedAt() const {return _joinedAt;}
+	QDateTime joinedAt() const
+	{return QDiscordUtilities::timestampToDateTime(d->_joinedAt);}
+	/*!
+	 * \brief Returns the milliseconds since the Unix epoch at which the member
+	 * has joined the guild, or QDiscordUtilities::invalidTimestamp.
+	 */
+	qint64 joinedAtMSecs() const {return d->_joinedAt;}
 	///\brief Returns a pointer to the user object contained by this object.
-	QSharedPointer<QDiscordUser> user() const {return _user;}
+	QSharedPointer<QDiscordUser> user() const {return d->_user;}
 	///\brief Returns a pointer to this object's parent guild.
-	QSharedPointer<QDiscordGuild> guild() const {return _guild;}
+	QSharedPointer<QDiscordGuild> guild() const {return d->_guild;}
 	///\brief Returns this member's nickname.
-	QString nickname() const {return _nickname;}
+	QString nickname() const {return d->_nickname;}
 	///\brief Returns a string which allows you to mention this member using their username.
-	QString mentionUsername() const {return QString("<@"+(_user?_user->id():"nullptr")+">");}
+	QString mentionUsername() const {return QString("<@"+(d->_user?d->_user->id():"nullptr")+">");}
 	///\brief Returns a string which allows you to mention this member using their nickname.
-	QString mentionNickname() const {return QString("<@!"+(_user?_user->id():"nullptr")+">");}
+	QString mentionNickname() const {return QString("<@!"+(d->_user?d->_user->id():"nullptr")+">");}
 	/*!
 	 * \brief Compares two members.
 	 *
@@ -78,12 +119,7 @@ public:
 	 */
 	bool operator !=(const QDiscordMember& other) const;
 private:
-	bool _deaf;
-	QDateTime _joinedAt;
-	bool _mute;
-	QString _nickname;
-	QSharedPointer<QDiscordUser> _user;
-	QSharedPointer<QDiscordGuild> _guild;
+	QSharedDataPointer<QDiscordMemberData> d;
 };
 
 Q_DECLARE_METATYPE(QDiscordMember)
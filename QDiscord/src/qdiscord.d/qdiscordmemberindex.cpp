@@ -0,0 +1,175 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordmemberindex.hpp"
+#include "qdiscorduser.hpp"
+
+QDiscordMemberIndex::QDiscordMemberIndex()
+{
+
+}
+
+void QDiscordMemberIndex::insert(QSharedPointer<QDiscordMember> member)
+{
+	if(!member || !member->user())
+		return;
+	remove(member->user()->id());
+	quint64 id = member->user()->id().toULongLong();
+	Entry entry;
+	entry.member = member;
+	entry.names = names(*member);
+	for(const QString& name : entry.names)
+	{
+		_prefixes.insert(prefixKey(name, id), id);
+		for(quint64 trigram : trigrams(name))
+			_trigrams[trigram].insert(id);
+	}
+	_entries.insert(id, entry);
+}
+
+void QDiscordMemberIndex::remove(const QString& userId)
+{
+	quint64 id = userId.toULongLong();
+	QHash<quint64, Entry>::iterator entry = _entries.find(id);
+	if(entry == _entries.end())
+		return;
+	for(const QString& name : entry->names)
+	{
+		_prefixes.remove(prefixKey(name, id));
+		for(quint64 trigram : trigrams(name))
+		{
+			QHash<quint64, QSet<quint64>>::iterator ids = _trigrams.find(trigram);
+			if(ids == _trigrams.end())
+				continue;
+			ids->remove(id);
+			if(ids->isEmpty())
+				_trigrams.erase(ids);
+		}
+	}
+	_entries.erase(entry);
+}
+
+void QDiscordMemberIndex::clear()
+{
+	_entries.clear();
+	_prefixes.clear();
+	_trigrams.clear();
+}
+
+QList<QSharedPointer<QDiscordMember>>
+QDiscordMemberIndex::findByPrefix(const QString& prefix, int limit) const
+{
+	QList<QSharedPointer<QDiscordMember>> results;
+	QSet<quint64> found;
+	QString folded = prefix.toCaseFolded();
+	for(QMap<QString, quint64>::const_iterator i = _prefixes.lowerBound(folded);
+		i != _prefixes.end() && i.key().startsWith(folded); ++i)
+	{
+		if(limit >= 0 && results.size() >= limit)
+			break;
+		//Members whose username and nickname both match are only returned once.
+		if(found.contains(i.value()))
+			continue;
+		found.insert(i.value());
+		results.append(_entries.value(i.value()).member);
+	}
+	return results;
+}
+
+QList<QSharedPointer<QDiscordMember>>
+QDiscordMemberIndex::findBySubstring(const QString& text, int limit) const
+{
+	QList<QSharedPointer<QDiscordMember>> results;
+	QString folded = text.toCaseFolded();
+	if(limit == 0)
+		return results;
+	if(folded.length() < 3)
+	{
+		for(const Entry& entry : _entries)
+		{
+			if(!matches(entry, folded))
+				continue;
+			results.append(entry.member);
+			if(limit >= 0 && results.size() >= limit)
+				break;
+		}
+		return results;
+	}
+	//Every match has to contain all of the query's trigrams, so only the
+	//members listed for the rarest one need to be checked.
+	const QSet<quint64>* candidates = nullptr;
+	for(quint64 trigram : trigrams(folded))
+	{
+		QHash<quint64, QSet<quint64>>::const_iterator ids =
+				_trigrams.find(trigram);
+		if(ids == _trigrams.end())
+			return results;
+		if(!candidates || ids->size() < candidates->size())
+			candidates = &ids.value();
+	}
+	for(quint64 id : *candidates)
+	{
+		QHash<quint64, Entry>::const_iterator entry = _entries.find(id);
+		if(entry == _entries.end() || !matches(*entry, folded))
+			continue;
+		results.append(entry->member);
+		if(limit >= 0 && results.size() >= limit)
+			break;
+	}
+	return results;
+}
+
+QStringList QDiscordMemberIndex::names(const QDiscordMember& member)
+{
+	QStringList names;
+	QString username = member.user()->username().toCaseFolded();
+	if(!username.isEmpty())
+		names.append(username);
+	QString nickname = member.nickname().toCaseFolded();
+	if(!nickname.isEmpty() && nickname != username)
+		names.append(nickname);
+	return names;
+}
+
+QSet<quint64> QDiscordMemberIndex::trigrams(const QString& name)
+{
+	QSet<quint64> trigrams;
+	const QChar* data = name.constData();
+	for(int i = 0; i + 2 < name.length(); i++)
+	{
+		trigrams.insert(quint64(data[i].unicode())<<32 |
+						quint64(data[i + 1].unicode())<<16 |
+						quint64(data[i + 2].unicode()));
+	}
+	return trigrams;
+}
+
+QString QDiscordMemberIndex::prefixKey(const QString& name, quint64 id)
+{
+	return name + QChar(0) + QString::number(id);
+}
+
+bool QDiscordMemberIndex::matches(const Entry& entry, const QString& text) const
+{
+	for(const QString& name : entry.names)
+	{
+		if(name.contains(text))
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,93 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDMEMBERINDEX_HPP
+#define QDISCORDMEMBERINDEX_HPP
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+#include "qdiscordmember.hpp"
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief A search index over the usernames and nicknames of guild members.
+ *
+ * Names are case folded and stored in a sorted map for prefix queries and
+ * split into trigrams for substring queries, so neither has to look at every
+ * member of the guild.\n
+ * A guild only keeps an index if it was enabled with
+ * QDiscordGuild::setMemberIndexEnabled or QDiscordCachePolicy::setIndexMembers.
+ * The guild keeps it up to date as members are added, removed or updated.
+ */
+class QDISCORD_API QDiscordMemberIndex
+{
+public:
+	///\brief Default public constructor.
+	QDiscordMemberIndex();
+	///\brief Returns the amount of indexed members.
+	int size() const {return _entries.size();}
+	/*!
+	 * \brief Indexes the provided member, replacing any previous entry for the
+	 * same user.
+	 */
+	void insert(QSharedPointer<QDiscordMember> member);
+	///\brief Removes the member of the user with the provided ID.
+	void remove(const QString& userId);
+	///\brief Removes all members from the index.
+	void clear();
+	/*!
+	 * \brief Returns members whose username or nickname starts with the
+	 * provided text, ignoring case.
+	 *
+	 * Results are ordered by the matching name.
+	 * \param limit The maximum amount of results. Negative values mean no limit.
+	 */
+	QList<QSharedPointer<QDiscordMember>>
+	findByPrefix(const QString& prefix, int limit = -1) const;
+	/*!
+	 * \brief Returns members whose username or nickname contains the provided
+	 * text, ignoring case.
+	 *
+	 * Results are in no particular order. Queries shorter than three characters
+	 * can not use the trigram index and fall back to checking every member's
+	 * names.
+	 * \param limit The maximum amount of results. Negative values mean no limit.
+	 */
+	QList<QSharedPointer<QDiscordMember>>
+	findBySubstring(const QString& text, int limit = -1) const;
+private:
+	struct Entry
+	{
+		QSharedPointer<QDiscordMember> member;
+		QStringList names;
+	};
+	static QStringList names(const QDiscordMember& member);
+	static QSet<quint64> trigrams(const QString& name);
+	static QString prefixKey(const QString& name, quint64 id);
+	bool matches(const Entry& entry, const QString& text) const;
+	QHash<quint64, Entry> _entries;
+	//Folded names followed by the user ID, so members sharing a name get
+	//their own keys.
+	QMap<QString, quint64> _prefixes;
+	QHash<quint64, QSet<quint64>> _trigrams;
+};
+
+#endif // QDISCORDMEMBERINDEX_HPP
@@ -0,0 +1,162 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordmemoryusage.hpp"
+#include "qdiscordchannel.hpp"
+#include "qdiscordmember.hpp"
+#include "qdiscordmessage.hpp"
+#include "qdiscorduser.hpp"
+
+namespace
+{
+	//Reference counts of a QSharedPointer, allocated next to the object.
+	const qint64 sharedPointerOverhead = 2*sizeof(int) + sizeof(void*);
+	//Colour, pointers and key of a QMap node.
+	const qint64 mapNodeOverhead = 3*sizeof(void*) + sizeof(QString);
+}
+
+QDiscordMemoryUsage::QDiscordMemoryUsage()
+{
+	members = 0;
+	users = 0;
+	channels = 0;
+	strings = 0;
+	messages = 0;
+	memberBytes = 0;
+	userBytes = 0;
+	channelBytes = 0;
+	stringBytes = 0;
+	messageBytes = 0;
+}
+
+QString QDiscordMemoryUsage::toString() const
+{
+	return QString("%1 KiB: %2 members (%3 KiB), %4 users (%5 KiB), "
+				   "%6 channels (%7 KiB), %8 strings (%9 KiB), "
+				   "%10 messages (%11 KiB)")
+			.arg(totalBytes()/1024)
+			.arg(members).arg(memberBytes/1024)
+			.arg(users).arg(userBytes/1024)
+			.arg(channels).arg(channelBytes/1024)
+			.arg(strings).arg(stringBytes/1024)
+			.arg(messages).arg(messageBytes/1024);
+}
+
+QDiscordMemoryUsage&
+QDiscordMemoryUsage::operator +=(const QDiscordMemoryUsage& other)
+{
+	members += other.members;
+	users += other.users;
+	channels += other.channels;
+	strings += other.strings;
+	messages += other.messages;
+	memberBytes += other.memberBytes;
+	userBytes += other.userBytes;
+	channelBytes += other.channelBytes;
+	stringBytes += other.stringBytes;
+	messageBytes += other.messageBytes;
+	return *this;
+}
+
+QDiscordMemoryUsage&
+QDiscordMemoryUsage::operator -=(const QDiscordMemoryUsage& other)
+{
+	members -= other.members;
+	users -= other.users;
+	channels -= other.channels;
+	strings -= other.strings;
+	messages -= other.messages;
+	memberBytes -= other.memberBytes;
+	userBytes -= other.userBytes;
+	channelBytes -= other.channelBytes;
+	stringBytes -= other.stringBytes;
+	messageBytes -= other.messageBytes;
+	return *this;
+}
+
+QDiscordMemoryUsage
+QDiscordMemoryUsage::operator +(const QDiscordMemoryUsage& other) const
+{
+	QDiscordMemoryUsage result(*this);
+	result += other;
+	return result;
+}
+
+QDiscordMemoryUsage QDiscordMemoryUsage::of(const QDiscordMember& member)
+{
+	QDiscordMemoryUsage usage;
+	usage.members = 1;
+	usage.memberBytes = sizeof(QDiscordMember) + sizeof(QDiscordMemberData) +
+			sharedPointerOverhead + mapNodeOverhead;
+	usage.addString(member.nickname());
+	if(member.user())
+		usage += of(*member.user());
+	return usage;
+}
+
+QDiscordMemoryUsage QDiscordMemoryUsage::of(const QDiscordUser& user)
+{
+	QDiscordMemoryUsage usage;
+	usage.users = 1;
+	usage.userBytes = sizeof(QDiscordUser) + sizeof(QDiscordUserData) +
+			sharedPointerOverhead;
+	//Four-digit discriminators are stored inline, other discriminators are
+	//interned.
+	usage.addString(user.id());
+	usage.addString(user.avatar());
+	usage.addString(user.email());
+	usage.addString(user.username());
+	return usage;
+}
+
+QDiscordMemoryUsage QDiscordMemoryUsage::of(const QDiscordChannel& channel)
+{
+	QDiscordMemoryUsage usage;
+	usage.channels = 1;
+	usage.channelBytes = sizeof(QDiscordChannel) + sizeof(QDiscordChannelData) +
+			sharedPointerOverhead + mapNodeOverhead;
+	usage.addString(channel.id());
+	usage.addString(channel.name());
+	usage.addString(channel.topic());
+	usage.addString(channel.lastMessageId());
+	return usage;
+}
+
+QDiscordMemoryUsage QDiscordMemoryUsage::of(const QDiscordMessage& message)
+{
+	QDiscordMemoryUsage usage;
+	usage.messages = 1;
+	usage.messageBytes = sizeof(QDiscordMessage) + sizeof(QDiscordMessageData) +
+			sharedPointerOverhead + message.mentions().size()*sizeof(void*);
+	usage.addString(message.id());
+	usage.addString(message.content());
+	usage.addString(message.channelId());
+	if(message.author())
+		usage += of(*message.author());
+	for(const QSharedPointer<QDiscordUser>& item : message.mentions())
+		usage += of(*item);
+	return usage;
+}
+
+void QDiscordMemoryUsage::addString(const QString& string)
+{
+	if(string.isEmpty())
+		return;
+	strings++;
+	stringBytes += sizeof(QArrayData) + (string.size() + 1)*sizeof(QChar);
+}
@@ -0,0 +1,78 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDMEMORYUSAGE_HPP
+#define QDISCORDMEMORYUSAGE_HPP
+
+#include <QMetaType>
+#include <QString>
+#include "qdiscordutilities.hpp"
+
+class QDiscordChannel;
+class QDiscordMember;
+class QDiscordMessage;
+class QDiscordUser;
+
+/*!
+ * \brief Approximate memory used by stored Discord objects.
+ *
+ * Byte counts are estimates based on the size of each object, its allocation
+ * overhead and the contents of its strings. Strings are counted separately
+ * from the objects holding them. Implicitly shared data is counted once for
+ * every object referencing it.
+ * \see QDiscordGuild::memoryUsage
+ * \see QDiscordStateComponent::memoryUsage
+ */
+struct QDISCORD_API QDiscordMemoryUsage
+{
+	int members;		///<\brief The amount of stored members.
+	int users;			///<\brief The amount of stored users.
+	int channels;		///<\brief The amount of stored channels.
+	int strings;		///<\brief The amount of non-empty strings.
+	int messages;		///<\brief The amount of cached messages.
+	qint64 memberBytes;	///<\brief Bytes used by members, excluding strings.
+	qint64 userBytes;	///<\brief Bytes used by users, excluding strings.
+	qint64 channelBytes;///<\brief Bytes used by channels, excluding strings.
+	qint64 stringBytes;	///<\brief Bytes used by string contents.
+	qint64 messageBytes;///<\brief Bytes used by messages, excluding strings.
+	///\brief Creates an empty instance.
+	QDiscordMemoryUsage();
+	///\brief Returns the sum of all byte counts.
+	qint64 totalBytes() const {
+		return memberBytes + userBytes + channelBytes + stringBytes + messageBytes;
+	}
+	///\brief Returns a single line describing this instance.
+	QString toString() const;
+	QDiscordMemoryUsage& operator +=(const QDiscordMemoryUsage& other);
+	QDiscordMemoryUsage& operator -=(const QDiscordMemoryUsage& other);
+	QDiscordMemoryUsage operator +(const QDiscordMemoryUsage& other) const;
+	///\brief Estimates the memory used by a member, including its user.
+	static QDiscordMemoryUsage of(const QDiscordMember& member);
+	///\brief Estimates the memory used by a user.
+	static QDiscordMemoryUsage of(const QDiscordUser& user);
+	///\brief Estimates the memory used by a channel, excluding its recipient.
+	static QDiscordMemoryUsage of(const QDiscordChannel& channel);
+	///\brief Estimates the memory used by a message, including its users.
+	static QDiscordMemoryUsage of(const QDiscordMessage& message);
+private:
+	void addString(const QString& string);
+};
+
+Q_DECLARE_METATYPE(QDiscordMemoryUsage)
+
+#endif // QDISCORDMEMORYUSAGE_HPP
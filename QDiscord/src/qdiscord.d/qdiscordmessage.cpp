@@ -17,23 +17,89 @@
  */
 
 #include "qdiscordmessage.hpp"
+#include "qdiscordtrace.hpp"
 
 QDiscordMessage::QDiscordMessage(const QJsonObject& object,
-								 QSharedPointer<QDiscordChannel> channel)
+								 QSharedPointer<QDiscordChannel> channel):
+	d(new QDiscordMessageData)
 {
-	_id = object["id"].toString("");
-	_mentionEveryone = object["mention_everyone"].toBool(false);
-	_content = object["content"].toString("");
-	_channel = channel;
-	_channelId = object["channel_id"].toString("");
-	_author = object.contains("author") ?
+	d->_id = object["id"].toString("");
+	d->_mentionEveryone = object["mention_everyone"].toBool(false);
+	d->_content = object["content"].toString("");
+	d->_channel = channel;
+	d->_channelId = object["channel_id"].toString("");
+	d->_author = object.contains("author") ?
 				QSharedPointer<QDiscordUser>(
 					new QDiscordUser(object["author"].toObject())
 				) : QSharedPointer<QDiscordUser>();
-	_tts = object["tts"].toBool(false);
-	_timestamp = QDateTime::fromString(object["timestamp"].toString(""),
-			Qt::ISODate);;
-	for(QJsonValue item : object["mentions"].toArray())
+	d->_tts = object["tts"].toBool(false);
+	d->_timestamp = QDiscordUtilities::parseTimestamp(
+			object["timestamp"].toString(""));
+	parseMentions(object["mentions"].toArray());
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordMessage constructed", quintptr(this));
+}
+
+QDiscordMessage::QDiscordMessage():
+	d(new QDiscordMessageData)
+{
+	d->_id = "";
+	d->_mentionEveryone = false;
+	d->_content = "";
+	d->_author = QSharedPointer<QDiscordUser>();
+	d->_channel = QSharedPointer<QDiscordChannel>();
+	d->_channelId = "";
+	d->_tts = false;
+	d->_timestamp = QDiscordUtilities::invalidTimestamp;
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordMessage constructed", quintptr(this));
+}
+
+QDiscordMessage::QDiscordMessage(const QDiscordMessage& other) = default;
+
+QDiscordMessage::QDiscordMessage(QDiscordMessage&& other) Q_DECL_NOTHROW = default;
+
+QDiscordMessage::~QDiscordMessage() = default;
+
+QDiscordMessage&
+QDiscordMessage::operator =(const QDiscordMessage& other) = default;
+
+QDiscordMessage&
+QDiscordMessage::operator =(QDiscordMessage&& other) Q_DECL_NOTHROW = default;
+
+void QDiscordMessage::update(const QJsonObject& object)
+{
+	if(object.contains("content"))
+		d->_content = object["content"].toString("");
+	if(object.contains("mention_everyone"))
+		d->_mentionEveryone = object["mention_everyone"].toBool(false);
+	if(object.contains("tts"))
+		d->_tts = object["tts"].toBool(false);
+	//The author may be shared with copies made before the update, which have
+	//to keep reporting the previous author.
+	if(object.contains("author"))
+	{
+		d->_author = QSharedPointer<QDiscordUser>(
+					new QDiscordUser(object["author"].toObject())
+					);
+	}
+	if(object.contains("mentions"))
+	{
+		d->_mentions.clear();
+		parseMentions(object["mentions"].toArray());
+	}
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordMessage updated", quintptr(this));
+}
+
+QSharedPointer<QDiscordGuild> QDiscordMessage::guild() const
+{
+	return d->_channel ? d->_channel->guild() : QSharedPointer<QDiscordGuild>();
+}
+
+void QDiscordMessage::parseMentions(const QJsonArray& mentions)
+{
+	for(QJsonValue item : mentions)
 	{
 		if(guild())
 		{
@@ -41,59 +107,21 @@ QDiscordMessage::QDiscordMessage(const QJsonObject& object,
 					guild()->member(item.toObject()["id"].toString(""));
 			if(member && member->user())
 			{
-				_mentions.removeAll(member->user());
-				_mentions.append(member->user());
+				d->_mentions.removeAll(member->user());
+				d->_mentions.append(member->user());
 			}
 			else
 			{
-				_mentions.append(QSharedPointer<QDiscordUser>(
+				d->_mentions.append(QSharedPointer<QDiscordUser>(
 									 new QDiscordUser(item.toObject())
 									 ));
 			}
 		}
 		else
 		{
-			_mentions.append(QSharedPointer<QDiscordUser>(
+			d->_mentions.append(QSharedPointer<QDiscordUser>(
 								 new QDiscordUser(item.toObject())
 								 ));
 		}
 	}
-
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordMessage("<<this<<") constructed";
-}
-
-QDiscordMessage::QDiscordMessage()
-{
-	_id = "";
-	_mentionEveryone = false;
-	_content = "";
-	_author = QSharedPointer<QDiscordUser>();
-	_channel = QSharedPointer<QDiscordChannel>();
-	_channelId = "";
-	_tts = false;
-	_timestamp = QDateTime();
-
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordMessage("<<this<<") constructed";
-}
-
-QDiscordMessage::QDiscordMessage(const QDiscordMessage& other)
-{
-	_id = other.id();
-	_mentionEveryone = other.mentionEveryone();
-	_content = other.content();
-	_author = other.author();
-	_channel = other.channel();
-	_channelId = other.channelId();
-	_tts = other.tts();
-	_timestamp = other.timestamp();
-	QList<QSharedPointer<QDiscordUser>> otherMentions = other.mentions();
-	for(QSharedPointer<QDiscordUser> item : otherMentions)
-		_mentions.append(item);
-}
-
-QSharedPointer<QDiscordGuild> QDiscordMessage::guild() const
-{
-	return _channel ? _channel->guild() : QSharedPointer<QDiscordGuild>();
 }
@@ -19,13 +19,32 @@
 #ifndef QDISCORDMESSAGE_HPP
 #define QDISCORDMESSAGE_HPP
 
+#include <QSharedData>
 #include "qdiscordmember.hpp"
 #include "qdiscordchannel.hpp"
 #include "qdiscordguild.hpp"
 #include "qdiscordutilities.hpp"
 
+///\brief The data shared between copies of a QDiscordMessage.
+class QDiscordMessageData : public QSharedData
+{
+public:
+	QString _id;
+	QString _content;
+	qint64 _timestamp;
+	bool _tts;
+	bool _mentionEveryone;
+	QString _channelId;
+	QSharedPointer<QDiscordChannel> _channel;
+	QSharedPointer<QDiscordUser> _author;
+	QList<QSharedPointer<QDiscordUser> > _mentions;
+};
+
 /*!
  * \brief Represents a message in the Discord API.
+ *
+ * Messages are implicitly shared, so copying one only increments a reference
+ * count.
  */
 class QDISCORD_API QDiscordMessage
 {
@@ -42,24 +61,50 @@ public:
 			);
 	///\brief Default public constructor.
 	QDiscordMessage();
-	///\brief Deep copies the provided object.
+	///\brief Shares the provided object's data until either of them is modified.
 	QDiscordMessage(const QDiscordMessage& other);
+	///\brief Takes over the provided object's data.
+	QDiscordMessage(QDiscordMessage&& other) Q_DECL_NOTHROW;
+	~QDiscordMessage();
+	QDiscordMessage& operator =(const QDiscordMessage& other);
+	QDiscordMessage& operator =(QDiscordMessage&& other) Q_DECL_NOTHROW;
+	/*!
+	 * \brief Updates the current instance from the provided parameters.
+	 *
+	 * Only the fields contained in the provided object will be changed.
+	 */
+	void update(const QJsonObject& object);
 	///\brief Returns the message's ID.
-	QString id() const {return _id;}
+	QString id() const {return d->_id;}
 	///\brief Returns the message's contents.
-	QString content() const {return _content;}
+	QString content() const {return d->_content;}
 	///\brief Returns the date at which the message was created.
-	QDateTime timestamp() const {return _timestamp;}
+	QDateTime timestamp() const
+	{return QDiscordUtilities::timestampToDateTime(d->_timestamp);}
+	/*!
+	 * \brief Returns the milliseconds since the Unix epoch at which the
+	 * message was sent, or QDiscordUtilities::invalidTimestamp.
+	 */
+	qint64 timestampMSecs() const {return d->_timestamp;}
+	/*!
+	 * \brief Returns the date this message was created, derived from its ID.
+	 *
+	 * Unlike timestamp(), this does not depend on the message's JSON having
+	 * contained a timestamp.
+	 */
+	QDateTime createdAt() const
+	{return QDiscordUtilities::timestampToDateTime(
+				QDiscordUtilities::snowflakeTimestamp(d->_id));}
 	///\brief Returns whether the message will use text to speech.
-	bool tts() const {return _tts;}
+	bool tts() const {return d->_tts;}
 	///\brief Returns whether the message successfully mentioned everyone.
-	bool mentionEveryone() const {return _mentionEveryone;}
+	bool mentionEveryone() const {return d->_mentionEveryone;}
 	///\brief Returns the ID of the channel this message was sent in.
-	QString channelId() const {return _channelId;}
+	QString channelId() const {return d->_channelId;}
 	///\brief Returns a pointer to the channel this message was sent in.
-	QSharedPointer<QDiscordChannel> channel() const {return _channel;}
+	QSharedPointer<QDiscordChannel> channel() const {return d->_channel;}
 	///\brief Returns a pointer to the user that sent this message.
-	QSharedPointer<QDiscordUser> author() const {return _author;}
+	QSharedPointer<QDiscordUser> author() const {return d->_author;}
 	/*!
 	 * \brief Returns a pointer to the guild this message was sent in using
 	 * the channel parameter provided in the class' constructor.
@@ -69,17 +114,10 @@ public:
 	QSharedPointer<QDiscordGuild> guild() const;
 	///\brief Returns a list of users mentioned in this message.
 	QList<QSharedPointer<QDiscordUser> >
-	mentions() const {return _mentions;}
+	mentions() const {return d->_mentions;}
 private:
-	QString _id;
-	QString _content;
-	QDateTime _timestamp;
-	bool _tts;
-	bool _mentionEveryone;
-	QString _channelId;
-	QSharedPointer<QDiscordChannel> _channel;
-	QSharedPointer<QDiscordUser> _author;
-	QList<QSharedPointer<QDiscordUser> > _mentions;
+	void parseMentions(const QJsonArray& mentions);
+	QSharedDataPointer<QDiscordMessageData> d;
 };
 
 Q_DECLARE_METATYPE(QDiscordMessage)
@@ -0,0 +1,295 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordmessagecache.hpp"
+
+QDiscordMessageCache::QDiscordMessageCache()
+{
+	_enabled = false;
+	_defaultCapacity = 100;
+	_maxMessages = 5000;
+}
+
+void QDiscordMessageCache::setEnabled(bool enabled)
+{
+	_enabled = enabled;
+	if(!_enabled)
+		clear();
+}
+
+void QDiscordMessageCache::setDefaultCapacity(int capacity)
+{
+	_defaultCapacity = capacity > 0 ? capacity : 0;
+}
+
+void QDiscordMessageCache::setGuildCapacity(const QString& guildId, int capacity)
+{
+	_guildCapacities.insert(guildId, capacity > 0 ? capacity : 0);
+	removeGuild(guildId);
+}
+
+void QDiscordMessageCache::resetGuildCapacity(const QString& guildId)
+{
+	_guildCapacities.remove(guildId);
+	removeGuild(guildId);
+}
+
+void QDiscordMessageCache::setMaxMessages(int maxMessages)
+{
+	_maxMessages = maxMessages > 0 ? maxMessages : 0;
+	trim();
+}
+
+QSharedPointer<QDiscordMessage>
+QDiscordMessageCache::insert(const QDiscordMessage& message)
+{
+	if(!_enabled)
+		return QSharedPointer<QDiscordMessage>();
+	quint64 id = message.id().toULongLong();
+	if(id == 0)
+		return QSharedPointer<QDiscordMessage>();
+
+	QHash<quint64, Entry>::iterator existing = _index.find(id);
+	if(existing != _index.end())
+	{
+		QString guildId = _channels.value(existing->channelId).guildId;
+		account(guildId, *existing->message, false);
+		*existing->message = message;
+		account(guildId, *existing->message, true);
+		return existing->message;
+	}
+
+	QSharedPointer<QDiscordGuild> guild = message.guild();
+	ChannelBuffer* channelBuffer =
+			buffer(message.channelId().toULongLong(),
+				   guild ? guild->id() : QString());
+	if(!channelBuffer)
+		return QSharedPointer<QDiscordMessage>();
+
+	const int capacity = channelBuffer->ring.size();
+	if(channelBuffer->used == capacity)
+		evictOldest(channelBuffer);
+
+	Entry entry;
+	entry.message = QSharedPointer<QDiscordMessage>(new QDiscordMessage(message));
+	entry.channelId = message.channelId().toULongLong();
+	entry.slot = channelBuffer->head;
+	channelBuffer->ring[channelBuffer->head] = id;
+	channelBuffer->head = (channelBuffer->head + 1) % capacity;
+	channelBuffer->used++;
+	channelBuffer->live++;
+	_index.insert(id, entry);
+	account(channelBuffer->guildId, *entry.message, true);
+
+	trim();
+	return entry.message;
+}
+
+QSharedPointer<QDiscordMessage>
+QDiscordMessageCache::update(const QJsonObject& object)
+{
+	QHash<quint64, Entry>::iterator entry =
+			_index.find(object["id"].toString("").toULongLong());
+	if(entry == _index.end())
+		return QSharedPointer<QDiscordMessage>();
+	QString guildId = _channels.value(entry->channelId).guildId;
+	account(guildId, *entry->message, false);
+	entry->message->update(object);
+	account(guildId, *entry->message, true);
+	return entry->message;
+}
+
+QSharedPointer<QDiscordMessage>
+QDiscordMessageCache::message(const QString& id) const
+{
+	QHash<quint64, Entry>::const_iterator entry = _index.find(id.toULongLong());
+	if(entry == _index.end())
+		return QSharedPointer<QDiscordMessage>();
+	return entry->message;
+}
+
+QSharedPointer<QDiscordMessage> QDiscordMessageCache::take(const QString& id)
+{
+	QHash<quint64, Entry>::iterator entry = _index.find(id.toULongLong());
+	if(entry == _index.end())
+		return QSharedPointer<QDiscordMessage>();
+
+	QSharedPointer<QDiscordMessage> message = entry->message;
+	quint64 channelId = entry->channelId;
+	QHash<quint64, ChannelBuffer>::iterator channelBuffer =
+			_channels.find(channelId);
+	if(channelBuffer != _channels.end())
+	{
+		channelBuffer->ring[entry->slot] = 0;
+		channelBuffer->live--;
+		account(channelBuffer->guildId, *message, false);
+	}
+	_index.erase(entry);
+	if(channelBuffer != _channels.end() && channelBuffer->live == 0)
+		removeBuffer(channelId);
+	return message;
+}
+
+QList<QSharedPointer<QDiscordMessage>>
+QDiscordMessageCache::channelMessages(const QString& channelId) const
+{
+	QList<QSharedPointer<QDiscordMessage>> messages;
+	QHash<quint64, ChannelBuffer>::const_iterator channelBuffer =
+			_channels.find(channelId.toULongLong());
+	if(channelBuffer == _channels.end())
+		return messages;
+	const int capacity = channelBuffer->ring.size();
+	for(int i = channelBuffer->used; i > 0; i--)
+	{
+		quint64 id = channelBuffer->ring[(channelBuffer->head - i + capacity)
+				% capacity];
+		if(id != 0)
+			messages.append(_index.value(id).message);
+	}
+	return messages;
+}
+
+void QDiscordMessageCache::removeChannel(const QString& channelId)
+{
+	removeBuffer(channelId.toULongLong());
+}
+
+void QDiscordMessageCache::removeGuild(const QString& guildId)
+{
+	QList<quint64> channelIds;
+	for(QHash<quint64, ChannelBuffer>::const_iterator i = _channels.begin();
+		i != _channels.end(); ++i)
+	{
+		if(i->guildId == guildId)
+			channelIds.append(i.key());
+	}
+	for(quint64 channelId : channelIds)
+		removeBuffer(channelId);
+}
+
+void QDiscordMessageCache::clear()
+{
+	_index.clear();
+	_channels.clear();
+	_lru.clear();
+	_memoryUsage = QDiscordMemoryUsage();
+	_guildMemoryUsage.clear();
+}
+
+QDiscordMessageCache::ChannelBuffer*
+QDiscordMessageCache::buffer(quint64 channelId, const QString& guildId)
+{
+	QHash<quint64, ChannelBuffer>::iterator channelBuffer =
+			_channels.find(channelId);
+	if(channelBuffer != _channels.end())
+	{
+		touch(&channelBuffer.value());
+		return &channelBuffer.value();
+	}
+
+	int capacity = guildCapacity(guildId);
+	if(capacity <= 0 || _maxMessages <= 0)
+		return nullptr;
+
+	ChannelBuffer newBuffer;
+	newBuffer.ring = QVector<quint64>(capacity, 0);
+	newBuffer.head = 0;
+	newBuffer.used = 0;
+	newBuffer.live = 0;
+	newBuffer.guildId = guildId;
+	newBuffer.lru = _lru.insert(_lru.end(), channelId);
+	return &_channels.insert(channelId, newBuffer).value();
+}
+
+void QDiscordMessageCache::touch(ChannelBuffer* buffer)
+{
+	_lru.splice(_lru.end(), _lru, buffer->lru);
+}
+
+bool QDiscordMessageCache::evictOldest(ChannelBuffer* buffer)
+{
+	//Frees a single slot, even if it only held a removed message, so an
+	//insert into a full buffer never evicts more than it needs.
+	if(buffer->used == 0)
+		return false;
+	const int capacity = buffer->ring.size();
+	int slot = (buffer->head - buffer->used + capacity) % capacity;
+	quint64 id = buffer->ring[slot];
+	buffer->ring[slot] = 0;
+	buffer->used--;
+	if(id == 0)
+		return false;
+	account(buffer->guildId, *_index.value(id).message, false);
+	_index.remove(id);
+	buffer->live--;
+	return true;
+}
+
+void QDiscordMessageCache::removeBuffer(quint64 channelId)
+{
+	QHash<quint64, ChannelBuffer>::iterator channelBuffer =
+			_channels.find(channelId);
+	if(channelBuffer == _channels.end())
+		return;
+	for(quint64 id : channelBuffer->ring)
+	{
+		if(id == 0)
+			continue;
+		account(channelBuffer->guildId, *_index.value(id).message, false);
+		_index.remove(id);
+	}
+	_lru.erase(channelBuffer->lru);
+	_channels.erase(channelBuffer);
+}
+
+void QDiscordMessageCache::trim()
+{
+	while(_index.size() > _maxMessages && !_lru.empty())
+	{
+		quint64 channelId = _lru.front();
+		QHash<quint64, ChannelBuffer>::iterator channelBuffer =
+				_channels.find(channelId);
+		if(channelBuffer == _channels.end())
+		{
+			_lru.pop_front();
+			continue;
+		}
+		evictOldest(&channelBuffer.value());
+		if(channelBuffer->live == 0)
+			removeBuffer(channelId);
+	}
+}
+
+void QDiscordMessageCache::account(const QString& guildId,
+								   const QDiscordMessage& message, bool added)
+{
+	QDiscordMemoryUsage usage = QDiscordMemoryUsage::of(message);
+	QDiscordMemoryUsage& guildUsage = _guildMemoryUsage[guildId];
+	if(added)
+	{
+		_memoryUsage += usage;
+		guildUsage += usage;
+	}
+	else
+	{
+		_memoryUsage -= usage;
+		guildUsage -= usage;
+		if(guildUsage.messages <= 0)
+			_guildMemoryUsage.remove(guildId);
+	}
+}
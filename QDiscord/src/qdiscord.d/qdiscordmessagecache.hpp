@@ -0,0 +1,175 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDMESSAGECACHE_HPP
+#define QDISCORDMESSAGECACHE_HPP
+
+#include <QHash>
+#include <QVector>
+#include <QSharedPointer>
+#include <list>
+#include "qdiscordmemoryusage.hpp"
+#include "qdiscordmessage.hpp"
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief A bounded cache of recently received messages.
+ *
+ * Every channel gets a fixed-capacity ring buffer and all cached messages are
+ * indexed by their snowflake, so inserting, looking up and removing a message
+ * are all constant time operations.\n
+ * When the total amount of cached messages exceeds maxMessages(), the oldest
+ * message of the least recently used channel is evicted.\n
+ * The cache is disabled by default. It is owned by QDiscordStateComponent and can
+ * be accessed through QDiscordStateComponent::messageCache().
+ */
+class QDISCORD_API QDiscordMessageCache
+{
+public:
+	///\brief Default public constructor.
+	QDiscordMessageCache();
+	///\brief Returns whether messages are being cached.
+	bool enabled() const {return _enabled;}
+	/*!
+	 * \brief Enables or disables the message cache.
+	 *
+	 * Disabling the cache will also clear it.
+	 */
+	void setEnabled(bool enabled);
+	///\brief Returns the amount of messages stored per channel by default.
+	int defaultCapacity() const {return _defaultCapacity;}
+	/*!
+	 * \brief Sets the amount of messages stored per channel by default.
+	 *
+	 * This only applies to channels which do not have a buffer yet.
+	 */
+	void setDefaultCapacity(int capacity);
+	/*!
+	 * \brief Returns the amount of messages stored per channel in the guild
+	 * with the provided ID.
+	 */
+	int guildCapacity(const QString& guildId) const {
+		return _guildCapacities.value(guildId, _defaultCapacity);
+	}
+	/*!
+	 * \brief Sets the amount of messages stored per channel in the guild with
+	 * the provided ID.
+	 *
+	 * Set to 0 in order to stop caching messages from that guild. Channels
+	 * of the guild which are already buffered will be dropped.
+	 */
+	void setGuildCapacity(const QString& guildId, int capacity);
+	///\brief Resets the guild with the provided ID to use defaultCapacity().
+	void resetGuildCapacity(const QString& guildId);
+	///\brief Returns the maximum amount of messages stored across all channels.
+	int maxMessages() const {return _maxMessages;}
+	/*!
+	 * \brief Sets the maximum amount of messages stored across all channels.
+	 *
+	 * If the cache already holds more messages, the least recently used channels
+	 * will be trimmed immediately.
+	 */
+	void setMaxMessages(int maxMessages);
+	///\brief Returns the amount of messages currently in the cache.
+	int count() const {return _index.size();}
+	///\brief Returns the amount of channels currently buffered.
+	int channelCount() const {return _channels.size();}
+	/*!
+	 * \brief Adds the provided message to the cache.
+	 *
+	 * If a message with the same ID is already cached, it will be replaced.
+	 * Does nothing if the cache is disabled.
+	 * \returns A pointer to the cached message or `nullptr` if the message was
+	 * not cached.
+	 */
+	QSharedPointer<QDiscordMessage> insert(const QDiscordMessage& message);
+	/*!
+	 * \brief Updates the cached message with the ID contained in the provided
+	 * JSON object.
+	 * \returns A pointer to the updated message or `nullptr` if the message is
+	 * not cached.
+	 */
+	QSharedPointer<QDiscordMessage> update(const QJsonObject& object);
+	/*!
+	 * \brief Returns a pointer to the cached message with the provided ID.
+	 * \returns `nullptr` if the message is not cached.
+	 */
+	QSharedPointer<QDiscordMessage> message(const QString& id) const;
+	/*!
+	 * \brief Removes the message with the provided ID from the cache.
+	 * \returns A pointer to the removed message or `nullptr` if the message
+	 * was not cached.
+	 */
+	QSharedPointer<QDiscordMessage> take(const QString& id);
+	///\brief Returns all cached messages of the provided channel, oldest first.
+	QList<QSharedPointer<QDiscordMessage>>
+	channelMessages(const QString& channelId) const;
+	///\brief Removes all cached messages of the provided channel.
+	void removeChannel(const QString& channelId);
+	///\brief Removes all cached messages of the provided guild.
+	void removeGuild(const QString& guildId);
+	///\brief Removes all messages from the cache.
+	void clear();
+	///\brief Returns the approximate memory used by all cached messages.
+	QDiscordMemoryUsage memoryUsage() const {return _memoryUsage;}
+	/*!
+	 * \brief Returns the approximate memory used by the cached messages of the
+	 * guild with the provided ID.
+	 *
+	 * Messages from private channels are accounted under an empty ID.
+	 */
+	QDiscordMemoryUsage memoryUsage(const QString& guildId) const {
+		return _guildMemoryUsage.value(guildId);
+	}
+private:
+	struct Entry
+	{
+		QSharedPointer<QDiscordMessage> message;
+		quint64 channelId;
+		int slot;
+	};
+	struct ChannelBuffer
+	{
+		//Snowflakes of the buffered messages, 0 marks a removed message.
+		QVector<quint64> ring;
+		int head;
+		int used;
+		int live;
+		QString guildId;
+		std::list<quint64>::iterator lru;
+	};
+	ChannelBuffer* buffer(quint64 channelId, const QString& guildId);
+	void touch(ChannelBuffer* buffer);
+	bool evictOldest(ChannelBuffer* buffer);
+	void removeBuffer(quint64 channelId);
+	void trim();
+	void account(const QString& guildId, const QDiscordMessage& message,
+				 bool added);
+	bool _enabled;
+	int _defaultCapacity;
+	int _maxMessages;
+	QHash<QString, int> _guildCapacities;
+	QHash<quint64, Entry> _index;
+	QHash<quint64, ChannelBuffer> _channels;
+	//Least recently used channels are at the front.
+	std::list<quint64> _lru;
+	QDiscordMemoryUsage _memoryUsage;
+	QHash<QString, QDiscordMemoryUsage> _guildMemoryUsage;
+};
+
+#endif // QDISCORDMESSAGECACHE_HPP
@@ -0,0 +1,212 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordmessagehistory.hpp"
+#include "qdiscordrestcomponent.hpp"
+
+namespace
+{
+	//Snowflakes grow over time, so they order messages by age.
+	bool isOlder(const QString& id, const QString& other)
+	{
+		return id.toULongLong() < other.toULongLong();
+	}
+}
+
+QDiscordMessageHistory::QDiscordMessageHistory(QDiscordRestComponent* rest,
+											   const QString& channelId,
+											   Direction direction,
+											   const QString& messageId)
+{
+	_rest = rest;
+	_channelId = channelId;
+	_direction = direction;
+	_cursor = messageId;
+	_pageSize = 100;
+	_messagesRead = 0;
+	_atEnd = false;
+	//The oldest message's history starts at the channel's creation.
+	if(_direction == Direction::After && _cursor.isEmpty())
+		_cursor = "0";
+}
+
+QDiscordMessageHistory::~QDiscordMessageHistory()
+{
+	_tail.cancel();
+	_buffered.cancel();
+}
+
+QDiscordFuture<QDiscordMessageHistory::Page> QDiscordMessageHistory::next()
+{
+	if(_buffered.isValid())
+	{
+		QDiscordFuture<Page> page = _buffered;
+		_buffered = QDiscordFuture<Page>();
+		//The buffered page has already arrived, so the one after it can be
+		//requested now.
+		if(page.isFinished() && !_atEnd)
+			_buffered = fetch();
+		return page;
+	}
+	//The following page is only known once the one requested last arrives.
+	if(_tail.isValid() && !_tail.isFinished())
+	{
+		return _tail.then([this](const Page&){
+			return next();
+		});
+	}
+	if(_atEnd)
+		return QDiscordFuture<Page>::resolved(Page());
+	return fetch();
+}
+
+QDiscordFuture<QDiscordMessageHistory::Page> QDiscordMessageHistory::fetch()
+{
+	_tail = _rest->getMessagesFuture(_channelId, _direction, _cursor,
+									 _pageSize)
+	.then([this](const Page& page){
+		received(page);
+	});
+	return _tail;
+}
+
+void QDiscordMessageHistory::received(const Page& page)
+{
+	_messagesRead += page.length();
+	if(page.length() < _pageSize || _direction == Direction::Around)
+		_atEnd = true;
+	for(const QDiscordMessage& message : page)
+	{
+		bool advance = _direction == Direction::After?
+					isOlder(_cursor, message.id()):
+					_cursor.isEmpty() || isOlder(message.id(), _cursor);
+		if(advance)
+			_cursor = message.id();
+	}
+	//Prefetch only once the page has been handed out, so at most one page is
+	//waiting to be read.
+	if(!_atEnd && !_buffered.isValid())
+		_buffered = fetch();
+}
+
+QDiscordHistoryWalker::QDiscordHistoryWalker(QDiscordRestComponent* rest,
+											 QObject* parent)
+	: QObject(parent)
+{
+	_rest = rest;
+	_concurrency = 4;
+	_starting = false;
+}
+
+QDiscordHistoryWalker::~QDiscordHistoryWalker()
+{
+	//Histories cancel their pages when destroyed.
+	_active.clear();
+}
+
+void QDiscordHistoryWalker::setConcurrency(int concurrency)
+{
+	_concurrency = qMax(concurrency, 1);
+	startWalks();
+}
+
+void QDiscordHistoryWalker::addChannel(
+		const QString& channelId,
+		QDiscordMessageHistory::Direction direction,
+		const QString& messageId)
+{
+	Walk walk;
+	walk.channelId = channelId;
+	walk.direction = direction;
+	walk.messageId = messageId;
+	_queue.append(walk);
+	startWalks();
+}
+
+void QDiscordHistoryWalker::addChannels(const QStringList& channelIds)
+{
+	for(const QString& channelId : channelIds)
+	{
+		Walk walk;
+		walk.channelId = channelId;
+		walk.direction = QDiscordMessageHistory::Direction::Before;
+		_queue.append(walk);
+	}
+	startWalks();
+}
+
+void QDiscordHistoryWalker::stop()
+{
+	_queue.clear();
+	_active.clear();
+}
+
+void QDiscordHistoryWalker::startWalks()
+{
+	//Walks failing right away finish from within read(), which would start
+	//the next walk recursively.
+	if(_starting)
+		return;
+	_starting = true;
+	while(!_queue.isEmpty() && _active.length() < _concurrency)
+	{
+		Walk walk = _queue.takeFirst();
+		QSharedPointer<QDiscordMessageHistory> history(
+					new QDiscordMessageHistory(_rest, walk.channelId,
+											   walk.direction,
+											   walk.messageId));
+		_active.append(history);
+		read(history.data());
+	}
+	_starting = false;
+}
+
+void QDiscordHistoryWalker::read(QDiscordMessageHistory* history)
+{
+	history->next()
+	.then([this, history](const QDiscordMessageHistory::Page& page){
+		bool more = !page.isEmpty();
+		if(more && _consumer)
+			more = _consumer(history->channelId(), page);
+		if(more)
+			read(history);
+		else
+			finishWalk(history, QNetworkReply::NoError);
+	})
+	.fail([this, history](QNetworkReply::NetworkError error){
+		finishWalk(history, error);
+	});
+}
+
+void QDiscordHistoryWalker::finishWalk(QDiscordMessageHistory* history,
+									   QNetworkReply::NetworkError error)
+{
+	QString channelId = history->channelId();
+	for(int i = 0; i < _active.length(); i++)
+	{
+		if(_active[i].data() == history)
+		{
+			_active.removeAt(i);
+			break;
+		}
+	}
+	emit channelFinished(channelId, error);
+	startWalks();
+	if(_active.isEmpty() && _queue.isEmpty())
+		emit finished();
+}
@@ -0,0 +1,188 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDMESSAGEHISTORY_HPP
+#define QDISCORDMESSAGEHISTORY_HPP
+
+#include <QList>
+#include <QObject>
+#include <QSharedPointer>
+#include <QStringList>
+#include <functional>
+#include "qdiscordfuture.hpp"
+#include "qdiscordmessage.hpp"
+
+class QDiscordRestComponent;
+
+/*!
+ * \brief Reads a channel's message history one page at a time.
+ *
+ * Each call to next() returns a future for the following page of up to
+ * pageSize() messages, which are decoded together once the page arrives. As
+ * soon as a page has been handed out and has arrived, the page after it is
+ * requested, so it is usually ready by the time the current page has been
+ * processed. Requests go through the REST component's rate limiter, and
+ * responses are never cached.\n
+ * Pages keep the order Discord returns them in, newest message first. The
+ * walk ends with the first page shorter than pageSize(), after which next()
+ * returns empty pages. A failed page can be requested again with next().\n
+ * Destroying the history cancels any pages it has not delivered yet.
+ */
+class QDISCORD_API QDiscordMessageHistory
+{
+public:
+	///\brief A page of messages.
+	typedef QList<QDiscordMessage> Page;
+	///\brief An enumerator holding the directions a history can be read in.
+	enum class Direction
+	{
+		///\brief Reads from the message towards the oldest message.
+		Before,
+		///\brief Reads from the message towards the newest message.
+		After,
+		///\brief Reads a single page around the message.
+		Around
+	};
+	/*!
+	 * \brief Creates a history for the provided channel.
+	 * \param messageId The message to start from, which is not included. If
+	 * empty, a history read `Before` starts with the newest message and one
+	 * read `After` starts with the oldest message.
+	 */
+	QDiscordMessageHistory(QDiscordRestComponent* rest,
+						   const QString& channelId,
+						   Direction direction = Direction::Before,
+						   const QString& messageId = QString());
+	~QDiscordMessageHistory();
+	///\brief Returns the ID of the channel being read.
+	const QString& channelId() const {return _channelId;}
+	///\brief Returns the direction the history is read in.
+	Direction direction() const {return _direction;}
+	///\brief Returns the maximum amount of messages in a page.
+	int pageSize() const {return _pageSize;}
+	///\brief Sets the maximum amount of messages in a page, up to 100.
+	void setPageSize(int pageSize) {_pageSize = qBound(1, pageSize, 100);}
+	///\brief Returns whether the last page has been received.
+	bool atEnd() const {return _atEnd;}
+	///\brief Returns the amount of messages received so far.
+	int messagesRead() const {return _messagesRead;}
+	///\brief Returns a future for the next page.
+	QDiscordFuture<Page> next();
+private:
+	Q_DISABLE_COPY(QDiscordMessageHistory)
+	QDiscordFuture<Page> fetch();
+	void received(const Page& page);
+	QDiscordRestComponent* _rest;
+	QString _channelId;
+	Direction _direction;
+	//The message following pages are read from.
+	QString _cursor;
+	int _pageSize;
+	int _messagesRead;
+	bool _atEnd;
+	//The page requested last.
+	QDiscordFuture<Page> _tail;
+	//A page requested ahead which has not been handed out yet.
+	QDiscordFuture<Page> _buffered;
+};
+
+/*!
+ * \brief Reads the message histories of many channels, a few at a time.
+ *
+ * Channels are read in the order they were added, with up to concurrency()
+ * of them being read at once. Since every channel has its own rate limit
+ * bucket, reading several channels at once is faster than reading them one
+ * after another.\n
+ * Each page is passed to the consumer, which returns whether to keep reading
+ * that channel.
+ */
+class QDISCORD_API QDiscordHistoryWalker : public QObject
+{
+	Q_OBJECT
+public:
+	/*!
+	 * \brief A function receiving a page of a channel's messages and returning
+	 * whether to read the channel's next page.
+	 */
+	typedef std::function<bool(const QString& channelId,
+							   const QDiscordMessageHistory::Page& page)>
+	Consumer;
+	///\brief Creates a walker reading histories through the REST component.
+	explicit QDiscordHistoryWalker(QDiscordRestComponent* rest,
+								   QObject* parent = 0);
+	~QDiscordHistoryWalker();
+	///\brief Returns how many channels are read at once.
+	int concurrency() const {return _concurrency;}
+	/*!
+	 * \brief Sets how many channels are read at once.
+	 *
+	 * Defaults to 4.
+	 */
+	void setConcurrency(int concurrency);
+	///\brief Sets the function receiving the pages.
+	void setConsumer(const Consumer& consumer) {_consumer = consumer;}
+	/*!
+	 * \brief Queues a channel to be read.
+	 *
+	 * Reading starts right away if fewer than concurrency() channels are being
+	 * read.
+	 * \see QDiscordMessageHistory::QDiscordMessageHistory
+	 */
+	void addChannel(const QString& channelId,
+					QDiscordMessageHistory::Direction direction =
+					QDiscordMessageHistory::Direction::Before,
+					const QString& messageId = QString());
+	///\brief Queues several channels to be read from their newest message.
+	void addChannels(const QStringList& channelIds);
+	///\brief Returns the amount of channels being read.
+	int active() const {return _active.length();}
+	///\brief Returns the amount of channels waiting to be read.
+	int queued() const {return _queue.length();}
+	///\brief Stops reading all channels and drops the queued ones.
+	void stop();
+signals:
+	/*!
+	 * \brief Emitted when a channel has been read completely, the consumer
+	 * stopped reading it or reading it failed.
+	 * \param channelId The ID of the channel.
+	 * \param error The error which stopped the walk, if any.
+	 */
+	void channelFinished(const QString& channelId,
+						 QNetworkReply::NetworkError error);
+	///\brief Emitted when no channels are being read or queued anymore.
+	void finished();
+private:
+	struct Walk
+	{
+		QString channelId;
+		QDiscordMessageHistory::Direction direction;
+		QString messageId;
+	};
+	void startWalks();
+	void read(QDiscordMessageHistory* history);
+	void finishWalk(QDiscordMessageHistory* history,
+					QNetworkReply::NetworkError error);
+	QDiscordRestComponent* _rest;
+	Consumer _consumer;
+	QList<Walk> _queue;
+	QList<QSharedPointer<QDiscordMessageHistory>> _active;
+	int _concurrency;
+	bool _starting;
+};
+
+#endif // QDISCORDMESSAGEHISTORY_HPP
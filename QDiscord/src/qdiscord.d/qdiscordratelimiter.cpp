@@ -0,0 +1,485 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QStringList>
+#include <QTimer>
+#include "qdiscordratelimiter.hpp"
+#include "qdiscordtrace.hpp"
+
+namespace
+{
+	bool isId(const QString& segment)
+	{
+		if(segment.isEmpty())
+			return false;
+		for(const QChar& c : segment)
+		{
+			if(c < QLatin1Char('0') || c > QLatin1Char('9'))
+				return false;
+		}
+		return true;
+	}
+
+	bool isMajorResource(const QString& segment)
+	{
+		return segment == QLatin1String("channels") ||
+				segment == QLatin1String("guilds") ||
+				segment == QLatin1String("webhooks");
+	}
+}
+
+QDiscordRateLimiter::Route
+QDiscordRateLimiter::Route::fromRequest(const QByteArray& method,
+										const QUrl& url)
+{
+	//The API base may be changed at runtime, so its path is only cached
+	//until it does.
+	thread_local QString apiBase;
+	thread_local QString apiPath;
+	if(apiBase != QDiscordUtilities::endPoints.apiBase)
+	{
+		apiBase = QDiscordUtilities::endPoints.apiBase;
+		apiPath = QUrl(apiBase).path();
+	}
+	QString path = url.path();
+	if(path.startsWith(apiPath))
+		path.remove(0, apiPath.length());
+	Route route;
+	route.name = QString::fromLatin1(method) + QLatin1Char(' ');
+	QString previous;
+	for(const QString& segment : path.split('/', Qt::SkipEmptyParts))
+	{
+		route.name += QLatin1Char('/');
+		if(isId(segment))
+		{
+			if(route.majorParameter.isEmpty() && isMajorResource(previous))
+			{
+				route.majorParameter = segment;
+				route.name += QLatin1String(":major");
+			}
+			else
+				route.name += QLatin1String(":id");
+		}
+		//Reactions share their limits regardless of the emoji.
+		else if(previous == QLatin1String("reactions"))
+			route.name += QLatin1String(":emoji");
+		else
+			route.name += segment;
+		previous = segment;
+	}
+	return route;
+}
+
+QDiscordRateLimiter::Request::Request()
+{
+	priority = Priority::Normal;
+	queuedAt = 0;
+	retries = 0;
+}
+
+QDiscordRateLimiter::Bucket::Bucket()
+{
+	limit = 1;
+	remaining = 1;
+	resetAt = 0;
+	inFlight = 0;
+	known = false;
+	timerPending = false;
+	for(int i = 0; i < priorityCount; i++)
+		credits[i] = 0;
+}
+
+int QDiscordRateLimiter::Bucket::length() const
+{
+	int length = 0;
+	for(int i = 0; i < priorityCount; i++)
+		length += queues[i].length();
+	return length;
+}
+
+QDiscordRateLimiter::Class::Class()
+{
+	weight = 4;
+	maxInFlight = 0;
+	inFlight = 0;
+	queued = 0;
+	waitTime = WaitTime{0, 0, 0};
+}
+
+QDiscordRateLimiter::QDiscordRateLimiter(QObject* parent) : QObject(parent)
+{
+	_clock.start();
+	_globalResetAt = 0;
+	_globalTimerPending = false;
+	_queued = 0;
+	_maxRetries = 5;
+	_classes[int(Priority::Interactive)].weight = 8;
+	_classes[int(Priority::Bulk)].weight = 1;
+	_classes[int(Priority::Bulk)].maxInFlight = 2;
+}
+
+void QDiscordRateLimiter::enqueue(const Route& route,
+								  std::function<QNetworkReply*()> send,
+								  std::function<void(QNetworkReply*)> finished)
+{
+	enqueue(route, Priority::Normal, send, finished);
+}
+
+void QDiscordRateLimiter::enqueue(const Route& route, Priority priority,
+								  std::function<QNetworkReply*()> send,
+								  std::function<void(QNetworkReply*)> finished)
+{
+	QString key = bucketKey(route);
+	Request request;
+	request.route = route;
+	request.send = send;
+	request.finished = finished;
+	request.priority = priority;
+	push(request, _buckets[key], false);
+	drain(key);
+}
+
+void QDiscordRateLimiter::setWeight(Priority priority, int weight)
+{
+	_classes[int(priority)].weight = qMax(weight, 1);
+}
+
+void QDiscordRateLimiter::setMaxInFlight(Priority priority, int maxInFlight)
+{
+	_classes[int(priority)].maxInFlight = qMax(maxInFlight, 0);
+	//A raised cap may let queued requests through.
+	drainAll();
+}
+
+void QDiscordRateLimiter::resetWaitTimes()
+{
+	for(int i = 0; i < priorityCount; i++)
+		_classes[i].waitTime = WaitTime{0, 0, 0};
+}
+
+int QDiscordRateLimiter::queued(const Route& route) const
+{
+	QString hash = _routeBuckets.value(route.name);
+	QString key = (hash.isEmpty()?route.name:hash) + '|' + route.majorParameter;
+	QHash<QString, Bucket>::const_iterator bucket = _buckets.find(key);
+	return bucket == _buckets.end()?0:bucket->length();
+}
+
+void QDiscordRateLimiter::clear()
+{
+	_routeBuckets.clear();
+	_buckets.clear();
+	_queued = 0;
+	for(int i = 0; i < priorityCount; i++)
+		_classes[i].queued = 0;
+	QDISCORD_TRACE_COUNTER(Rest, Debug, "rest requests queued", 0);
+}
+
+QString QDiscordRateLimiter::bucketKey(const Route& route)
+{
+	QString provisional = route.name + '|' + route.majorParameter;
+	QString hash = _routeBuckets.value(route.name);
+	if(hash.isEmpty())
+		return provisional;
+	QString key = hash + '|' + route.majorParameter;
+	//Requests sent before the route's bucket hash was known move into the
+	//shared bucket the first time it is looked up.
+	QHash<QString, Bucket>::iterator old = _buckets.find(provisional);
+	if(old != _buckets.end())
+	{
+		Bucket moved = old.value();
+		_buckets.erase(old);
+		Bucket& bucket = _buckets[key];
+		bucket.inFlight += moved.inFlight;
+		for(int i = 0; i < priorityCount; i++)
+			bucket.queues[i].append(moved.queues[i]);
+		if(!bucket.known && moved.known)
+		{
+			bucket.limit = moved.limit;
+			bucket.remaining = moved.remaining;
+			bucket.resetAt = moved.resetAt;
+			bucket.known = true;
+		}
+	}
+	return key;
+}
+
+bool QDiscordRateLimiter::hasCapacity(Bucket& bucket, qint64 now) const
+{
+	if(!bucket.known)
+		return bucket.inFlight == 0;
+	if(bucket.limit < 0)
+		return true;
+	if(bucket.remaining <= 0 && now >= bucket.resetAt)
+		bucket.remaining = bucket.limit;
+	return bucket.remaining > 0;
+}
+
+int QDiscordRateLimiter::schedule(Bucket& bucket)
+{
+	//Smooth weighted round robin: every waiting priority gains its weight,
+	//the richest one is picked and pays the weights of all that competed.
+	int total = 0;
+	int chosen = -1;
+	for(int i = 0; i < priorityCount; i++)
+	{
+		const Class& priority = _classes[i];
+		if(bucket.queues[i].isEmpty())
+		{
+			bucket.credits[i] = 0;
+			continue;
+		}
+		if(priority.maxInFlight > 0 && priority.inFlight >= priority.maxInFlight)
+			continue;
+		bucket.credits[i] += priority.weight;
+		total += priority.weight;
+		if(chosen < 0 || bucket.credits[i] > bucket.credits[chosen])
+			chosen = i;
+	}
+	if(chosen >= 0)
+		bucket.credits[chosen] -= total;
+	return chosen;
+}
+
+void QDiscordRateLimiter::push(Request request, Bucket& bucket, bool front)
+{
+	request.queuedAt = _clock.elapsed();
+	QQueue<Request>& queue = bucket.queues[int(request.priority)];
+	if(front)
+		queue.prepend(request);
+	else
+		queue.enqueue(request);
+	_queued++;
+	_classes[int(request.priority)].queued++;
+}
+
+void QDiscordRateLimiter::drain(const QString& key)
+{
+	QHash<QString, Bucket>::iterator i = _buckets.find(key);
+	if(i == _buckets.end())
+		return;
+	Bucket& bucket = i.value();
+	const qint64 now = _clock.elapsed();
+	if(now < _globalResetAt)
+	{
+		if(!_globalTimerPending)
+		{
+			_globalTimerPending = true;
+			QTimer::singleShot(_globalResetAt - now, this, [this](){
+				_globalTimerPending = false;
+				drainAll();
+			});
+		}
+		return;
+	}
+	while(hasCapacity(bucket, now))
+	{
+		const int index = schedule(bucket);
+		if(index < 0)
+			break;
+		Request request = bucket.queues[index].dequeue();
+		Class& priority = _classes[index];
+		_queued--;
+		priority.queued--;
+		bucket.inFlight++;
+		if(bucket.known && bucket.limit >= 0)
+			bucket.remaining--;
+		QNetworkReply* reply = request.send();
+		if(!reply)
+		{
+			//The request was dropped while it was queued.
+			bucket.inFlight--;
+			if(bucket.known && bucket.limit >= 0)
+				bucket.remaining++;
+			continue;
+		}
+		priority.inFlight++;
+		const qint64 waited = now - request.queuedAt;
+		priority.waitTime.count++;
+		priority.waitTime.total += waited;
+		priority.waitTime.longest = qMax(priority.waitTime.longest, waited);
+		QDISCORD_TRACE(Rest, Verbose, "rest request sent", quintptr(reply));
+		QDISCORD_TRACE(Rest, Verbose, "rest request waited", waited);
+		connect(reply, &QNetworkReply::finished, this,
+				[this, request, reply](){
+			replyFinished(request, reply);
+		});
+	}
+	QDISCORD_TRACE_COUNTER(Rest, Debug, "rest requests queued", _queued);
+	if(bucket.length() == 0)
+	{
+		//Idle buckets are dropped once their limit has reset, the next request
+		//relearns it. Unlimited buckets are kept, as forgetting them would
+		//serialize the next requests until the first reply.
+		if(bucket.inFlight > 0 || bucket.timerPending || bucket.limit < 0)
+			return;
+		if(now >= bucket.resetAt)
+		{
+			_buckets.remove(key);
+			return;
+		}
+	}
+	//A bucket with requests in flight is drained again by their replies, and
+	//one with capacity left is only waiting for capped priorities, which drain
+	//all buckets when their requests finish. Otherwise it has to wait for its
+	//reset.
+	else if(bucket.timerPending || !bucket.known || bucket.inFlight > 0 ||
+			hasCapacity(bucket, now))
+		return;
+	else if(QDiscordUtilities::debugMode)
+	{
+		qDebug()<<this<<"bucket"<<key<<"exhausted,"<<bucket.length()
+			   <<"requests queued";
+	}
+	bucket.timerPending = true;
+	QTimer::singleShot(qMax<qint64>(bucket.resetAt - now, 0), this,
+					   [this, key](){
+		QHash<QString, Bucket>::iterator i = _buckets.find(key);
+		if(i == _buckets.end())
+			return;
+		i->timerPending = false;
+		drain(key);
+	});
+}
+
+void QDiscordRateLimiter::drainAll()
+{
+	QStringList keys;
+	for(QHash<QString, Bucket>::const_iterator i = _buckets.begin();
+		i != _buckets.end(); ++i)
+	{
+		if(i->length() > 0)
+			keys.append(i.key());
+	}
+	for(const QString& key : keys)
+		drain(key);
+}
+
+void QDiscordRateLimiter::replyFinished(const Request& request,
+										QNetworkReply* reply)
+{
+	const Route& route = request.route;
+	QString hash = QString::fromLatin1(reply->rawHeader("X-RateLimit-Bucket"));
+	if(!hash.isEmpty() && _routeBuckets.value(route.name) != hash)
+		_routeBuckets.insert(route.name, hash);
+	QString key = bucketKey(route);
+	Bucket& bucket = _buckets[key];
+	//The bucket may have been dropped by clear() while the reply was in flight.
+	if(bucket.inFlight > 0)
+		bucket.inFlight--;
+	Class& priority = _classes[int(request.priority)];
+	const bool capped = priority.maxInFlight > 0 &&
+			priority.inFlight >= priority.maxInFlight;
+	if(priority.inFlight > 0)
+		priority.inFlight--;
+	const qint64 now = _clock.elapsed();
+	learn(bucket, reply, now);
+	const bool retried = retry(request, bucket, reply, now);
+	//Requests of a capped priority may be waiting in any bucket.
+	if(capped)
+		drainAll();
+	//Also drops the bucket if it has become idle.
+	drain(key);
+	if(retried)
+	{
+		reply->deleteLater();
+		return;
+	}
+	if(request.finished)
+		request.finished(reply);
+}
+
+bool QDiscordRateLimiter::retry(const Request& request, Bucket& bucket,
+								QNetworkReply* reply, qint64 now)
+{
+	if(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 429)
+		return false;
+	bool ok;
+	double seconds = reply->rawHeader("Retry-After").toDouble(&ok);
+	if(!ok)
+		seconds = reply->rawHeader("X-RateLimit-Reset-After").toDouble(&ok);
+	const qint64 retryAfter = ok?qMax<qint64>(qint64(seconds*1000), 0):1000;
+	const bool global = reply->rawHeader("X-RateLimit-Global") == "true" ||
+			reply->rawHeader("X-RateLimit-Scope") == "global";
+	if(global)
+		_globalResetAt = qMax(_globalResetAt, now + retryAfter);
+	else
+	{
+		if(!bucket.known || bucket.limit < 0)
+		{
+			bucket.known = true;
+			bucket.limit = 1;
+		}
+		bucket.remaining = 0;
+		bucket.resetAt = qMax(bucket.resetAt, now + retryAfter);
+	}
+	const bool retrying = request.retries < _maxRetries;
+	if(retrying)
+	{
+		Request retried = request;
+		retried.retries++;
+		push(retried, bucket, true);
+	}
+	QDISCORD_TRACE(Rest, Info, "rest rate limited", retryAfter);
+	if(QDiscordUtilities::debugMode)
+	{
+		qDebug()<<this<<(global?"globally":"")<<"rate limited on"<<request.route.name
+			   <<"for"<<retryAfter<<"ms";
+	}
+	emit rateLimited(request.route.name, request.route.majorParameter,
+					 retryAfter, global);
+	return retrying;
+}
+
+void QDiscordRateLimiter::learn(Bucket& bucket, QNetworkReply* reply,
+								qint64 now)
+{
+	bool ok;
+	int limit = reply->rawHeader("X-RateLimit-Limit").toInt(&ok);
+	if(!ok)
+	{
+		//Routes answering successfully without limits are not limited.
+		int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute)
+				.toInt();
+		if(!bucket.known && status >= 200 && status < 300)
+		{
+			bucket.known = true;
+			bucket.limit = -1;
+		}
+		return;
+	}
+	int remaining = reply->rawHeader("X-RateLimit-Remaining").toInt();
+	qint64 resetAfter = 0;
+	double seconds = reply->rawHeader("X-RateLimit-Reset-After").toDouble(&ok);
+	if(ok)
+		resetAfter = qint64(seconds*1000);
+	else
+	{
+		seconds = reply->rawHeader("X-RateLimit-Reset").toDouble(&ok);
+		if(ok)
+			resetAfter = qint64(seconds*1000) - QDateTime::currentMSecsSinceEpoch();
+	}
+	bucket.known = true;
+	bucket.limit = limit;
+	//Requests still in flight were sent after this one and count against the
+	//remaining requests reported by it.
+	bucket.remaining = qMax(remaining - bucket.inFlight, 0);
+	bucket.resetAt = now + qMax<qint64>(resetAfter, 0);
+	QDISCORD_TRACE(Rest, Debug, "rest bucket remaining", remaining);
+}
@@ -0,0 +1,259 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDRATELIMITER_HPP
+#define QDISCORDRATELIMITER_HPP
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QNetworkReply>
+#include <QObject>
+#include <QQueue>
+#include <QUrl>
+#include <functional>
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief Queues REST requests so they stay within Discord's rate limits.
+ *
+ * Every request belongs to a route, which is its method and path with all IDs
+ * except the major parameter (a channel, guild or webhook ID) replaced.
+ * Requests of a route are sent through a bucket per major parameter, so
+ * saturating one channel never delays requests to another.\n
+ * Buckets learn their limits from the `X-RateLimit-Limit`,
+ * `X-RateLimit-Remaining`, `X-RateLimit-Reset-After` and `X-RateLimit-Reset`
+ * response headers. Routes reporting the same `X-RateLimit-Bucket` share their
+ * buckets. Until a bucket's limits are known, only one of its requests is in
+ * flight at a time. Requests which do not fit into their bucket are queued
+ * locally and sent in order once the bucket resets.\n
+ * Every request has a Priority. Within a bucket, the priorities take turns in
+ * proportion to their weights, so bulk work queued on a bucket can not delay
+ * interactive requests by more than a few turns. Each priority can also be
+ * capped to an amount of requests in flight across all buckets. The time
+ * requests spend waiting is recorded per priority.\n
+ * Requests rejected with `429 Too Many Requests` are retried transparently at
+ * the front of their bucket's queue for their priority once the advertised `Retry-After` has passed. If
+ * the limit was global, as reported by `X-RateLimit-Global`, all requests are
+ * paused until then. Every rejection is reported through rateLimited().\n
+ * The rate limiter is owned by QDiscordRestComponent and can be accessed
+ * through QDiscordRestComponent::rateLimiter().
+ */
+class QDISCORD_API QDiscordRateLimiter : public QObject
+{
+	Q_OBJECT
+public:
+	///\brief Identifies the bucket a request is sent through.
+	struct Route
+	{
+		/*!
+		 * \brief The method and path of the request, with the major parameter
+		 * replaced by `:major` and all other IDs by `:id`.
+		 */
+		QString name;
+		///\brief The ID of the channel, guild or webhook the request targets.
+		QString majorParameter;
+		///\brief Returns the route of a request.
+		static Route fromRequest(const QByteArray& method, const QUrl& url);
+	};
+	///\brief The scheduling classes of requests.
+	enum class Priority
+	{
+		///\brief Requests a user is waiting for, such as command replies.
+		Interactive,
+		///\brief Requests without a more specific class. The default.
+		Normal,
+		///\brief Maintenance work, such as bulk deletes and history reads.
+		Bulk
+	};
+	///\brief The amount of priorities.
+	static const int priorityCount = 3;
+	///\brief Statistics about the time requests of a priority spent queued.
+	struct WaitTime
+	{
+		///\brief The amount of requests sent.
+		quint64 count;
+		///\brief The total time in milliseconds the sent requests waited.
+		qint64 total;
+		///\brief The longest time in milliseconds a sent request waited.
+		qint64 longest;
+		///\brief Returns the average wait in milliseconds, or 0 if none was sent.
+		qint64 average() const {return count == 0?0:total/qint64(count);}
+	};
+	///\brief Standard QObject constructor.
+	explicit QDiscordRateLimiter(QObject* parent = 0);
+	/*!
+	 * \brief Sends a request with Priority::Normal once its bucket has
+	 * capacity.
+	 * \see enqueue(const Route&, Priority, std::function<QNetworkReply*()>,
+	 * std::function<void(QNetworkReply*)>)
+	 */
+	void enqueue(const Route& route, std::function<QNetworkReply*()> send,
+				 std::function<void(QNetworkReply*)> finished);
+	/*!
+	 * \brief Sends a request once its bucket has capacity and its priority is
+	 * scheduled.
+	 * \param route The route of the request.
+	 * \param priority The scheduling class of the request.
+	 * \param send A function sending the request and returning its reply. It
+	 * may return `nullptr` to drop the request, for example because it was
+	 * canceled while it was queued.
+	 * \param finished A function called with the reply once it has finished.
+	 * It is not called for dropped requests.
+	 */
+	void enqueue(const Route& route, Priority priority,
+				 std::function<QNetworkReply*()> send,
+				 std::function<void(QNetworkReply*)> finished);
+	/*!
+	 * \brief Sets how many turns a priority gets for every turn of a priority
+	 * with weight 1 when both have requests queued on a bucket.
+	 *
+	 * Defaults to 8 for Priority::Interactive, 4 for Priority::Normal and 1
+	 * for Priority::Bulk. Weights below 1 are treated as 1.
+	 */
+	void setWeight(Priority priority, int weight);
+	///\brief Returns the weight of a priority.
+	int weight(Priority priority) const {return _classes[int(priority)].weight;}
+	/*!
+	 * \brief Caps the amount of requests of a priority in flight across all
+	 * buckets.
+	 *
+	 * A cap of 0 means no cap. Defaults to 2 for Priority::Bulk and no cap
+	 * otherwise.
+	 */
+	void setMaxInFlight(Priority priority, int maxInFlight);
+	///\brief Returns the cap on requests of a priority in flight.
+	int maxInFlight(Priority priority) const {
+		return _classes[int(priority)].maxInFlight;
+	}
+	///\brief Returns the amount of requests of a priority in flight.
+	int inFlight(Priority priority) const {
+		return _classes[int(priority)].inFlight;
+	}
+	/*!
+	 * \brief Returns how long the sent requests of a priority waited in their
+	 * queue.
+	 *
+	 * Retried requests count once more for every retry, with the time they
+	 * waited for it.
+	 */
+	const WaitTime& waitTime(Priority priority) const {
+		return _classes[int(priority)].waitTime;
+	}
+	///\brief Resets the wait time statistics of all priorities.
+	void resetWaitTimes();
+	/*!
+	 * \brief Sets how often a request rejected with `429 Too Many Requests` is
+	 * retried before its reply is passed on.
+	 *
+	 * Defaults to 5.
+	 */
+	void setMaxRetries(int maxRetries) {_maxRetries = maxRetries;}
+	///\brief Returns how often a rejected request is retried.
+	int maxRetries() const {return _maxRetries;}
+	///\brief Returns whether all requests are paused by a global rate limit.
+	bool globallyLimited() const {return _clock.elapsed() < _globalResetAt;}
+	///\brief Returns the amount of requests waiting for their bucket.
+	int queued() const {return _queued;}
+	///\brief Returns the amount of requests waiting for the provided route's bucket.
+	int queued(const Route& route) const;
+	/*!
+	 * \brief Returns the amount of buckets currently tracked.
+	 *
+	 * Buckets without queued requests or requests in flight are dropped once
+	 * their limit has reset.
+	 */
+	int bucketCount() const {return _buckets.size();}
+	///\brief Returns the amount of requests of a priority waiting for their bucket.
+	int queued(Priority priority) const {
+		return _classes[int(priority)].queued;
+	}
+	/*!
+	 * \brief Drops all queued requests and everything learned about buckets.
+	 *
+	 * The finished functions of dropped requests are never called.
+	 */
+	void clear();
+signals:
+	/*!
+	 * \brief Emitted when Discord rejected a request with
+	 * `429 Too Many Requests`.
+	 * \param route The name of the rejected request's route.
+	 * \param majorParameter The major parameter of the rejected request.
+	 * \param retryAfter The time in milliseconds before the request is retried.
+	 * \param global Whether all requests are paused, not only the route's.
+	 */
+	void rateLimited(const QString& route, const QString& majorParameter,
+					 qint64 retryAfter, bool global);
+private:
+	struct Request
+	{
+		Request();
+		Route route;
+		std::function<QNetworkReply*()> send;
+		std::function<void(QNetworkReply*)> finished;
+		Priority priority;
+		qint64 queuedAt;
+		int retries;
+	};
+	struct Bucket
+	{
+		Bucket();
+		//A negative limit means that the bucket is not limited.
+		int limit;
+		int remaining;
+		qint64 resetAt;
+		int inFlight;
+		bool known;
+		bool timerPending;
+		int length() const;
+		//A queue per priority.
+		QQueue<Request> queues[priorityCount];
+		//The credit of every priority for smooth weighted round robin.
+		int credits[priorityCount];
+	};
+	struct Class
+	{
+		Class();
+		int weight;
+		int maxInFlight;
+		int inFlight;
+		int queued;
+		WaitTime waitTime;
+	};
+	QString bucketKey(const Route& route);
+	bool hasCapacity(Bucket& bucket, qint64 now) const;
+	int schedule(Bucket& bucket);
+	void push(Request request, Bucket& bucket, bool front);
+	void drain(const QString& key);
+	void drainAll();
+	void replyFinished(const Request& request, QNetworkReply* reply);
+	bool retry(const Request& request, Bucket& bucket, QNetworkReply* reply,
+			   qint64 now);
+	void learn(Bucket& bucket, QNetworkReply* reply, qint64 now);
+	//Bucket hashes reported through X-RateLimit-Bucket, by route name.
+	QHash<QString, QString> _routeBuckets;
+	QHash<QString, Bucket> _buckets;
+	QElapsedTimer _clock;
+	qint64 _globalResetAt;
+	bool _globalTimerPending;
+	int _queued;
+	int _maxRetries;
+	Class _classes[priorityCount];
+};
+
+#endif // QDISCORDRATELIMITER_HPP
@@ -0,0 +1,171 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QJsonDocument>
+#include "qdiscordrequest.hpp"
+
+QDiscordRequest QDiscordRequest::get(const QUrl& url)
+{
+	return QDiscordRequest(Method::Get, url);
+}
+
+QDiscordRequest QDiscordRequest::post(const QUrl& url,
+									  const QJsonObject& object)
+{
+	QDiscordRequest request(Method::Post, url);
+	request.setBody(QJsonDocument(object).toJson(QJsonDocument::Compact));
+	return request;
+}
+
+QDiscordRequest QDiscordRequest::post(const QUrl& url, const QJsonArray& array)
+{
+	QDiscordRequest request(Method::Post, url);
+	request.setBody(QJsonDocument(array).toJson(QJsonDocument::Compact));
+	return request;
+}
+
+QDiscordRequest QDiscordRequest::post(const QUrl& url,
+									  const QDiscordUpload& upload)
+{
+	QDiscordRequest request(Method::Post, url);
+	request.setUpload(upload);
+	return request;
+}
+
+QDiscordRequest QDiscordRequest::patch(const QUrl& url,
+									   const QJsonObject& object)
+{
+	QDiscordRequest request(Method::Patch, url);
+	request.setBody(QJsonDocument(object).toJson(QJsonDocument::Compact));
+	return request;
+}
+
+QDiscordRequest QDiscordRequest::patch(const QUrl& url,
+									   const QJsonArray& array)
+{
+	QDiscordRequest request(Method::Patch, url);
+	request.setBody(QJsonDocument(array).toJson(QJsonDocument::Compact));
+	return request;
+}
+
+QDiscordRequest QDiscordRequest::deleteResource(const QUrl& url)
+{
+	return QDiscordRequest(Method::Delete, url);
+}
+
+QDiscordRequest::QDiscordRequest(Method method, const QUrl& url)
+{
+	_method = method;
+	_url = url;
+	_cacheable = true;
+	_priority = QDiscordRateLimiter::Priority::Normal;
+}
+
+QDiscordRequest::QDiscordRequest()
+{
+	_method = Method::Get;
+	_cacheable = true;
+	_priority = QDiscordRateLimiter::Priority::Normal;
+}
+
+QByteArray QDiscordRequest::methodName() const
+{
+	switch(_method)
+	{
+	case Method::Get:
+		return QByteArrayLiteral("GET");
+	case Method::Post:
+		return QByteArrayLiteral("POST");
+	case Method::Put:
+		return QByteArrayLiteral("PUT");
+	case Method::Patch:
+		return QByteArrayLiteral("PATCH");
+	case Method::Delete:
+		return QByteArrayLiteral("DELETE");
+	}
+	return QByteArray();
+}
+
+void QDiscordRequest::setBody(const QByteArray& body,
+							  const QByteArray& contentType)
+{
+	_body = body;
+	_contentType = contentType;
+	_upload.clear();
+}
+
+void QDiscordRequest::setUpload(const QDiscordUpload& upload)
+{
+	_body.clear();
+	_contentType.clear();
+	_upload = QSharedPointer<const QDiscordUpload>(new QDiscordUpload(upload));
+}
+
+void QDiscordRequest::setRawHeader(const QByteArray& name,
+								   const QByteArray& value)
+{
+	_rawHeaders.append(qMakePair(name, value));
+}
+
+void QDiscordRequest::removeRawHeader(const QByteArray& name)
+{
+	for(int i = _rawHeaders.length() - 1; i >= 0; i--)
+	{
+		if(qstricmp(_rawHeaders[i].first.constData(), name.constData()) == 0)
+			_rawHeaders.removeAt(i);
+	}
+}
+
+QDiscordResponse::QDiscordResponse(QNetworkReply* reply)
+{
+	_error = reply->error();
+	_statusCode =
+			reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+	_body = reply->readAll();
+	_rawHeaders = reply->rawHeaderPairs();
+}
+
+QDiscordResponse::QDiscordResponse()
+{
+	_error = QNetworkReply::NoError;
+	_statusCode = 0;
+}
+
+QByteArray QDiscordResponse::rawHeader(const QByteArray& name) const
+{
+	for(const QNetworkReply::RawHeaderPair& header : _rawHeaders)
+	{
+		if(qstricmp(header.first.constData(), name.constData()) == 0)
+			return header.second;
+	}
+	return QByteArray();
+}
+
+void QDiscordResponse::setRawHeader(const QByteArray& name,
+									const QByteArray& value)
+{
+	for(QNetworkReply::RawHeaderPair& header : _rawHeaders)
+	{
+		if(qstricmp(header.first.constData(), name.constData()) == 0)
+		{
+			header.second = value;
+			return;
+		}
+	}
+	_rawHeaders.append(qMakePair(name, value));
+}
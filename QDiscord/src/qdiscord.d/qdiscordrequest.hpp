@@ -0,0 +1,184 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDREQUEST_HPP
+#define QDISCORDREQUEST_HPP
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QNetworkReply>
+#include <QPair>
+#include <QSharedPointer>
+#include <QUrl>
+#include "qdiscordratelimiter.hpp"
+#include "qdiscordupload.hpp"
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief Describes a REST request before it is sent by
+ * QDiscordRequestPipeline.
+ *
+ * Headers shared by all requests, such as `Authorization` and `User-Agent`,
+ * are added by the pipeline and do not need to be set here.
+ */
+class QDISCORD_API QDiscordRequest
+{
+public:
+	///\brief An enumerator holding the HTTP methods used by the Discord API.
+	enum class Method
+	{
+		Get,
+		Post,
+		Put,
+		Patch,
+		Delete
+	};
+	///\brief Creates a `GET` request for the provided URL.
+	static QDiscordRequest get(const QUrl& url);
+	///\brief Creates a `POST` request sending the provided object as JSON.
+	static QDiscordRequest post(const QUrl& url, const QJsonObject& object);
+	///\brief Creates a `POST` request sending the provided array as JSON.
+	static QDiscordRequest post(const QUrl& url, const QJsonArray& array);
+	///\brief Creates a `POST` request sending the provided files.
+	static QDiscordRequest post(const QUrl& url, const QDiscordUpload& upload);
+	///\brief Creates a `PATCH` request sending the provided object as JSON.
+	static QDiscordRequest patch(const QUrl& url, const QJsonObject& object);
+	///\brief Creates a `PATCH` request sending the provided array as JSON.
+	static QDiscordRequest patch(const QUrl& url, const QJsonArray& array);
+	///\brief Creates a `DELETE` request for the provided URL.
+	static QDiscordRequest deleteResource(const QUrl& url);
+	///\brief Creates a request without a body.
+	QDiscordRequest(Method method, const QUrl& url);
+	///\brief Default public constructor, creating a `GET` request without URL.
+	QDiscordRequest();
+	///\brief Returns the request's method.
+	Method method() const {return _method;}
+	///\brief Returns the request's method as sent in HTTP, such as `"PATCH"`.
+	QByteArray methodName() const;
+	///\brief Returns the request's URL.
+	const QUrl& url() const {return _url;}
+	///\brief Sets the request's URL.
+	void setUrl(const QUrl& url) {_url = url;}
+	///\brief Returns the request's body.
+	const QByteArray& body() const {return _body;}
+	///\brief Returns the `Content-Type` of the request's body.
+	const QByteArray& contentType() const {return _contentType;}
+	///\brief Sets the request's body and its `Content-Type`.
+	void setBody(const QByteArray& body,
+				 const QByteArray& contentType = "application/json");
+	///\brief Returns whether the request's body is a multipart upload.
+	bool hasUpload() const {return !_upload.isNull();}
+	/*!
+	 * \brief Returns the files sent as the request's body.
+	 *
+	 * Only valid if hasUpload() returns `true`.
+	 */
+	const QDiscordUpload& upload() const {return *_upload;}
+	/*!
+	 * \brief Sends the provided files as the request's body.
+	 *
+	 * This replaces any body set with setBody(). The `Content-Type` is set when
+	 * the request is sent, since it contains the multipart boundary.
+	 */
+	void setUpload(const QDiscordUpload& upload);
+	///\brief Returns the headers set on this request.
+	const QList<QPair<QByteArray, QByteArray>>& rawHeaders() const {
+		return _rawHeaders;
+	}
+	///\brief Adds a header sent with this request only.
+	void setRawHeader(const QByteArray& name, const QByteArray& value);
+	///\brief Removes all headers with the provided name.
+	void removeRawHeader(const QByteArray& name);
+	/*!
+	 * \brief Returns whether the response of a `GET` request may be stored in
+	 * and answered from QDiscordResponseCache.
+	 *
+	 * Defaults to `true`.
+	 */
+	bool isCacheable() const {return _cacheable;}
+	///\brief Sets whether the response may be cached.
+	void setCacheable(bool cacheable) {_cacheable = cacheable;}
+	/*!
+	 * \brief Returns the scheduling class of the request.
+	 *
+	 * Defaults to QDiscordRateLimiter::Priority::Normal.
+	 */
+	QDiscordRateLimiter::Priority priority() const {return _priority;}
+	///\brief Sets the scheduling class of the request.
+	void setPriority(QDiscordRateLimiter::Priority priority) {
+		_priority = priority;
+	}
+	///\brief Returns the rate limit route of the request.
+	QDiscordRateLimiter::Route route() const {
+		return QDiscordRateLimiter::Route::fromRequest(methodName(), _url);
+	}
+private:
+	Method _method;
+	QUrl _url;
+	QByteArray _body;
+	QByteArray _contentType;
+	QSharedPointer<const QDiscordUpload> _upload;
+	QList<QPair<QByteArray, QByteArray>> _rawHeaders;
+	bool _cacheable;
+	QDiscordRateLimiter::Priority _priority;
+};
+
+/*!
+ * \brief Holds a finished REST request's result.
+ *
+ * The body is read from the QNetworkReply once, so interceptors and callbacks
+ * can inspect and change the response without consuming the reply.
+ */
+class QDISCORD_API QDiscordResponse
+{
+public:
+	///\brief Reads the result of the provided finished reply.
+	explicit QDiscordResponse(QNetworkReply* reply);
+	///\brief Default public constructor, creating a successful empty response.
+	QDiscordResponse();
+	///\brief Returns the network error of the request, if any.
+	QNetworkReply::NetworkError error() const {return _error;}
+	///\brief Sets the network error of the request.
+	void setError(QNetworkReply::NetworkError error) {_error = error;}
+	///\brief Returns whether the request succeeded.
+	bool isSuccess() const {return _error == QNetworkReply::NoError;}
+	///\brief Returns the HTTP status code, or 0 if no response was received.
+	int statusCode() const {return _statusCode;}
+	///\brief Sets the HTTP status code.
+	void setStatusCode(int statusCode) {_statusCode = statusCode;}
+	///\brief Returns the response's body.
+	const QByteArray& body() const {return _body;}
+	///\brief Sets the response's body.
+	void setBody(const QByteArray& body) {_body = body;}
+	///\brief Returns the value of a response header, or an empty array.
+	QByteArray rawHeader(const QByteArray& name) const;
+	///\brief Returns all response headers.
+	const QList<QNetworkReply::RawHeaderPair>& rawHeaders() const {
+		return _rawHeaders;
+	}
+	///\brief Sets a response header, replacing any with the same name.
+	void setRawHeader(const QByteArray& name, const QByteArray& value);
+private:
+	QNetworkReply::NetworkError _error;
+	int _statusCode;
+	QByteArray _body;
+	QList<QNetworkReply::RawHeaderPair> _rawHeaders;
+};
+
+#endif // QDISCORDREQUEST_HPP
@@ -0,0 +1,300 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QBuffer>
+#include <QTimer>
+#include "qdiscordrequestpipeline.hpp"
+#include "qdiscordtrace.hpp"
+
+QDiscordRequestInterceptor::~QDiscordRequestInterceptor()
+{
+
+}
+
+void QDiscordRequestInterceptor::request(QDiscordRequest& request)
+{
+	Q_UNUSED(request);
+}
+
+void QDiscordRequestInterceptor::response(const QDiscordRequest& request,
+										  QDiscordResponse& response)
+{
+	Q_UNUSED(request);
+	Q_UNUSED(response);
+}
+
+QDiscordRequestPipeline::QDiscordRequestPipeline(QObject* parent)
+	: QObject(parent)
+{
+	_coalesced = 0;
+	updatePrototype();
+}
+
+void QDiscordRequestPipeline::setAuthorization(const QString& authorization)
+{
+	if(_authorization != authorization)
+	{
+		//Responses and requests in flight belong to the previous user.
+		_cache.clear();
+		_inFlight.clear();
+	}
+	_authorization = authorization;
+	updatePrototype();
+}
+
+void QDiscordRequestPipeline::addInterceptor(
+		QDiscordRequestInterceptor* interceptor)
+{
+	if(interceptor && !_interceptors.contains(interceptor))
+		_interceptors.append(interceptor);
+}
+
+void QDiscordRequestPipeline::removeInterceptor(
+		QDiscordRequestInterceptor* interceptor)
+{
+	_interceptors.removeAll(interceptor);
+}
+
+QNetworkRequest
+QDiscordRequestPipeline::networkRequest(const QDiscordRequest& request)
+{
+	//The bot name is public and may change at any time.
+	if(_prototypeBotName != QDiscordUtilities::botName)
+		updatePrototype();
+	QNetworkRequest networkRequest = _prototype;
+	networkRequest.setUrl(request.url());
+	if(!request.contentType().isEmpty())
+		networkRequest.setRawHeader("content-type", request.contentType());
+	for(const QPair<QByteArray, QByteArray>& header : request.rawHeaders())
+		networkRequest.setRawHeader(header.first, header.second);
+	return networkRequest;
+}
+
+void QDiscordRequestPipeline::send(QDiscordRequest request, Callback callback)
+{
+	send(request, callback, QSharedPointer<QDiscordFutureState>());
+}
+
+void QDiscordRequestPipeline::send(
+		QDiscordRequest request, Callback callback,
+		const QSharedPointer<QDiscordFutureState>& state)
+{
+	for(QDiscordRequestInterceptor* interceptor : _interceptors)
+		interceptor->request(request);
+
+	if(QDiscordUtilities::debugMode)
+		qDebug()<<this<<request.methodName()<<"to"<<request.url();
+
+	if(request.method() != QDiscordRequest::Method::Get)
+	{
+		invalidate(request);
+		enqueue(request, QString(), callback, state);
+		return;
+	}
+	const QString key = cacheKey(request);
+	QDiscordResponse cached;
+	if(request.isCacheable() && _cache.lookup(key, cached))
+	{
+		//Callbacks are never called before send() returns.
+		QTimer::singleShot(0, this, [callback, cached](){
+			if(callback)
+				callback(cached);
+		});
+		return;
+	}
+	QHash<QString, Waiting>::iterator waiting = _inFlight.find(key);
+	if(waiting != _inFlight.end())
+	{
+		waiting.value()->append(callback);
+		_coalesced++;
+		QDISCORD_TRACE(Rest, Verbose, "rest request coalesced", _coalesced);
+		return;
+	}
+	Waiting callbacks(new QList<Callback>());
+	callbacks->append(callback);
+	_inFlight.insert(key, callbacks);
+	if(request.isCacheable())
+	{
+		QByteArray etag = _cache.etag(key);
+		if(!etag.isEmpty())
+			request.setRawHeader("If-None-Match", etag);
+	}
+	enqueue(request, request.isCacheable()?key:QString(),
+			[this, key, callbacks](const QDiscordResponse& response){
+		QHash<QString, Waiting>::iterator i = _inFlight.find(key);
+		if(i != _inFlight.end() && i.value() == callbacks)
+			_inFlight.erase(i);
+		for(const Callback& callback : *callbacks)
+		{
+			if(callback)
+				callback(response);
+		}
+	}, QSharedPointer<QDiscordFutureState>());
+}
+
+void QDiscordRequestPipeline::invalidate(const QDiscordRequest& request)
+{
+	//A write changes its resource and everything below it, and may change the
+	//collection it belongs to, such as a channel's messages.
+	QUrl url = request.url().adjusted(QUrl::RemoveQuery |
+									  QUrl::StripTrailingSlash);
+	_cache.invalidate(url);
+	_cache.invalidate(url.adjusted(QUrl::RemoveFilename |
+								   QUrl::StripTrailingSlash), false);
+}
+
+QString QDiscordRequestPipeline::cacheKey(const QDiscordRequest& request)
+{
+	QString key = request.url().toString();
+	for(const QPair<QByteArray, QByteArray>& header : request.rawHeaders())
+	{
+		key += QLatin1Char('\n') + QString::fromLatin1(header.first) +
+				QLatin1Char(':') + QString::fromLatin1(header.second);
+	}
+	return key;
+}
+
+void QDiscordRequestPipeline::updatePrototype()
+{
+	_prototypeBotName = QDiscordUtilities::botName;
+	QString userAgent = "DiscordBot (" + QDiscordUtilities::libLink +
+						", v" + QDiscordUtilities::libMajor + ":" +
+						QDiscordUtilities::libMinor + ")" +
+						"; " + QDiscordUtilities::botName;
+	_prototype = QNetworkRequest();
+	if(!_authorization.isEmpty())
+		_prototype.setRawHeader("Authorization", _authorization.toUtf8());
+	_prototype.setRawHeader("User-Agent", userAgent.toUtf8());
+}
+
+void QDiscordRequestPipeline::enqueue(
+		const QDiscordRequest& request, const QString& cacheKey,
+		Callback callback, const QSharedPointer<QDiscordFutureState>& state)
+{
+	QNetworkRequest networkRequest = this->networkRequest(request);
+	_rateLimiter.enqueue(request.route(), request.priority(),
+						 [this, request, networkRequest, state]()
+						 -> QNetworkReply* {
+		if(state && state->isCanceled())
+			return nullptr;
+		QNetworkReply* reply = transmit(request, networkRequest);
+		if(state)
+			state->setReply(reply);
+		return reply;
+	}, [this, request, cacheKey, callback](QNetworkReply* reply){
+		finish(request, cacheKey, reply, callback);
+	});
+}
+
+QNetworkReply*
+QDiscordRequestPipeline::transmit(const QDiscordRequest& request,
+								  const QNetworkRequest& networkRequest)
+{
+	if(request.hasUpload())
+		return transmitUpload(request, networkRequest);
+	switch(request.method())
+	{
+	case QDiscordRequest::Method::Get:
+		return _manager.get(networkRequest);
+	case QDiscordRequest::Method::Post:
+		return _manager.post(networkRequest, request.body());
+	case QDiscordRequest::Method::Put:
+		return _manager.put(networkRequest, request.body());
+	case QDiscordRequest::Method::Delete:
+		if(request.body().isEmpty())
+			return _manager.deleteResource(networkRequest);
+		break;
+	case QDiscordRequest::Method::Patch:
+		break;
+	}
+	QBuffer *buffer = new QBuffer();
+	buffer->open(QBuffer::ReadWrite);
+	buffer->write(request.body());
+	buffer->seek(0);
+	QNetworkReply* reply =
+			_manager.sendCustomRequest(networkRequest, request.methodName(),
+									   buffer);
+	connect(reply, &QNetworkReply::finished, buffer, &QBuffer::deleteLater);
+	return reply;
+}
+
+QNetworkReply*
+QDiscordRequestPipeline::transmitUpload(const QDiscordRequest& request,
+										const QNetworkRequest& networkRequest)
+{
+	const QDiscordUpload& upload = request.upload();
+	//Built for every attempt, so retries send the files from the start.
+	QHttpMultiPart* multiPart = upload.multiPart();
+	QNetworkReply* reply;
+	switch(request.method())
+	{
+	case QDiscordRequest::Method::Post:
+		reply = _manager.post(networkRequest, multiPart);
+		break;
+	case QDiscordRequest::Method::Put:
+		reply = _manager.put(networkRequest, multiPart);
+		break;
+	default:
+		reply = _manager.sendCustomRequest(networkRequest,
+										   request.methodName(), multiPart);
+		break;
+	}
+	multiPart->setParent(reply);
+	if(upload.progressHandler())
+	{
+		QDiscordUpload::ProgressHandler handler = upload.progressHandler();
+		connect(reply, &QNetworkReply::uploadProgress, reply,
+				[handler](qint64 sent, qint64 total){
+			handler(sent, total);
+		});
+	}
+	return reply;
+}
+
+void QDiscordRequestPipeline::finish(const QDiscordRequest& request,
+									 const QString& cacheKey,
+									 QNetworkReply* reply,
+									 const Callback& callback)
+{
+	QDiscordResponse response(reply);
+	reply->deleteLater();
+	//GET requests started before the write finished may have stored the
+	//previous state in the meantime.
+	if(request.method() != QDiscordRequest::Method::Get)
+		invalidate(request);
+	if(!cacheKey.isEmpty() && !_cache.update(cacheKey, response))
+	{
+		//The response being revalidated was evicted in the meantime, so it is
+		//fetched again in full.
+		QDiscordRequest refetch = request;
+		refetch.removeRawHeader("If-None-Match");
+		enqueue(refetch, cacheKey, callback,
+				QSharedPointer<QDiscordFutureState>());
+		return;
+	}
+	for(int i = _interceptors.length() - 1; i >= 0; i--)
+		_interceptors[i]->response(request, response);
+	QDISCORD_TRACE(Rest, Debug, "rest response", response.statusCode());
+	if(QDiscordUtilities::debugMode && !response.isSuccess())
+	{
+		qDebug()<<this<<request.methodName()<<"to"<<request.url()<<"failed:"
+			   <<QDiscordUtilities::networkErrorToString(response.error());
+	}
+	if(callback)
+		callback(response);
+}
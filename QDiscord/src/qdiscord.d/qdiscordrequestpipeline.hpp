@@ -0,0 +1,274 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDREQUESTPIPELINE_HPP
+#define QDISCORDREQUESTPIPELINE_HPP
+
+#include <QHash>
+#include <QJsonDocument>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QSharedPointer>
+#include <functional>
+#include "qdiscordfuture.hpp"
+#include "qdiscordratelimiter.hpp"
+#include "qdiscordrequest.hpp"
+#include "qdiscordresponsecache.hpp"
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief Observes and modifies requests passing through a
+ * QDiscordRequestPipeline.
+ *
+ * Both methods do nothing by default, so only the needed one has to be
+ * reimplemented.
+ * \see QDiscordRequestPipeline::addInterceptor
+ */
+class QDISCORD_API QDiscordRequestInterceptor
+{
+public:
+	virtual ~QDiscordRequestInterceptor();
+	/*!
+	 * \brief Called for every request before it is queued.
+	 *
+	 * Interceptors are called in the order they were added.
+	 */
+	virtual void request(QDiscordRequest& request);
+	/*!
+	 * \brief Called for every finished request before its response is
+	 * decoded.
+	 *
+	 * Interceptors are called in the reverse order they were added. Requests
+	 * which are retried because of a rate limit only reach this once.
+	 */
+	virtual void response(const QDiscordRequest& request,
+						  QDiscordResponse& response);
+};
+
+/*!
+ * \brief Converts a response's body to the type requested from
+ * QDiscordRequestPipeline::send.
+ *
+ * By default, the body is parsed as a JSON object and passed to the type's
+ * constructor, which works for all QDiscord models. Specializations exist for
+ * QDiscordResponse, QJsonDocument, QJsonObject, QJsonArray and QByteArray.
+ */
+template<typename T>
+struct QDiscordResponseDecoder
+{
+	static T decode(const QDiscordResponse& response) {
+		return T(QJsonDocument::fromJson(response.body()).object());
+	}
+};
+
+template<>
+struct QDiscordResponseDecoder<QDiscordResponse>
+{
+	static QDiscordResponse decode(const QDiscordResponse& response) {
+		return response;
+	}
+};
+
+template<>
+struct QDiscordResponseDecoder<QJsonDocument>
+{
+	static QJsonDocument decode(const QDiscordResponse& response) {
+		return QJsonDocument::fromJson(response.body());
+	}
+};
+
+template<>
+struct QDiscordResponseDecoder<QJsonObject>
+{
+	static QJsonObject decode(const QDiscordResponse& response) {
+		return QJsonDocument::fromJson(response.body()).object();
+	}
+};
+
+template<>
+struct QDiscordResponseDecoder<QJsonArray>
+{
+	static QJsonArray decode(const QDiscordResponse& response) {
+		return QJsonDocument::fromJson(response.body()).array();
+	}
+};
+
+template<>
+struct QDiscordResponseDecoder<QByteArray>
+{
+	static QByteArray decode(const QDiscordResponse& response) {
+		return response.body();
+	}
+};
+
+/*!
+ * \brief Sends all REST requests of QDiscordRestComponent.
+ *
+ * Every request passes through the same steps:
+ * 1. The interceptors' QDiscordRequestInterceptor::request methods.
+ * 2. For `GET` requests, the QDiscordResponseCache. A fresh response is passed
+ *    to the callback right away. A `GET` request identical to one already in
+ *    flight does not send anything and receives the same response. Other
+ *    requests remove the cached responses for their URL, the URLs below it
+ *    and its parent, both when they are sent and when they finish.
+ * 3. Conversion to a QNetworkRequest, starting from a prebuilt copy holding the
+ *    `Authorization` and `User-Agent` headers.
+ * 4. The QDiscordRateLimiter, which sends the request once its bucket has
+ *    capacity and retries it if it gets rate limited.
+ * 5. The interceptors' QDiscordRequestInterceptor::response methods, which
+ *    are skipped for responses taken from the cache.
+ * 6. The callback, optionally after decoding the response with
+ *    QDiscordResponseDecoder.
+ *
+ * Headers are copied into requests when they are queued, so changing the
+ * authorization does not affect requests already waiting for their bucket.
+ * It does clear the response cache.
+ */
+class QDISCORD_API QDiscordRequestPipeline : public QObject
+{
+	Q_OBJECT
+public:
+	///\brief A function receiving the response of a finished request.
+	typedef std::function<void(const QDiscordResponse&)> Callback;
+	///\brief Standard QObject constructor.
+	explicit QDiscordRequestPipeline(QObject* parent = 0);
+	///\brief Returns the value of the `Authorization` header, if any.
+	const QString& authorization() const {return _authorization;}
+	///\brief Sets the value of the `Authorization` header sent with requests.
+	void setAuthorization(const QString& authorization);
+	/*!
+	 * \brief Adds an interceptor to the end of the chain.
+	 *
+	 * The pipeline does not take ownership. The interceptor has to be removed
+	 * before it is destroyed.
+	 */
+	void addInterceptor(QDiscordRequestInterceptor* interceptor);
+	///\brief Removes an interceptor from the chain.
+	void removeInterceptor(QDiscordRequestInterceptor* interceptor);
+	///\brief Returns all interceptors in the order they are called for requests.
+	const QList<QDiscordRequestInterceptor*>& interceptors() const {
+		return _interceptors;
+	}
+	///\brief Returns the rate limiter all requests are sent through.
+	QDiscordRateLimiter* rateLimiter() {return &_rateLimiter;}
+	///\brief Returns the cache storing the responses of `GET` requests.
+	QDiscordResponseCache* responseCache() {return &_cache;}
+	/*!
+	 * \brief Returns how many `GET` requests shared the reply of an identical
+	 * request instead of being sent.
+	 */
+	quint64 coalescedRequests() const {return _coalesced;}
+	///\brief Returns the network access manager sending the requests.
+	QNetworkAccessManager* networkAccessManager() {return &_manager;}
+	/*!
+	 * \brief Returns the QNetworkRequest the provided request is sent as.
+	 *
+	 * This does not call any interceptors.
+	 */
+	QNetworkRequest networkRequest(const QDiscordRequest& request);
+	///\brief Sends a request and calls the callback with its response.
+	void send(QDiscordRequest request, Callback callback);
+	/*!
+	 * \brief Sends a request and calls the callback with its response unless
+	 * the future owning the provided state is canceled first.
+	 *
+	 * A canceled request is dropped if it has not been sent yet and aborted
+	 * otherwise. `GET` requests are only skipped, since identical requests
+	 * made later may share their reply.
+	 */
+	void send(QDiscordRequest request, Callback callback,
+			  const QSharedPointer<QDiscordFutureState>& state);
+	/*!
+	 * \brief Sends a request and decodes its response.
+	 * \param success Called with the decoded response if the request
+	 * succeeded.
+	 * \param failure Called with the error if the request failed.
+	 */
+	template<typename T>
+	void send(const QDiscordRequest& request,
+			  std::function<void(const T&)> success,
+			  std::function<void(QNetworkReply::NetworkError)> failure);
+	/*!
+	 * \brief Sends a request and returns a future for its decoded response.
+	 *
+	 * Canceling the future drops or aborts the request.
+	 */
+	template<typename T>
+	QDiscordFuture<T> send(const QDiscordRequest& request);
+private:
+	typedef QSharedPointer<QList<Callback>> Waiting;
+	static QString cacheKey(const QDiscordRequest& request);
+	void invalidate(const QDiscordRequest& request);
+	void updatePrototype();
+	void enqueue(const QDiscordRequest& request, const QString& cacheKey,
+				 Callback callback,
+				 const QSharedPointer<QDiscordFutureState>& state);
+	QNetworkReply* transmit(const QDiscordRequest& request,
+							const QNetworkRequest& networkRequest);
+	QNetworkReply* transmitUpload(const QDiscordRequest& request,
+								  const QNetworkRequest& networkRequest);
+	void finish(const QDiscordRequest& request, const QString& cacheKey,
+				QNetworkReply* reply, const Callback& callback);
+	//A request holding the headers shared by all requests, copied for each
+	//request instead of rebuilding the headers every time.
+	QNetworkRequest _prototype;
+	QString _prototypeBotName;
+	QString _authorization;
+	QList<QDiscordRequestInterceptor*> _interceptors;
+	QDiscordResponseCache _cache;
+	//Callbacks of GET requests in flight, by their cache key.
+	QHash<QString, Waiting> _inFlight;
+	quint64 _coalesced;
+	QNetworkAccessManager _manager;
+	QDiscordRateLimiter _rateLimiter;
+};
+
+template<typename T>
+void QDiscordRequestPipeline::send(const QDiscordRequest& request,
+								   std::function<void(const T&)> success,
+								   std::function<void(QNetworkReply::NetworkError)> failure)
+{
+	send(request, [success, failure](const QDiscordResponse& response){
+		if(!response.isSuccess())
+		{
+			if(failure)
+				failure(response.error());
+		}
+		else if(success)
+			success(QDiscordResponseDecoder<T>::decode(response));
+	});
+}
+
+template<typename T>
+QDiscordFuture<T> QDiscordRequestPipeline::send(const QDiscordRequest& request)
+{
+	QDiscordPromise<T> promise;
+	send(request, [promise](const QDiscordResponse& response) mutable {
+		if(promise.isCanceled())
+			return;
+		if(!response.isSuccess())
+			promise.reject(response.error());
+		else
+			promise.resolve(QDiscordResponseDecoder<T>::decode(response));
+	}, promise.state());
+	return promise.future();
+}
+
+#endif // QDISCORDREQUESTPIPELINE_HPP
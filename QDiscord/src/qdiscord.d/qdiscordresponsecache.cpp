@@ -0,0 +1,113 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordresponsecache.hpp"
+#include "qdiscordtrace.hpp"
+
+QDiscordResponseCache::QDiscordResponseCache()
+{
+	_entries.setMaxCost(4*1024*1024);
+	_clock.start();
+	_timeToLive = 30000;
+	_hits = 0;
+	_misses = 0;
+	_revalidations = 0;
+}
+
+bool QDiscordResponseCache::lookup(const QString& key,
+								   QDiscordResponse& response)
+{
+	Entry* entry = _entries.object(key);
+	if(entry && _clock.elapsed() < entry->expiresAt)
+	{
+		_hits++;
+		response = entry->response;
+		QDISCORD_TRACE(Rest, Verbose, "rest cache hit", _hits);
+		return true;
+	}
+	//Expired responses are only useful for revalidation.
+	if(entry && entry->etag.isEmpty())
+		_entries.remove(key);
+	_misses++;
+	QDISCORD_TRACE(Rest, Verbose, "rest cache miss", _misses);
+	return false;
+}
+
+QByteArray QDiscordResponseCache::etag(const QString& key)
+{
+	Entry* entry = _entries.object(key);
+	return entry?entry->etag:QByteArray();
+}
+
+bool QDiscordResponseCache::update(const QString& key,
+								   QDiscordResponse& response)
+{
+	if(response.statusCode() == 304)
+	{
+		Entry* entry = _entries.object(key);
+		//The response was evicted while it was being revalidated, so there is
+		//no body to answer with.
+		if(!entry)
+		{
+			response.setError(QNetworkReply::ContentReSendError);
+			return false;
+		}
+		_revalidations++;
+		entry->expiresAt = _clock.elapsed() + _timeToLive;
+		response.setError(QNetworkReply::NoError);
+		response.setStatusCode(entry->response.statusCode());
+		response.setBody(entry->response.body());
+		return true;
+	}
+	if(!response.isSuccess() || response.statusCode() != 200 ||
+	   _timeToLive <= 0 ||
+	   response.rawHeader("Cache-Control").contains("no-store"))
+	{
+		_entries.remove(key);
+		return true;
+	}
+	Entry* entry = new Entry;
+	entry->response = response;
+	entry->etag = response.rawHeader("ETag");
+	entry->expiresAt = _clock.elapsed() + _timeToLive;
+	//Takes ownership, deleting the entry right away if it is too large.
+	_entries.insert(key, entry, response.body().size() + 1);
+	return true;
+}
+
+void QDiscordResponseCache::invalidate(const QUrl& url, bool descendants)
+{
+	const QString prefix = url.toString();
+	for(const QString& key : _entries.keys())
+	{
+		if(!key.startsWith(prefix))
+			continue;
+		if(key.length() == prefix.length() ||
+		   (descendants && key[prefix.length()] == QLatin1Char('/')) ||
+		   key[prefix.length()] == QLatin1Char('?') ||
+		   key[prefix.length()] == QLatin1Char('\n'))
+			_entries.remove(key);
+	}
+}
+
+void QDiscordResponseCache::resetStatistics()
+{
+	_hits = 0;
+	_misses = 0;
+	_revalidations = 0;
+}
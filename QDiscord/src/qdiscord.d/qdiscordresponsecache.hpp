@@ -0,0 +1,118 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDRESPONSECACHE_HPP
+#define QDISCORDRESPONSECACHE_HPP
+
+#include <QCache>
+#include <QElapsedTimer>
+#include <QUrl>
+#include "qdiscordrequest.hpp"
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief Stores responses of `GET` requests made through
+ * QDiscordRequestPipeline.
+ *
+ * Successful responses are kept for timeToLive() milliseconds and answered
+ * without a request while they are fresh. Expired responses with an `ETag`
+ * are kept and revalidated with `If-None-Match`. A `304 Not Modified` reply
+ * is then answered with the stored body. The cache is bounded by the total
+ * size of the stored bodies, evicting the least recently used responses
+ * first.\n
+ * QDiscord invalidates the stored users, channels and guilds whenever the
+ * gateway reports a change to them, and clears the cache whenever a new
+ * gateway session is ready.
+ */
+class QDISCORD_API QDiscordResponseCache
+{
+public:
+	///\brief Creates an empty cache.
+	QDiscordResponseCache();
+	///\brief Returns the maximum total size of the stored bodies in bytes.
+	int maxSize() const {return _entries.maxCost();}
+	///\brief Sets the maximum total size of the stored bodies in bytes.
+	void setMaxSize(int bytes) {_entries.setMaxCost(bytes);}
+	/*!
+	 * \brief Returns how long responses are used without revalidating them,
+	 * in milliseconds.
+	 */
+	qint64 timeToLive() const {return _timeToLive;}
+	/*!
+	 * \brief Sets how long responses are used without revalidating them, in
+	 * milliseconds.
+	 *
+	 * A value of 0 disables storing new responses.
+	 */
+	void setTimeToLive(qint64 msecs) {_timeToLive = msecs;}
+	///\brief Returns the amount of stored responses.
+	int count() const {return _entries.count();}
+	/*!
+	 * \brief Looks up a fresh response.
+	 * \returns `true` and sets the response if it was found.
+	 */
+	bool lookup(const QString& key, QDiscordResponse& response);
+	/*!
+	 * \brief Returns the `ETag` of an expired response, which should be sent
+	 * as `If-None-Match`.
+	 */
+	QByteArray etag(const QString& key);
+	/*!
+	 * \brief Stores a response, or completes a `304 Not Modified` response
+	 * with the stored body.
+	 * \returns `false` if the response is a `304 Not Modified` for a response
+	 * which is no longer stored. It is then turned into a
+	 * QNetworkReply::ContentReSendError failure, and the request has to be
+	 * sent again without `If-None-Match`.
+	 */
+	bool update(const QString& key, QDiscordResponse& response);
+	/*!
+	 * \brief Removes the responses for the provided URL and all URLs below it,
+	 * such as `channels/1/messages` for `channels/1`.
+	 * \param url The URL to remove.
+	 * \param descendants Whether to remove the URLs below it as well.
+	 * Responses for the URL with a query are removed either way.
+	 */
+	void invalidate(const QUrl& url, bool descendants = true);
+	///\brief Removes all responses.
+	void clear() {_entries.clear();}
+	///\brief Returns how often a fresh response was found.
+	quint64 hits() const {return _hits;}
+	///\brief Returns how often no fresh response was found.
+	quint64 misses() const {return _misses;}
+	///\brief Returns how often an expired response was confirmed with `304`.
+	quint64 revalidations() const {return _revalidations;}
+	///\brief Sets all statistics back to 0.
+	void resetStatistics();
+private:
+	Q_DISABLE_COPY(QDiscordResponseCache)
+	struct Entry
+	{
+		QDiscordResponse response;
+		QByteArray etag;
+		qint64 expiresAt;
+	};
+	QCache<QString, Entry> _entries;
+	QElapsedTimer _clock;
+	qint64 _timeToLive;
+	quint64 _hits;
+	quint64 _misses;
+	quint64 _revalidations;
+};
+
+#endif // QDISCORDRESPONSECACHE_HPP
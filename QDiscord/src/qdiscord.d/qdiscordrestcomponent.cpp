@@ -17,13 +17,15 @@
  */
 
 #include "qdiscordrestcomponent.hpp"
-#include <QBuffer>
 #include <QMap>
+#include <QUrlQuery>
 
 QDiscordRestComponent::QDiscordRestComponent(QObject* parent) : QObject(parent)
 {
-	_authentication = "";
 	_self = QSharedPointer<QDiscordUser>();
+	_priority = QDiscordRateLimiter::Priority::Normal;
+	connect(_pipeline.rateLimiter(), &QDiscordRateLimiter::rateLimited,
+			this, &QDiscordRestComponent::rateLimited);
 
 	if(QDiscordUtilities::debugMode)
 		qDebug()<<this<<"constructed";
@@ -34,41 +36,28 @@ void QDiscordRestComponent::login(const QString& email, const QString& password)
 	QJsonObject object;
 	object["email"] = email;
 	object["password"] = password;
-	post(object, QDiscordUtilities::endPoints.login,
-	[=](){
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-		if(!reply)
-			return;
-		if(reply->error() != QNetworkReply::NoError)
-			emit loginFailed(reply->error());
-		else
-		{
-			_authentication =
-					QJsonDocument::fromJson(
-							reply->readAll()
-						).object().value("token").toString();
-			emit tokenVerified(_authentication);
-		}
-		reply->deleteLater();
+	_pipeline.send<QJsonObject>(
+				QDiscordRequest::post(QDiscordUtilities::endPoints.login, object),
+	[=](const QJsonObject& result){
+		_pipeline.setAuthorization(result.value("token").toString());
+		emit tokenVerified(_pipeline.authorization());
+	},
+	[=](QNetworkReply::NetworkError error){
+		emit loginFailed(error);
 	});
 }
 
 void QDiscordRestComponent::login(const QString& token)
 {
-	_authentication = "Bot "+token;
-	get(QDiscordUtilities::endPoints.me,
-	[=](){
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-		if(!reply)
-			return;
-		if(reply->error() != QNetworkReply::NoError)
-		{
-			_authentication = "";
-			emit loginFailed(reply->error());
-		}
-		else
-			emit tokenVerified(_authentication);
-		reply->deleteLater();
+	_pipeline.setAuthorization("Bot "+token);
+	_pipeline.send<QDiscordResponse>(
+				QDiscordRequest::get(QDiscordUtilities::endPoints.me),
+	[=](const QDiscordResponse&){
+		emit tokenVerified(_pipeline.authorization());
+	},
+	[=](QNetworkReply::NetworkError error){
+		_pipeline.setAuthorization(QString());
+		emit loginFailed(error);
 	});
 }
 
@@ -76,80 +65,63 @@ void QDiscordRestComponent::sendMessage(const QString& content,
 										QSharedPointer<QDiscordChannel> channel,
 										bool tts)
 {
-	if(_authentication.isEmpty())
+	if(!channel || _pipeline.authorization().isEmpty())
 		return;
 
-	if(!channel)
-		return;
+	reportMessage(postMessage(content, channel->id(), tts, channel));
+}
 
-	QString id = channel->id();
-	QJsonObject object;
-	object["content"] = content;
+void QDiscordRestComponent::sendMessage(const QString& content,
+										const QString& channelId,
+										bool tts)
+{
+	if(_pipeline.authorization().isEmpty())
+		return;
 
-	if(tts)
-		object["tts"] = true;
+	reportMessage(postMessage(content, channelId, tts,
+							  QSharedPointer<QDiscordChannel>()));
+}
 
-	post(object,
-		 QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" +
-					  id + "/messages"
-				  )),
-	[=]()
+QDiscordFuture<QDiscordMessage>
+QDiscordRestComponent::sendMessageFuture(const QString& content,
+										 QSharedPointer<QDiscordChannel> channel,
+										 bool tts)
+{
+	if(!channel)
 	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
+		return QDiscordFuture<QDiscordMessage>::rejected(
+					QNetworkReply::ContentNotFoundError);
+	}
 
-		if(!reply)
-			return;
+	return postMessage(content, channel->id(), tts, channel);
+}
 
-		if(reply->error() != QNetworkReply::NoError)
-			emit messageSendFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordMessage message(object, channel);
-			emit messageSent(message);
-		}
-		reply->deleteLater();
-	});
+QDiscordFuture<QDiscordMessage>
+QDiscordRestComponent::sendMessageFuture(const QString& content,
+										 const QString& channelId, bool tts)
+{
+	return postMessage(content, channelId, tts,
+					   QSharedPointer<QDiscordChannel>());
 }
 
 void QDiscordRestComponent::sendMessage(const QString& content,
 										const QString& channelId,
-										bool tts)
+										const QDiscordUpload& upload, bool tts)
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
 
-	QJsonObject object;
-	object["content"] = content;
-
-	if(tts)
-		object["tts"] = true;
-
-	post(object,
-		 QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" +
-					  channelId + "/messages"
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
+	reportMessage(postMessage(content, channelId, tts,
+							  QSharedPointer<QDiscordChannel>(), &upload));
+}
 
-		if(reply->error() != QNetworkReply::NoError)
-			emit messageSendFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordMessage message(object, QSharedPointer<QDiscordChannel>());
-			emit messageSent(message);
-		}
-		reply->deleteLater();
-	});
+QDiscordFuture<QDiscordMessage>
+QDiscordRestComponent::sendMessageFuture(const QString& content,
+										 const QString& channelId,
+										 const QDiscordUpload& upload, bool tts)
+{
+	return postMessage(content, channelId, tts,
+					   QSharedPointer<QDiscordChannel>(), &upload);
 }
 
 void QDiscordRestComponent::deleteMessage(QDiscordMessage message)
@@ -160,21 +132,33 @@ void QDiscordRestComponent::deleteMessage(QDiscordMessage message)
 void QDiscordRestComponent::deleteMessage(const QString& messageId,
 										  const QString& channelId)
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
-	deleteResource(QUrl(QString(
+	deleteMessageFuture(messageId, channelId)
+	.then([this](const QString& id){
+		emit messageDeleted(id);
+	})
+	.fail([this](QNetworkReply::NetworkError error){
+		emit messageDeleteFailed(error);
+	});
+}
+
+QDiscordFuture<QString>
+QDiscordRestComponent::deleteMessageFuture(const QString& messageId,
+										   const QString& channelId)
+{
+	if(_pipeline.authorization().isEmpty())
+	{
+		return QDiscordFuture<QString>::rejected(
+					QNetworkReply::AuthenticationRequiredError);
+	}
+	return _pipeline.send<QDiscordResponse>(
+				QDiscordRequest::deleteResource(QUrl(QString(
 								QDiscordUtilities::endPoints.channels + "/" +
 								channelId + "/messages/" + messageId
-							)),
-	[=](){
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-		if(!reply)
-			return;
-		if(reply->error() != QNetworkReply::NoError)
-			emit messageDeleteFailed(reply->error());
-		else
-			emit messageDeleted(messageId);
-		reply->deleteLater();
+							))))
+	.then([messageId](const QDiscordResponse&){
+		return messageId;
 	});
 }
 
@@ -196,63 +180,61 @@ void QDiscordRestComponent::bulkDeleteMessages(const QList<QDiscordMessage> mess
 }
 
 void QDiscordRestComponent::bulkDeleteMessages(const QStringList &messageIds, const QString &channelId)
+{
+	bulkDeleteMessagesFuture(messageIds, channelId)
+	.then([this](const QStringList& ids){
+		emit bulkDeleteSuccess(ids);
+	})
+	.fail([this](QNetworkReply::NetworkError error){
+		emit bulkDeleteFailed(error);
+	});
+}
+
+QDiscordFuture<QStringList>
+QDiscordRestComponent::bulkDeleteMessagesFuture(const QStringList& messageIds,
+												const QString& channelId)
 {
 	QJsonObject toDelete;
 	toDelete["messages"] = QJsonArray::fromStringList(messageIds);
-	post(toDelete,QUrl(QString(
-						   QDiscordUtilities::endPoints.channels + "/" +
-						   channelId + "/messages/bulk-delete"
-					   )),
-	[=](){
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-		if(!reply)
-			return;
-		if(reply->error() != QNetworkReply::NoError)
-			emit bulkDeleteFailed(reply->error());
-		else
-			emit bulkDeleteSuccess(messageIds);
-		reply->deleteLater();
+	QDiscordRequest request =
+			QDiscordRequest::post(QUrl(QString(
+						QDiscordUtilities::endPoints.channels + "/" +
+						channelId + "/messages/bulk-delete"
+					)), toDelete);
+	request.setPriority(QDiscordRateLimiter::Priority::Bulk);
+
+	return _pipeline.send<QDiscordResponse>(request)
+	.then([messageIds](const QDiscordResponse&){
+		return messageIds;
 	});
 }
 
 void QDiscordRestComponent::logout()
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
 	_self.reset();
 	QJsonObject object;
-	object["token"] = _authentication;
-	_authentication = "";
-	post(object, QDiscordUtilities::endPoints.logout,
-	[=](){
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-		if(!reply)
-			return;
+	object["token"] = _pipeline.authorization();
+	_pipeline.setAuthorization(QString());
+	_pipeline.send(QDiscordRequest::post(QDiscordUtilities::endPoints.logout,
+										 object),
+	[=](const QDiscordResponse&){
 		emit loggedOut();
-		reply->deleteLater();
 	});
 }
 
 void QDiscordRestComponent::getEndpoint()
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
-	get(QDiscordUtilities::endPoints.gateway,
-	[=](){
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-		if(!reply)
-			return;
-		if(reply->error() != QNetworkReply::NoError)
-			emit endpointAcquireFailed(reply->error());
-		else
-		{
-			emit endpointAcquired(
-							QJsonDocument::fromJson(
-									reply->readAll()
-								).object().value("url").toString()
-						);
-		}
-		reply->deleteLater();
+	_pipeline.send<QJsonObject>(
+				QDiscordRequest::get(QDiscordUtilities::endPoints.gateway),
+	[=](const QJsonObject& object){
+		emit endpointAcquired(object.value("url").toString());
+	},
+	[=](QNetworkReply::NetworkError error){
+		emit endpointAcquireFailed(error);
 	});
 }
 
@@ -260,68 +242,28 @@ void
 QDiscordRestComponent::setChannelName(const QString& name,
 										QSharedPointer<QDiscordChannel> channel)
 {
-	if(_authentication.isEmpty())
-		return;
-
 	if(!channel)
 		return;
 
-	QJsonObject object;
-	object["name"] = name;
-
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channel->id()
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
-
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
-	});
+	setChannelName(name, channel->id());
 }
 
 void QDiscordRestComponent::setChannelName(const QString& name,
 										   const QString& channelId)
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
 
+	updateChannel(setChannelNameFuture(name, channelId));
+}
+
+QDiscordFuture<QDiscordChannel>
+QDiscordRestComponent::setChannelNameFuture(const QString& name,
+											const QString& channelId)
+{
 	QJsonObject object;
 	object["name"] = name;
-
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channelId
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
-
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
-	});
+	return modifyChannel(object, channelId);
 }
 
 void QDiscordRestComponent::setChannelPosition(
@@ -329,68 +271,28 @@ void QDiscordRestComponent::setChannelPosition(
 			QSharedPointer<QDiscordChannel> channel
 		)
 {
-	if(_authentication.isEmpty())
-		return;
-
 	if(!channel)
 		return;
 
-	QJsonObject object;
-	object["position"] = position;
-
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channel->id()
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
-
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
-	});
+	setChannelPosition(position, channel->id());
 }
 
 void QDiscordRestComponent::setChannelPosition(int position,
 											   const QString& channelId)
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
 
+	updateChannel(setChannelPositionFuture(position, channelId));
+}
+
+QDiscordFuture<QDiscordChannel>
+QDiscordRestComponent::setChannelPositionFuture(int position,
+												const QString& channelId)
+{
 	QJsonObject object;
 	object["position"] = position;
-
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channelId
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
-
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
-	});
+	return modifyChannel(object, channelId);
 }
 
 void QDiscordRestComponent::setChannelTopic(
@@ -398,71 +300,31 @@ void QDiscordRestComponent::setChannelTopic(
 			QSharedPointer<QDiscordChannel> channel
 		)
 {
-	if(_authentication.isEmpty())
-		return;
-
 	if(!channel)
 		return;
 
 	if(channel->type() != QDiscordChannel::ChannelType::Text)
 		return;
 
-	QJsonObject object;
-	object["topic"] = topic;
-
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channel->id()
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
-
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
-	});
+	setChannelTopic(topic, channel->id());
 }
 
 void QDiscordRestComponent::setChannelTopic(const QString& topic,
 											const QString& channelId)
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
 
+	updateChannel(setChannelTopicFuture(topic, channelId));
+}
+
+QDiscordFuture<QDiscordChannel>
+QDiscordRestComponent::setChannelTopicFuture(const QString& topic,
+											 const QString& channelId)
+{
 	QJsonObject object;
 	object["topic"] = topic;
-
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channelId
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
-
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
-	});
+	return modifyChannel(object, channelId);
 }
 
 void QDiscordRestComponent::setChannelBitrate(
@@ -470,71 +332,31 @@ void QDiscordRestComponent::setChannelBitrate(
 			QSharedPointer<QDiscordChannel> channel
 		)
 {
-	if(_authentication.isEmpty())
-		return;
-
 	if(!channel)
 		return;
 
 	if(channel->type() != QDiscordChannel::ChannelType::Voice)
 		return;
 
-	QJsonObject object;
-	object["bitrate"] = bitrate;
-
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channel->id()
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
-
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
-	});
+	setChannelBitrate(bitrate, channel->id());
 }
 
 void QDiscordRestComponent::setChannelBitrate(int bitrate,
 											  const QString& channelId)
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
 
+	updateChannel(setChannelBitrateFuture(bitrate, channelId));
+}
+
+QDiscordFuture<QDiscordChannel>
+QDiscordRestComponent::setChannelBitrateFuture(int bitrate,
+											   const QString& channelId)
+{
 	QJsonObject object;
 	object["bitrate"] = bitrate;
-
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channelId
-				  )),
-	[=]()
-	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
-
-		if(!reply)
-			return;
-
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
-	});
+	return modifyChannel(object, channelId);
 }
 
 void QDiscordRestComponent::setChannelUserLimit(
@@ -542,70 +364,170 @@ void QDiscordRestComponent::setChannelUserLimit(
 		QSharedPointer<QDiscordChannel> channel
 		)
 {
-	if(_authentication.isEmpty())
-		return;
-
 	if(!channel)
 		return;
 
 	if(channel->type() != QDiscordChannel::ChannelType::Voice)
 		return;
 
+	setChannelUserLimit(limit, channel->id());
+}
+
+void QDiscordRestComponent::setChannelUserLimit(int limit,
+												const QString& channelId)
+{
+	if(_pipeline.authorization().isEmpty())
+		return;
+
+	updateChannel(setChannelUserLimitFuture(limit, channelId));
+}
+
+QDiscordFuture<QDiscordChannel>
+QDiscordRestComponent::setChannelUserLimitFuture(int limit,
+												 const QString& channelId)
+{
 	QJsonObject object;
 	object["user_limit"] = limit;
+	return modifyChannel(object, channelId);
+}
 
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channel->id()
-				  )),
-	[=]()
+void QDiscordRestComponent::getUser(const QString& userId)
+{
+	if(_pipeline.authorization().isEmpty())
+		return;
+
+	getUserFuture(userId)
+	.then([this](const QDiscordUser& user){
+		emit userReceived(user);
+	})
+	.fail([this, userId](QNetworkReply::NetworkError error){
+		emit userReceiveFailed(userId, error);
+	});
+}
+
+QDiscordFuture<QDiscordUser>
+QDiscordRestComponent::getUserFuture(const QString& userId)
+{
+	if(_pipeline.authorization().isEmpty())
 	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
+		return QDiscordFuture<QDiscordUser>::rejected(
+					QNetworkReply::AuthenticationRequiredError);
+	}
 
-		if(!reply)
-			return;
+	QDiscordRequest request = QDiscordRequest::get(QUrl(QString(
+			QDiscordUtilities::endPoints.users + "/" + userId
+		)));
+	request.setPriority(_priority);
 
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
-		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
-		}
-		reply->deleteLater();
+	return _pipeline.send<QDiscordUser>(request);
+}
+
+void QDiscordRestComponent::getChannel(const QString& channelId)
+{
+	if(_pipeline.authorization().isEmpty())
+		return;
+
+	getChannelFuture(channelId)
+	.then([this](const QDiscordChannel& channel){
+		emit channelReceived(channel);
+	})
+	.fail([this, channelId](QNetworkReply::NetworkError error){
+		emit channelReceiveFailed(channelId, error);
 	});
 }
 
-void QDiscordRestComponent::setChannelUserLimit(int limit,
-												const QString& channelId)
+QDiscordFuture<QDiscordChannel>
+QDiscordRestComponent::getChannelFuture(const QString& channelId)
+{
+	if(_pipeline.authorization().isEmpty())
+	{
+		return QDiscordFuture<QDiscordChannel>::rejected(
+					QNetworkReply::AuthenticationRequiredError);
+	}
+
+	QDiscordRequest request = QDiscordRequest::get(QUrl(QString(
+			QDiscordUtilities::endPoints.channels + "/" + channelId
+		)));
+	request.setPriority(_priority);
+
+	return _pipeline.send<QDiscordChannel>(request);
+}
+
+void QDiscordRestComponent::getGuild(const QString& guildId)
 {
-	if(_authentication.isEmpty())
+	if(_pipeline.authorization().isEmpty())
 		return;
 
-	QJsonObject object;
-	object["user_limit"] = limit;
+	getGuildFuture(guildId)
+	.then([this](const QDiscordGuild& guild){
+		emit guildReceived(guild);
+	})
+	.fail([this, guildId](QNetworkReply::NetworkError error){
+		emit guildReceiveFailed(guildId, error);
+	});
+}
 
-	patch(object, QUrl(QString(
-					  QDiscordUtilities::endPoints.channels + "/" + channelId
-				  )),
-	[=]()
+QDiscordFuture<QDiscordGuild>
+QDiscordRestComponent::getGuildFuture(const QString& guildId)
+{
+	if(_pipeline.authorization().isEmpty())
 	{
-		QNetworkReply* reply = static_cast<QNetworkReply*>(sender());
+		return QDiscordFuture<QDiscordGuild>::rejected(
+					QNetworkReply::AuthenticationRequiredError);
+	}
 
-		if(!reply)
-			return;
+	QDiscordRequest request = QDiscordRequest::get(QUrl(QString(
+			QDiscordUtilities::endPoints.servers + "/" + guildId
+		)));
+	request.setPriority(_priority);
 
-		if(reply->error() != QNetworkReply::NoError)
-			emit channelUpdateFailed(reply->error());
-		else
+	return _pipeline.send<QDiscordGuild>(request);
+}
+
+QDiscordFuture<QDiscordMessageHistory::Page>
+QDiscordRestComponent::getMessagesFuture(
+		const QString& channelId, QDiscordMessageHistory::Direction direction,
+		const QString& messageId, int limit)
+{
+	if(_pipeline.authorization().isEmpty())
+	{
+		return QDiscordFuture<QDiscordMessageHistory::Page>::rejected(
+					QNetworkReply::AuthenticationRequiredError);
+	}
+
+	QUrlQuery query;
+	query.addQueryItem("limit", QString::number(qBound(1, limit, 100)));
+	if(!messageId.isEmpty())
+	{
+		switch(direction)
 		{
-			QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-			QJsonObject object = document.object();
-			QDiscordChannel updatedChannel(object);
-			emit channelUpdated(updatedChannel);
+		case QDiscordMessageHistory::Direction::Before:
+			query.addQueryItem("before", messageId);
+			break;
+		case QDiscordMessageHistory::Direction::After:
+			query.addQueryItem("after", messageId);
+			break;
+		case QDiscordMessageHistory::Direction::Around:
+			query.addQueryItem("around", messageId);
+			break;
 		}
-		reply->deleteLater();
+	}
+	QUrl url(QDiscordUtilities::endPoints.channels + "/" + channelId +
+			 "/messages");
+	url.setQuery(query);
+	QDiscordRequest request = QDiscordRequest::get(url);
+	//Pages are large and rarely read twice, so they would only push useful
+	//responses out of the cache.
+	request.setCacheable(false);
+	request.setPriority(_priority);
+
+	return _pipeline.send<QJsonArray>(request)
+	.then([](const QJsonArray& array){
+		QDiscordMessageHistory::Page page;
+		page.reserve(array.size());
+		for(const QJsonValue& value : array)
+			page.append(QDiscordMessage(value.toObject()));
+		return page;
 	});
 }
 
@@ -614,135 +536,77 @@ void QDiscordRestComponent::selfCreated(QSharedPointer<QDiscordUser> self)
 	_self = self;
 }
 
-void QDiscordRestComponent::deleteResource(const QUrl& url,
-										   std::function<void()> function)
+QDiscordFuture<QDiscordMessage>
+QDiscordRestComponent::postMessage(const QString& content,
+								   const QString& channelId, bool tts,
+								   QSharedPointer<QDiscordChannel> channel,
+								   const QDiscordUpload* upload)
 {
-	QString userAgent = "DiscordBot (" + QDiscordUtilities::libLink +
-						", v" + QDiscordUtilities::libMajor + ":" +
-						QDiscordUtilities::libMinor + ")" +
-						"; " + QDiscordUtilities::botName;
-	QNetworkRequest request(url);
-	if(_authentication != "")
-		request.setRawHeader("Authorization", _authentication.toUtf8());
-	request.setRawHeader("User-Agent", userAgent.toUtf8());
-	connect(_manager.deleteResource(request), &QNetworkReply::finished,
-			this, function);
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<this<<"DELETE to "<<url;
-}
-
-void QDiscordRestComponent::patch(const QJsonObject &object, const QUrl &url, std::function<void ()> function)
-{
-	QString userAgent = "DiscordBot (" + QDiscordUtilities::libLink +
-						", v" + QDiscordUtilities::libMajor + ":" +
-						QDiscordUtilities::libMinor + ")" +
-						"; " + QDiscordUtilities::botName;
-	QJsonDocument document;
-	document.setObject(object);
-	QNetworkRequest request(url);
-	if(_authentication != "")
-		request.setRawHeader("Authorization", _authentication.toUtf8());
-	request.setRawHeader("User-Agent", userAgent.toUtf8());
-	request.setRawHeader("content-type", "application/json");
-	QBuffer *buffer = new QBuffer();
-	buffer->open(QBuffer::ReadWrite);
-	buffer->write(document.toJson(QJsonDocument::Compact));
-	buffer->seek(0);
-	QNetworkReply* reply =
-			_manager.sendCustomRequest(request, "PATCH", buffer);
-	connect(reply, &QNetworkReply::finished, buffer, &QBuffer::deleteLater);
-	connect(reply, &QNetworkReply::finished, this, function);
+	if(_pipeline.authorization().isEmpty())
+	{
+		return QDiscordFuture<QDiscordMessage>::rejected(
+					QNetworkReply::AuthenticationRequiredError);
+	}
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<this<<"patch: "<<object<<" to "<<url;
-}
-
-void QDiscordRestComponent::patch(const QJsonArray &array, const QUrl &url, std::function<void ()> function)
-{
-	QString userAgent = "DiscordBot (" + QDiscordUtilities::libLink +
-						", v" + QDiscordUtilities::libMajor + ":" +
-						QDiscordUtilities::libMinor + ")" +
-						"; " + QDiscordUtilities::botName;
-	QJsonDocument document;
-	document.setArray(array);
-	QNetworkRequest request(url);
-	if(_authentication != "")
-		request.setRawHeader("Authorization", _authentication.toUtf8());
-	request.setRawHeader("User-Agent", userAgent.toUtf8());
-	request.setRawHeader("content-type", "application/json");
-	QBuffer *buffer = new QBuffer();
-	buffer->open(QBuffer::ReadWrite);
-	buffer->write(document.toJson(QJsonDocument::Compact));
-	buffer->seek(0);
-	QNetworkReply* reply =
-			_manager.sendCustomRequest(request, "PATCH", buffer);
-	connect(reply, &QNetworkReply::finished, buffer, &QBuffer::deleteLater);
-	connect(reply, &QNetworkReply::finished, this, function);
+	QJsonObject object;
+	object["content"] = content;
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<this<<"patch: "<<array<<" to "<<url;
-}
-
-void QDiscordRestComponent::post(const QJsonObject& object,
-								 const QUrl& url,
-								 std::function<void()> function)
-{
-	QString userAgent = "DiscordBot (" + QDiscordUtilities::libLink +
-						", v" + QDiscordUtilities::libMajor + ":" +
-						QDiscordUtilities::libMinor + ")" +
-						"; " + QDiscordUtilities::botName;
-	QJsonDocument document;
-	document.setObject(object);
-	QNetworkRequest request(url);
-	if(_authentication != "")
-		request.setRawHeader("Authorization", _authentication.toUtf8());
-	request.setRawHeader("User-Agent", userAgent.toUtf8());
-	request.setRawHeader("content-type", "application/json");
-	QNetworkReply* reply =
-			_manager.post(request, document.toJson(QJsonDocument::Compact));
-	connect(reply, &QNetworkReply::finished, this, function);
+	if(tts)
+		object["tts"] = true;
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<this<<"posted: "<<object<<" to "<<url;
-}
-
-void QDiscordRestComponent::post(const QJsonArray& array,
-								 const QUrl& url,
-								 std::function<void()> function)
-{
-	QString userAgent = "DiscordBot (" + QDiscordUtilities::libLink +
-						", v" + QDiscordUtilities::libMajor + ":" +
-						QDiscordUtilities::libMinor + ")" +
-						"; " + QDiscordUtilities::botName;
-	QJsonDocument document;
-	document.setArray(array);
-	QNetworkRequest request(url);
-	if(_authentication != "")
-		request.setRawHeader("Authorization", _authentication.toUtf8());
-	request.setRawHeader("User-Agent", userAgent.toUtf8());
-	request.setRawHeader("content-type", "application/json");
-	QNetworkReply* reply =
-			_manager.post(request, document.toJson(QJsonDocument::Compact));
-	connect(reply, &QNetworkReply::finished, this, function);
+	QUrl url(QString(QDiscordUtilities::endPoints.channels + "/" +
+					 channelId + "/messages"));
+	QDiscordRequest request = QDiscordRequest::post(url, object);
+	if(upload)
+	{
+		QDiscordUpload files = *upload;
+		files.setPayload(object);
+		request = QDiscordRequest::post(url, files);
+	}
+	request.setPriority(QDiscordRateLimiter::Priority::Interactive);
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<this<<"posted: "<<array<<" to "<<url;
+	return _pipeline.send<QJsonObject>(request)
+	.then([channel](const QJsonObject& result){
+		return QDiscordMessage(result, channel);
+	});
 }
 
-void QDiscordRestComponent::get(const QUrl& url,
-								std::function<void()> function)
+QDiscordFuture<QDiscordChannel>
+QDiscordRestComponent::modifyChannel(const QJsonObject& object,
+									 const QString& channelId)
 {
-	QString userAgent = "DiscordBot (" + QDiscordUtilities::libLink +
-						", v" + QDiscordUtilities::libMajor + ":" +
-						QDiscordUtilities::libMinor + ")" +
-						"; " + QDiscordUtilities::botName;
-	QNetworkRequest request(url);
-	if(_authentication != "")
-		request.setRawHeader("Authorization", _authentication.toUtf8());
-	request.setRawHeader("User-Agent", userAgent.toUtf8());
-	QNetworkReply* reply = _manager.get(request);
-	connect(reply, &QNetworkReply::finished, this, function);
+	if(_pipeline.authorization().isEmpty())
+	{
+		return QDiscordFuture<QDiscordChannel>::rejected(
+					QNetworkReply::AuthenticationRequiredError);
+	}
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<this<<"GET to "<<url;
+	QDiscordRequest request = QDiscordRequest::patch(QUrl(QString(
+			QDiscordUtilities::endPoints.channels + "/" + channelId
+		)), object);
+	request.setPriority(_priority);
+
+	return _pipeline.send<QDiscordChannel>(request);
+}
+
+void QDiscordRestComponent::reportMessage(
+		const QDiscordFuture<QDiscordMessage>& future)
+{
+	future.then([this](const QDiscordMessage& message){
+		emit messageSent(message);
+	})
+	.fail([this](QNetworkReply::NetworkError error){
+		emit messageSendFailed(error);
+	});
+}
+
+void QDiscordRestComponent::updateChannel(
+		const QDiscordFuture<QDiscordChannel>& future)
+{
+	future.then([this](const QDiscordChannel& channel){
+		emit channelUpdated(channel);
+	})
+	.fail([this](QNetworkReply::NetworkError error){
+		emit channelUpdateFailed(error);
+	});
 }
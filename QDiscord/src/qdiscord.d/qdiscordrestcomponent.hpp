@@ -23,11 +23,14 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
-#include <QNetworkAccessManager>
 #include <functional>
+#include "qdiscordfuture.hpp"
 #include "qdiscordmessage.hpp"
+#include "qdiscordmessagehistory.hpp"
+#include "qdiscordrequestpipeline.hpp"
 #include "qdiscordutilities.hpp"
 #include "qdiscordchannel.hpp"
+#include "qdiscordguild.hpp"
 #include "qdiscorduser.hpp"
 
 class QDiscord;
@@ -35,7 +38,19 @@ class QDiscord;
 /*!
  * \brief The REST component of QDiscord.
  *
- * This class handles all REST operations to the Discord API.
+ * This class handles all REST operations to the Discord API.\n
+ * All requests are sent through a QDiscordRequestPipeline, which queues
+ * requests exceeding Discord's rate limits locally instead of having them
+ * rejected.\n
+ * Most requests come in two variants. The plain one reports its result
+ * through this class's signals, which every connected receiver has to filter.
+ * The one ending in `Future` returns a QDiscordFuture resolving to the
+ * result of that request only, and emits no signals. Its future fails with
+ * QNetworkReply::AuthenticationRequiredError if not logged in.\n
+ * Messages are sent with QDiscordRateLimiter::Priority::Interactive and bulk
+ * deletes with QDiscordRateLimiter::Priority::Bulk. All other requests use
+ * the priority set with setPriority(), so mass edits can be kept from
+ * delaying replies to users.
  */
 class QDISCORD_API QDiscordRestComponent : public QObject
 {
@@ -81,14 +96,57 @@ public:
 	 * \param tts Whether to use text to speech when sending the message.
 	 */
 	void sendMessage(const QString& content, const QString& channelId, bool tts = false);
+	/*!
+	 * \brief Sends a message to the specified channel.
+	 * \returns A future for the sent message. It fails with
+	 * QNetworkReply::ContentNotFoundError if the channel pointer is NULL.
+	 */
+	QDiscordFuture<QDiscordMessage>
+	sendMessageFuture(const QString& content,
+					  QSharedPointer<QDiscordChannel> channel,
+					  bool tts = false);
+	///\brief Sends a message to the specified channel ID.
+	QDiscordFuture<QDiscordMessage>
+	sendMessageFuture(const QString& content, const QString& channelId,
+					  bool tts = false);
+	/*!
+	 * \brief Sends a message with attached files to the specified channel ID.
+	 *
+	 * The files are streamed while the message is sent. Their progress is
+	 * reported to the upload's QDiscordUpload::progressHandler.
+	 * \param content The message's contents. May be empty.
+	 * \param channelId The channel to send the message in.
+	 * \param upload The files to attach. Its payload is replaced by the
+	 * message.
+	 * \param tts Whether to use text to speech when sending the message.
+	 */
+	void sendMessage(const QString& content, const QString& channelId,
+					 const QDiscordUpload& upload, bool tts = false);
+	///\brief Sends a message with attached files to the specified channel ID.
+	QDiscordFuture<QDiscordMessage>
+	sendMessageFuture(const QString& content, const QString& channelId,
+					  const QDiscordUpload& upload, bool tts = false);
 	///\brief Deletes the specified message.
 	void deleteMessage(QDiscordMessage message);
 	///\brief Deletes the specified message by ID and channel ID.
 	void deleteMessage(const QString& messageId, const QString& channelId);
+	/*!
+	 * \brief Deletes the specified message by ID and channel ID.
+	 * \returns A future for the deleted message's ID.
+	 */
+	QDiscordFuture<QString> deleteMessageFuture(const QString& messageId,
+												const QString& channelId);
 	///\brief Deletes the specified messages(multi-channel).
 	void bulkDeleteMessages(QList<QDiscordMessage> messages);
 	///\brief Deletes the specified messages by ID and channel ID.
 	void bulkDeleteMessages(const QStringList& messageIds, const QString& channelId);
+	/*!
+	 * \brief Deletes the specified messages by ID and channel ID.
+	 * \returns A future for the deleted messages' IDs.
+	 */
+	QDiscordFuture<QStringList>
+	bulkDeleteMessagesFuture(const QStringList& messageIds,
+							 const QString& channelId);
 	///\brief Logs out using the stored token.
 	void logout();
 	///\brief Sends a request to receive an endpoint for connecting using a WebSocket.
@@ -97,26 +155,125 @@ public:
 	void setChannelName(const QString& name, QSharedPointer<QDiscordChannel> channel);
 	///\brief Changes the name of the channel with specified ID.
 	void setChannelName(const QString& name, const QString& channelId);
+	/*!
+	 * \brief Changes the name of the channel with the specified ID.
+	 * \returns A future for the updated channel.
+	 */
+	QDiscordFuture<QDiscordChannel>
+	setChannelNameFuture(const QString& name,
+						 const QString& channelId);
 	///\brief Changes the position of the specified text channel on the channel list.
 	void setChannelPosition(int position,
 							QSharedPointer<QDiscordChannel> channel);
 	///\brief Changes the position of the text channel with the specified ID on the channel list.
 	void setChannelPosition(int position, const QString& channelId);
+	/*!
+	 * \brief Changes the position of the text channel with the specified ID.
+	 * \returns A future for the updated channel.
+	 */
+	QDiscordFuture<QDiscordChannel>
+	setChannelPositionFuture(int position,
+							 const QString& channelId);
 	///\brief Changes the topic of the specified text channel.
 	void setChannelTopic(const QString& topic,
 						 QSharedPointer<QDiscordChannel> channel);
 	///\brief Changes the topic of the text channel with the specified ID.
 	void setChannelTopic(const QString& topic, const QString& channelId);
+	/*!
+	 * \brief Changes the topic of the text channel with the specified ID.
+	 * \returns A future for the updated channel.
+	 */
+	QDiscordFuture<QDiscordChannel>
+	setChannelTopicFuture(const QString& topic,
+						  const QString& channelId);
 	///\brief Changes the bitrate of the specified voice channel.
 	void setChannelBitrate(int bitrate,
 						   QSharedPointer<QDiscordChannel> channel);
 	///\brief Changes the bitrate of the voice channel with the specified ID.
 	void setChannelBitrate(int bitrate, const QString& channelId);
+	/*!
+	 * \brief Changes the bitrate of the voice channel with the specified ID.
+	 * \returns A future for the updated channel.
+	 */
+	QDiscordFuture<QDiscordChannel>
+	setChannelBitrateFuture(int bitrate,
+							const QString& channelId);
 	///\brief Changes the user limit on the specified voice channel.
 	void setChannelUserLimit(int limit,
 							 QSharedPointer<QDiscordChannel> channel);
 	///\brief Changes the user limit of the voice channel with the specified ID.
 	void setChannelUserLimit(int limit, const QString& channelId);
+	/*!
+	 * \brief Changes the user limit of the voice channel with the specified ID.
+	 * \returns A future for the updated channel.
+	 */
+	QDiscordFuture<QDiscordChannel>
+	setChannelUserLimitFuture(int limit,
+							  const QString& channelId);
+	/*!
+	 * \brief Requests the user with the specified ID.
+	 *
+	 * Concurrent requests for the same user share a single request, and
+	 * recent responses are answered from QDiscordRequestPipeline::responseCache.
+	 */
+	void getUser(const QString& userId);
+	///\brief Requests the user with the specified ID.
+	QDiscordFuture<QDiscordUser> getUserFuture(const QString& userId);
+	/*!
+	 * \brief Requests the channel with the specified ID.
+	 *
+	 * Concurrent requests for the same channel share a single request, and
+	 * recent responses are answered from QDiscordRequestPipeline::responseCache.
+	 */
+	void getChannel(const QString& channelId);
+	///\brief Requests the channel with the specified ID.
+	QDiscordFuture<QDiscordChannel> getChannelFuture(const QString& channelId);
+	/*!
+	 * \brief Requests the guild with the specified ID.
+	 *
+	 * Concurrent requests for the same guild share a single request, and
+	 * recent responses are answered from QDiscordRequestPipeline::responseCache.
+	 */
+	void getGuild(const QString& guildId);
+	///\brief Requests the guild with the specified ID.
+	QDiscordFuture<QDiscordGuild> getGuildFuture(const QString& guildId);
+	/*!
+	 * \brief Requests a page of a channel's messages.
+	 *
+	 * Use QDiscordMessageHistory to read more than a single page.
+	 * \param channelId The channel to read.
+	 * \param direction Whether to read messages before, after or around the
+	 * provided message.
+	 * \param messageId The message to read from. If empty, the newest
+	 * messages are read.
+	 * \param limit The maximum amount of messages, up to 100.
+	 * \returns A future for the messages, newest first.
+	 */
+	QDiscordFuture<QDiscordMessageHistory::Page>
+	getMessagesFuture(const QString& channelId,
+					  QDiscordMessageHistory::Direction direction =
+					  QDiscordMessageHistory::Direction::Before,
+					  const QString& messageId = QString(), int limit = 100);
+	///\brief Returns the pipeline all requests are sent through.
+	QDiscordRequestPipeline* pipeline() {return &_pipeline;}
+	///\brief Returns the rate limiter all requests are sent through.
+	QDiscordRateLimiter* rateLimiter() {return _pipeline.rateLimiter();}
+	/*!
+	 * \brief Returns the priority of requests without a fixed priority.
+	 *
+	 * Defaults to QDiscordRateLimiter::Priority::Normal.
+	 */
+	QDiscordRateLimiter::Priority priority() const {return _priority;}
+	/*!
+	 * \brief Sets the priority of requests without a fixed priority made from
+	 * now on.
+	 *
+	 * For example, set it to QDiscordRateLimiter::Priority::Bulk before
+	 * editing many channels and back afterwards.
+	 */
+	void setPriority(QDiscordRateLimiter::Priority priority) {
+		_priority = priority;
+	}
 
 signals:
 	/*!
@@ -181,17 +338,65 @@ signals:
 	 * may return a more useful string in the context of the Discord API.
 	 */
 	void channelUpdateFailed(QNetworkReply::NetworkError error);
+	///\brief Emitted when a user requested with getUser() has been received.
+	void userReceived(const QDiscordUser& user);
+	/*!
+	 * \brief Emitted when requesting a user has failed.
+	 * \param userId The ID of the requested user.
+	 * \param error A QNetworkReply::NetworkError enum containing more
+	 * information about the reason why this request failed. QDiscordUtilities::networkErrorToString
+	 * may return a more useful string in the context of the Discord API.
+	 */
+	void userReceiveFailed(const QString& userId,
+						   QNetworkReply::NetworkError error);
+	///\brief Emitted when a channel requested with getChannel() has been received.
+	void channelReceived(const QDiscordChannel& channel);
+	/*!
+	 * \brief Emitted when requesting a channel has failed.
+	 * \param channelId The ID of the requested channel.
+	 * \param error A QNetworkReply::NetworkError enum containing more
+	 * information about the reason why this request failed. QDiscordUtilities::networkErrorToString
+	 * may return a more useful string in the context of the Discord API.
+	 */
+	void channelReceiveFailed(const QString& channelId,
+							  QNetworkReply::NetworkError error);
+	///\brief Emitted when a guild requested with getGuild() has been received.
+	void guildReceived(const QDiscordGuild& guild);
+	/*!
+	 * \brief Emitted when requesting a guild has failed.
+	 * \param guildId The ID of the requested guild.
+	 * \param error A QNetworkReply::NetworkError enum containing more
+	 * information about the reason why this request failed. QDiscordUtilities::networkErrorToString
+	 * may return a more useful string in the context of the Discord API.
+	 */
+	void guildReceiveFailed(const QString& guildId,
+							QNetworkReply::NetworkError error);
+	/*!
+	 * \brief Emitted when Discord rejected a request with
+	 * `429 Too Many Requests`.
+	 *
+	 * The request is retried automatically once the limit has passed, so
+	 * this is meant for monitoring. See QDiscordRateLimiter::rateLimited.
+	 * \param route The name of the rejected request's route.
+	 * \param majorParameter The channel, guild or webhook ID of the request.
+	 * \param retryAfter The time in milliseconds before the request is retried.
+	 * \param global Whether all requests are paused, not only the route's.
+	 */
+	void rateLimited(const QString& route, const QString& majorParameter,
+					 qint64 retryAfter, bool global);
 private:
 	void selfCreated(QSharedPointer<QDiscordUser> self);
-	void deleteResource(const QUrl& url, std::function<void()> function);
-	void patch(const QJsonObject& object, const QUrl& url, std::function<void()> function);
-	void patch(const QJsonArray& array, const QUrl& url, std::function<void ()> function);
-	void post(const QJsonObject& object, const QUrl& url, std::function<void()> function);
-	void post(const QJsonArray& array, const QUrl& url, std::function<void ()> function);
-	void get(const QUrl& url, std::function<void ()> function);
+	QDiscordFuture<QDiscordMessage>
+	postMessage(const QString& content, const QString& channelId, bool tts,
+				QSharedPointer<QDiscordChannel> channel,
+				const QDiscordUpload* upload = nullptr);
+	QDiscordFuture<QDiscordChannel> modifyChannel(const QJsonObject& object,
+												  const QString& channelId);
+	void reportMessage(const QDiscordFuture<QDiscordMessage>& future);
+	void updateChannel(const QDiscordFuture<QDiscordChannel>& future);
 	QSharedPointer<QDiscordUser> _self;
-	QString _authentication;
-	QNetworkAccessManager _manager;
+	QDiscordRequestPipeline _pipeline;
+	QDiscordRateLimiter::Priority _priority;
 };
 
 #endif // QDISCORDRESTCOMPONENT_HPP
@@ -16,12 +16,32 @@
  * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <QFileInfo>
 #include "qdiscordstatecomponent.hpp"
 
 QDiscordStateComponent::QDiscordStateComponent(QObject* parent)
 	: QObject(parent)
 {
 	_self = QSharedPointer<QDiscordUser>();
+	connect(&_snapshotTimer, &QTimer::timeout,
+			this, &QDiscordStateComponent::snapshotTimerTimeout);
+	connect(&_recentMemberTimer, &QTimer::timeout,
+			this, &QDiscordStateComponent::recentMemberTimerTimeout);
+	connect(&_memoryReportTimer, &QTimer::timeout,
+			this, &QDiscordStateComponent::memoryReportTimerTimeout);
+	connect(&_staleTimer, &QTimer::timeout,
+			this, &QDiscordStateComponent::staleTimerTimeout);
+	_staleTimer.setSingleShot(true);
+	_staleTimer.setInterval(60000);
+	_viewEnabled = false;
+	_viewPublishScheduled = false;
+	_viewCleared = false;
+	_viewSelfChanged = false;
+	_viewPrivateChannelsChanged = false;
+	_staleModeEnabled = false;
+	_stale = false;
+	_staleReadyReceived = false;
 
 	if(QDiscordUtilities::debugMode)
 		qDebug()<<this<<"constructed";
@@ -32,53 +52,496 @@ QDiscordStateComponent::~QDiscordStateComponent()
 	clear();
 }
 
+QSharedPointer<QDiscordGuild> QDiscordStateComponent::guild(const QString& id)
+{
+	QSharedPointer<QDiscordGuild> guild = _guilds.value(id);
+	if(!guild && _snapshotGuilds.contains(id))
+		guild = loadSnapshotGuild(id);
+	return guild;
+}
+
+QMap<QString, QSharedPointer<QDiscordGuild>> QDiscordStateComponent::guilds()
+{
+	//Loading a guild removes it from the set being iterated.
+	const QSet<QString> ids = _snapshotGuilds;
+	for(const QString& id : ids)
+		loadSnapshotGuild(id);
+	return _guilds;
+}
+
 QSharedPointer<QDiscordChannel>
 QDiscordStateComponent::channel(const QString& id)
 {
 	if(_privateChannels.contains(id))
 		return _privateChannels.value(id);
+	if(!_snapshotGuilds.isEmpty())
+	{
+		QString guildId = _snapshot.channelGuild(id);
+		if(_snapshotGuilds.contains(guildId))
+			loadSnapshotGuild(guildId);
+	}
 	for(const QSharedPointer<QDiscordGuild>& item : _guilds)
 	{
-		if(item->channels().keys().contains(id))
-			return item->channels().value(id);
+		QSharedPointer<QDiscordChannel> channel = item->channel(id);
+		if(channel)
+			return channel;
 	}
 	return QSharedPointer<QDiscordChannel>();
 }
 
+void QDiscordStateComponent::setCachePolicy(const QDiscordCachePolicy& policy)
+{
+	_cachePolicy = policy;
+	if(_cachePolicy.usesRecentMembers())
+	{
+		_recentMemberTimer.start(
+					qMax(1000, _cachePolicy.recentMemberTimeout()/4)
+					);
+	}
+	else
+	{
+		_recentMemberTimer.stop();
+		_recentMembers.clear();
+	}
+}
+
+QDiscordMemoryUsage QDiscordStateComponent::memoryUsage() const
+{
+	QDiscordMemoryUsage usage = _privateChannelMemoryUsage;
+	if(_self)
+		usage += QDiscordMemoryUsage::of(*_self);
+	for(const QSharedPointer<QDiscordGuild>& item : _guilds)
+		usage += item->memoryUsage();
+	usage += _messageCache.memoryUsage();
+	return usage;
+}
+
+QDiscordMemoryUsage
+QDiscordStateComponent::memoryUsage(const QString& guildId) const
+{
+	QDiscordMemoryUsage usage = _messageCache.memoryUsage(guildId);
+	QSharedPointer<QDiscordGuild> guild = _guilds.value(guildId);
+	if(guild)
+		usage += guild->memoryUsage();
+	return usage;
+}
+
+QMap<QString, QDiscordMemoryUsage>
+QDiscordStateComponent::guildMemoryUsage() const
+{
+	QMap<QString, QDiscordMemoryUsage> usage;
+	for(const QString& id : _guilds.keys())
+		usage.insert(id, memoryUsage(id));
+	return usage;
+}
+
+QString QDiscordStateComponent::memoryUsageReport(int maxGuilds) const
+{
+	QList<QPair<qint64, QString>> guilds;
+	QMap<QString, QDiscordMemoryUsage> usage = guildMemoryUsage();
+	for(QMap<QString, QDiscordMemoryUsage>::const_iterator i = usage.begin();
+		i != usage.end(); ++i)
+	{
+		guilds.append(qMakePair(i.value().totalBytes(), i.key()));
+	}
+	std::sort(guilds.begin(), guilds.end(),
+			  [](const QPair<qint64, QString>& a, const QPair<qint64, QString>& b)
+	{
+		return a.first > b.first;
+	});
+
+	QString report = "Total: " + memoryUsage().toString() + "\n";
+	report += "Private channels: " + _privateChannelMemoryUsage.toString() + "\n";
+	QDiscordMemoryUsage privateMessages = _messageCache.memoryUsage(QString());
+	if(privateMessages.messages > 0)
+		report += "Private messages: " + privateMessages.toString() + "\n";
+	if(maxGuilds <= 0 || maxGuilds > guilds.size())
+		maxGuilds = guilds.size();
+	for(int i = 0; i < maxGuilds; i++)
+	{
+		const QString& id = guilds[i].second;
+		report += "Guild " + id + " (" + _guilds.value(id)->name() + "): " +
+				usage.value(id).toString() + "\n";
+	}
+	if(maxGuilds < guilds.size())
+		report += QString("%1 smaller guilds omitted\n").arg(guilds.size() - maxGuilds);
+	return report;
+}
+
+void QDiscordStateComponent::setMemoryReportInterval(int interval)
+{
+	if(interval > 0)
+		_memoryReportTimer.start(interval);
+	else
+		_memoryReportTimer.stop();
+}
+
+void QDiscordStateComponent::setViewEnabled(bool enabled)
+{
+	if(_viewEnabled == enabled)
+		return;
+	_viewEnabled = enabled;
+	if(_viewEnabled)
+	{
+		_viewCleared = true;
+		_viewSelfChanged = true;
+		_viewPrivateChannelsChanged = true;
+		_viewRebuiltGuilds =
+				QSet<QString>(_guilds.keyBegin(), _guilds.keyEnd());
+		scheduleViewPublish();
+	}
+	else
+	{
+		_viewRebuiltGuilds.clear();
+		_viewChangedGuilds.clear();
+		_viewChangedMembers.clear();
+		std::atomic_store(&_view, std::shared_ptr<const QDiscordStateView>());
+	}
+}
+
+std::shared_ptr<const QDiscordStateView> QDiscordStateComponent::view() const
+{
+	return std::atomic_load(&_view);
+}
+
+void QDiscordStateComponent::connectNotify(const QMetaMethod& signal)
+{
+	//Like the rest of this class, this expects connections to be made from
+	//this object's thread.
+	if(_signalAdapters.contains(signal.methodIndex()))
+		return;
+	QDiscordEventBus::Subscription subscription = adaptSignal(signal);
+	if(subscription != 0)
+		_signalAdapters.insert(signal.methodIndex(), subscription);
+}
+
+void QDiscordStateComponent::disconnectNotify(const QMetaMethod& signal)
+{
+	//An invalid method means that several signals may have been disconnected.
+	QList<int> indices = signal.isValid() ?
+				QList<int>({signal.methodIndex()}) : _signalAdapters.keys();
+	for(int index : indices)
+	{
+		if(!_signalAdapters.contains(index) ||
+				isSignalConnected(metaObject()->method(index)))
+			continue;
+		_events.off(_signalAdapters.take(index));
+	}
+}
+
+QDiscordEventBus::Subscription
+QDiscordStateComponent::adaptSignal(const QMetaMethod& signal)
+{
+	using namespace QDiscordEvent;
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::selfCreated))
+	{
+		return _events.on<SelfCreate>([this](const SelfCreate& event){
+			emit selfCreated(event.self);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::guildCreated))
+	{
+		return _events.on<GuildCreate>([this](const GuildCreate& event){
+			emit guildCreated(event.guild);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::guildAvailable))
+	{
+		return _events.on<GuildAvailable>([this](const GuildAvailable& event){
+			emit guildAvailable(event.guild);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::guildDeleted))
+	{
+		return _events.on<GuildDelete>([this](const GuildDelete& event){
+			emit guildDeleted(event.guild);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::guildUpdated))
+	{
+		return _events.on<GuildUpdate>([this](const GuildUpdate& event){
+			emit guildUpdated(event.guild);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::guildMemberAdded))
+	{
+		return _events.on<GuildMemberAdd>([this](const GuildMemberAdd& event){
+			emit guildMemberAdded(event.member);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::guildMemberRemoved))
+	{
+		return _events.on<GuildMemberRemove>([this](const GuildMemberRemove& event){
+			emit guildMemberRemoved(event.member);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::guildMemberUpdated))
+	{
+		return _events.on<GuildMemberUpdate>([this](const GuildMemberUpdate& event){
+			emit guildMemberUpdated(event.member);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::channelCreated))
+	{
+		return _events.on<ChannelCreate>([this](const ChannelCreate& event){
+			emit channelCreated(event.channel);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::channelDeleted))
+	{
+		return _events.on<ChannelDelete>([this](const ChannelDelete& event){
+			emit channelDeleted(event.channel);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::channelUpdated))
+	{
+		return _events.on<ChannelUpdate>([this](const ChannelUpdate& event){
+			emit channelUpdated(event.channel);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::privateChannelCreated))
+	{
+		return _events.on<PrivateChannelCreate>([this](const PrivateChannelCreate& event){
+			emit privateChannelCreated(event.channel);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::privateChannelDeleted))
+	{
+		return _events.on<PrivateChannelDelete>([this](const PrivateChannelDelete& event){
+			emit privateChannelDeleted(event.channel);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::privateChannelUpdated))
+	{
+		return _events.on<PrivateChannelUpdate>([this](const PrivateChannelUpdate& event){
+			emit privateChannelUpdated(event.channel);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::messageCreated))
+	{
+		return _events.on<MessageCreate>([this](const MessageCreate& event){
+			emit messageCreated(event.message);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::messageDeleted))
+	{
+		return _events.on<MessageDelete>([this](const MessageDelete& event){
+			emit messageDeleted(event.message);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::messageUpdated))
+	{
+		return _events.on<MessageUpdate>([this](const MessageUpdate& event){
+			emit messageUpdated(event.message, event.editedTimestamp);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::cachedMessageUpdated))
+	{
+		return _events.on<CachedMessageUpdate>([this](const CachedMessageUpdate& event){
+			emit cachedMessageUpdated(event.previous, event.current);
+		});
+	}
+	if(signal == QMetaMethod::fromSignal(&QDiscordStateComponent::voiceStateUpdated))
+	{
+		return _events.on<VoiceStateUpdate>([this](const VoiceStateUpdate& event){
+			emit voiceStateUpdated(event.voiceState, event.previousChannelId);
+		});
+	}
+	return 0;
+}
+
+bool QDiscordStateComponent::saveSnapshot(const QString& fileName)
+{
+	QDiscordStateSnapshotWriter writer(fileName);
+	if(!writer.open())
+		return false;
+	writer.writeSelf(_self ? _self->toJson() : QJsonObject());
+	QJsonArray privateChannels;
+	for(const QSharedPointer<QDiscordChannel>& item : _privateChannels)
+		privateChannels.append(item->toJson());
+	writer.writePrivateChannels(privateChannels);
+	for(const QSharedPointer<QDiscordGuild>& item : _guilds)
+		writer.writeGuild(item->id(), item->toJson());
+	for(const QString& id : _snapshotGuilds)
+	{
+		writer.writeRawGuild(id, _snapshot.rawGuild(id),
+							 _snapshot.guildChannelIds(id));
+	}
+	//Replacing a file fails on some platforms while it is mapped. The new
+	//file contains the same guilds, so it is mapped instead.
+	bool remap = _snapshot.isOpen() &&
+			QFileInfo(_snapshot.fileName()) == QFileInfo(fileName);
+	if(remap)
+		_snapshot.close();
+	bool success = writer.commit();
+	if(remap && !_snapshot.open(fileName))
+	{
+		if(QDiscordUtilities::debugMode)
+			qDebug()<<this<<"failed to remap snapshot"<<fileName;
+		_snapshotGuilds.clear();
+	}
+
+	if(QDiscordUtilities::debugMode)
+		qDebug()<<this<<"snapshot written to"<<fileName<<"success:"<<success;
+
+	return success;
+}
+
+bool QDiscordStateComponent::loadSnapshot(const QString& fileName)
+{
+	clear();
+	if(!_snapshot.open(fileName))
+		return false;
+	const QStringList ids = _snapshot.guildIds();
+	_snapshotGuilds = QSet<QString>(ids.begin(), ids.end());
+	for(QJsonValue item : _snapshot.privateChannels())
+	{
+		storePrivateChannel(QSharedPointer<QDiscordChannel>(
+								new QDiscordChannel(item.toObject())
+								));
+	}
+	markViewPrivateChannelsChanged();
+	QJsonObject self = _snapshot.self();
+	if(!self.isEmpty())
+	{
+		_self = QSharedPointer<QDiscordUser>(new QDiscordUser(self));
+		markViewSelfChanged();
+		_events.publish(QDiscordEvent::SelfCreate{_self});
+	}
+	if(_snapshotGuilds.isEmpty())
+		_snapshot.close();
+	return true;
+}
+
+void QDiscordStateComponent::setSnapshotInterval(const QString& fileName,
+												 int interval)
+{
+	_snapshotFileName = fileName;
+	if(interval > 0)
+		_snapshotTimer.start(interval);
+	else
+		_snapshotTimer.stop();
+}
+
 void QDiscordStateComponent::clear()
 {
 	_self.reset();
 	_guilds.clear();
 	_privateChannels.clear();
+	_privateChannelMemoryUsage = QDiscordMemoryUsage();
+	_recentMembers.clear();
+	_messageCache.clear();
+	_typingTracker.clear();
+	_snapshotGuilds.clear();
+	_staleGuilds.clear();
+	_unavailableGuilds.clear();
+	_staleTimer.stop();
+	if(_stale)
+	{
+		_stale = false;
+		_staleReadyReceived = false;
+		emit staleChanged(false);
+	}
+	_snapshot.close();
+	if(_viewEnabled)
+	{
+		_viewCleared = true;
+		_viewRebuiltGuilds.clear();
+		_viewChangedGuilds.clear();
+		_viewChangedMembers.clear();
+		scheduleViewPublish();
+	}
 }
 
 void QDiscordStateComponent::readyReceived(const QJsonObject& object)
 {
-	_self = QSharedPointer<QDiscordUser>(
-				new QDiscordUser(object["user"].toObject())
-			);
-	emit selfCreated(_self);
+	QJsonObject user = object["user"].toObject();
+	if(_stale && _self && _self->id() == user["id"].toString(""))
+		_self->update(user);
+	else
+		_self = QSharedPointer<QDiscordUser>(new QDiscordUser(user));
+	markViewSelfChanged();
+	_events.publish(QDiscordEvent::SelfCreate{_self});
+	QSet<QString> readyGuilds;
 	for(QJsonValue item : object["guilds"].toArray())
-		guildCreateReceived(item.toObject());
-	for(QJsonValue item : object["private_channels"].toArray())
-		channelCreateReceived(item.toObject());
+	{
+		//Keep stored guilds and guilds loaded from a snapshot until they
+		//become available.
+		QJsonObject guildObject = item.toObject();
+		QString id = guildObject["id"].toString("");
+		readyGuilds.insert(id);
+		if(guildObject["unavailable"].toBool(false) &&
+				(_guilds.contains(id) || _snapshotGuilds.contains(id)))
+		{
+			continue;
+		}
+		guildCreateReceived(guildObject);
+	}
+	if(!_stale)
+	{
+		for(QJsonValue item : object["private_channels"].toArray())
+			channelCreateReceived(item.toObject());
+		return;
+	}
+
+	//Remove guilds the client has left while it was disconnected.
+	for(const QString& id : _staleGuilds - readyGuilds)
+		guildDeleteReceived(QJsonObject({{"id", id}}));
+	reconcilePrivateChannels(object["private_channels"].toArray());
+	_staleReadyReceived = true;
+	finishStale();
+	if(_stale && _staleTimer.interval() > 0)
+		_staleTimer.start();
 }
 
 void QDiscordStateComponent::guildCreateReceived(const QJsonObject& object)
 {
+	//Only guilds kept from before a disconnect are reconciled, any other
+	//GUILD_CREATE replaces the stored guild.
+	QSharedPointer<QDiscordGuild> existing =
+			_guilds.value(object["id"].toString(""));
+	bool kept = existing && (_unavailableGuilds.contains(existing->id()) ||
+			(_staleGuilds.contains(existing->id()) && !existing->unavailable()));
+	if(kept && !object["unavailable"].toBool(false))
+	{
+		if(_unavailableGuilds.remove(existing->id()))
+			existing->update(QJsonObject({{"unavailable", false}}));
+		reconcileGuild(existing, object);
+		_staleGuilds.remove(existing->id());
+		_events.publish(QDiscordEvent::GuildCreate{existing});
+		_events.publish(QDiscordEvent::GuildAvailable{existing});
+		finishStale();
+		return;
+	}
 	QSharedPointer<QDiscordGuild> guild =
-			QSharedPointer<QDiscordGuild>(new QDiscordGuild(object));
+			QSharedPointer<QDiscordGuild>(
+				new QDiscordGuild(object, _cachePolicy, selfId())
+			);
 	_guilds.insert(guild->id(), guild);
-	emit guildCreated(guild);
+	_recentMembers.remove(guild->id());
+	dropSnapshotGuild(guild->id());
+	markViewGuildRebuilt(guild->id());
+	_unavailableGuilds.remove(guild->id());
+	if(!guild->unavailable())
+		_staleGuilds.remove(guild->id());
+	_events.publish(QDiscordEvent::GuildCreate{guild});
 	if(!guild->unavailable())
-		emit guildAvailable(guild);
+		_events.publish(QDiscordEvent::GuildAvailable{guild});
+	finishStale();
 }
 
 void QDiscordStateComponent::guildDeleteReceived(const QJsonObject& object)
 {
 	QDiscordGuild guild(object);
 	_guilds.remove(guild.id());
-	emit guildDeleted(guild);
+	_recentMembers.remove(guild.id());
+	dropSnapshotGuild(guild.id());
+	_messageCache.removeGuild(guild.id());
+	markViewGuildChanged(guild.id());
+	_staleGuilds.remove(guild.id());
+	_unavailableGuilds.remove(guild.id());
+	_events.publish(QDiscordEvent::GuildDelete{guild});
+	finishStale();
 }
 
 void QDiscordStateComponent::guildBanAddReceived(const QJsonObject& object)
@@ -101,13 +564,27 @@ void QDiscordStateComponent::guildIntegrationsUpdateRecevied(const QJsonObject&
 
 void QDiscordStateComponent::guildMemberAddReceived(const QJsonObject& object)
 {
-	QSharedPointer<QDiscordGuild> guildPtr =
-			guild(object["guild_id"].toString(""));
-	QSharedPointer<QDiscordMember> member =
-			QSharedPointer<QDiscordMember>(new QDiscordMember(object, guildPtr));
-	if(guildPtr)
+	QString guildId = object["guild_id"].toString("");
+	QString userId = object["user"].toObject()["id"].toString("");
+	QSharedPointer<QDiscordGuild> guildPtr = guild(guildId);
+	QSharedPointer<QDiscordMember> member;
+	if(guildPtr && _cachePolicy.cachesActiveMember(guildId, userId, selfId()))
+	{
+		member = QSharedPointer<QDiscordMember>(
+					new QDiscordMember(trimMember(object), guildPtr)
+					);
 		guildPtr->addMember(member);
-	emit guildMemberAdded(member);
+		touchRecentMember(guildId, userId);
+		if(member->user())
+			markViewMemberChanged(guildPtr->id(), member->user()->id());
+	}
+	else
+	{
+		member = QSharedPointer<QDiscordMember>(
+					new QDiscordMember(object, guildPtr)
+					);
+	}
+	_events.publish(QDiscordEvent::GuildMemberAdd{member});
 
 }
 
@@ -122,10 +599,12 @@ void QDiscordStateComponent::guildMemberRemoveReceived(const QJsonObject& object
 				guildPtr->member(object["user"].toObject()["id"].toString(""));
 		if(tmpMember)
 		{
-			member = QSharedPointer<QDiscordMember>(
-						new QDiscordMember(*tmpMember)
-						);
+			member = tmpMember;
 			guildPtr->removeMember(tmpMember);
+			if(_recentMembers.contains(guildPtr->id()))
+				_recentMembers[guildPtr->id()].remove(tmpMember->user()->id());
+			markViewMemberChanged(guildPtr->id(),
+								  object["user"].toObject()["id"].toString(""));
 		}
 		else
 		{
@@ -141,8 +620,7 @@ void QDiscordStateComponent::guildMemberRemoveReceived(const QJsonObject& object
 					new QDiscordMember(object, QSharedPointer<QDiscordGuild>())
 					);
 	}
-	QDiscordMember newMember(*member);
-	emit guildMemberRemoved(newMember);
+	_events.publish(QDiscordEvent::GuildMemberRemove{*member});
 }
 
 void QDiscordStateComponent::guildMemberUpdateReceived(const QJsonObject& object)
@@ -151,12 +629,35 @@ void QDiscordStateComponent::guildMemberUpdateReceived(const QJsonObject& object
 			guild(object["guild_id"].toString(""));
 	if(guildPtr)
 	{
-		QSharedPointer<QDiscordMember> memberPtr =
-				guildPtr->member(object["user"].toObject()["id"].toString(""));
+		QString userId = object["user"].toObject()["id"].toString("");
+		QSharedPointer<QDiscordMember> memberPtr = guildPtr->member(userId);
 		if(memberPtr)
 		{
-			memberPtr->update(object, guildPtr);
-			emit guildMemberUpdated(memberPtr);
+			guildPtr->updateMember(memberPtr, trimMember(object));
+			touchRecentMember(guildPtr->id(), userId);
+			markViewMemberChanged(guildPtr->id(), userId);
+			_events.publish(QDiscordEvent::GuildMemberUpdate{memberPtr});
+		}
+		else if(_cachePolicy.memberPolicy(guildPtr->id()) !=
+				QDiscordCachePolicy::MemberPolicy::All)
+		{
+			//The member was skipped by the cache policy.
+			if(_cachePolicy.cachesActiveMember(guildPtr->id(), userId, selfId()))
+			{
+				memberPtr = QSharedPointer<QDiscordMember>(
+							new QDiscordMember(trimMember(object), guildPtr)
+							);
+				guildPtr->addMember(memberPtr);
+				touchRecentMember(guildPtr->id(), userId);
+				markViewMemberChanged(guildPtr->id(), userId);
+			}
+			else
+			{
+				memberPtr = QSharedPointer<QDiscordMember>(
+							new QDiscordMember(object, guildPtr)
+							);
+			}
+			_events.publish(QDiscordEvent::GuildMemberUpdate{memberPtr});
 		}
 		else
 			if(QDiscordUtilities::debugMode)
@@ -194,42 +695,124 @@ void QDiscordStateComponent::guildRoleUpdateReceived(const QJsonObject& object)
 
 void QDiscordStateComponent::guildUpdateReceived(const QJsonObject& object)
 {
-	//TODO Implement
-	Q_UNUSED(object);
+	QSharedPointer<QDiscordGuild> guildPtr = guild(object["id"].toString(""));
+	if(!guildPtr)
+	{
+		if(QDiscordUtilities::debugMode)
+			qDebug()<<this<<
+			"DESYNC: Guild update received but guild is not stored in state.\n"
+			"Guild ID: "+object["id"].toString("");
+		return;
+	}
+	guildPtr->update(object);
+	markViewGuildChanged(guildPtr->id());
+	_events.publish(QDiscordEvent::GuildUpdate{guildPtr});
 }
 
 void QDiscordStateComponent::messageCreateReceived(const QJsonObject& object)
 {
-	QDiscordMessage message(object, channel(object["channel_id"].toString("")));
-	emit messageCreated(message);
+	QSharedPointer<QDiscordChannel> channelPtr =
+			channel(object["channel_id"].toString(""));
+	QSharedPointer<QDiscordGuild> guildPtr =
+			channelPtr ? channelPtr->guild() : QSharedPointer<QDiscordGuild>();
+	if(guildPtr && _cachePolicy.memberPolicy(guildPtr->id()) ==
+			QDiscordCachePolicy::MemberPolicy::Recent)
+	{
+		QString userId = object["author"].toObject()["id"].toString("");
+		if(!userId.isEmpty() && !guildPtr->member(userId))
+		{
+			QJsonObject memberObject;
+			memberObject["user"] = object["author"];
+			guildPtr->addMember(QSharedPointer<QDiscordMember>(
+									new QDiscordMember(trimMember(memberObject),
+													   guildPtr)
+									));
+			markViewMemberChanged(guildPtr->id(), userId);
+		}
+		touchRecentMember(guildPtr->id(), userId);
+	}
+	//Sending a message ends the author's typing indicator.
+	_typingTracker.stop(object["channel_id"].toString(""),
+						object["author"].toObject()["id"].toString(""));
+	//Nothing needs the message unless it is cached or listened for.
+	if(!_messageCache.enabled() &&
+			!_events.hasSubscribers<QDiscordEvent::MessageCreate>())
+		return;
+	QDiscordMessage message(object, channelPtr);
+	_messageCache.insert(message);
+	_events.publish(QDiscordEvent::MessageCreate{message});
 }
 
 void QDiscordStateComponent::messageDeleteReceived(const QJsonObject& object)
 {
+	QSharedPointer<QDiscordMessage> cached =
+			_messageCache.take(object["id"].toString(""));
+	if(cached)
+	{
+		_events.publish(QDiscordEvent::MessageDelete{*cached});
+		return;
+	}
+	if(!_events.hasSubscribers<QDiscordEvent::MessageDelete>())
+		return;
 	QDiscordMessage message(object, channel(object["channel_id"].toString("")));
-	emit messageDeleted(message);
+	_events.publish(QDiscordEvent::MessageDelete{message});
 }
 
 void QDiscordStateComponent::messageUpdateReceived(const QJsonObject& object)
 {
+	const bool updateListened =
+			_events.hasSubscribers<QDiscordEvent::MessageUpdate>();
+	QDateTime editedTimestamp = updateListened ?
+				QDiscordUtilities::timestampToDateTime(
+					QDiscordUtilities::parseTimestamp(
+						object["edited_timestamp"].toString())) :
+				QDateTime();
+	QSharedPointer<QDiscordMessage> cached =
+			_messageCache.message(object["id"].toString(""));
+	if(cached)
+	{
+		//Keeping the previous message makes the update detach the cached one,
+		//so it is only kept for subscribers.
+		QDiscordMessage previous;
+		const bool previousListened =
+				_events.hasSubscribers<QDiscordEvent::CachedMessageUpdate>();
+		if(previousListened)
+			previous = *cached;
+		_messageCache.update(object);
+		_events.publish(QDiscordEvent::MessageUpdate{*cached, editedTimestamp});
+		if(previousListened)
+			_events.publish(QDiscordEvent::CachedMessageUpdate{previous, *cached});
+		return;
+	}
+	if(!updateListened)
+		return;
 	QDiscordMessage message(object, channel(object["channel_id"].toString("")));
-	emit messageUpdated(message,
-						QDateTime::fromString(
-							object["edited_timestamp"].toString(),
-							Qt::ISODate)
-			);
+	_events.publish(QDiscordEvent::MessageUpdate{message, editedTimestamp});
 }
 
 void QDiscordStateComponent::presenceUpdateReceived(const QJsonObject& object)
 {
-	//TODO Implement
-	Q_UNUSED(object);
+	//TODO Implement statuses and games
+	QSharedPointer<QDiscordGuild> guildPtr =
+			guild(object["guild_id"].toString(""));
+	if(!guildPtr)
+		return;
+	QJsonObject user = object["user"].toObject();
+	//Presence updates only contain a changed user's other fields.
+	if(user.size() <= 1 || !_cachePolicy.cacheUsers())
+		return;
+	QSharedPointer<QDiscordMember> member =
+			guildPtr->member(user["id"].toString(""));
+	if(!member)
+		return;
+	guildPtr->updateMember(member, QJsonObject({{"user", user}}));
+	markViewMemberChanged(guildPtr->id(), member->user()->id());
 }
 
 void QDiscordStateComponent::typingStartReceived(const QJsonObject& object)
 {
-	//TODO Implement
-	Q_UNUSED(object);
+	_typingTracker.start(object["channel_id"].toString(""),
+						 object["user_id"].toString(""));
 }
 
 void QDiscordStateComponent::userSettingsUpdateReceived(const QJsonObject& object)
@@ -240,8 +823,16 @@ void QDiscordStateComponent::userSettingsUpdateReceived(const QJsonObject& objec
 
 void QDiscordStateComponent::voiceStateUpdateReceived(const QJsonObject& object)
 {
-	//TODO Implement
-	Q_UNUSED(object);
+	QSharedPointer<QDiscordVoiceState> voiceState =
+			QSharedPointer<QDiscordVoiceState>(new QDiscordVoiceState(object));
+	QSharedPointer<QDiscordGuild> guildPtr = guild(voiceState->guildId());
+	QSharedPointer<QDiscordVoiceState> previous;
+	if(guildPtr)
+		previous = guildPtr->updateVoiceState(voiceState);
+	_events.publish(QDiscordEvent::VoiceStateUpdate{
+						voiceState,
+						previous ? previous->channelId() : QString()
+					});
 }
 
 void QDiscordStateComponent::channelCreateReceived(const QJsonObject& object)
@@ -252,37 +843,47 @@ void QDiscordStateComponent::channelCreateReceived(const QJsonObject& object)
 		);
 	if(channel->isPrivate())
 	{
-		_privateChannels.insert(channel->id(), channel);
-		emit privateChannelCreated(channel);
+		if(_cachePolicy.cachePrivateChannels())
+		{
+			storePrivateChannel(channel);
+			markViewPrivateChannelsChanged();
+		}
+		_events.publish(QDiscordEvent::PrivateChannelCreate{channel});
 	}
 	else
 	{
 		if(!channel->guild())
 			return;
 		channel->guild()->addChannel(channel);
-		emit channelCreated(channel);
+		markViewGuildChanged(channel->guild()->id());
+		_events.publish(QDiscordEvent::ChannelCreate{channel});
 	}
 }
 
 void QDiscordStateComponent::channelDeleteReceived(const QJsonObject& object)
 {
 	QDiscordChannel channel(object, guild(object["guild_id"].toString("")));
+	_messageCache.removeChannel(channel.id());
 	if(channel.isPrivate())
 	{
-		_privateChannels.remove(channel.id());
-		emit privateChannelDeleted(channel);
+		removePrivateChannel(channel.id());
+		markViewPrivateChannelsChanged();
+		_events.publish(QDiscordEvent::PrivateChannelDelete{channel});
 	}
 	else
 	{
 		if(!channel.guild())
 			return;
 		channel.guild()->removeChannel(channel.guild()->channel(channel.id()));
-		emit channelDeleted(channel);
+		markViewGuildChanged(channel.guild()->id());
+		_events.publish(QDiscordEvent::ChannelDelete{channel});
 	}
 }
 
 void QDiscordStateComponent::channelUpdateReceived(const QJsonObject& object)
 {
+	//Stored channels are updated in place, so pointers held by user code
+	//stay valid.
 	QSharedPointer<QDiscordChannel> channel =
 			QSharedPointer<QDiscordChannel>(
 				new QDiscordChannel(
@@ -292,14 +893,505 @@ void QDiscordStateComponent::channelUpdateReceived(const QJsonObject& object)
 			);
 	if(channel->isPrivate())
 	{
-		_privateChannels.insert(channel->id(), channel);
-		emit privateChannelUpdated(channel);
+		QSharedPointer<QDiscordChannel> existing =
+				_privateChannels.value(channel->id());
+		if(existing)
+		{
+			updatePrivateChannel(existing, object);
+			channel = existing;
+			markViewPrivateChannelsChanged();
+		}
+		else if(_cachePolicy.cachePrivateChannels())
+		{
+			storePrivateChannel(channel);
+			markViewPrivateChannelsChanged();
+		}
+		_events.publish(QDiscordEvent::PrivateChannelUpdate{channel});
 	}
 	else
 	{
 		if(!channel->guild())
 			return;
-		channel->guild()->addChannel(channel);
-		emit channelUpdated(channel);
+		QSharedPointer<QDiscordChannel> existing =
+				channel->guild()->channel(channel->id());
+		if(existing)
+		{
+			channel->guild()->updateChannel(existing, object);
+			channel = existing;
+		}
+		else
+			channel->guild()->addChannel(channel);
+		markViewGuildChanged(channel->guild()->id());
+		_events.publish(QDiscordEvent::ChannelUpdate{channel});
+	}
+}
+
+void QDiscordStateComponent::snapshotTimerTimeout()
+{
+	if(!_snapshotFileName.isEmpty())
+		saveSnapshot(_snapshotFileName);
+}
+
+void QDiscordStateComponent::memoryReportTimerTimeout()
+{
+	if(QDiscordUtilities::debugMode)
+		qDebug().noquote()<<this<<"memory usage:\n"+memoryUsageReport();
+	emit memoryUsageReported(memoryUsage(), guildMemoryUsage());
+}
+
+void QDiscordStateComponent::storePrivateChannel(
+		QSharedPointer<QDiscordChannel> channel)
+{
+	removePrivateChannel(channel->id());
+	_privateChannels.insert(channel->id(), channel);
+	_privateChannelMemoryUsage += QDiscordMemoryUsage::of(*channel);
+	if(channel->recipient())
+		_privateChannelMemoryUsage += QDiscordMemoryUsage::of(*channel->recipient());
+}
+
+void QDiscordStateComponent::removePrivateChannel(const QString& id)
+{
+	QSharedPointer<QDiscordChannel> channel = _privateChannels.take(id);
+	if(!channel)
+		return;
+	_privateChannelMemoryUsage -= QDiscordMemoryUsage::of(*channel);
+	if(channel->recipient())
+		_privateChannelMemoryUsage -= QDiscordMemoryUsage::of(*channel->recipient());
+}
+
+void QDiscordStateComponent::updatePrivateChannel(
+		QSharedPointer<QDiscordChannel> channel, const QJsonObject& object)
+{
+	_privateChannelMemoryUsage -= QDiscordMemoryUsage::of(*channel);
+	if(channel->recipient())
+		_privateChannelMemoryUsage -= QDiscordMemoryUsage::of(*channel->recipient());
+	channel->update(object);
+	_privateChannelMemoryUsage += QDiscordMemoryUsage::of(*channel);
+	if(channel->recipient())
+		_privateChannelMemoryUsage += QDiscordMemoryUsage::of(*channel->recipient());
+}
+
+void QDiscordStateComponent::connectionLost()
+{
+	if(!_staleModeEnabled)
+	{
+		clear();
+		return;
+	}
+	if(!_stale && !_self && _guilds.isEmpty() && _snapshotGuilds.isEmpty())
+		return;
+	bool wasStale = _stale;
+	_stale = true;
+	_staleReadyReceived = false;
+	_staleGuilds = QSet<QString>(_guilds.keyBegin(), _guilds.keyEnd());
+	_staleGuilds.unite(_snapshotGuilds);
+	_staleTimer.stop();
+	_typingTracker.clear();
+
+	if(QDiscordUtilities::debugMode)
+		qDebug()<<this<<"state marked stale with"<<_staleGuilds.size()<<"guilds";
+
+	if(!wasStale)
+		emit staleChanged(true);
+}
+
+void QDiscordStateComponent::finishStale()
+{
+	if(!_stale || !_staleReadyReceived || !_staleGuilds.isEmpty())
+		return;
+	_stale = false;
+	_staleReadyReceived = false;
+	_staleTimer.stop();
+
+	if(QDiscordUtilities::debugMode)
+		qDebug()<<this<<"state reconciled";
+
+	emit staleChanged(false);
+}
+
+void QDiscordStateComponent::staleTimerTimeout()
+{
+	if(!_stale || !_staleReadyReceived)
+		return;
+	//Guilds which are still missing are kept as unavailable guilds. Guilds
+	//only loaded from a snapshot stay in it until they are requested.
+	for(const QString& id : _staleGuilds)
+	{
+		QSharedPointer<QDiscordGuild> guild = _guilds.value(id);
+		if(!guild || guild->unavailable())
+			continue;
+		guild->update(QJsonObject({{"unavailable", true}}));
+		_unavailableGuilds.insert(id);
+		markViewGuildChanged(id);
+		_events.publish(QDiscordEvent::GuildUpdate{guild});
+	}
+
+	if(QDiscordUtilities::debugMode)
+	{
+		qDebug()<<this<<"stale timeout expired with"<<_staleGuilds.size()
+			   <<"guilds missing";
+	}
+
+	_staleGuilds.clear();
+	finishStale();
+}
+
+void QDiscordStateComponent::reconcilePrivateChannels(const QJsonArray& channels)
+{
+	QSet<QString> removed(_privateChannels.keyBegin(),
+						  _privateChannels.keyEnd());
+	for(QJsonValue item : channels)
+	{
+		QJsonObject object = item.toObject();
+		QString id = object["id"].toString("");
+		removed.remove(id);
+		QSharedPointer<QDiscordChannel> existing = _privateChannels.value(id);
+		if(!existing)
+		{
+			channelCreateReceived(object);
+			continue;
+		}
+		if(QDiscordChannel(object).toJson() == existing->toJson())
+			continue;
+		updatePrivateChannel(existing, object);
+		markViewPrivateChannelsChanged();
+		_events.publish(QDiscordEvent::PrivateChannelUpdate{existing});
+	}
+	for(const QString& id : removed)
+	{
+		QSharedPointer<QDiscordChannel> channel = _privateChannels.value(id);
+		removePrivateChannel(id);
+		_messageCache.removeChannel(id);
+		markViewPrivateChannelsChanged();
+		_events.publish(QDiscordEvent::PrivateChannelDelete{*channel});
+	}
+}
+
+void QDiscordStateComponent::reconcileGuild(QSharedPointer<QDiscordGuild> guild,
+											const QJsonObject& object)
+{
+	const QString id = guild->id();
+
+	QString name = guild->name();
+	int verificationLevel = guild->verificationLevel();
+	int afkTimeout = guild->afkTimeout();
+	int memberCount = guild->memberCount();
+	qint64 joinedAt = guild->joinedAtMSecs();
+	guild->update(object);
+	if(name != guild->name() ||
+			verificationLevel != guild->verificationLevel() ||
+			afkTimeout != guild->afkTimeout() ||
+			memberCount != guild->memberCount() ||
+			joinedAt != guild->joinedAtMSecs())
+	{
+		_events.publish(QDiscordEvent::GuildUpdate{guild});
 	}
+
+	const QMap<QString, QSharedPointer<QDiscordChannel>> channels =
+			guild->channels();
+	QSet<QString> removedChannels(channels.keyBegin(), channels.keyEnd());
+	for(QJsonValue item : object["channels"].toArray())
+	{
+		QJsonObject channelObject = item.toObject();
+		QSharedPointer<QDiscordChannel> channel =
+				QSharedPointer<QDiscordChannel>(
+					new QDiscordChannel(channelObject, guild)
+				);
+		removedChannels.remove(channel->id());
+		QSharedPointer<QDiscordChannel> existing = guild->channel(channel->id());
+		if(!existing)
+		{
+			guild->addChannel(channel);
+			_events.publish(QDiscordEvent::ChannelCreate{channel});
+		}
+		else if(existing->toJson() != channel->toJson())
+		{
+			guild->updateChannel(existing, channelObject);
+			_events.publish(QDiscordEvent::ChannelUpdate{existing});
+		}
+	}
+	for(const QString& channelId : removedChannels)
+	{
+		QSharedPointer<QDiscordChannel> channel = guild->channel(channelId);
+		guild->removeChannel(channel);
+		_messageCache.removeChannel(channelId);
+		_events.publish(QDiscordEvent::ChannelDelete{*channel});
+	}
+
+	//Large guilds only send online members, and members skipped by the cache
+	//policy are never stored, so missing members can only be told apart from
+	//departed ones if the guild sent all of them.
+	bool completeMembers = !object["large"].toBool(false) &&
+			_cachePolicy.memberPolicy(id) == QDiscordCachePolicy::MemberPolicy::All;
+	QSet<QString> removedMembers;
+	if(completeMembers)
+	{
+		const QMap<QString, QSharedPointer<QDiscordMember>> members =
+				guild->members();
+		removedMembers = QSet<QString>(members.keyBegin(), members.keyEnd());
+	}
+	for(QJsonValue item : object["members"].toArray())
+	{
+		QJsonObject memberObject = trimMember(item.toObject());
+		QString userId = memberObject["user"].toObject()["id"].toString("");
+		removedMembers.remove(userId);
+		QSharedPointer<QDiscordMember> existing = guild->member(userId);
+		if(!existing && !_cachePolicy.cachesMember(id, userId, selfId()))
+			continue;
+		QSharedPointer<QDiscordMember> member =
+				QSharedPointer<QDiscordMember>(
+					new QDiscordMember(memberObject, guild)
+				);
+		if(!existing)
+		{
+			guild->addMember(member);
+			_events.publish(QDiscordEvent::GuildMemberAdd{member});
+		}
+		else if(existing->toJson() != member->toJson())
+		{
+			guild->updateMember(existing, memberObject);
+			_events.publish(QDiscordEvent::GuildMemberUpdate{existing});
+		}
+	}
+	for(const QString& userId : removedMembers)
+	{
+		QSharedPointer<QDiscordMember> member = guild->member(userId);
+		guild->removeMember(member);
+		_events.publish(QDiscordEvent::GuildMemberRemove{*member});
+	}
+
+	QHash<QString, QSharedPointer<QDiscordVoiceState>> removedVoiceStates =
+			guild->voiceStates();
+	for(QJsonValue item : object["voice_states"].toArray())
+	{
+		QSharedPointer<QDiscordVoiceState> voiceState =
+				QSharedPointer<QDiscordVoiceState>(
+					new QDiscordVoiceState(item.toObject(), id)
+				);
+		removedVoiceStates.remove(voiceState->userId());
+		QSharedPointer<QDiscordVoiceState> existing =
+				guild->voiceState(voiceState->userId());
+		if(existing && existing->toJson() == voiceState->toJson())
+			continue;
+		guild->updateVoiceState(voiceState);
+		_events.publish(QDiscordEvent::VoiceStateUpdate{
+							voiceState,
+							existing ? existing->channelId() : QString()
+						});
+	}
+	for(const QSharedPointer<QDiscordVoiceState>& item : removedVoiceStates)
+	{
+		guild->removeVoiceState(item->userId());
+		QJsonObject disconnected = item->toJson();
+		disconnected["channel_id"] = QJsonValue();
+		_events.publish(QDiscordEvent::VoiceStateUpdate{
+							QSharedPointer<QDiscordVoiceState>(
+								new QDiscordVoiceState(disconnected)
+								),
+							item->channelId()
+						});
+	}
+
+	markViewGuildRebuilt(id);
+
+	if(QDiscordUtilities::debugMode)
+		qDebug()<<this<<"reconciled guild"<<id;
+}
+
+QString QDiscordStateComponent::selfId() const
+{
+	return _self ? _self->id() : QString();
+}
+
+QJsonObject QDiscordStateComponent::trimMember(const QJsonObject& object) const
+{
+	if(_cachePolicy.cacheUsers())
+		return object;
+	QJsonObject trimmed = object;
+	trimmed["user"] = QJsonObject({{"id", object["user"].toObject()["id"]}});
+	return trimmed;
+}
+
+void QDiscordStateComponent::touchRecentMember(const QString& guildId,
+											   const QString& userId)
+{
+	if(_cachePolicy.memberPolicy(guildId) !=
+			QDiscordCachePolicy::MemberPolicy::Recent)
+	{
+		return;
+	}
+	//The current user's member is always stored.
+	if(userId.isEmpty() || userId == selfId())
+		return;
+	_recentMembers[guildId].insert(userId, QDateTime::currentMSecsSinceEpoch());
+}
+
+void QDiscordStateComponent::recentMemberTimerTimeout()
+{
+	qint64 expiry = QDateTime::currentMSecsSinceEpoch() -
+			_cachePolicy.recentMemberTimeout();
+	QHash<QString, QHash<QString, qint64>>::iterator guildItem =
+			_recentMembers.begin();
+	while(guildItem != _recentMembers.end())
+	{
+		QSharedPointer<QDiscordGuild> guildPtr = _guilds.value(guildItem.key());
+		QHash<QString, qint64>& members = guildItem.value();
+		QHash<QString, qint64>::iterator item = members.begin();
+		while(item != members.end())
+		{
+			if(item.value() > expiry)
+			{
+				++item;
+				continue;
+			}
+			//Expired members are only dropped from the cache, they have not
+			//left the guild, so guildMemberRemoved is not emitted.
+			if(guildPtr && guildPtr->removeMember(guildPtr->member(item.key())))
+				markViewMemberChanged(guildItem.key(), item.key());
+			item = members.erase(item);
+		}
+		if(members.isEmpty())
+			guildItem = _recentMembers.erase(guildItem);
+		else
+			++guildItem;
+	}
+}
+
+QSharedPointer<QDiscordGuild>
+QDiscordStateComponent::loadSnapshotGuild(const QString& id)
+{
+	QJsonObject object = _snapshot.guild(id);
+	dropSnapshotGuild(id);
+	if(object.isEmpty())
+		return QSharedPointer<QDiscordGuild>();
+	QSharedPointer<QDiscordGuild> guild =
+			QSharedPointer<QDiscordGuild>(
+				new QDiscordGuild(object, _cachePolicy, selfId())
+			);
+	_guilds.insert(guild->id(), guild);
+	markViewGuildRebuilt(guild->id());
+	return guild;
+}
+
+void QDiscordStateComponent::dropSnapshotGuild(const QString& id)
+{
+	if(!_snapshotGuilds.remove(id))
+		return;
+	if(_snapshotGuilds.isEmpty())
+		_snapshot.close();
+}
+
+void QDiscordStateComponent::markViewGuildRebuilt(const QString& id)
+{
+	if(!_viewEnabled)
+		return;
+	_viewRebuiltGuilds.insert(id);
+	scheduleViewPublish();
+}
+
+void QDiscordStateComponent::markViewGuildChanged(const QString& id)
+{
+	if(!_viewEnabled)
+		return;
+	_viewChangedGuilds.insert(id);
+	scheduleViewPublish();
+}
+
+void QDiscordStateComponent::markViewMemberChanged(const QString& guildId,
+												   const QString& userId)
+{
+	if(!_viewEnabled)
+		return;
+	_viewChangedMembers[guildId].insert(userId);
+	scheduleViewPublish();
+}
+
+void QDiscordStateComponent::markViewSelfChanged()
+{
+	if(!_viewEnabled)
+		return;
+	_viewSelfChanged = true;
+	scheduleViewPublish();
+}
+
+void QDiscordStateComponent::markViewPrivateChannelsChanged()
+{
+	if(!_viewEnabled)
+		return;
+	_viewPrivateChannelsChanged = true;
+	scheduleViewPublish();
+}
+
+void QDiscordStateComponent::scheduleViewPublish()
+{
+	if(_viewPublishScheduled)
+		return;
+	_viewPublishScheduled = true;
+	QTimer::singleShot(0, this, &QDiscordStateComponent::publishView);
+}
+
+void QDiscordStateComponent::publishView()
+{
+	_viewPublishScheduled = false;
+	if(!_viewEnabled)
+		return;
+
+	std::shared_ptr<const QDiscordStateView> previous = std::atomic_load(&_view);
+	std::shared_ptr<QDiscordStateView> view =
+			std::make_shared<QDiscordStateView>();
+	if(previous && !_viewCleared)
+		*view = *previous;
+	view->_version = previous ? previous->version() + 1 : 1;
+
+	if(_viewSelfChanged || _viewCleared)
+		view->_self = _self ? *_self : QDiscordUser();
+	if(_viewPrivateChannelsChanged || _viewCleared)
+	{
+		view->_privateChannels.clear();
+		for(const QSharedPointer<QDiscordChannel>& item : _privateChannels)
+		{
+			view->_privateChannels.insert(
+						item->id(),
+						QSharedPointer<const QDiscordChannelView>(
+							new QDiscordChannelView(*item)
+						));
+		}
+	}
+
+	QSet<QString> changedGuilds = _viewRebuiltGuilds;
+	changedGuilds.unite(_viewChangedGuilds);
+	for(const QString& id : _viewChangedMembers.keys())
+		changedGuilds.insert(id);
+	for(const QString& id : changedGuilds)
+	{
+		QSharedPointer<QDiscordGuild> guild = _guilds.value(id);
+		if(!guild)
+		{
+			view->_guilds.remove(id);
+			continue;
+		}
+		QSharedPointer<const QDiscordGuildView> previousGuild =
+				view->_guilds.value(id);
+		QDiscordGuildView* guildView;
+		if(!previousGuild || _viewRebuiltGuilds.contains(id))
+			guildView = new QDiscordGuildView(*guild);
+		else
+		{
+			guildView = new QDiscordGuildView(*previousGuild, *guild,
+											  _viewChangedMembers.value(id),
+											  _viewChangedGuilds.contains(id));
+		}
+		view->_guilds.insert(id, QSharedPointer<const QDiscordGuildView>(guildView));
+	}
+
+	_viewCleared = false;
+	_viewSelfChanged = false;
+	_viewPrivateChannelsChanged = false;
+	_viewRebuiltGuilds.clear();
+	_viewChangedGuilds.clear();
+	_viewChangedMembers.clear();
+
+	quint64 version = view->version();
+	std::atomic_store(&_view, std::shared_ptr<const QDiscordStateView>(view));
+	emit viewPublished(version);
 }
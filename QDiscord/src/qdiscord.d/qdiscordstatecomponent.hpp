@@ -20,16 +20,31 @@
 #define QDISCORDSTATECOMPONENT_HPP
 
 #include <QObject>
+#include <QHash>
 #include <QMap>
+#include <QMetaMethod>
+#include <QSet>
+#include <QTimer>
+#include <memory>
 #include "qdiscordguild.hpp"
 #include "qdiscorduser.hpp"
 #include "qdiscordchannel.hpp"
 #include "qdiscordmessage.hpp"
+#include "qdiscordcachepolicy.hpp"
+#include "qdiscordeventbus.hpp"
+#include "qdiscordmessagecache.hpp"
+#include "qdiscordstatesnapshot.hpp"
+#include "qdiscordstateview.hpp"
+#include "qdiscordtypingtracker.hpp"
 
 /*!
  * \brief The state component of QDiscord.
  *
- * This class contains and manages all information related to the current state of the client.
+ * This class contains and manages all information related to the current state of the client.\n
+ * Changes to the state are published through the event bus returned by
+ * events(). The signals of this class are adapters on top of it: connecting to
+ * a signal subscribes to the corresponding QDiscordEvent, so events which
+ * nobody listens for through either way skip building their models.
  */
 class QDISCORD_API QDiscordStateComponent : public QObject
 {
@@ -44,11 +59,13 @@ public:
 	 * May return `nullptr` if nothing was found.
 	 * \returns `nullptr` if nothing was found.
 	 */
-	QSharedPointer<QDiscordGuild> guild(const QString& id) {
-		return _guilds.value(id, QSharedPointer<QDiscordGuild>());
-	}
-	///\brief Returns a map of pointers to all guilds and their IDs.
-	QMap<QString, QSharedPointer<QDiscordGuild>> guilds() {return _guilds;}
+	QSharedPointer<QDiscordGuild> guild(const QString& id);
+	/*!
+	 * \brief Returns a map of pointers to all guilds and their IDs.
+	 *
+	 * This decodes all guilds which are still pending from a loaded snapshot.
+	 */
+	QMap<QString, QSharedPointer<QDiscordGuild>> guilds();
 	/*!
 	 * \brief Returns a pointer to the channel that has the provided ID.
 	 * May return `nullptr` if nothing was found.
@@ -61,6 +78,153 @@ public:
 	}
 	///\brief Returns a pointer to this client's information.
 	QSharedPointer<QDiscordUser> self() {return _self;}
+	///\brief Returns the policy selecting which information is stored.
+	QDiscordCachePolicy cachePolicy() const {return _cachePolicy;}
+	/*!
+	 * \brief Sets the policy selecting which information is stored.
+	 *
+	 * The policy is applied to information received afterwards. Information
+	 * which is already stored is kept, except for members stored because of
+	 * QDiscordCachePolicy::MemberPolicy::Recent, which expire as usual.
+	 */
+	void setCachePolicy(const QDiscordCachePolicy& policy);
+	/*!
+	 * \brief Returns a pointer to the message cache.
+	 *
+	 * The cache is disabled by default. Use QDiscordMessageCache::setEnabled to
+	 * make deleted and updated messages carry their previous contents.
+	 */
+	QDiscordMessageCache* messageCache() {return &_messageCache;}
+	/*!
+	 * \brief Returns a pointer to the typing tracker.
+	 *
+	 * Connect to its signals in order to be notified when users start or stop
+	 * typing.
+	 */
+	QDiscordTypingTracker* typingTracker() {return &_typingTracker;}
+	/*!
+	 * \brief Returns a pointer to the event bus state changes are published
+	 * through.
+	 *
+	 * The bus must only be used from this object's thread.
+	 */
+	QDiscordEventBus* events() {return &_events;}
+	/*!
+	 * \brief Writes the current state into a snapshot file.
+	 *
+	 * The file is replaced atomically, so a failed write keeps the previous
+	 * snapshot intact.
+	 * \returns `false` if the snapshot could not be written.
+	 */
+	bool saveSnapshot(const QString& fileName);
+	/*!
+	 * \brief Replaces the current state with the contents of a snapshot file.
+	 *
+	 * The snapshot is memory-mapped. The client's user and private channels are
+	 * loaded immediately, while guilds are only decoded once they are accessed
+	 * through guild(), guilds() or channel(). Guilds received from the gateway
+	 * afterwards replace their snapshot counterparts.\n
+	 * Emits QDiscordStateComponent::selfCreated if the snapshot contains a user.
+	 * \returns `false` if the file could not be loaded.
+	 */
+	bool loadSnapshot(const QString& fileName);
+	/*!
+	 * \brief Periodically writes a snapshot into the provided file.
+	 * \param fileName The file to write snapshots into.
+	 * \param interval The delay between two snapshots in milliseconds. Set to 0
+	 * in order to stop writing snapshots.
+	 */
+	void setSnapshotInterval(const QString& fileName, int interval);
+	/*!
+	 * \brief Returns the approximate memory used by the stored state and the
+	 * message cache.
+	 *
+	 * Guilds still pending from a loaded snapshot are not included, as they are
+	 * only memory-mapped.
+	 */
+	QDiscordMemoryUsage memoryUsage() const;
+	/*!
+	 * \brief Returns the approximate memory used by the guild with the provided
+	 * ID, including its cached messages.
+	 */
+	QDiscordMemoryUsage memoryUsage(const QString& guildId) const;
+	///\brief Returns the approximate memory used by each guild, by guild ID.
+	QMap<QString, QDiscordMemoryUsage> guildMemoryUsage() const;
+	/*!
+	 * \brief Returns a human-readable report of the memory used by the state.
+	 *
+	 * Guilds are listed from largest to smallest.
+	 * \param maxGuilds The maximum amount of guilds to list. Set to 0 in order
+	 * to list all guilds.
+	 */
+	QString memoryUsageReport(int maxGuilds = 10) const;
+	/*!
+	 * \brief Periodically emits QDiscordStateComponent::memoryUsageReported.
+	 *
+	 * If the `QDISCORD_DEBUG` environment variable is set, the report is also
+	 * printed.
+	 * \param interval The delay between two reports in milliseconds. Set to 0
+	 * in order to stop reporting.
+	 */
+	void setMemoryReportInterval(int interval);
+	///\brief Returns whether the state is kept when the gateway disconnects.
+	bool staleModeEnabled() const {return _staleModeEnabled;}
+	/*!
+	 * \brief Sets whether the state is kept when the gateway disconnects.
+	 *
+	 * If enabled, a disconnect marks the state as stale instead of clearing
+	 * it. Once the client reconnects, the stored state is
+	 * reconciled against the READY and GUILD_CREATE events. Objects which did
+	 * not change keep their identity, so pointers held by user code stay
+	 * valid, and the regular created, updated and deleted signals are emitted
+	 * for everything that did change. guildCreated() and guildAvailable() are
+	 * still emitted for every reconciled guild.\n
+	 * If disabled, which is the default, the state is cleared on every
+	 * disconnect.
+	 */
+	void setStaleModeEnabled(bool enabled) {_staleModeEnabled = enabled;}
+	/*!
+	 * \brief Returns how long guilds are waited for after a READY event.
+	 * \see setStaleTimeout
+	 */
+	int staleTimeout() const {return _staleTimer.interval();}
+	/*!
+	 * \brief Sets how long guilds are waited for after a READY event.
+	 *
+	 * Guilds which are still unavailable once the timeout expires are kept
+	 * as unavailable guilds and no longer keep the state stale. Their data
+	 * is reconciled if they become available later on.
+	 * \param timeout The timeout in milliseconds. Set to 0 in order to wait
+	 * indefinitely. Defaults to 60000.
+	 */
+	void setStaleTimeout(int timeout) {_staleTimer.setInterval(timeout);}
+	/*!
+	 * \brief Returns whether the state is stale.
+	 *
+	 * The state is stale from a disconnect until the READY event and the
+	 * GUILD_CREATE events of all previously stored guilds have been reconciled,
+	 * or until the timeout set with setStaleTimeout() has expired.
+	 * \see staleChanged
+	 */
+	bool isStale() const {return _stale;}
+	///\brief Returns whether immutable views of the state are being published.
+	bool viewEnabled() const {return _viewEnabled;}
+	/*!
+	 * \brief Enables or disables publishing immutable views of the state.
+	 *
+	 * While enabled, a new QDiscordStateView is published once per event loop
+	 * iteration in which the state has changed. Only guilds which have changed
+	 * are copied, everything else is shared with the previous view.
+	 */
+	void setViewEnabled(bool enabled);
+	/*!
+	 * \brief Returns the most recently published view of the state.
+	 *
+	 * Unlike every other method of this class, this may be called from any thread.
+	 * The returned view never changes, so it can be read without locking.
+	 * \returns `nullptr` if views are disabled or none has been published yet.
+	 */
+	std::shared_ptr<const QDiscordStateView> view() const;
 signals:
 	/*!
 	 * \brief Emitted when a guild has been created.
@@ -82,6 +246,17 @@ signals:
 	 * \param guild An object containing information about the guild that was deleted.
 	 */
 	void guildDeleted(QDiscordGuild guild);
+	/*!
+	 * \brief Emitted when a guild's own properties have been updated.
+	 * \param guild A pointer to the guild that has been updated.
+	 */
+	void guildUpdated(QSharedPointer<QDiscordGuild> guild);
+	/*!
+	 * \brief Emitted when the state becomes stale or has been reconciled.
+	 * \param stale Whether the state is now stale.
+	 * \see isStale
+	 */
+	void staleChanged(bool stale);
 	/*!
 	 * \brief Emitted when a member has been added to a guild.
 	 * \param member A pointer to the guild member that has been added.
@@ -140,9 +315,10 @@ signals:
 	 */
 	void messageCreated(QDiscordMessage message);
 	/*!
-	 * \brief Emitted when a message has been created.
-	 * \param message An object containing information about the deleted message. Usually,
-	 * the only valid information is the ID.
+	 * \brief Emitted when a message has been deleted.
+	 * \param message An object containing information about the deleted message.
+	 * If the message was not in the message cache, the only valid information is
+	 * usually the ID.
 	 */
 	void messageDeleted(QDiscordMessage message);
 	/*!
@@ -151,8 +327,43 @@ signals:
 	 * \param editedTimestamp The timestamp when the message was edited.
 	 */
 	void messageUpdated(QDiscordMessage message, QDateTime editedTimestamp);
+	/*!
+	 * \brief Emitted when a message stored in the message cache has been updated.
+	 *
+	 * This is emitted after QDiscordStateComponent::messageUpdated.
+	 * \param previous An object containing the message before the update.
+	 * \param current An object containing the message after the update.
+	 */
+	void cachedMessageUpdated(QDiscordMessage previous, QDiscordMessage current);
+	/*!
+	 * \brief Emitted when a user has joined, left or moved between voice
+	 * channels, or their voice status has changed.
+	 * \param voiceState A pointer to the user's new voice state. If the user
+	 * has disconnected, its channel ID is empty and it is no longer stored.
+	 * \param previousChannelId The ID of the voice channel the user was
+	 * connected to before, if any.
+	 */
+	void voiceStateUpdated(QSharedPointer<QDiscordVoiceState> voiceState,
+						   QString previousChannelId);
+	/*!
+	 * \brief Emitted periodically with the memory used by the state.
+	 * \param total The memory used by the whole state.
+	 * \param guilds The memory used by each guild, by guild ID.
+	 * \see setMemoryReportInterval
+	 */
+	void memoryUsageReported(QDiscordMemoryUsage total,
+							 QMap<QString, QDiscordMemoryUsage> guilds);
+	/*!
+	 * \brief Emitted when a new view of the state has been published.
+	 * \param version The version of the published view.
+	 */
+	void viewPublished(quint64 version);
+protected:
+	void connectNotify(const QMetaMethod& signal) override;
+	void disconnectNotify(const QMetaMethod& signal) override;
 private:
 	void clear();
+	QDiscordEventBus::Subscription adaptSignal(const QMetaMethod& signal);
 	void readyReceived(const QJsonObject& object);
 	void guildCreateReceived(const QJsonObject& object);
 	void guildDeleteReceived(const QJsonObject& object);
@@ -176,9 +387,69 @@ private:
 	void channelCreateReceived(const QJsonObject& object);
 	void channelDeleteReceived(const QJsonObject& object);
 	void channelUpdateReceived(const QJsonObject& object);
+	void snapshotTimerTimeout();
+	void connectionLost();
+	void finishStale();
+	void staleTimerTimeout();
+	void reconcilePrivateChannels(const QJsonArray& channels);
+	void reconcileGuild(QSharedPointer<QDiscordGuild> guild,
+						const QJsonObject& object);
+	void updatePrivateChannel(QSharedPointer<QDiscordChannel> channel,
+							  const QJsonObject& object);
+	void memoryReportTimerTimeout();
+	void storePrivateChannel(QSharedPointer<QDiscordChannel> channel);
+	void removePrivateChannel(const QString& id);
+	QString selfId() const;
+	QJsonObject trimMember(const QJsonObject& object) const;
+	void touchRecentMember(const QString& guildId, const QString& userId);
+	void recentMemberTimerTimeout();
+	QSharedPointer<QDiscordGuild> loadSnapshotGuild(const QString& id);
+	void dropSnapshotGuild(const QString& id);
+	void markViewGuildRebuilt(const QString& id);
+	void markViewGuildChanged(const QString& id);
+	void markViewMemberChanged(const QString& guildId, const QString& userId);
+	void markViewSelfChanged();
+	void markViewPrivateChannelsChanged();
+	void scheduleViewPublish();
+	void publishView();
 	QMap<QString, QSharedPointer<QDiscordGuild> > _guilds;
 	QMap<QString, QSharedPointer<QDiscordChannel> > _privateChannels;
 	QSharedPointer<QDiscordUser> _self;
+	QDiscordMemoryUsage _privateChannelMemoryUsage;
+	QTimer _memoryReportTimer;
+	QDiscordCachePolicy _cachePolicy;
+	//Last activity of members stored because of MemberPolicy::Recent,
+	//by guild ID and user ID.
+	QHash<QString, QHash<QString, qint64>> _recentMembers;
+	QTimer _recentMemberTimer;
+	QDiscordMessageCache _messageCache;
+	QDiscordTypingTracker _typingTracker;
+	QDiscordEventBus _events;
+	//Bus subscriptions emitting connected signals, by signal method index.
+	QHash<int, QDiscordEventBus::Subscription> _signalAdapters;
+	QDiscordStateSnapshot _snapshot;
+	QSet<QString> _snapshotGuilds;
+	bool _staleModeEnabled;
+	bool _stale;
+	bool _staleReadyReceived;
+	//Guilds which have not been reconciled since the last disconnect.
+	QSet<QString> _staleGuilds;
+	//Guilds which were still unavailable when the stale timeout expired. They
+	//are reconciled once they become available.
+	QSet<QString> _unavailableGuilds;
+	QTimer _staleTimer;
+	QString _snapshotFileName;
+	QTimer _snapshotTimer;
+	bool _viewEnabled;
+	bool _viewPublishScheduled;
+	bool _viewCleared;
+	bool _viewSelfChanged;
+	bool _viewPrivateChannelsChanged;
+	QSet<QString> _viewRebuiltGuilds;
+	QSet<QString> _viewChangedGuilds;
+	QHash<QString, QSet<QString>> _viewChangedMembers;
+	//Only ever accessed through std::atomic_load and std::atomic_store.
+	std::shared_ptr<const QDiscordStateView> _view;
 };
 
 #endif // QDISCORDSTATECOMPONENT_HPP
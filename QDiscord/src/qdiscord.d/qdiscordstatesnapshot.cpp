@@ -0,0 +1,279 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCborMap>
+#include <QCborArray>
+#include <QDateTime>
+#include "qdiscordstatesnapshot.hpp"
+
+const quint32 QDiscordStateSnapshot::magic = 0x51445353; // "QDSS"
+const quint32 QDiscordStateSnapshot::version = 2;
+
+namespace
+{
+	//magic, version, creation time and index offset
+	const qint64 headerSize = 4 + 4 + 8 + 8;
+	const qint64 indexOffsetPosition = 4 + 4 + 8;
+}
+
+QDiscordStateSnapshot::QDiscordStateSnapshot()
+{
+	_data = nullptr;
+	_size = 0;
+	_createdAt = 0;
+	_self = Blob();
+	_privateChannels = Blob();
+}
+
+QDiscordStateSnapshot::~QDiscordStateSnapshot()
+{
+	close();
+}
+
+bool QDiscordStateSnapshot::open(const QString& fileName)
+{
+	close();
+	_file.setFileName(fileName);
+	if(!_file.open(QFile::ReadOnly))
+		return false;
+	_size = _file.size();
+	if(_size < headerSize)
+	{
+		close();
+		return false;
+	}
+	_data = _file.map(0, _size);
+	if(!_data)
+	{
+		close();
+		return false;
+	}
+
+	QByteArray mapped =
+			QByteArray::fromRawData(reinterpret_cast<const char*>(_data), _size);
+	QDataStream stream(mapped);
+	stream.setVersion(QDataStream::Qt_5_6);
+	quint32 fileMagic, fileVersion;
+	qint64 indexOffset;
+	stream>>fileMagic>>fileVersion>>_createdAt>>indexOffset;
+	if(fileMagic != magic || fileVersion != version ||
+			indexOffset < headerSize || indexOffset >= _size)
+	{
+		if(QDiscordUtilities::debugMode)
+			qDebug()<<"QDiscordStateSnapshot: invalid snapshot"<<fileName;
+		close();
+		return false;
+	}
+
+	stream.device()->seek(indexOffset);
+	qint32 guildCount;
+	stream>>_self.offset>>_self.size;
+	stream>>_privateChannels.offset>>_privateChannels.size;
+	stream>>guildCount;
+	for(qint32 i = 0; i < guildCount && stream.status() == QDataStream::Ok; i++)
+	{
+		QString id;
+		Blob blob;
+		stream>>id>>blob.offset>>blob.size>>blob.channelIds;
+		_guilds.insert(id, blob);
+		for(const QString& channelId : blob.channelIds)
+			_channels.insert(channelId, id);
+	}
+
+	bool valid = stream.status() == QDataStream::Ok;
+	QList<Blob> blobs = _guilds.values();
+	blobs.append(_self);
+	blobs.append(_privateChannels);
+	for(const Blob& blob : blobs)
+	{
+		if(blob.offset < 0 || blob.size < 0 ||
+				blob.offset + blob.size > indexOffset)
+		{
+			valid = false;
+		}
+	}
+	if(!valid)
+	{
+		if(QDiscordUtilities::debugMode)
+			qDebug()<<"QDiscordStateSnapshot: corrupt index in"<<fileName;
+		close();
+		return false;
+	}
+
+	if(QDiscordUtilities::debugMode)
+	{
+		qDebug()<<"QDiscordStateSnapshot: mapped"<<fileName<<"with"<<
+				  _guilds.size()<<"guilds";
+	}
+	return true;
+}
+
+void QDiscordStateSnapshot::close()
+{
+	if(_data)
+		_file.unmap(_data);
+	_data = nullptr;
+	_size = 0;
+	_createdAt = 0;
+	_self = Blob();
+	_privateChannels = Blob();
+	_guilds.clear();
+	_channels.clear();
+	_file.close();
+}
+
+QJsonObject QDiscordStateSnapshot::self() const
+{
+	return decode(_self).toMap().toJsonObject();
+}
+
+QJsonArray QDiscordStateSnapshot::privateChannels() const
+{
+	return decode(_privateChannels).toArray().toJsonArray();
+}
+
+QJsonObject QDiscordStateSnapshot::guild(const QString& id) const
+{
+	QHash<QString, Blob>::const_iterator blob = _guilds.find(id);
+	if(blob == _guilds.end())
+		return QJsonObject();
+	return decode(blob.value()).toMap().toJsonObject();
+}
+
+QByteArray QDiscordStateSnapshot::rawGuild(const QString& id) const
+{
+	QHash<QString, Blob>::const_iterator blob = _guilds.find(id);
+	if(blob == _guilds.end())
+		return QByteArray();
+	return raw(blob.value());
+}
+
+QByteArray QDiscordStateSnapshot::raw(const Blob& blob) const
+{
+	if(!_data || blob.size <= 0)
+		return QByteArray();
+	return QByteArray::fromRawData(
+				reinterpret_cast<const char*>(_data + blob.offset), blob.size);
+}
+
+QCborValue QDiscordStateSnapshot::decode(const Blob& blob) const
+{
+	//Decoding copies the blob into the CBOR containers, so the result stays
+	//valid after the file is unmapped.
+	QByteArray data = raw(blob);
+	if(data.isEmpty())
+		return QCborValue();
+	QCborParserError error;
+	QCborValue value = QCborValue::fromCbor(data, &error);
+	if(error.error != QCborError::NoError)
+	{
+		if(QDiscordUtilities::debugMode)
+		{
+			qDebug()<<"QDiscordStateSnapshot: corrupt blob at"<<blob.offset<<
+					  error.errorString();
+		}
+		return QCborValue();
+	}
+	return value;
+}
+
+QDiscordStateSnapshotWriter::QDiscordStateSnapshotWriter(const QString& fileName):
+	_file(fileName)
+{
+	_self = Blob();
+	_privateChannels = Blob();
+}
+
+bool QDiscordStateSnapshotWriter::open()
+{
+	if(!_file.open(QFile::WriteOnly))
+		return false;
+	_stream.setDevice(&_file);
+	_stream.setVersion(QDataStream::Qt_5_6);
+	_stream<<QDiscordStateSnapshot::magic<<QDiscordStateSnapshot::version<<
+			 QDateTime::currentMSecsSinceEpoch()<<qint64(0);
+	return _stream.status() == QDataStream::Ok;
+}
+
+void QDiscordStateSnapshotWriter::writeSelf(const QJsonObject& self)
+{
+	_self = writeBlob(QCborMap::fromJsonObject(self).toCborValue().toCbor());
+}
+
+void QDiscordStateSnapshotWriter::writePrivateChannels(const QJsonArray& channels)
+{
+	_privateChannels =
+			writeBlob(QCborArray::fromJsonArray(channels).toCborValue().toCbor());
+}
+
+void QDiscordStateSnapshotWriter::writeGuild(const QString& id,
+											 const QJsonObject& guild)
+{
+	QStringList channelIds;
+	for(const QJsonValue& item : guild["channels"].toArray())
+		channelIds.append(item.toObject()["id"].toString(""));
+	writeRawGuild(id, QCborMap::fromJsonObject(guild).toCborValue().toCbor(),
+				  channelIds);
+}
+
+void QDiscordStateSnapshotWriter::writeRawGuild(const QString& id,
+												const QByteArray& guild,
+												const QStringList& channelIds)
+{
+	Blob blob = writeBlob(guild);
+	blob.channelIds = channelIds;
+	_guilds.append(qMakePair(id, blob));
+}
+
+bool QDiscordStateSnapshotWriter::commit()
+{
+	if(!_file.isOpen())
+		return false;
+	qint64 indexOffset = _file.pos();
+	_stream<<_self.offset<<_self.size;
+	_stream<<_privateChannels.offset<<_privateChannels.size;
+	_stream<<qint32(_guilds.size());
+	for(const QPair<QString, Blob>& item : _guilds)
+	{
+		_stream<<item.first<<item.second.offset<<item.second.size<<
+				 item.second.channelIds;
+	}
+	if(!_file.seek(indexOffsetPosition))
+	{
+		_file.cancelWriting();
+		return false;
+	}
+	_stream<<indexOffset;
+	if(_stream.status() != QDataStream::Ok)
+	{
+		_file.cancelWriting();
+		return false;
+	}
+	return _file.commit();
+}
+
+QDiscordStateSnapshotWriter::Blob
+QDiscordStateSnapshotWriter::writeBlob(const QByteArray& data)
+{
+	Blob blob;
+	blob.offset = _file.pos();
+	blob.size = data.size();
+	if(_file.write(data) != data.size())
+		_stream.setStatus(QDataStream::WriteFailed);
+	return blob;
+}
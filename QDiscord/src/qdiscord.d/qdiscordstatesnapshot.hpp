@@ -0,0 +1,161 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDSTATESNAPSHOT_HPP
+#define QDISCORDSTATESNAPSHOT_HPP
+
+#include <QCborValue>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QDataStream>
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief A read-only view of a state snapshot file.
+ *
+ * Snapshot files store the client's user, its private channels and every guild
+ * with its channels and members. They are written by QDiscordStateSnapshotWriter
+ * and are usually handled through QDiscordStateComponent::saveSnapshot and
+ * QDiscordStateComponent::loadSnapshot.\n
+ * The file is memory-mapped when opened and only the index is read. Guilds are
+ * stored as separate CBOR blobs, which are decoded one at a time when they are
+ * requested.
+ */
+class QDISCORD_API QDiscordStateSnapshot
+{
+public:
+	///\brief The magic number at the start of every snapshot file.
+	static const quint32 magic;
+	///\brief The format version written by this version of the library.
+	static const quint32 version;
+	///\brief Default public constructor.
+	QDiscordStateSnapshot();
+	~QDiscordStateSnapshot();
+	/*!
+	 * \brief Maps the provided snapshot file and reads its index.
+	 * \returns `false` if the file could not be mapped, is not a snapshot
+	 * or was written by an incompatible version.
+	 */
+	bool open(const QString& fileName);
+	///\brief Unmaps the snapshot file.
+	void close();
+	///\brief Returns the name of the mapped snapshot file.
+	QString fileName() const {return _file.fileName();}
+	///\brief Returns whether a snapshot file is currently mapped.
+	bool isOpen() const {return _data != nullptr;}
+	///\brief Returns the time at which the snapshot was written, in milliseconds since epoch.
+	qint64 createdAt() const {return _createdAt;}
+	///\brief Returns the JSON object of the client's user.
+	QJsonObject self() const;
+	///\brief Returns the JSON objects of the client's private channels.
+	QJsonArray privateChannels() const;
+	///\brief Returns the IDs of all guilds in the snapshot.
+	QStringList guildIds() const {return _guilds.keys();}
+	///\brief Returns whether the snapshot contains the guild with the provided ID.
+	bool containsGuild(const QString& id) const {return _guilds.contains(id);}
+	/*!
+	 * \brief Returns the ID of the guild which contains the channel with the
+	 * provided ID.
+	 * \returns An empty string if no guild in the snapshot contains the channel.
+	 */
+	QString channelGuild(const QString& channelId) const {
+		return _channels.value(channelId);
+	}
+	///\brief Returns the IDs of all channels of the guild with the provided ID.
+	QStringList guildChannelIds(const QString& id) const {
+		return _guilds.value(id).channelIds;
+	}
+	/*!
+	 * \brief Decodes the guild with the provided ID.
+	 * \returns An empty object if the guild is not contained in the snapshot.
+	 */
+	QJsonObject guild(const QString& id) const;
+	/*!
+	 * \brief Returns the encoded blob of the guild with the provided ID.
+	 *
+	 * This allows writing guilds which were never decoded into a new snapshot
+	 * without decoding them. The returned array does not copy the mapped data
+	 * and must not outlive this object.
+	 */
+	QByteArray rawGuild(const QString& id) const;
+private:
+	struct Blob
+	{
+		qint64 offset;
+		qint32 size;
+		QStringList channelIds;
+	};
+	QByteArray raw(const Blob& blob) const;
+	QCborValue decode(const Blob& blob) const;
+	QFile _file;
+	uchar* _data;
+	qint64 _size;
+	qint64 _createdAt;
+	Blob _self;
+	Blob _privateChannels;
+	QHash<QString, Blob> _guilds;
+	QHash<QString, QString> _channels;
+};
+
+/*!
+ * \brief Writes state snapshot files which can be read by QDiscordStateSnapshot.
+ *
+ * The file is written to a temporary location and only replaces the target
+ * file once commit() succeeds, so an interrupted write never leaves a corrupt
+ * snapshot behind.
+ */
+class QDISCORD_API QDiscordStateSnapshotWriter
+{
+public:
+	///\brief Creates a writer for the provided file name.
+	QDiscordStateSnapshotWriter(const QString& fileName);
+	///\brief Opens the temporary file and writes the snapshot header.
+	bool open();
+	///\brief Writes the client's user.
+	void writeSelf(const QJsonObject& self);
+	///\brief Writes the client's private channels.
+	void writePrivateChannels(const QJsonArray& channels);
+	///\brief Writes a guild serialized by QDiscordGuild::toJson.
+	void writeGuild(const QString& id, const QJsonObject& guild);
+	///\brief Writes a guild blob acquired from QDiscordStateSnapshot::rawGuild.
+	void writeRawGuild(const QString& id, const QByteArray& guild,
+					   const QStringList& channelIds);
+	/*!
+	 * \brief Writes the index and atomically replaces the target file.
+	 * \returns `false` if any write has failed.
+	 */
+	bool commit();
+private:
+	struct Blob
+	{
+		qint64 offset;
+		qint32 size;
+		QStringList channelIds;
+	};
+	Blob writeBlob(const QByteArray& data);
+	QSaveFile _file;
+	QDataStream _stream;
+	Blob _self;
+	Blob _privateChannels;
+	QList<QPair<QString, Blob>> _guilds;
+};
+
+#endif // QDISCORDSTATESNAPSHOT_HPP
@@ -0,0 +1,357 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtAlgorithms>
+#include "qdiscordstateview.hpp"
+
+QDiscordChannelView::QDiscordChannelView(const QDiscordChannel& channel)
+{
+	_id = channel.id();
+	_name = channel.name();
+	_topic = channel.topic();
+	_position = channel.position();
+	_type = channel.type();
+	_isPrivate = channel.isPrivate();
+	_lastMessageId = channel.lastMessageId();
+	_guildId = channel.guild() ? channel.guild()->id() : QString();
+	_recipientId = channel.recipient() ? channel.recipient()->id() : QString();
+}
+
+QDiscordMemberView::QDiscordMemberView(const QDiscordMember& member)
+{
+	QSharedPointer<QDiscordUser> user = member.user();
+	_userId = user ? user->id() : QString();
+	_username = user ? user->username() : QString();
+	_discriminator = user ? user->discriminator() : QString();
+	_avatar = user ? user->avatar() : QString();
+	_bot = user ? user->bot() : false;
+	_nickname = member.nickname();
+	_joinedAt = member.joinedAtMSecs();
+	_deaf = member.deaf();
+	_mute = member.mute();
+}
+
+namespace
+{
+	//The bits of a member's hash consumed by each level of the trie.
+	const int levelBits = 5;
+	//Nodes below this shift have used up the hash and hold colliding members.
+	const int hashBits = 64;
+
+	int fragment(quint64 hash, int shift)
+	{
+		return int(hash >> shift) & ((1 << levelBits) - 1);
+	}
+}
+
+/*!
+ * A slot either holds a member or points at the node one level below. Members
+ * are kept in the slot for the first fragment of their hash which is not
+ * shared with another member.
+ */
+struct QDiscordGuildView::MemberSlot
+{
+	MemberSlot(): hash(0) {}
+	quint64 hash;
+	QSharedPointer<const QDiscordMemberView> member;
+	MemberNodePointer child;
+};
+
+/*!
+ * Only occupied slots are stored. Bit i of the bitmap is set if the slot for
+ * fragment i is occupied, and the slots are stored in the order of their bits.
+ */
+struct QDiscordGuildView::MemberNode
+{
+	MemberNode(): bitmap(0) {}
+	quint32 bitmap;
+	QVector<MemberSlot> slots;
+	int position(quint32 bit) const {return qPopulationCount(bitmap & (bit - 1));}
+};
+
+QDiscordGuildView::QDiscordGuildView(const QDiscordGuild& guild)
+{
+	copyProperties(guild);
+	QVector<MemberSlot> leaves;
+	leaves.reserve(guild.members().size());
+	for(const QSharedPointer<QDiscordMember>& item : guild.members())
+	{
+		if(!item->user())
+			continue;
+		MemberSlot leaf;
+		leaf.hash = memberHash(item->user()->id());
+		leaf.member = QSharedPointer<const QDiscordMemberView>(
+					new QDiscordMemberView(*item)
+					);
+		leaves.append(leaf);
+	}
+	if(!leaves.isEmpty())
+		_members = buildMembers(leaves, 0);
+	_copiedMemberSlots = 0;
+}
+
+QDiscordGuildView::QDiscordGuildView(const QDiscordGuildView& previous,
+									 const QDiscordGuild& guild,
+									 const QSet<QString>& changedMembers,
+									 bool guildChanged):
+	QDiscordGuildView(previous)
+{
+	if(guildChanged)
+		copyProperties(guild);
+
+	_copiedMemberSlots = 0;
+	for(const QString& userId : changedMembers)
+	{
+		QSharedPointer<QDiscordMember> member = guild.member(userId);
+		if(member)
+		{
+			MemberSlot leaf;
+			leaf.hash = memberHash(userId);
+			leaf.member = QSharedPointer<const QDiscordMemberView>(
+						new QDiscordMemberView(*member)
+						);
+			_members = insertMember(_members, 0, leaf, _copiedMemberSlots);
+		}
+		else
+		{
+			_members = removeMember(_members, 0, memberHash(userId), userId,
+									_copiedMemberSlots);
+		}
+	}
+}
+
+QSharedPointer<const QDiscordMemberView>
+QDiscordGuildView::member(const QString& userId) const
+{
+	quint64 hash = memberHash(userId);
+	const MemberNode* node = _members.data();
+	for(int shift = 0; node; shift += levelBits)
+	{
+		if(shift >= hashBits)
+		{
+			for(const MemberSlot& slot : node->slots)
+			{
+				if(slot.member->userId() == userId)
+					return slot.member;
+			}
+			break;
+		}
+		quint32 bit = 1u << fragment(hash, shift);
+		if(!(node->bitmap & bit))
+			break;
+		const MemberSlot& slot = node->slots[node->position(bit)];
+		if(!slot.child)
+		{
+			if(slot.member->userId() == userId)
+				return slot.member;
+			break;
+		}
+		node = slot.child.data();
+	}
+	return QSharedPointer<const QDiscordMemberView>();
+}
+
+QList<QSharedPointer<const QDiscordMemberView>>
+QDiscordGuildView::members() const
+{
+	QList<QSharedPointer<const QDiscordMemberView>> members;
+	if(_members)
+		collectMembers(*_members, members);
+	return members;
+}
+
+quint64 QDiscordGuildView::memberHash(const QString& userId)
+{
+	bool ok;
+	quint64 hash = userId.toULongLong(&ok);
+	if(!ok)
+		hash = qHash(userId);
+	//Snowflakes that are close to each other share most of their bits, so they
+	//are mixed to spread them over the whole trie. The mix is reversible, so
+	//different snowflakes never collide.
+	hash ^= hash >> 33;
+	hash *= Q_UINT64_C(0xff51afd7ed558ccd);
+	hash ^= hash >> 33;
+	hash *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+	hash ^= hash >> 33;
+	return hash;
+}
+
+QDiscordGuildView::MemberNodePointer
+QDiscordGuildView::buildMembers(const QVector<MemberSlot>& slots, int shift)
+{
+	MemberNode* node = new MemberNode;
+	if(shift >= hashBits)
+	{
+		node->slots = slots;
+		return MemberNodePointer(node);
+	}
+	QVector<QVector<MemberSlot>> groups(1 << levelBits);
+	for(const MemberSlot& slot : slots)
+		groups[fragment(slot.hash, shift)].append(slot);
+	for(int i = 0; i < groups.size(); i++)
+	{
+		if(groups[i].isEmpty())
+			continue;
+		node->bitmap |= 1u << i;
+		if(groups[i].size() == 1)
+			node->slots.append(groups[i].first());
+		else
+		{
+			MemberSlot slot;
+			slot.child = buildMembers(groups[i], shift + levelBits);
+			node->slots.append(slot);
+		}
+	}
+	return MemberNodePointer(node);
+}
+
+QDiscordGuildView::MemberNodePointer
+QDiscordGuildView::insertMember(const MemberNodePointer& node, int shift,
+								const MemberSlot& leaf, int& copied)
+{
+	MemberNode* copy = node ? new MemberNode(*node) : new MemberNode;
+	copied += copy->slots.size();
+	if(shift >= hashBits)
+	{
+		for(MemberSlot& slot : copy->slots)
+		{
+			if(slot.member->userId() == leaf.member->userId())
+			{
+				slot = leaf;
+				return MemberNodePointer(copy);
+			}
+		}
+		copy->slots.append(leaf);
+		return MemberNodePointer(copy);
+	}
+	quint32 bit = 1u << fragment(leaf.hash, shift);
+	int position = copy->position(bit);
+	if(!(copy->bitmap & bit))
+	{
+		copy->bitmap |= bit;
+		copy->slots.insert(position, leaf);
+		return MemberNodePointer(copy);
+	}
+	MemberSlot& slot = copy->slots[position];
+	if(slot.child)
+		slot.child = insertMember(slot.child, shift + levelBits, leaf, copied);
+	else if(slot.member->userId() == leaf.member->userId())
+		slot = leaf;
+	else
+	{
+		//Both members move one level down, where their hashes may differ.
+		MemberNodePointer child =
+				insertMember(MemberNodePointer(), shift + levelBits, slot, copied);
+		slot = MemberSlot();
+		slot.child = insertMember(child, shift + levelBits, leaf, copied);
+	}
+	return MemberNodePointer(copy);
+}
+
+QDiscordGuildView::MemberNodePointer
+QDiscordGuildView::removeMember(const MemberNodePointer& node, int shift,
+								quint64 hash, const QString& userId,
+								int& copied)
+{
+	if(!node)
+		return node;
+	if(shift >= hashBits)
+	{
+		for(int i = 0; i < node->slots.size(); i++)
+		{
+			if(node->slots[i].member->userId() != userId)
+				continue;
+			if(node->slots.size() == 1)
+				return MemberNodePointer();
+			MemberNode* copy = new MemberNode(*node);
+			copied += copy->slots.size();
+			copy->slots.remove(i);
+			return MemberNodePointer(copy);
+		}
+		return node;
+	}
+	quint32 bit = 1u << fragment(hash, shift);
+	if(!(node->bitmap & bit))
+		return node;
+	int position = node->position(bit);
+	const MemberSlot& slot = node->slots[position];
+	MemberNodePointer child;
+	if(slot.child)
+	{
+		child = removeMember(slot.child, shift + levelBits, hash, userId, copied);
+		if(child == slot.child)
+			return node;
+	}
+	else if(slot.member->userId() != userId)
+		return node;
+	if(!child && node->slots.size() == 1)
+		return MemberNodePointer();
+
+	MemberNode* copy = new MemberNode(*node);
+	copied += copy->slots.size();
+	if(!child)
+	{
+		copy->bitmap &= ~bit;
+		copy->slots.remove(position);
+	}
+	else if(child->slots.size() == 1 && !child->slots.first().child)
+	{
+		//A single remaining member moves up into this node.
+		copy->slots[position] = child->slots.first();
+	}
+	else
+		copy->slots[position].child = child;
+	return MemberNodePointer(copy);
+}
+
+void QDiscordGuildView::collectMembers(
+		const MemberNode& node,
+		QList<QSharedPointer<const QDiscordMemberView>>& members)
+{
+	for(const MemberSlot& slot : node.slots)
+	{
+		if(slot.child)
+			collectMembers(*slot.child, members);
+		else
+			members.append(slot.member);
+	}
+}
+
+void QDiscordGuildView::copyProperties(const QDiscordGuild& guild)
+{
+	_id = guild.id();
+	_name = guild.name();
+	_unavailable = guild.unavailable();
+	_verificationLevel = guild.verificationLevel();
+	_afkTimeout = guild.afkTimeout();
+	_memberCount = guild.memberCount();
+	_joinedAt = guild.joinedAtMSecs();
+	_channels.clear();
+	for(const QSharedPointer<QDiscordChannel>& item : guild.channels())
+	{
+		_channels.insert(item->id(), QSharedPointer<const QDiscordChannelView>(
+							 new QDiscordChannelView(*item)
+							 ));
+	}
+}
+
+QDiscordStateView::QDiscordStateView()
+{
+	_version = 0;
+}
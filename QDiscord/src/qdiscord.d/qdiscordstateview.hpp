@@ -0,0 +1,243 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDSTATEVIEW_HPP
+#define QDISCORDSTATEVIEW_HPP
+
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
+#include "qdiscordguild.hpp"
+#include "qdiscorduser.hpp"
+#include "qdiscordutilities.hpp"
+
+class QDiscordStateComponent;
+
+///\brief An immutable copy of a channel, part of a QDiscordStateView.
+class QDISCORD_API QDiscordChannelView
+{
+public:
+	///\brief Copies the provided channel.
+	explicit QDiscordChannelView(const QDiscordChannel& channel);
+	///\brief Returns the channel's ID.
+	QString id() const {return _id;}
+	///\brief Returns the channel's name.
+	QString name() const {return _name;}
+	///\brief Returns the channel's topic.
+	QString topic() const {return _topic;}
+	///\brief Returns the channel's position in the channel list.
+	int position() const {return _position;}
+	///\brief Returns the channel's type.
+	QDiscordChannel::ChannelType type() const {return _type;}
+	///\brief Returns whether the channel is a private or a guild channel.
+	bool isPrivate() const {return _isPrivate;}
+	///\brief Returns the ID of the last sent message.
+	QString lastMessageId() const {return _lastMessageId;}
+	///\brief Returns the ID of the channel's guild, if this is a guild channel.
+	QString guildId() const {return _guildId;}
+	///\brief Returns the ID of the channel's recipient, if this is a private channel.
+	QString recipientId() const {return _recipientId;}
+private:
+	QString _id;
+	QString _name;
+	QString _topic;
+	int _position;
+	QDiscordChannel::ChannelType _type;
+	bool _isPrivate;
+	QString _lastMessageId;
+	QString _guildId;
+	QString _recipientId;
+};
+
+///\brief An immutable copy of a guild member, part of a QDiscordStateView.
+class QDISCORD_API QDiscordMemberView
+{
+public:
+	///\brief Copies the provided member.
+	explicit QDiscordMemberView(const QDiscordMember& member);
+	///\brief Returns the member's user ID.
+	QString userId() const {return _userId;}
+	///\brief Returns the member's username.
+	QString username() const {return _username;}
+	///\brief Returns the member's discriminator.
+	QString discriminator() const {return _discriminator;}
+	///\brief Returns the member's avatar string.
+	QString avatar() const {return _avatar;}
+	///\brief Returns whether the member is a bot.
+	bool bot() const {return _bot;}
+	///\brief Returns the member's nickname.
+	QString nickname() const {return _nickname;}
+	///\brief Returns the date at which the member has joined the guild.
+	QDateTime joinedAt() const
+	{return QDiscordUtilities::timestampToDateTime(_joinedAt);}
+	///\brief Returns whether the member has disabled their speakers.
+	bool deaf() const {return _deaf;}
+	///\brief Returns whether the member has muted their microphone.
+	bool mute() const {return _mute;}
+private:
+	QString _userId;
+	QString _username;
+	QString _discriminator;
+	QString _avatar;
+	bool _bot;
+	QString _nickname;
+	qint64 _joinedAt;
+	bool _deaf;
+	bool _mute;
+};
+
+/*!
+ * \brief An immutable copy of a guild, part of a QDiscordStateView.
+ *
+ * Members are stored in a persistent hash trie keyed by their user ID, with
+ * 32 slots per node. When a view is published, only the nodes on the paths to
+ * changed members are copied, while all other nodes are shared with the
+ * previous view. Publishing a change therefore copies a number of slots that
+ * grows with the logarithm of the guild's size.
+ */
+class QDISCORD_API QDiscordGuildView
+{
+public:
+	///\brief Copies the provided guild, including all of its channels and members.
+	explicit QDiscordGuildView(const QDiscordGuild& guild);
+	/*!
+	 * \brief Creates a view of the provided guild based on a previous view.
+	 * \param previous The previous view of the same guild.
+	 * \param guild The guild to copy changes from.
+	 * \param changedMembers The IDs of the members which were added, removed
+	 * or updated since the previous view was created.
+	 * \param guildChanged Whether the guild's own properties or its channels
+	 * have changed since the previous view was created.
+	 */
+	QDiscordGuildView(const QDiscordGuildView& previous,
+					  const QDiscordGuild& guild,
+					  const QSet<QString>& changedMembers,
+					  bool guildChanged);
+	///\brief Returns the guild's ID.
+	QString id() const {return _id;}
+	///\brief Returns the guild's name.
+	QString name() const {return _name;}
+	///\brief Returns whether the guild is unavailable.
+	bool unavailable() const {return _unavailable;}
+	///\brief Returns the guild's verification level.
+	int verificationLevel() const {return _verificationLevel;}
+	///\brief Returns the guild's AFK time needed to move a user to the AFK channel.
+	int afkTimeout() const {return _afkTimeout;}
+	///\brief Returns the guild's member count.
+	int memberCount() const {return _memberCount;}
+	///\brief Returns the date the current user joined this guild.
+	QDateTime joinedAt() const
+	{return QDiscordUtilities::timestampToDateTime(_joinedAt);}
+	///\brief Returns a map of the guild's channels and their IDs.
+	QMap<QString, QSharedPointer<const QDiscordChannelView>>
+	channels() const {return _channels;}
+	/*!
+	 * \brief Returns the channel with the provided ID.
+	 * \returns `nullptr` if the channel was not found.
+	 */
+	QSharedPointer<const QDiscordChannelView> channel(const QString& id) const {
+		return _channels.value(id);
+	}
+	/*!
+	 * \brief Returns the member with the provided user ID.
+	 * \returns `nullptr` if the member was not found.
+	 */
+	QSharedPointer<const QDiscordMemberView> member(const QString& userId) const;
+	///\brief Returns a list of all of the guild's members.
+	QList<QSharedPointer<const QDiscordMemberView>> members() const;
+	/*!
+	 * \brief Returns the amount of member slots which were copied from the
+	 * previous view when this view was created.
+	 *
+	 * Views copied from a guild directly do not have a previous view and
+	 * return 0.
+	 */
+	int copiedMemberSlots() const {return _copiedMemberSlots;}
+private:
+	struct MemberNode;
+	struct MemberSlot;
+	typedef QSharedPointer<const MemberNode> MemberNodePointer;
+	static quint64 memberHash(const QString& userId);
+	static MemberNodePointer buildMembers(const QVector<MemberSlot>& slots,
+										  int shift);
+	static MemberNodePointer
+	insertMember(const MemberNodePointer& node, int shift,
+				 const MemberSlot& leaf, int& copied);
+	static MemberNodePointer
+	removeMember(const MemberNodePointer& node, int shift, quint64 hash,
+				 const QString& userId, int& copied);
+	static void collectMembers(const MemberNode& node,
+							   QList<QSharedPointer<const QDiscordMemberView>>& members);
+	void copyProperties(const QDiscordGuild& guild);
+	QString _id;
+	QString _name;
+	bool _unavailable;
+	int _verificationLevel;
+	int _afkTimeout;
+	int _memberCount;
+	qint64 _joinedAt;
+	QMap<QString, QSharedPointer<const QDiscordChannelView>> _channels;
+	MemberNodePointer _members;
+	int _copiedMemberSlots;
+};
+
+/*!
+ * \brief An immutable, versioned copy of the state held by QDiscordStateComponent.
+ *
+ * Views are published by the state component on its own thread and can be
+ * acquired from any thread through QDiscordStateComponent::view(). A view never
+ * changes after it has been published, so no locking is required to read it.
+ */
+class QDISCORD_API QDiscordStateView
+{
+	friend class QDiscordStateComponent;
+public:
+	///\brief Creates an empty view.
+	QDiscordStateView();
+	/*!
+	 * \brief Returns the version of this view.
+	 *
+	 * Each published view has a higher version than the previous one.
+	 */
+	quint64 version() const {return _version;}
+	///\brief Returns a copy of this client's user.
+	QDiscordUser self() const {return _self;}
+	///\brief Returns a map of all guilds and their IDs.
+	QMap<QString, QSharedPointer<const QDiscordGuildView>>
+	guilds() const {return _guilds;}
+	/*!
+	 * \brief Returns the guild with the provided ID.
+	 * \returns `nullptr` if the guild was not found.
+	 */
+	QSharedPointer<const QDiscordGuildView> guild(const QString& id) const {
+		return _guilds.value(id);
+	}
+	///\brief Returns a map of all private channels and their IDs.
+	QMap<QString, QSharedPointer<const QDiscordChannelView>>
+	privateChannels() const {return _privateChannels;}
+private:
+	quint64 _version;
+	QDiscordUser _self;
+	QMap<QString, QSharedPointer<const QDiscordGuildView>> _guilds;
+	QMap<QString, QSharedPointer<const QDiscordChannelView>> _privateChannels;
+};
+
+#endif // QDISCORDSTATEVIEW_HPP
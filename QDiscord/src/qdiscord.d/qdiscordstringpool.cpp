@@ -0,0 +1,130 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QMutex>
+#include <QSet>
+#include "qdiscordstringpool.hpp"
+
+namespace
+{
+	const int minimumSweepThreshold = 1024;
+
+	struct Shard
+	{
+		Shard()
+		{
+			sweepThreshold = minimumSweepThreshold;
+			lookups = 0;
+			hits = 0;
+			bytesSaved = 0;
+		}
+		QMutex mutex;
+		QSet<QString> strings;
+		int sweepThreshold;
+		quint64 lookups;
+		quint64 hits;
+		qint64 bytesSaved;
+	};
+
+	struct Pool
+	{
+		Shard shards[QDiscordStringPool::shardCount];
+	};
+
+	Q_GLOBAL_STATIC(Pool, pool)
+
+	//Removes strings which are only referenced by the pool itself.
+	int sweep(Shard& shard)
+	{
+		int removed = 0;
+		QSet<QString>::iterator item = shard.strings.begin();
+		while(item != shard.strings.end())
+		{
+			if(item->isDetached())
+			{
+				item = shard.strings.erase(item);
+				removed++;
+			}
+			else
+				++item;
+		}
+		shard.sweepThreshold = qMax(minimumSweepThreshold,
+									shard.strings.size()*2);
+		return removed;
+	}
+}
+
+QString QDiscordStringPool::intern(const QString& string)
+{
+	if(string.isEmpty())
+		return string;
+	Shard& shard = pool()->shards[qHash(string) % shardCount];
+	QMutexLocker locker(&shard.mutex);
+	shard.lookups++;
+	QSet<QString>::const_iterator item = shard.strings.constFind(string);
+	if(item != shard.strings.constEnd())
+	{
+		shard.hits++;
+		shard.bytesSaved += sizeof(QArrayData) + (string.size() + 1)*sizeof(QChar);
+		return *item;
+	}
+	if(shard.strings.size() >= shard.sweepThreshold)
+		sweep(shard);
+	shard.strings.insert(string);
+	return string;
+}
+
+QDiscordStringPool::Statistics QDiscordStringPool::statistics()
+{
+	Statistics statistics;
+	statistics.lookups = 0;
+	statistics.hits = 0;
+	statistics.bytesSaved = 0;
+	statistics.strings = 0;
+	for(Shard& shard : pool()->shards)
+	{
+		QMutexLocker locker(&shard.mutex);
+		statistics.lookups += shard.lookups;
+		statistics.hits += shard.hits;
+		statistics.bytesSaved += shard.bytesSaved;
+		statistics.strings += shard.strings.size();
+	}
+	return statistics;
+}
+
+void QDiscordStringPool::resetStatistics()
+{
+	for(Shard& shard : pool()->shards)
+	{
+		QMutexLocker locker(&shard.mutex);
+		shard.lookups = 0;
+		shard.hits = 0;
+		shard.bytesSaved = 0;
+	}
+}
+
+int QDiscordStringPool::purge()
+{
+	int removed = 0;
+	for(Shard& shard : pool()->shards)
+	{
+		QMutexLocker locker(&shard.mutex);
+		removed += sweep(shard);
+	}
+	return removed;
+}
@@ -0,0 +1,70 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDSTRINGPOOL_HPP
+#define QDISCORDSTRINGPOOL_HPP
+
+#include <QString>
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief A process-wide pool of interned strings.
+ *
+ * Model constructors pass low-cardinality fields, such as channel names, game
+ * names and nicknames, through intern(). Equal strings then share a single
+ * allocation instead of each object holding its own copy.\n
+ * The pool is split into shards, each with its own lock, so it may be used from
+ * any thread. Strings are only weakly held: once no object references a pooled
+ * string anymore, it is removed during the next sweep of its shard.
+ */
+class QDISCORD_API QDiscordStringPool
+{
+public:
+	///\brief A struct used for storing statistics about the pool.
+	struct Statistics
+	{
+		quint64 lookups;	///<\brief The amount of calls to intern().
+		quint64 hits;		///<\brief The amount of lookups which found a pooled string.
+		qint64 bytesSaved;	///<\brief Bytes not allocated twice thanks to hits.
+		int strings;		///<\brief The amount of strings currently pooled.
+		///\brief Returns the ratio of lookups which found a pooled string.
+		double hitRate() const {return lookups ? double(hits)/lookups : 0.0;}
+	};
+	///\brief The amount of shards the pool is split into.
+	static const int shardCount = 16;
+	/*!
+	 * \brief Returns a pooled string equal to the provided one.
+	 *
+	 * If no equal string is pooled yet, the provided string is added to the pool
+	 * and returned.
+	 */
+	static QString intern(const QString& string);
+	///\brief Returns statistics summed over all shards.
+	static Statistics statistics();
+	///\brief Resets the lookup, hit and bytes saved counters.
+	static void resetStatistics();
+	/*!
+	 * \brief Removes all pooled strings which are no longer referenced.
+	 *
+	 * Shards are also swept automatically whenever they grow.
+	 * \returns The amount of removed strings.
+	 */
+	static int purge();
+};
+
+#endif // QDISCORDSTRINGPOOL_HPP
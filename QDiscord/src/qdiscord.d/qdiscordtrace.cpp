@@ -0,0 +1,457 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include "qdiscordtrace.hpp"
+
+std::atomic<int> QDiscordTrace::_levels[static_cast<int>(Category::Count)];
+
+namespace
+{
+	struct Record
+	{
+		qint64 timestamp;
+		const char* name;
+		quint64 value;
+		QDiscordTrace::Category category;
+		QDiscordTrace::Phase phase;
+	};
+
+	//A buffer written by a single thread and read by whichever thread holds
+	//the drain mutex.
+	struct Ring
+	{
+		static const quint32 capacity = 4096;
+		Record records[capacity];
+		std::atomic<quint32> head{0};
+		std::atomic<quint32> tail{0};
+		std::atomic<bool> finished{false};
+		quint32 thread = 0;
+		//Only used by the writing thread. Scopes are nested, so a slot is kept
+		//free for the End of every open scope whose Begin was written.
+		quint32 openScopes = 0;
+		quint32 writtenScopes = 0;
+		//The nesting depth of the outermost scope whose Begin was dropped, 0 if
+		//there is none. Begin and End records of it and its inner scopes are
+		//dropped.
+		quint32 droppedScope = 0;
+	};
+
+	const char* categoryName(QDiscordTrace::Category category)
+	{
+		switch(category)
+		{
+		case QDiscordTrace::Category::Model:
+			return "model";
+		case QDiscordTrace::Category::Gateway:
+			return "gateway";
+		case QDiscordTrace::Category::State:
+			return "state";
+		case QDiscordTrace::Category::Rest:
+			return "rest";
+		default:
+			return "unknown";
+		}
+	}
+
+	class Flusher;
+
+	struct Tracer
+	{
+		Tracer();
+		~Tracer();
+		void drain();
+		void write(const Ring& ring, const Record& record);
+		QElapsedTimer clock;
+		std::atomic<quint64> dropped{0};
+		//Protects rings, names and the flusher.
+		QMutex mutex;
+		QList<Ring*> rings;
+		quint32 nextThread = 1;
+		QHash<QString, QByteArray> names;
+		Flusher* flusher = nullptr;
+		//Held by whoever is reading the rings and writing the output.
+		QMutex drainMutex;
+		QFile capture;
+		bool firstEvent = true;
+	};
+
+	Q_GLOBAL_STATIC(Tracer, tracer)
+
+	class Flusher: public QThread
+	{
+	public:
+		void stop()
+		{
+			QMutexLocker locker(&_mutex);
+			_stopped = true;
+			_condition.wakeOne();
+		}
+	protected:
+		void run() override
+		{
+			QMutexLocker locker(&_mutex);
+			while(!_stopped)
+			{
+				_condition.wait(&_mutex, 100);
+				locker.unlock();
+				if(Tracer* instance = tracer())
+					instance->drain();
+				locker.relock();
+			}
+		}
+	private:
+		QMutex _mutex;
+		QWaitCondition _condition;
+		bool _stopped = false;
+	};
+
+	struct RingHolder
+	{
+		~RingHolder()
+		{
+			//The ring is freed by the next drain once it has been emptied.
+			if(ring)
+				ring->finished.store(true, std::memory_order_release);
+		}
+		Ring* ring = nullptr;
+	};
+
+	thread_local RingHolder currentRing;
+
+	Ring* threadRing()
+	{
+		if(currentRing.ring)
+			return currentRing.ring;
+		Tracer* instance = tracer();
+		if(!instance)
+			return nullptr;
+		Ring* ring = new Ring;
+		QMutexLocker locker(&instance->mutex);
+		ring->thread = instance->nextThread++;
+		instance->rings.append(ring);
+		if(!instance->flusher)
+		{
+			instance->flusher = new Flusher;
+			instance->flusher->start(QThread::LowPriority);
+		}
+		currentRing.ring = ring;
+		return ring;
+	}
+
+	QByteArray escaped(const char* text)
+	{
+		QByteArray result;
+		for(const char* i = text; *i; i++)
+		{
+			if(*i == '"' || *i == '\\')
+				result.append('\\');
+			if(static_cast<unsigned char>(*i) >= 0x20)
+				result.append(*i);
+		}
+		return result;
+	}
+
+	QDiscordTrace::Level parseLevel(const QString& name)
+	{
+		if(name == "error")
+			return QDiscordTrace::Level::Error;
+		if(name == "info")
+			return QDiscordTrace::Level::Info;
+		if(name == "debug")
+			return QDiscordTrace::Level::Debug;
+		if(name == "verbose")
+			return QDiscordTrace::Level::Verbose;
+		return QDiscordTrace::Level::Off;
+	}
+
+	void applyEnvironment()
+	{
+		//Checks the variable directly, as QDiscordUtilities::debugMode might
+		//not be initialized yet.
+		if(qEnvironmentVariableIsSet("QDISCORD_DEBUG"))
+			QDiscordTrace::setLevel(QDiscordTrace::Level::Verbose);
+		for(const QString& item :
+			QString::fromLocal8Bit(qgetenv("QDISCORD_TRACE")).split(','))
+		{
+			QStringList pair = item.trimmed().toLower().split('=');
+			if(pair.size() == 1 && !pair.first().isEmpty())
+			{
+				QDiscordTrace::setLevel(parseLevel(pair.first()));
+				continue;
+			}
+			if(pair.size() != 2)
+				continue;
+			for(int i = 0; i < static_cast<int>(QDiscordTrace::Category::Count); i++)
+			{
+				QDiscordTrace::Category category =
+						static_cast<QDiscordTrace::Category>(i);
+				if(pair.first() == categoryName(category))
+					QDiscordTrace::setLevel(category, parseLevel(pair.last()));
+			}
+		}
+	}
+
+	Q_CONSTRUCTOR_FUNCTION(applyEnvironment)
+}
+
+Tracer::Tracer()
+{
+	clock.start();
+}
+
+Tracer::~Tracer()
+{
+	if(flusher)
+	{
+		flusher->stop();
+		flusher->wait();
+		delete flusher;
+	}
+	QMutexLocker locker(&drainMutex);
+	if(capture.isOpen())
+	{
+		capture.write("\n]}\n");
+		capture.close();
+	}
+	//Rings of threads which are still running are leaked on purpose, as
+	//those threads may still write to them.
+}
+
+void Tracer::drain()
+{
+	QMutexLocker drainLocker(&drainMutex);
+	QList<Ring*> current;
+	{
+		QMutexLocker locker(&mutex);
+		current = rings;
+	}
+	QList<Ring*> emptied;
+	for(Ring* ring : current)
+	{
+		//Read finished first, so records written before the thread exited
+		//are always drained.
+		bool finished = ring->finished.load(std::memory_order_acquire);
+		quint32 tail = ring->tail.load(std::memory_order_relaxed);
+		quint32 head = ring->head.load(std::memory_order_acquire);
+		for(; tail != head; tail++)
+			write(*ring, ring->records[tail%Ring::capacity]);
+		ring->tail.store(tail, std::memory_order_release);
+		if(finished)
+			emptied.append(ring);
+	}
+	if(capture.isOpen())
+		capture.flush();
+	if(emptied.isEmpty())
+		return;
+	QMutexLocker locker(&mutex);
+	for(Ring* ring : emptied)
+	{
+		rings.removeOne(ring);
+		delete ring;
+	}
+}
+
+void Tracer::write(const Ring& ring, const Record& record)
+{
+	if(!capture.isOpen())
+	{
+		if(record.phase == QDiscordTrace::Phase::End)
+			return;
+		qDebug().nospace().noquote()<<
+			"[" << categoryName(record.category) << "] " <<
+			record.name << " " << record.value <<
+			" (thread " << ring.thread << ", " <<
+			record.timestamp/1000 << "us)";
+		return;
+	}
+	QByteArray event;
+	event.reserve(160);
+	event.append(firstEvent ? "\n" : ",\n");
+	firstEvent = false;
+	event.append("{\"name\":\"").append(escaped(record.name));
+	event.append("\",\"cat\":\"").append(categoryName(record.category));
+	event.append("\",\"ph\":\"").append(static_cast<char>(record.phase));
+	event.append("\",\"ts\":").append(QByteArray::number(record.timestamp/1000.0, 'f', 3));
+	event.append(",\"pid\":1,\"tid\":").append(QByteArray::number(ring.thread));
+	if(record.phase == QDiscordTrace::Phase::Instant)
+		event.append(",\"s\":\"t\"");
+	if(record.phase != QDiscordTrace::Phase::End)
+		event.append(",\"args\":{\"value\":").append(QByteArray::number(record.value)).append('}');
+	event.append('}');
+	capture.write(event);
+}
+
+QDiscordTrace::Level QDiscordTrace::level(Category category)
+{
+	return static_cast<Level>(
+				_levels[static_cast<int>(category)].load(std::memory_order_relaxed)
+			);
+}
+
+void QDiscordTrace::setLevel(Category category, Level level)
+{
+	_levels[static_cast<int>(category)].store(static_cast<int>(level),
+											  std::memory_order_relaxed);
+}
+
+void QDiscordTrace::setLevel(Level level)
+{
+	for(int i = 0; i < static_cast<int>(Category::Count); i++)
+		setLevel(static_cast<Category>(i), level);
+}
+
+void QDiscordTrace::record(Category category, Level level, Phase phase,
+						   const char* name, quint64 value)
+{
+	Q_UNUSED(level);
+	Ring* ring = threadRing();
+	if(!ring)
+		return;
+	quint32 head = ring->head.load(std::memory_order_relaxed);
+	quint32 used = head - ring->tail.load(std::memory_order_acquire);
+	bool drop = false;
+	switch(phase)
+	{
+	case Phase::Begin:
+		ring->openScopes++;
+		if(ring->droppedScope == 0 &&
+				used + ring->writtenScopes + 2 > Ring::capacity)
+		{
+			ring->droppedScope = ring->openScopes;
+		}
+		drop = ring->droppedScope != 0;
+		if(!drop)
+			ring->writtenScopes++;
+		break;
+	case Phase::End:
+		//The slot for this record was kept free when its Begin was written.
+		drop = ring->droppedScope != 0;
+		if(ring->droppedScope == ring->openScopes)
+			ring->droppedScope = 0;
+		if(!drop && ring->writtenScopes > 0)
+			ring->writtenScopes--;
+		if(ring->openScopes > 0)
+			ring->openScopes--;
+		break;
+	default:
+		drop = used + ring->writtenScopes + 1 > Ring::capacity;
+	}
+	if(drop)
+	{
+		tracer()->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	Record& record = ring->records[head%Ring::capacity];
+	record.timestamp = tracer()->clock.nsecsElapsed();
+	record.name = name;
+	record.value = value;
+	record.category = category;
+	record.phase = phase;
+	ring->head.store(head + 1, std::memory_order_release);
+}
+
+const char* QDiscordTrace::intern(const QString& name)
+{
+	Tracer* instance = tracer();
+	if(!instance)
+		return "";
+	QMutexLocker locker(&instance->mutex);
+	QHash<QString, QByteArray>::iterator interned = instance->names.find(name);
+	if(interned == instance->names.end())
+		interned = instance->names.insert(name, name.toUtf8());
+	//The QByteArray is never modified or removed, so its data stays valid.
+	return interned->constData();
+}
+
+bool QDiscordTrace::startCapture(const QString& fileName)
+{
+	stopCapture();
+	Tracer* instance = tracer();
+	if(!instance)
+		return false;
+	//Records collected before the capture started are not part of it.
+	instance->drain();
+	QMutexLocker locker(&instance->drainMutex);
+	instance->capture.setFileName(fileName);
+	if(!instance->capture.open(QFile::WriteOnly|QFile::Truncate))
+	{
+		if(QDiscordUtilities::debugMode)
+			qDebug()<<"QDiscordTrace: failed to open"<<fileName;
+		return false;
+	}
+	instance->firstEvent = true;
+	instance->capture.write("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	return true;
+}
+
+void QDiscordTrace::stopCapture()
+{
+	Tracer* instance = tracer();
+	if(!instance)
+		return;
+	instance->drain();
+	QMutexLocker locker(&instance->drainMutex);
+	if(!instance->capture.isOpen())
+		return;
+	instance->capture.write("\n]}\n");
+	instance->capture.close();
+}
+
+bool QDiscordTrace::capturing()
+{
+	Tracer* instance = tracer();
+	if(!instance)
+		return false;
+	QMutexLocker locker(&instance->drainMutex);
+	return instance->capture.isOpen();
+}
+
+void QDiscordTrace::flush()
+{
+	if(Tracer* instance = tracer())
+		instance->drain();
+}
+
+quint64 QDiscordTrace::droppedRecords()
+{
+	Tracer* instance = tracer();
+	return instance ? instance->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+QDiscordTrace::Scope::Scope(Category category, Level level, const char* name)
+{
+	_category = category;
+	_level = level;
+	_name = name;
+	_enabled = QDiscordTrace::enabled(category, level);
+	if(_enabled)
+		QDiscordTrace::record(category, level, Phase::Begin, name);
+}
+
+QDiscordTrace::Scope::~Scope()
+{
+	if(_enabled)
+		QDiscordTrace::record(_category, _level, Phase::End, _name);
+}
@@ -0,0 +1,193 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDTRACE_HPP
+#define QDISCORDTRACE_HPP
+
+#include <QString>
+#include <atomic>
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief Low overhead tracing used in QDiscord's hot paths.
+ *
+ * Trace points are placed with the QDISCORD_TRACE, QDISCORD_TRACE_SCOPE and
+ * QDISCORD_TRACE_COUNTER macros. A disabled trace point costs a single relaxed
+ * atomic load, and defining `QDISCORD_NO_TRACE` while building the library
+ * removes trace points entirely.\n
+ * Enabled trace points write small binary records into a ring buffer owned by
+ * the current thread, without locking or allocating. A background thread
+ * drains the buffers and either writes the records to a Chrome trace event
+ * file started with startCapture() or prints them with qDebug(). Records which
+ * do not fit into a full buffer are dropped and counted by droppedRecords().\n
+ * Levels can also be set with the `QDISCORD_TRACE` environment variable, for
+ * example `QDISCORD_TRACE=gateway=debug,state=info`. If `QDISCORD_DEBUG` is
+ * set, all categories start at Level::Verbose.
+ */
+class QDISCORD_API QDiscordTrace
+{
+public:
+	///\brief An enumerator holding the areas of the library which can be traced.
+	enum class Category : int
+	{
+		///\brief Construction and updates of model objects.
+		Model,
+		///\brief Messages received from and sent through the gateway.
+		Gateway,
+		///\brief Gateway events being applied to QDiscordStateComponent.
+		State,
+		///\brief Requests made through QDiscordRestComponent.
+		Rest,
+		///\brief The amount of categories. Not a valid category.
+		Count
+	};
+	///\brief An enumerator holding the levels of trace records.
+	enum class Level : int
+	{
+		///\brief Used with setLevel() to disable a category.
+		Off,
+		Error,
+		Info,
+		Debug,
+		Verbose
+	};
+	///\brief An enumerator holding the kinds of trace records.
+	enum class Phase : char
+	{
+		///\brief The start of a scope.
+		Begin = 'B',
+		///\brief The end of a scope.
+		End = 'E',
+		///\brief A single point in time.
+		Instant = 'i',
+		///\brief A sampled value.
+		Counter = 'C'
+	};
+	/*!
+	 * \brief Returns whether records of the provided category and level are
+	 * being collected.
+	 */
+	static bool enabled(Category category, Level level) {
+		return static_cast<int>(level) <=
+				_levels[static_cast<int>(category)].load(std::memory_order_relaxed);
+	}
+	///\brief Returns the level up to which records of a category are collected.
+	static Level level(Category category);
+	///\brief Sets the level up to which records of a category are collected.
+	static void setLevel(Category category, Level level);
+	///\brief Sets the level of all categories.
+	static void setLevel(Level level);
+	/*!
+	 * \brief Writes a record into the current thread's buffer.
+	 *
+	 * This does not check whether the category is enabled, use the macros
+	 * instead.
+	 * \param name A name which must stay valid until the record has been
+	 * flushed, usually a string literal or a string returned by intern().
+	 * \param value A value stored with the record.
+	 */
+	static void record(Category category, Level level, Phase phase,
+					   const char* name, quint64 value = 0);
+	/*!
+	 * \brief Returns a name for the provided string which stays valid until the
+	 * application exits.
+	 *
+	 * Meant for the small set of names only known at runtime, such as gateway
+	 * event types.
+	 */
+	static const char* intern(const QString& name);
+	/*!
+	 * \brief Starts writing all records to the provided file in the Chrome
+	 * trace event format.
+	 *
+	 * The file can be opened in `chrome://tracing` or Perfetto. Any running
+	 * capture is stopped first.
+	 * \returns `false` if the file could not be opened.
+	 */
+	static bool startCapture(const QString& fileName);
+	///\brief Flushes all records and finishes the running capture.
+	static void stopCapture();
+	///\brief Returns whether a capture is running.
+	static bool capturing();
+	/*!
+	 * \brief Writes out the records of all threads' buffers from the calling
+	 * thread instead of waiting for the background thread.
+	 */
+	static void flush();
+	/*!
+	 * \brief Returns the amount of records dropped because a buffer was full.
+	 *
+	 * Scopes are dropped as a whole, so the beginning and the end of a scope
+	 * are either both written or both dropped.
+	 */
+	static quint64 droppedRecords();
+	///\brief Records the beginning of a scope and its end once destroyed.
+	class QDISCORD_API Scope
+	{
+	public:
+		Scope(Category category, Level level, const char* name);
+		~Scope();
+	private:
+		Q_DISABLE_COPY(Scope)
+		Category _category;
+		Level _level;
+		const char* _name;
+		bool _enabled;
+	};
+private:
+	static std::atomic<int> _levels[static_cast<int>(Category::Count)];
+};
+
+#ifndef QDISCORD_NO_TRACE
+#define QDISCORD_TRACE_CONCAT_(a, b) a##b
+#define QDISCORD_TRACE_CONCAT(a, b) QDISCORD_TRACE_CONCAT_(a, b)
+///\brief Records a single point in time with an associated value.
+#define QDISCORD_TRACE(category, level, name, value) \
+	do { \
+		if(QDiscordTrace::enabled(QDiscordTrace::Category::category, \
+								  QDiscordTrace::Level::level)) \
+		{ \
+			QDiscordTrace::record(QDiscordTrace::Category::category, \
+								  QDiscordTrace::Level::level, \
+								  QDiscordTrace::Phase::Instant, \
+								  name, quint64(value)); \
+		} \
+	} while(0)
+///\brief Records a sampled value, shown as a graph in trace viewers.
+#define QDISCORD_TRACE_COUNTER(category, level, name, value) \
+	do { \
+		if(QDiscordTrace::enabled(QDiscordTrace::Category::category, \
+								  QDiscordTrace::Level::level)) \
+		{ \
+			QDiscordTrace::record(QDiscordTrace::Category::category, \
+								  QDiscordTrace::Level::level, \
+								  QDiscordTrace::Phase::Counter, \
+								  name, quint64(value)); \
+		} \
+	} while(0)
+///\brief Records the rest of the enclosing block as a scope.
+#define QDISCORD_TRACE_SCOPE(category, level, name) \
+	QDiscordTrace::Scope QDISCORD_TRACE_CONCAT(qdiscordTraceScope, __LINE__)( \
+		QDiscordTrace::Category::category, QDiscordTrace::Level::level, name)
+#else
+#define QDISCORD_TRACE(category, level, name, value) do {} while(0)
+#define QDISCORD_TRACE_COUNTER(category, level, name, value) do {} while(0)
+#define QDISCORD_TRACE_SCOPE(category, level, name) do {} while(0)
+#endif
+
+#endif // QDISCORDTRACE_HPP
@@ -0,0 +1,153 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordtypingtracker.hpp"
+
+QDiscordTypingTracker::QDiscordTypingTracker(QObject* parent) : QObject(parent)
+{
+	_timeout = 10000;
+	_clock.start();
+	_tick = 0;
+	_wheel.resize(slotCount);
+	_outerWheel.resize(slotCount);
+	_timer.setInterval(tickInterval);
+	connect(&_timer, &QTimer::timeout, this, &QDiscordTypingTracker::tick);
+}
+
+void QDiscordTypingTracker::setTimeout(int timeout)
+{
+	_timeout = timeout > 0 ? timeout : 0;
+}
+
+bool QDiscordTypingTracker::isTyping(const QString& channelId,
+									 const QString& userId) const
+{
+	QHash<Key, qint64>::const_iterator entry =
+			_entries.find(qMakePair(channelId.toULongLong(), userId.toULongLong()));
+	return entry != _entries.end() && entry.value() > currentTick();
+}
+
+bool QDiscordTypingTracker::start(const QString& channelId,
+								  const QString& userId)
+{
+	if(_entries.isEmpty())
+	{
+		//Nothing is scheduled, so the wheel can skip straight to the present.
+		clear();
+		_tick = currentTick();
+		_timer.start();
+	}
+	else
+		advance();
+
+	Item item;
+	item.key = qMakePair(channelId.toULongLong(), userId.toULongLong());
+	item.expiryTick = _tick + qMax(1, (_timeout + tickInterval - 1)/tickInterval);
+	bool started = !_entries.contains(item.key);
+	_entries.insert(item.key, item.expiryTick);
+	schedule(item);
+	if(started)
+		emit typingStarted(channelId, userId);
+	return started;
+}
+
+bool QDiscordTypingTracker::stop(const QString& channelId,
+								 const QString& userId)
+{
+	if(!_entries.remove(qMakePair(channelId.toULongLong(), userId.toULongLong())))
+		return false;
+	if(_entries.isEmpty())
+		clear();
+	emit typingStopped(channelId, userId);
+	return true;
+}
+
+void QDiscordTypingTracker::clear()
+{
+	_timer.stop();
+	_entries.clear();
+	for(QVector<Item>& slot : _wheel)
+		slot.clear();
+	for(QVector<Item>& slot : _outerWheel)
+		slot.clear();
+}
+
+qint64 QDiscordTypingTracker::currentTick() const
+{
+	return _clock.elapsed()/tickInterval;
+}
+
+void QDiscordTypingTracker::schedule(const Item& item)
+{
+	//Items due within one revolution go into the inner wheel, later items into
+	//the outer wheel, which moves them inwards once they come within range.
+	qint64 delta = item.expiryTick - _tick;
+	if(delta < slotCount)
+		_wheel[item.expiryTick & slotMask].append(item);
+	else
+	{
+		qint64 outerDelta = qMin<qint64>((item.expiryTick >> slotBits) -
+										 (_tick >> slotBits), slotCount - 1);
+		_outerWheel[((_tick >> slotBits) + outerDelta) & slotMask].append(item);
+	}
+}
+
+void QDiscordTypingTracker::tick()
+{
+	advance();
+	if(_entries.isEmpty())
+		clear();
+}
+
+void QDiscordTypingTracker::advance()
+{
+	qint64 now = currentTick();
+	while(_tick < now && !_entries.isEmpty())
+	{
+		_tick++;
+		if((_tick & slotMask) == 0)
+		{
+			QVector<Item> cascaded;
+			cascaded.swap(_outerWheel[(_tick >> slotBits) & slotMask]);
+			for(const Item& item : cascaded)
+			{
+				if(_entries.value(item.key, -1) == item.expiryTick)
+					schedule(item);
+			}
+		}
+
+		QVector<Item> due;
+		due.swap(_wheel[_tick & slotMask]);
+		for(const Item& item : due)
+		{
+			QHash<Key, qint64>::iterator entry = _entries.find(item.key);
+			if(entry == _entries.end() || entry.value() != item.expiryTick)
+				continue;
+			if(item.expiryTick > _tick)
+			{
+				schedule(item);
+				continue;
+			}
+			_entries.erase(entry);
+			emit typingStopped(QString::number(item.key.first),
+							   QString::number(item.key.second));
+		}
+	}
+	if(_entries.isEmpty())
+		_tick = now;
+}
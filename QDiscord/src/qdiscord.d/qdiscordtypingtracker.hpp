@@ -0,0 +1,108 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDTYPINGTRACKER_HPP
+#define QDISCORDTYPINGTRACKER_HPP
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QTimer>
+#include <QVector>
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief Tracks which users are currently typing in which channels.
+ *
+ * Entries expire after timeout() milliseconds unless they are refreshed by
+ * another TYPING_START event. Expiry is handled by a two-level timer wheel
+ * driven by a single QTimer, which only runs while anyone is typing, so the
+ * amount of tracked users does not affect the amount of timers.\n
+ * The tracker is owned by QDiscordStateComponent and can be accessed through
+ * QDiscordStateComponent::typingTracker().
+ */
+class QDISCORD_API QDiscordTypingTracker : public QObject
+{
+	Q_OBJECT
+public:
+	///\brief Standard QObject constructor.
+	explicit QDiscordTypingTracker(QObject* parent = 0);
+	///\brief Returns how long a user is considered typing, in milliseconds.
+	int timeout() const {return _timeout;}
+	/*!
+	 * \brief Sets how long a user is considered typing, in milliseconds.
+	 *
+	 * This only applies to entries started or refreshed afterwards.
+	 */
+	void setTimeout(int timeout);
+	///\brief Returns whether the provided user is typing in the provided channel.
+	bool isTyping(const QString& channelId, const QString& userId) const;
+	///\brief Returns the amount of users currently typing across all channels.
+	int count() const {return _entries.size();}
+	/*!
+	 * \brief Marks the provided user as typing in the provided channel.
+	 *
+	 * If the user is already typing, their entry is refreshed.
+	 * \returns `true` if the user was not typing before.
+	 */
+	bool start(const QString& channelId, const QString& userId);
+	/*!
+	 * \brief Marks the provided user as no longer typing in the provided channel.
+	 * \returns `true` if the user was typing.
+	 */
+	bool stop(const QString& channelId, const QString& userId);
+	///\brief Removes all entries without emitting any signals.
+	void clear();
+signals:
+	/*!
+	 * \brief Emitted when a user has started typing in a channel.
+	 *
+	 * This is not emitted again when an entry is refreshed.
+	 */
+	void typingStarted(QString channelId, QString userId);
+	///\brief Emitted when a user has stopped typing or their entry has expired.
+	void typingStopped(QString channelId, QString userId);
+private:
+	typedef QPair<quint64, quint64> Key;
+	struct Item
+	{
+		Key key;
+		qint64 expiryTick;
+	};
+	static const int tickInterval = 100;
+	static const int slotBits = 6;
+	static const int slotCount = 1 << slotBits;
+	static const int slotMask = slotCount - 1;
+	qint64 currentTick() const;
+	void schedule(const Item& item);
+	void tick();
+	void advance();
+	int _timeout;
+	QElapsedTimer _clock;
+	QTimer _timer;
+	//The last tick which was processed.
+	qint64 _tick;
+	//Expiry ticks of all typing users. Wheel items whose expiry tick does not
+	//match are left over from refreshed or stopped entries and are skipped.
+	QHash<Key, qint64> _entries;
+	QVector<QVector<Item>> _wheel;
+	QVector<QVector<Item>> _outerWheel;
+};
+
+#endif // QDISCORDTYPINGTRACKER_HPP
@@ -0,0 +1,152 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMimeDatabase>
+#include <climits>
+#include "qdiscordupload.hpp"
+
+QDiscordUpload::QDiscordUpload()
+{
+
+}
+
+QJsonObject QDiscordUpload::payload() const
+{
+	QJsonObject payload = _payload;
+	QJsonArray attachments;
+	for(int i = 0; i < _attachments.length(); i++)
+	{
+		QJsonObject attachment;
+		attachment["id"] = i;
+		attachment["filename"] = _attachments[i].fileName;
+		attachments.append(attachment);
+	}
+	payload["attachments"] = attachments;
+	return payload;
+}
+
+bool QDiscordUpload::addFile(const QString& path, const QString& fileName,
+							 bool memoryMap)
+{
+	QSharedPointer<QFile> file(new QFile(path));
+	if(!file->open(QIODevice::ReadOnly))
+		return false;
+	Attachment attachment;
+	attachment.fileName =
+			fileName.isEmpty()?QFileInfo(path).fileName():fileName;
+	attachment.contentType = contentType(attachment.fileName);
+	attachment.file = file;
+	attachment.start = 0;
+	//QByteArray can not hold more than 2 GiB, so larger files are read.
+	uchar* mapped = nullptr;
+	if(memoryMap && file->size() > 0 && file->size() <= INT_MAX)
+		mapped = file->map(0, file->size());
+	//The mapping lives as long as the file, which outlives all copies of the
+	//data since the attachment holds both.
+	if(mapped)
+	{
+		attachment.data =
+				QByteArray::fromRawData(reinterpret_cast<const char*>(mapped),
+										int(file->size()));
+	}
+	else
+		attachment.device = file.data();
+	_attachments.append(attachment);
+	return true;
+}
+
+void QDiscordUpload::addDevice(QIODevice* device, const QString& fileName)
+{
+	Attachment attachment;
+	attachment.fileName = fileName;
+	attachment.contentType = contentType(fileName);
+	attachment.device = device;
+	attachment.start = device->isSequential()?0:device->pos();
+	_attachments.append(attachment);
+}
+
+void QDiscordUpload::addData(const QByteArray& data, const QString& fileName)
+{
+	Attachment attachment;
+	attachment.fileName = fileName;
+	attachment.contentType = contentType(fileName);
+	attachment.start = 0;
+	attachment.data = data;
+	_attachments.append(attachment);
+}
+
+qint64 QDiscordUpload::size() const
+{
+	qint64 size = 0;
+	for(const Attachment& attachment : _attachments)
+	{
+		if(!attachment.device)
+			size += attachment.data.size();
+		else if(attachment.device->isSequential())
+			return -1;
+		else
+			size += attachment.device->size() - attachment.start;
+	}
+	return size;
+}
+
+QHttpMultiPart* QDiscordUpload::multiPart() const
+{
+	QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
+	QHttpPart payloadPart;
+	payloadPart.setHeader(QNetworkRequest::ContentDispositionHeader,
+						  "form-data; name=\"payload_json\"");
+	payloadPart.setHeader(QNetworkRequest::ContentTypeHeader,
+						  "application/json");
+	payloadPart.setBody(QJsonDocument(payload())
+						.toJson(QJsonDocument::Compact));
+	multiPart->append(payloadPart);
+	for(int i = 0; i < _attachments.length(); i++)
+	{
+		const Attachment& attachment = _attachments[i];
+		QHttpPart part;
+		QString fileName = attachment.fileName;
+		fileName.replace('"', "\\\"");
+		part.setHeader(QNetworkRequest::ContentDispositionHeader,
+					   "form-data; name=\"files[" + QString::number(i) +
+					   "]\"; filename=\"" + fileName + "\"");
+		part.setHeader(QNetworkRequest::ContentTypeHeader,
+					   attachment.contentType);
+		if(attachment.device)
+		{
+			if(!attachment.device->isSequential())
+				attachment.device->seek(attachment.start);
+			part.setBodyDevice(attachment.device);
+		}
+		else
+			part.setBody(attachment.data);
+		multiPart->append(part);
+	}
+	return multiPart;
+}
+
+QByteArray QDiscordUpload::contentType(const QString& fileName)
+{
+	static const QMimeDatabase database;
+	return database.mimeTypeForFile(fileName, QMimeDatabase::MatchExtension)
+			.name().toUtf8();
+}
@@ -0,0 +1,121 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDUPLOAD_HPP
+#define QDISCORDUPLOAD_HPP
+
+#include <QByteArray>
+#include <QHttpMultiPart>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QList>
+#include <QPointer>
+#include <QSharedPointer>
+#include <functional>
+#include "qdiscordutilities.hpp"
+
+/*!
+ * \brief Describes the files attached to a REST request, sent as
+ * `multipart/form-data`.
+ *
+ * Files are streamed from their devices while the request is being sent, so
+ * memory use does not depend on their size. Files added by path are opened
+ * right away and can optionally be memory mapped instead of read.\n
+ * A QHttpMultiPart is built for every attempt to send the request, so
+ * requests retried after a rate limit send the files again from the start.
+ * This requires devices added with addDevice() to be seekable if the request
+ * may be retried.
+ */
+class QDISCORD_API QDiscordUpload
+{
+public:
+	///\brief A function receiving the amount of bytes sent and the total.
+	typedef std::function<void(qint64 sent, qint64 total)> ProgressHandler;
+	///\brief Creates an upload without files.
+	QDiscordUpload();
+	/*!
+	 * \brief Returns the JSON sent as the `payload_json` part, including the
+	 * `attachments` array describing the files.
+	 */
+	QJsonObject payload() const;
+	///\brief Sets the JSON sent along with the files, such as a message.
+	void setPayload(const QJsonObject& payload) {_payload = payload;}
+	/*!
+	 * \brief Attaches a file from the disk.
+	 * \param path The path of the file.
+	 * \param fileName The name the file is uploaded as. Defaults to the name
+	 * of the file on the disk.
+	 * \param memoryMap Whether to map the file into memory instead of reading
+	 * it. Falls back to reading if mapping fails.
+	 * \returns `false` if the file could not be opened.
+	 */
+	bool addFile(const QString& path, const QString& fileName = QString(),
+				 bool memoryMap = false);
+	/*!
+	 * \brief Attaches the data of a device from its current position to its
+	 * end.
+	 *
+	 * The device is not owned by the upload and has to stay open until the
+	 * request has finished.
+	 */
+	void addDevice(QIODevice* device, const QString& fileName);
+	///\brief Attaches data held in memory.
+	void addData(const QByteArray& data, const QString& fileName);
+	///\brief Returns the amount of attached files.
+	int count() const {return _attachments.length();}
+	/*!
+	 * \brief Returns the total size of the attached files in bytes, or -1 if
+	 * a sequential device's size is unknown.
+	 */
+	qint64 size() const;
+	///\brief Returns the function receiving the upload's progress.
+	const ProgressHandler& progressHandler() const {return _progressHandler;}
+	/*!
+	 * \brief Sets a function receiving the upload's progress.
+	 *
+	 * The total includes the multipart headers and the payload.
+	 */
+	void setProgressHandler(const ProgressHandler& handler) {
+		_progressHandler = handler;
+	}
+	/*!
+	 * \brief Builds the body to send.
+	 *
+	 * Devices are moved back to the position they had when they were added.
+	 * The caller takes ownership of the result.
+	 */
+	QHttpMultiPart* multiPart() const;
+private:
+	struct Attachment
+	{
+		QString fileName;
+		QByteArray contentType;
+		//Files opened by the upload, shared between its copies.
+		QSharedPointer<QIODevice> file;
+		QPointer<QIODevice> device;
+		qint64 start;
+		//Data held in memory, or pointing into a memory mapped file.
+		QByteArray data;
+	};
+	static QByteArray contentType(const QString& fileName);
+	QJsonObject _payload;
+	QList<Attachment> _attachments;
+	ProgressHandler _progressHandler;
+};
+
+#endif // QDISCORDUPLOAD_HPP
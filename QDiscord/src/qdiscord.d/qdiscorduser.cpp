@@ -16,63 +16,120 @@
  * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "qdiscordstringpool.hpp"
 #include "qdiscorduser.hpp"
+#include "qdiscordtrace.hpp"
 
-QDiscordUser::QDiscordUser(const QJsonObject& object)
+QDiscordUser::QDiscordUser(const QJsonObject& object):
+	d(new QDiscordUserData)
 {
-	_id = object["id"].toString("");
-	_bot = object["bot"].toBool(false);
-	_discriminator = object["discriminator"].toString("");
-	_email = object["email"].toString("");
-	_username = object["username"].toString("");
-	_verified = object["verified"].toBool(false);
-	_avatar = object["avatar"].toString("");
-
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordUser("<<this<<") constructed";
+	d->_id = object["id"].toString("");
+	d->_bot = object["bot"].toBool(false);
+	setDiscriminator(object["discriminator"].toString(""));
+	d->_email = object["email"].toString("");
+	d->_username = object["username"].toString("");
+	d->_verified = object["verified"].toBool(false);
+	d->_avatar = QDiscordStringPool::intern(object["avatar"].toString(""));
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordUser constructed", quintptr(this));
 }
 
-QDiscordUser::QDiscordUser()
+QDiscordUser::QDiscordUser():
+	d(new QDiscordUserData)
 {
-	_id = "";
-	_bot = false;
-	_discriminator = "";
-	_email = "";
-	_username = "";
-	_verified = false;
-	_avatar = "";
-
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordUser("<<this<<") constructed";
+	d->_id = "";
+	d->_bot = false;
+	d->_discriminator = -1;
+	d->_email = "";
+	d->_username = "";
+	d->_verified = false;
+	d->_avatar = "";
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordUser constructed", quintptr(this));
 }
 
+QDiscordUser::QDiscordUser(const QDiscordUser& other) = default;
+
+QDiscordUser::QDiscordUser(QDiscordUser&& other) Q_DECL_NOTHROW = default;
+
+QDiscordUser::~QDiscordUser() = default;
+
+QDiscordUser& QDiscordUser::operator =(const QDiscordUser& other) = default;
+
+QDiscordUser& QDiscordUser::operator =(QDiscordUser&& other) Q_DECL_NOTHROW = default;
+
 void QDiscordUser::update(const QJsonObject& object)
 {
 	if(object.contains("id"))
-		_id = object["id"].toString("");
+		d->_id = object["id"].toString("");
 	if(object.contains("bot"))
-		_bot = object["bot"].toBool(false);
+		d->_bot = object["bot"].toBool(false);
 	if(object.contains("discriminator"))
-		_discriminator = object["discriminator"].toString("");
+		setDiscriminator(object["discriminator"].toString(""));
 	if(object.contains("email"))
-		_email = object["email"].toString("");
+		d->_email = object["email"].toString("");
 	if(object.contains("username"))
-		_username = object["username"].toString("");
+		d->_username = object["username"].toString("");
 	if(object.contains("verified"))
-		_verified = object["verified"].toBool(false);
+		d->_verified = object["verified"].toBool(false);
 	if(object.contains("avatar"))
-		_avatar = object["avatar"].toString("");
+		d->_avatar = QDiscordStringPool::intern(object["avatar"].toString(""));
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordUser updated", quintptr(this));
+}
+
+QString QDiscordUser::discriminator() const
+{
+	if(d->_discriminator == -2)
+		return d->_discriminatorText;
+	if(d->_discriminator < 0)
+		return "";
+	return QString("%1").arg(d->_discriminator, 4, 10, QChar('0'));
+}
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<"QDiscordUser("<<this<<") updated";
+void QDiscordUser::setDiscriminator(const QString& discriminator)
+{
+	//Legacy discriminators are four digits and stored as a number. Anything
+	//else, such as the "0" of migrated usernames, is kept as it is.
+	bool canonical = discriminator.size() == 4;
+	for(int i = 0; canonical && i < discriminator.size(); i++)
+		canonical = discriminator[i] >= '0' && discriminator[i] <= '9';
+	if(canonical)
+	{
+		d->_discriminator = qint16(discriminator.toInt());
+		d->_discriminatorText = QString();
+	}
+	else if(discriminator.isEmpty())
+	{
+		d->_discriminator = -1;
+		d->_discriminatorText = QString();
+	}
+	else
+	{
+		d->_discriminator = -2;
+		d->_discriminatorText = QDiscordStringPool::intern(discriminator);
+	}
+}
+
+QJsonObject QDiscordUser::toJson() const
+{
+	QJsonObject object;
+	object["id"] = d->_id;
+	object["avatar"] = avatar();
+	object["bot"] = d->_bot;
+	object["discriminator"] = discriminator();
+	object["email"] = d->_email;
+	object["username"] = d->_username;
+	object["verified"] = d->_verified;
+	return object;
 }
 
 bool QDiscordUser::operator ==(const QDiscordUser& other) const
 {
-	return other.id() == _id;
+	return other.id() == d->_id;
 }
 
 bool QDiscordUser::operator !=(const QDiscordUser& other) const
 {
-	return other.id() != _id;
+	return other.id() != d->_id;
 }
@@ -21,9 +21,32 @@
 
 #include <QDebug>
 #include <QJsonObject>
+#include <QSharedData>
 #include "qdiscordutilities.hpp"
 
-///\brief Represents a user in the Discord API.
+///\brief The data shared between copies of a QDiscordUser.
+class QDiscordUserData : public QSharedData
+{
+public:
+	QString _id;
+	QString _avatar;
+	bool _bot;
+	//The discriminator as a number, -1 if it is empty. Discriminators which
+	//are not four digits, such as "0", are marked with -2 and kept in
+	//_discriminatorText instead.
+	qint16 _discriminator;
+	QString _discriminatorText;
+	QString _email;
+	QString _username;
+	bool _verified;
+};
+
+/*!
+ * \brief Represents a user in the Discord API.
+ *
+ * Users are implicitly shared, so copying one only increments a reference
+ * count.
+ */
 class QDISCORD_API QDiscordUser
 {
 public:
@@ -34,36 +57,44 @@ public:
 	QDiscordUser(const QJsonObject& object);
 	///\brief Default public constructor
 	QDiscordUser();
+	///\brief Shares the provided object's data until either of them is modified.
+	QDiscordUser(const QDiscordUser& other);
+	///\brief Takes over the provided object's data.
+	QDiscordUser(QDiscordUser&& other) Q_DECL_NOTHROW;
+	~QDiscordUser();
+	QDiscordUser& operator =(const QDiscordUser& other);
+	QDiscordUser& operator =(QDiscordUser&& other) Q_DECL_NOTHROW;
 	///\brief Updates the current instance from the provided parameters.
 	void update(const QJsonObject& object);
+	///\brief Serializes this object into the JSON format used by the Discord API.
+	QJsonObject toJson() const;
 	///\brief Returns the user's ID.
-	QString id() const {return _id;}
+	QString id() const {return d->_id;}
+	///\brief Returns the date this user's account was created, derived from its ID.
+	QDateTime createdAt() const
+	{return QDiscordUtilities::timestampToDateTime(
+				QDiscordUtilities::snowflakeTimestamp(d->_id));}
 	///\brief Returns the user's avatar string.
-	QString avatar() const {return _avatar;}
+	QString avatar() const {return d->_avatar;}
 	///\brief Returns whether the user is a bot.
-	bool bot() const {return _bot;}
+	bool bot() const {return d->_bot;}
 	///\brief Returns the user's discriminator.
-	QString discriminator() const {return _discriminator;}
+	QString discriminator() const;
 	///\brief Returns the user's e-mail, if it can be determined.
-	QString email() const {return _email;}
+	QString email() const {return d->_email;}
 	///\brief Returns the user's username.
-	QString username() const {return _username;}
+	QString username() const {return d->_username;}
 	///\brief Returns whether the user has verified their e-mail.
-	bool verified() const {return _verified;}
+	bool verified() const {return d->_verified;}
 	///\brief Returns a string which allows you to mention this user using their username.
-	QString mention() const {return QString("<@"+_id+">");}
+	QString mention() const {return QString("<@"+d->_id+">");}
 	///\brief Compares two users based on their ID
 	bool operator ==(const QDiscordUser& other) const;
 	///\brief Compares two users based on their ID
 	bool operator !=(const QDiscordUser& other) const;
 private:
-	QString _id;
-	QString _avatar;
-	bool _bot;
-	QString _discriminator;
-	QString _email;
-	QString _username;
-	bool _verified;
+	void setDiscriminator(const QString& discriminator);
+	QSharedDataPointer<QDiscordUserData> d;
 };
 
 Q_DECLARE_METATYPE(QDiscordUser)
@@ -29,7 +29,10 @@ const QString QDiscordUtilities::libMinor = "8";
 const bool QDiscordUtilities::debugMode = getenv("QDISCORD_DEBUG")!=NULL?true:false;
 //--------------------------------------------------------------------------------------
 
-const struct QDiscordUtilities::EndPoints QDiscordUtilities::endPoints =
+const qint64 QDiscordUtilities::invalidTimestamp;
+const qint64 QDiscordUtilities::discordEpoch;
+
+struct QDiscordUtilities::EndPoints QDiscordUtilities::endPoints =
 {
 	"https://discordapp.com",
 	"https://discordapp.com/api",
@@ -43,6 +46,21 @@ const struct QDiscordUtilities::EndPoints QDiscordUtilities::endPoints =
 	"https://discordapp.com/api/channels"
 };
 
+void QDiscordUtilities::setEndPointBase(const QString& base)
+{
+	const QString apiBase = base + "/api";
+	endPoints.base = base;
+	endPoints.apiBase = apiBase;
+	endPoints.gateway = apiBase + "/gateway?encoding=json&v=4";
+	endPoints.users = apiBase + "/users";
+	endPoints.me = apiBase + "/users/@me";
+	endPoints.register_ = apiBase + "/auth/register";
+	endPoints.login = apiBase + "/auth/login";
+	endPoints.logout = apiBase + "/auth/logout";
+	endPoints.servers = apiBase + "/guilds";
+	endPoints.channels = apiBase + "/channels";
+}
+
 QString QDiscordUtilities::networkErrorToString(QNetworkReply::NetworkError error)
 {
 	switch((int)error)
@@ -73,3 +91,145 @@ QString QDiscordUtilities::networkErrorToString(QNetworkReply::NetworkError erro
 		else return "xxx (UNKNOWN): Unknown error.";
 	}
 }
+
+namespace
+{
+	//Reads a fixed amount of digits, returning -1 if any of them is missing.
+	int readDigits(const QChar* data, int size, int& position, int count)
+	{
+		int value = 0;
+		for(int i = 0; i < count; i++, position++)
+		{
+			if(position >= size)
+				return -1;
+			unsigned digit = unsigned(data[position].unicode()) - '0';
+			if(digit > 9)
+				return -1;
+			value = value*10 + static_cast<int>(digit);
+		}
+		return value;
+	}
+
+	bool readSeparator(const QChar* data, int size, int& position, char separator)
+	{
+		if(position >= size || data[position] != QLatin1Char(separator))
+			return false;
+		position++;
+		return true;
+	}
+
+	int daysInMonth(int year, int month)
+	{
+		static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+		if(month == 2 && ((year%4 == 0 && year%100 != 0) || year%400 == 0))
+			return 29;
+		return days[month - 1];
+	}
+
+	//Returns the days between 1970-01-01 and a date in the Gregorian calendar.
+	qint64 daysFromCivil(int year, int month, int day)
+	{
+		if(month <= 2)
+			year--;
+		int era = (year >= 0 ? year : year - 399)/400;
+		int yearOfEra = year - era*400;
+		int dayOfYear = (153*(month > 2 ? month - 3 : month + 9) + 2)/5 + day - 1;
+		int dayOfEra = yearOfEra*365 + yearOfEra/4 - yearOfEra/100 + dayOfYear;
+		return qint64(era)*146097 + dayOfEra - 719468;
+	}
+}
+
+qint64 QDiscordUtilities::parseTimestamp(const QString& timestamp)
+{
+	const QChar* data = timestamp.constData();
+	const int size = timestamp.size();
+	int position = 0;
+
+	int year = readDigits(data, size, position, 4);
+	if(year < 0 || !readSeparator(data, size, position, '-'))
+		return invalidTimestamp;
+	int month = readDigits(data, size, position, 2);
+	if(month < 1 || month > 12 || !readSeparator(data, size, position, '-'))
+		return invalidTimestamp;
+	int day = readDigits(data, size, position, 2);
+	if(day < 1 || day > daysInMonth(year, month))
+		return invalidTimestamp;
+	if(!readSeparator(data, size, position, 'T') &&
+			!readSeparator(data, size, position, ' '))
+		return invalidTimestamp;
+	int hour = readDigits(data, size, position, 2);
+	if(hour < 0 || hour > 23 || !readSeparator(data, size, position, ':'))
+		return invalidTimestamp;
+	int minute = readDigits(data, size, position, 2);
+	if(minute < 0 || minute > 59 || !readSeparator(data, size, position, ':'))
+		return invalidTimestamp;
+	int second = readDigits(data, size, position, 2);
+	if(second < 0 || second > 59)
+		return invalidTimestamp;
+
+	int millisecond = 0;
+	if(readSeparator(data, size, position, '.'))
+	{
+		int digits = 0;
+		for(; position < size; position++, digits++)
+		{
+			unsigned digit = unsigned(data[position].unicode()) - '0';
+			if(digit > 9)
+				break;
+			if(digits < 3)
+				millisecond = millisecond*10 + static_cast<int>(digit);
+		}
+		if(digits == 0)
+			return invalidTimestamp;
+		for(; digits < 3; digits++)
+			millisecond *= 10;
+	}
+
+	int offset = 0;
+	if(position < size)
+	{
+		if(data[position] == QLatin1Char('Z'))
+			position++;
+		else if(data[position] == QLatin1Char('+') ||
+				data[position] == QLatin1Char('-'))
+		{
+			int sign = data[position] == QLatin1Char('-') ? -1 : 1;
+			position++;
+			int offsetHours = readDigits(data, size, position, 2);
+			if(offsetHours < 0 || offsetHours > 23)
+				return invalidTimestamp;
+			readSeparator(data, size, position, ':');
+			int offsetMinutes = readDigits(data, size, position, 2);
+			if(offsetMinutes < 0 || offsetMinutes > 59)
+				return invalidTimestamp;
+			offset = sign*(offsetHours*60 + offsetMinutes);
+		}
+	}
+	if(position != size)
+		return invalidTimestamp;
+
+	qint64 seconds = daysFromCivil(year, month, day)*86400 +
+			hour*3600 + (minute - offset)*60 + second;
+	return seconds*1000 + millisecond;
+}
+
+qint64 QDiscordUtilities::snowflakeTimestamp(quint64 id)
+{
+	if(id == 0)
+		return invalidTimestamp;
+	return static_cast<qint64>(id >> 22) + discordEpoch;
+}
+
+qint64 QDiscordUtilities::snowflakeTimestamp(const QString& id)
+{
+	bool ok = false;
+	quint64 value = id.toULongLong(&ok);
+	return ok ? snowflakeTimestamp(value) : invalidTimestamp;
+}
+
+QDateTime QDiscordUtilities::timestampToDateTime(qint64 timestamp)
+{
+	if(timestamp == invalidTimestamp)
+		return QDateTime();
+	return QDateTime::fromMSecsSinceEpoch(timestamp, Qt::UTC);
+}
@@ -19,8 +19,10 @@
 #ifndef QDISCORDUTILITIES_HPP
 #define QDISCORDUTILITIES_HPP
 
+#include <QDateTime>
 #include <QString>
 #include <QNetworkReply>
+#include <limits>
 #include <stdlib.h>
 
 #ifndef QDISCORD_STATIC
@@ -51,7 +53,20 @@ public:
 		QString servers;  ///<\brief The servers endpoint.
 		QString channels; ///<\brief The channels endpoint.
 	};
-	const static EndPoints endPoints;
+	/*!
+	 * \brief The endpoints all requests are sent to.
+	 *
+	 * Change them through setEndPointBase() before sending any requests.
+	 */
+	static EndPoints endPoints;
+	/*!
+	 * \brief Points all endpoints at another server, such as a local mock of
+	 * the Discord API used for testing.
+	 * \param base The scheme, host and port of the server, without a trailing
+	 * slash, such as `http://127.0.0.1:8080`. The default is
+	 * `https://discordapp.com`.
+	 */
+	static void setEndPointBase(const QString& base);
 	/*!
 	 * \brief Converts network errors to a human-readable string based on Discord documentation.
 	 *
@@ -60,6 +75,35 @@ public:
 	 * \return A human-readable string to help explain the reason for failure.
 	 */
 	static QString networkErrorToString(QNetworkReply::NetworkError error);
+	///\brief The value returned by the timestamp functions for invalid input.
+	const static qint64 invalidTimestamp = std::numeric_limits<qint64>::min();
+	///\brief The first millisecond of 2015, which snowflakes count from.
+	const static qint64 discordEpoch = Q_INT64_C(1420070400000);
+	/*!
+	 * \brief Parses an ISO 8601 timestamp as sent by Discord.
+	 *
+	 * This accepts the `YYYY-MM-DDTHH:MM:SS[.ffffff][Z|+HH:MM]` form used by
+	 * the API without allocating, which is considerably faster than
+	 * QDateTime::fromString(). Digits past milliseconds are truncated and a
+	 * missing offset is treated as UTC.
+	 * \param timestamp The timestamp to parse.
+	 * \return The milliseconds since the Unix epoch, or invalidTimestamp if the
+	 * timestamp is malformed.
+	 */
+	static qint64 parseTimestamp(const QString& timestamp);
+	/*!
+	 * \brief Returns the creation time encoded in a snowflake.
+	 * \return The milliseconds since the Unix epoch, or invalidTimestamp if the
+	 * ID is not a valid snowflake.
+	 */
+	static qint64 snowflakeTimestamp(quint64 id);
+	///\brief Returns the creation time encoded in a snowflake string.
+	static qint64 snowflakeTimestamp(const QString& id);
+	/*!
+	 * \brief Converts milliseconds since the Unix epoch to a UTC QDateTime.
+	 * \return An invalid QDateTime for invalidTimestamp.
+	 */
+	static QDateTime timestampToDateTime(qint64 timestamp);
 	/*!
 	 * \brief The library name.
 	 *
@@ -0,0 +1,67 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qdiscordvoicestate.hpp"
+#include "qdiscordtrace.hpp"
+
+QDiscordVoiceState::QDiscordVoiceState(const QJsonObject& object,
+									   const QString& guildId)
+{
+	_guildId = object["guild_id"].toString(guildId);
+	_channelId = object["channel_id"].toString("");
+	_userId = object["user_id"].toString("");
+	_sessionId = object["session_id"].toString("");
+	_deaf = object["deaf"].toBool(false);
+	_mute = object["mute"].toBool(false);
+	_selfDeaf = object["self_deaf"].toBool(false);
+	_selfMute = object["self_mute"].toBool(false);
+	_suppress = object["suppress"].toBool(false);
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordVoiceState constructed", quintptr(this));
+}
+
+QDiscordVoiceState::QDiscordVoiceState()
+{
+	_guildId = "";
+	_channelId = "";
+	_userId = "";
+	_sessionId = "";
+	_deaf = false;
+	_mute = false;
+	_selfDeaf = false;
+	_selfMute = false;
+	_suppress = false;
+
+	QDISCORD_TRACE(Model, Verbose, "QDiscordVoiceState constructed", quintptr(this));
+}
+
+QJsonObject QDiscordVoiceState::toJson() const
+{
+	QJsonObject object;
+	object["guild_id"] = _guildId;
+	object["channel_id"] = _channelId.isEmpty() ?
+				QJsonValue() : QJsonValue(_channelId);
+	object["user_id"] = _userId;
+	object["session_id"] = _sessionId;
+	object["deaf"] = _deaf;
+	object["mute"] = _mute;
+	object["self_deaf"] = _selfDeaf;
+	object["self_mute"] = _selfMute;
+	object["suppress"] = _suppress;
+	return object;
+}
@@ -0,0 +1,78 @@
+/*
+ * QDiscord - An unofficial C++ and Qt wrapper for the Discord API.
+ * Copyright (C) 2016 george99g
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.	 If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDISCORDVOICESTATE_HPP
+#define QDISCORDVOICESTATE_HPP
+
+#include <QDebug>
+#include <QJsonObject>
+#include "qdiscordutilities.hpp"
+
+///\brief Represents a user's voice connection status in the Discord API.
+class QDISCORD_API QDiscordVoiceState
+{
+public:
+	/*!
+	 * \brief Creates an instance from the provided parameters.
+	 * \param object A JSON object of a Discord voice state.
+	 * \param guildId The ID of the voice state's guild. Used if the object
+	 * does not contain a guild ID, as is the case in GUILD_CREATE events.
+	 */
+	QDiscordVoiceState(const QJsonObject& object,
+					   const QString& guildId = QString());
+	///\brief Default public constructor.
+	QDiscordVoiceState();
+	///\brief Serializes this object into the JSON format used by the Discord API.
+	QJsonObject toJson() const;
+	///\brief Returns the ID of the voice state's guild.
+	QString guildId() const {return _guildId;}
+	/*!
+	 * \brief Returns the ID of the voice channel the user is connected to.
+	 *
+	 * Empty if the user has disconnected.
+	 */
+	QString channelId() const {return _channelId;}
+	///\brief Returns the ID of the voice state's user.
+	QString userId() const {return _userId;}
+	///\brief Returns the voice session ID.
+	QString sessionId() const {return _sessionId;}
+	///\brief Returns whether the user was deafened by the guild.
+	bool deaf() const {return _deaf;}
+	///\brief Returns whether the user was muted by the guild.
+	bool mute() const {return _mute;}
+	///\brief Returns whether the user has deafened themselves.
+	bool selfDeaf() const {return _selfDeaf;}
+	///\brief Returns whether the user has muted themselves.
+	bool selfMute() const {return _selfMute;}
+	///\brief Returns whether the user was suppressed by the current user.
+	bool suppress() const {return _suppress;}
+private:
+	QString _guildId;
+	QString _channelId;
+	QString _userId;
+	QString _sessionId;
+	bool _deaf;
+	bool _mute;
+	bool _selfDeaf;
+	bool _selfMute;
+	bool _suppress;
+};
+
+Q_DECLARE_METATYPE(QDiscordVoiceState)
+
+#endif // QDISCORDVOICESTATE_HPP
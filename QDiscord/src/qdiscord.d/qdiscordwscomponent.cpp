@@ -17,6 +17,7 @@
  */
 
 #include "qdiscordwscomponent.hpp"
+#include "qdiscordtrace.hpp"
 
 QDiscordWsComponent::QDiscordWsComponent(QObject* parent) : QObject(parent)
 {
@@ -202,7 +203,12 @@ void QDiscordWsComponent::error_(QAbstractSocket::SocketError err)
 
 void QDiscordWsComponent::textMessageReceived(const QString& message)
 {
-	QJsonDocument document = QJsonDocument::fromJson(message.toUtf8());
+	QDISCORD_TRACE_SCOPE(Gateway, Debug, "gateway message");
+	QJsonDocument document;
+	{
+		QDISCORD_TRACE_SCOPE(Gateway, Verbose, "gateway parse");
+		document = QJsonDocument::fromJson(message.toUtf8());
+	}
 	QJsonObject object = document.object();
 	if(_useDumpfile)
 	{
@@ -213,24 +219,35 @@ void QDiscordWsComponent::textMessageReceived(const QString& message)
 		file.close();
 	}
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<this<<"op:"<<object["op"].toInt()<<" t:"<<object["t"].toString();
+	QDISCORD_TRACE(Gateway, Verbose, "gateway op", object["op"].toInt());
 
 	switch(object["op"].toInt(-1))
 	{
 	case 0:
-		if(_eventDispatchTable.keys().contains(object["t"].toString()))
-			_eventDispatchTable[object["t"].toString()](object["d"].toObject());
-		else if(QDiscordUtilities::debugMode)
-			qDebug()<<this<<"encountered an event not in the dispatch table";
+	{
+		QString type = object["t"].toString();
+		QMap<QString, std::function<void (const QJsonObject&)>>::const_iterator
+				handler = _eventDispatchTable.constFind(type);
+		if(handler == _eventDispatchTable.constEnd())
+		{
+			QDISCORD_TRACE(Gateway, Info, "gateway event not in dispatch table", 0);
+			break;
+		}
+		//Dispatching includes the state update and all directly connected
+		//slots, so this scope covers the whole event.
+		QDISCORD_TRACE_SCOPE(State, Debug,
+			QDiscordTrace::enabled(QDiscordTrace::Category::State,
+								   QDiscordTrace::Level::Debug) ?
+								   QDiscordTrace::intern(type) : "");
+		handler.value()(object["d"].toObject());
 		break;
+	}
 	case -1:
-		if(QDiscordUtilities::debugMode)
-			qDebug()<<this<<"error while parsing operation code";
+		QDISCORD_TRACE(Gateway, Error, "gateway operation code not parsed", 0);
 		break;
 	default:
-		if(QDiscordUtilities::debugMode)
-			qDebug()<<this<<"encountered an unhandled operation";
+		QDISCORD_TRACE(Gateway, Info, "gateway operation not handled",
+					   object["op"].toInt());
 	}
 }
 
@@ -243,8 +260,7 @@ void QDiscordWsComponent::heartbeat()
 	document.setObject(object);
 	_socket.sendTextMessage(document.toJson(QJsonDocument::Compact));
 
-	if(QDiscordUtilities::debugMode)
-		qDebug()<<this<<"heartbeat sent";
+	QDISCORD_TRACE(Gateway, Debug, "heartbeat sent", 0);
 }
 
 void QDiscordWsComponent::initDispatchTable()
@@ -1,6 +1,12 @@
 QT       += network websockets
 QT       -= gui
 
+# State snapshots are stored as CBOR, which was added in Qt 5.12, and range
+# constructors of the containers were added in Qt 5.14.
+equals(QT_MAJOR_VERSION, 5):lessThan(QT_MINOR_VERSION, 14) {
+    error("QDiscord requires Qt 5.14 or newer.")
+}
+
 TARGET = QDiscord
 TEMPLATE = lib
 CONFIG += c++11
@@ -9,6 +15,14 @@ DEFINES += QDISCORD_LIBRARY
 CONFIG(staticlib) {
     DEFINES += QDISCORD_STATIC
 }
+CONFIG(qdiscord_no_trace) {
+    DEFINES += QDISCORD_NO_TRACE
+}
+CONFIG(qdiscord_coroutines) {
+    CONFIG -= c++11
+    CONFIG += c++2a
+    DEFINES += QDISCORD_COROUTINES
+}
 
 isEmpty(PREFIX) {
     PREFIX=/usr
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordcachepolicy.cpp
+
+include(../auto.pri)
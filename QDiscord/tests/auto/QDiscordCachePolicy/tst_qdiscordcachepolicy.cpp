@@ -0,0 +1,102 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordCachePolicy: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordCachePolicy();
+private slots:
+	void testDefaults();
+	void testGuildOverride();
+	void testGuildMembers();
+	void testCacheUsers();
+private:
+	QJsonObject guild(const QString& id);
+};
+
+tst_QDiscordCachePolicy::tst_QDiscordCachePolicy()
+{
+
+}
+
+QJsonObject tst_QDiscordCachePolicy::guild(const QString& id)
+{
+	QJsonArray members;
+	for(const QString& userId : {"1", "2", "3"})
+	{
+		members.append(QJsonObject({
+									   {"user", QJsonObject({
+											{"id", userId},
+											{"username", "user" + userId}
+										})},
+									   {"nick", "nick" + userId}
+								   }));
+	}
+	return QJsonObject({
+						   {"id", id},
+						   {"name", "guild"},
+						   {"members", members}
+					   });
+}
+
+void tst_QDiscordCachePolicy::testDefaults()
+{
+	QDiscordCachePolicy policy;
+
+	QVERIFY(policy.memberPolicy() == QDiscordCachePolicy::MemberPolicy::All);
+	QVERIFY(policy.cachePrivateChannels());
+	QVERIFY(policy.cacheUsers());
+	QVERIFY(!policy.usesRecentMembers());
+	QVERIFY(policy.cachesMember("10", "1", "2"));
+}
+
+void tst_QDiscordCachePolicy::testGuildOverride()
+{
+	QDiscordCachePolicy policy;
+	policy.setMemberPolicy(QDiscordCachePolicy::MemberPolicy::None);
+	policy.setGuildMemberPolicy("10", QDiscordCachePolicy::MemberPolicy::Recent);
+
+	QVERIFY(policy.usesRecentMembers());
+	QVERIFY(!policy.cachesMember("20", "1", "1"));
+	QVERIFY(policy.cachesMember("10", "1", "1"));
+	QVERIFY(!policy.cachesMember("10", "2", "1"));
+	QVERIFY(policy.cachesActiveMember("10", "2", "1"));
+
+	policy.resetGuildMemberPolicy("10");
+	QVERIFY(!policy.usesRecentMembers());
+	QVERIFY(!policy.cachesActiveMember("10", "2", "1"));
+}
+
+void tst_QDiscordCachePolicy::testGuildMembers()
+{
+	QDiscordCachePolicy policy;
+	QCOMPARE(QDiscordGuild(guild("10"), policy).members().size(), 3);
+
+	policy.setMemberPolicy(QDiscordCachePolicy::MemberPolicy::SelfOnly);
+	QDiscordGuild selfOnly(guild("10"), policy, "2");
+	QCOMPARE(selfOnly.members().size(), 1);
+	QVERIFY(selfOnly.member("2"));
+
+	policy.setMemberPolicy(QDiscordCachePolicy::MemberPolicy::None);
+	QDiscordGuild none(guild("10"), policy, "2");
+	QVERIFY(none.members().isEmpty());
+	QCOMPARE(none.name(), QString("guild"));
+}
+
+void tst_QDiscordCachePolicy::testCacheUsers()
+{
+	QDiscordCachePolicy policy;
+	policy.setCacheUsers(false);
+	QDiscordGuild guildObject(guild("10"), policy);
+
+	QSharedPointer<QDiscordMember> member = guildObject.member("1");
+	QVERIFY(member);
+	QCOMPARE(member->user()->id(), QString("1"));
+	QCOMPARE(member->user()->username(), QString(""));
+	QCOMPARE(member->nickname(), QString("nick1"));
+}
+
+QTEST_MAIN(tst_QDiscordCachePolicy)
+
+#include "tst_qdiscordcachepolicy.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordchannelorder.cpp
+
+include(../auto.pri)
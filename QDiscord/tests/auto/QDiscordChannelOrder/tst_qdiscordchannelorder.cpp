@@ -0,0 +1,108 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordChannelOrder: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordChannelOrder();
+private slots:
+	void testGuildCreate();
+	void testAddRemove();
+	void testUpdate();
+private:
+	QJsonObject channel(const QString& id, const QString& type, int position);
+	QStringList orderedIds(const QDiscordGuild& guild);
+};
+
+tst_QDiscordChannelOrder::tst_QDiscordChannelOrder()
+{
+
+}
+
+QJsonObject tst_QDiscordChannelOrder::channel(const QString& id,
+											  const QString& type,
+											  int position)
+{
+	return QJsonObject({
+						   {"id", id},
+						   {"name", "channel" + id},
+						   {"type", type},
+						   {"position", position}
+					   });
+}
+
+QStringList tst_QDiscordChannelOrder::orderedIds(const QDiscordGuild& guild)
+{
+	QStringList ids;
+	for(const QSharedPointer<QDiscordChannel>& item : guild.orderedChannels())
+		ids.append(item->id());
+	return ids;
+}
+
+void tst_QDiscordChannelOrder::testGuildCreate()
+{
+	QDiscordGuild guild(QJsonObject({
+										{"id", "10"},
+										{"channels", QJsonArray({
+											 channel("4", "voice", 0),
+											 channel("3", "text", 1),
+											 channel("2", "text", 0),
+											 channel("1", "text", 1)
+										 })}
+									}));
+
+	QCOMPARE(orderedIds(guild), QStringList({"2", "1", "3", "4"}));
+	QCOMPARE(guild.indexOf("1"), 1);
+	QCOMPARE(guild.indexOf("4"), 3);
+	QCOMPARE(guild.indexOf("5"), -1);
+}
+
+void tst_QDiscordChannelOrder::testAddRemove()
+{
+	QDiscordGuild guild(QJsonObject({{"id", "10"}}));
+	guild.addChannel(QSharedPointer<QDiscordChannel>(
+						 new QDiscordChannel(channel("1", "text", 2))
+						 ));
+	guild.addChannel(QSharedPointer<QDiscordChannel>(
+						 new QDiscordChannel(channel("2", "text", 0))
+						 ));
+	QCOMPARE(orderedIds(guild), QStringList({"2", "1"}));
+
+	//Replacing a channel must not leave its old entry behind.
+	guild.addChannel(QSharedPointer<QDiscordChannel>(
+						 new QDiscordChannel(channel("1", "text", 0))
+						 ));
+	QCOMPARE(orderedIds(guild), QStringList({"1", "2"}));
+
+	QVERIFY(guild.removeChannel(guild.channel("1")));
+	QCOMPARE(orderedIds(guild), QStringList({"2"}));
+	QCOMPARE(guild.indexOf("1"), -1);
+	QCOMPARE(guild.indexOf("2"), 0);
+}
+
+void tst_QDiscordChannelOrder::testUpdate()
+{
+	QDiscordGuild guild(QJsonObject({
+										{"id", "10"},
+										{"channels", QJsonArray({
+											 channel("1", "text", 0),
+											 channel("2", "text", 1),
+											 channel("3", "text", 2)
+										 })}
+									}));
+
+	guild.updateChannel(guild.channel("1"), QJsonObject({{"position", 5}}));
+	QCOMPARE(orderedIds(guild), QStringList({"2", "3", "1"}));
+	QCOMPARE(guild.indexOf("1"), 2);
+
+	guild.updateChannel(guild.channel("3"), QJsonObject({{"type", "voice"}}));
+	QCOMPARE(orderedIds(guild), QStringList({"2", "1", "3"}));
+
+	QDiscordGuild copy(guild);
+	QCOMPARE(orderedIds(copy), QStringList({"2", "1", "3"}));
+}
+
+QTEST_MAIN(tst_QDiscordChannelOrder)
+
+#include "tst_qdiscordchannelorder.moc"
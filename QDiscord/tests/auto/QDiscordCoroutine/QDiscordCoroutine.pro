@@ -0,0 +1,9 @@
+TEMPLATE = app
+
+CONFIG -= c++11
+CONFIG += c++2a
+DEFINES += QDISCORD_COROUTINES
+
+SOURCES += tst_qdiscordcoroutine.cpp
+
+include(../auto.pri)
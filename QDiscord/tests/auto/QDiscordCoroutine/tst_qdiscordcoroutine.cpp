@@ -0,0 +1,142 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordCoroutine: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordCoroutine();
+private slots:
+	void testFuture();
+	void testFinishedFuture();
+	void testMultipleAwaiters();
+	void testEvent();
+	void testDeletedOwner();
+private:
+	QDiscordTask awaitFuture(QDiscordFuture<int> future);
+	QDiscordTask awaitEvent(QDiscordEventBus* bus);
+	QList<int> _results;
+};
+
+namespace
+{
+	QDiscordTask awaitOwned(QObject* owner, QDiscordFuture<int> future,
+							int* result)
+	{
+		//Only used by QDiscordTask to find the task's owner.
+		Q_UNUSED(owner);
+		QDiscordFuture<int> finished = co_await future;
+		*result = finished.result();
+	}
+}
+
+tst_QDiscordCoroutine::tst_QDiscordCoroutine()
+{
+
+}
+
+QDiscordTask tst_QDiscordCoroutine::awaitFuture(QDiscordFuture<int> future)
+{
+	QDiscordFuture<int> first = co_await future;
+	_results.append(first.result());
+	QDiscordFuture<QString> second = co_await first.then([](int value){
+		return QString::number(value + 1);
+	});
+	_results.append(second.result().toInt());
+}
+
+QDiscordTask tst_QDiscordCoroutine::awaitEvent(QDiscordEventBus* bus)
+{
+	QDiscordEvent::VoiceStateUpdate update =
+			co_await qDiscordNextEvent<QDiscordEvent::VoiceStateUpdate>(
+				bus, [](const QDiscordEvent::VoiceStateUpdate& event){
+		return event.previousChannelId == "2";
+	});
+	_results.append(update.previousChannelId.toInt());
+	update = co_await qDiscordNextEvent<QDiscordEvent::VoiceStateUpdate>(bus);
+	_results.append(update.previousChannelId.toInt());
+}
+
+void tst_QDiscordCoroutine::testFuture()
+{
+	_results.clear();
+	QDiscordPromise<int> promise;
+	awaitFuture(promise.future());
+	QVERIFY(_results.isEmpty());
+	promise.resolve(1);
+	QCOMPARE(_results, QList<int>() << 1 << 2);
+}
+
+void tst_QDiscordCoroutine::testFinishedFuture()
+{
+	_results.clear();
+	awaitFuture(QDiscordFuture<int>::resolved(4));
+	QCOMPARE(_results, QList<int>() << 4 << 5);
+
+	//Failed futures resume the task as well.
+	_results.clear();
+	QDiscordPromise<int> promise;
+	awaitFuture(promise.future());
+	promise.cancel();
+	QCOMPARE(_results, QList<int>() << 0 << 0);
+}
+
+void tst_QDiscordCoroutine::testMultipleAwaiters()
+{
+	int first = 0;
+	int second = 0;
+	int third = 0;
+	QDiscordPromise<int> promise;
+	QDiscordFuture<int> future = promise.future();
+	awaitOwned(this, future, &first);
+	awaitOwned(this, future, &second);
+	awaitOwned(this, future, &third);
+	QVERIFY(future.state()->hasWaiter());
+	promise.resolve(3);
+	QCOMPARE(first, 3);
+	QCOMPARE(second, 3);
+	QCOMPARE(third, 3);
+	QVERIFY(!future.state()->hasWaiter());
+}
+
+void tst_QDiscordCoroutine::testEvent()
+{
+	_results.clear();
+	QDiscordEventBus bus;
+	awaitEvent(&bus);
+	QCOMPARE(bus.subscriberCount<QDiscordEvent::VoiceStateUpdate>(), 1);
+
+	QDiscordEvent::VoiceStateUpdate event;
+	event.previousChannelId = "1";
+	bus.publish(event);
+	QVERIFY(_results.isEmpty());
+	event.previousChannelId = "2";
+	bus.publish(event);
+	QCOMPARE(_results, QList<int>() << 2);
+	event.previousChannelId = "3";
+	bus.publish(event);
+	QCOMPARE(_results, QList<int>() << 2 << 3);
+	QCOMPARE(bus.subscriberCount<QDiscordEvent::VoiceStateUpdate>(), 0);
+}
+
+void tst_QDiscordCoroutine::testDeletedOwner()
+{
+	int result = 0;
+	QDiscordPromise<int> promise;
+	QObject* owner = new QObject();
+	awaitOwned(owner, promise.future(), &result);
+	promise.resolve(1);
+	QCOMPARE(result, 1);
+	delete owner;
+
+	QDiscordPromise<int> other;
+	owner = new QObject();
+	awaitOwned(owner, other.future(), &result);
+	delete owner;
+	other.resolve(2);
+	QCOMPARE(result, 1);
+}
+
+QTEST_MAIN(tst_QDiscordCoroutine)
+
+#include "tst_qdiscordcoroutine.moc"
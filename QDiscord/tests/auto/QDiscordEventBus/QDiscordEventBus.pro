@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordeventbus.cpp
+
+include(../auto.pri)
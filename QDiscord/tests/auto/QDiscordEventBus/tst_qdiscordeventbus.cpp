@@ -0,0 +1,176 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordEventBus: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordEventBus();
+private slots:
+	void testPublish();
+	void testOff();
+	void testInlineStorage();
+	void testSubscribeWhilePublishing();
+	void testUnsubscribeWhilePublishing();
+	void testSignalAdapter();
+};
+
+tst_QDiscordEventBus::tst_QDiscordEventBus()
+{
+
+}
+
+void tst_QDiscordEventBus::testPublish()
+{
+	QDiscordEventBus bus;
+	QStringList received;
+	QCOMPARE(bus.subscriberCount<QDiscordEvent::MessageCreate>(), 0);
+	bus.on<QDiscordEvent::MessageCreate>(
+				[&](const QDiscordEvent::MessageCreate& event){
+		received.append(event.message.content());
+	});
+	bus.on<QDiscordEvent::MessageDelete>(
+				[&](const QDiscordEvent::MessageDelete& event){
+		received.append("deleted " + event.message.id());
+	});
+	QCOMPARE(bus.subscriberCount<QDiscordEvent::MessageCreate>(), 1);
+	QVERIFY(bus.hasSubscribers<QDiscordEvent::MessageDelete>());
+	QVERIFY(!bus.hasSubscribers<QDiscordEvent::MessageUpdate>());
+
+	bus.publish(QDiscordEvent::MessageCreate{
+					QDiscordMessage(QJsonObject({{"content", "hello"}}),
+									QSharedPointer<QDiscordChannel>())
+				});
+	bus.publish(QDiscordEvent::MessageDelete{
+					QDiscordMessage(QJsonObject({{"id", "12"}}),
+									QSharedPointer<QDiscordChannel>())
+				});
+	bus.publish(QDiscordEvent::MessageUpdate{QDiscordMessage(), QDateTime()});
+	QCOMPARE(received, QStringList({"hello", "deleted 12"}));
+}
+
+void tst_QDiscordEventBus::testOff()
+{
+	QDiscordEventBus bus;
+	int calls = 0;
+	QDiscordEventBus::Subscription first =
+			bus.on<QDiscordEvent::GuildCreate>(
+				[&](const QDiscordEvent::GuildCreate&){calls++;});
+	QDiscordEventBus::Subscription second =
+			bus.on<QDiscordEvent::GuildCreate>(
+				[&](const QDiscordEvent::GuildCreate&){calls += 10;});
+	QVERIFY(first != 0);
+	QVERIFY(first != second);
+	QVERIFY(bus.off(first));
+	QVERIFY(!bus.off(first));
+	QVERIFY(!bus.off(0));
+	QCOMPARE(bus.subscriberCount<QDiscordEvent::GuildCreate>(), 1);
+	bus.publish(QDiscordEvent::GuildCreate{QSharedPointer<QDiscordGuild>()});
+	QCOMPARE(calls, 10);
+	bus.clear();
+	QVERIFY(!bus.hasSubscribers<QDiscordEvent::GuildCreate>());
+	bus.publish(QDiscordEvent::GuildCreate{QSharedPointer<QDiscordGuild>()});
+	QCOMPARE(calls, 10);
+}
+
+void tst_QDiscordEventBus::testInlineStorage()
+{
+	int calls = 0;
+	int* counter = &calls;
+	QDiscordEventCallback small =
+			QDiscordEventCallback::create<QDiscordEvent::SelfCreate>(
+				[counter](const QDiscordEvent::SelfCreate&){(*counter)++;});
+	QVERIFY(small.isInline());
+
+	QString a = "a", b = "b", c = "c", d = "d";
+	QDiscordEventCallback large =
+			QDiscordEventCallback::create<QDiscordEvent::SelfCreate>(
+				[counter, a, b, c, d](const QDiscordEvent::SelfCreate&){
+		*counter += (a + b + c + d).size();
+	});
+	QVERIFY(!large.isInline());
+
+	QDiscordEvent::SelfCreate event;
+	QDiscordEventCallback movedSmall(std::move(small));
+	QDiscordEventCallback movedLarge(std::move(large));
+	movedSmall(&event);
+	movedLarge(&event);
+	QCOMPARE(calls, 5);
+}
+
+void tst_QDiscordEventBus::testSubscribeWhilePublishing()
+{
+	QDiscordEventBus bus;
+	int outer = 0;
+	int inner = 0;
+	bus.on<QDiscordEvent::ChannelCreate>(
+				[&](const QDiscordEvent::ChannelCreate&){
+		outer++;
+		//Enough subscriptions to reallocate the vector being iterated.
+		for(int i = 0; i < 64; i++)
+		{
+			bus.on<QDiscordEvent::ChannelCreate>(
+						[&](const QDiscordEvent::ChannelCreate&){inner++;});
+		}
+	});
+	bus.publish(QDiscordEvent::ChannelCreate{QSharedPointer<QDiscordChannel>()});
+	QCOMPARE(outer, 1);
+	QCOMPARE(inner, 0);
+	QCOMPARE(bus.subscriberCount<QDiscordEvent::ChannelCreate>(), 65);
+	bus.publish(QDiscordEvent::ChannelCreate{QSharedPointer<QDiscordChannel>()});
+	QCOMPARE(outer, 2);
+	QCOMPARE(inner, 64);
+}
+
+void tst_QDiscordEventBus::testUnsubscribeWhilePublishing()
+{
+	QDiscordEventBus bus;
+	int calls = 0;
+	QDiscordEventBus::Subscription second = 0;
+	QDiscordEventBus::Subscription first =
+			bus.on<QDiscordEvent::ChannelUpdate>(
+				[&](const QDiscordEvent::ChannelUpdate&){
+		calls++;
+		bus.off(first);
+		bus.off(second);
+	});
+	second = bus.on<QDiscordEvent::ChannelUpdate>(
+				[&](const QDiscordEvent::ChannelUpdate&){calls += 10;});
+	bus.publish(QDiscordEvent::ChannelUpdate{QSharedPointer<QDiscordChannel>()});
+	QCOMPARE(calls, 1);
+	QVERIFY(!bus.hasSubscribers<QDiscordEvent::ChannelUpdate>());
+	bus.publish(QDiscordEvent::ChannelUpdate{QSharedPointer<QDiscordChannel>()});
+	QCOMPARE(calls, 1);
+}
+
+void tst_QDiscordEventBus::testSignalAdapter()
+{
+	qRegisterMetaType<QDiscordMessage>();
+	QDiscordStateComponent state;
+	QDiscordEventBus* bus = state.events();
+	QVERIFY(!bus->hasSubscribers<QDiscordEvent::MessageCreate>());
+
+	QSignalSpy spy(&state, &QDiscordStateComponent::messageCreated);
+	QCOMPARE(bus->subscriberCount<QDiscordEvent::MessageCreate>(), 1);
+	QObject context;
+	connect(&state, &QDiscordStateComponent::messageCreated,
+			&context, [](QDiscordMessage){});
+	QCOMPARE(bus->subscriberCount<QDiscordEvent::MessageCreate>(), 1);
+
+	bus->publish(QDiscordEvent::MessageCreate{
+					 QDiscordMessage(QJsonObject({{"content", "hello"}}),
+									 QSharedPointer<QDiscordChannel>())
+				 });
+	QCOMPARE(spy.count(), 1);
+	QCOMPARE(spy.first().first().value<QDiscordMessage>().content(),
+			 QString("hello"));
+
+	disconnect(&state, &QDiscordStateComponent::messageCreated, &context, nullptr);
+	QCOMPARE(bus->subscriberCount<QDiscordEvent::MessageCreate>(), 1);
+	QVERIFY(state.disconnect(&spy));
+	QVERIFY(!bus->hasSubscribers<QDiscordEvent::MessageCreate>());
+}
+
+QTEST_MAIN(tst_QDiscordEventBus)
+
+#include "tst_qdiscordeventbus.moc"
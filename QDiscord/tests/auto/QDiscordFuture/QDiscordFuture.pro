@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordfuture.cpp
+
+include(../auto.pri)
@@ -0,0 +1,177 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordFuture: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordFuture();
+private slots:
+	void testResolve();
+	void testThen();
+	void testFlatten();
+	void testFailure();
+	void testCancel();
+	void testCancelChained();
+};
+
+tst_QDiscordFuture::tst_QDiscordFuture()
+{
+
+}
+
+void tst_QDiscordFuture::testResolve()
+{
+	QDiscordFuture<int> invalid;
+	QVERIFY(!invalid.isValid());
+	QVERIFY(!invalid.isFinished());
+	QVERIFY(!invalid.then([](int){}).isValid());
+
+	QDiscordPromise<int> promise;
+	QDiscordFuture<int> future = promise.future();
+	QVERIFY(future.isValid());
+	QVERIFY(!future.isFinished());
+	QCOMPARE(future.result(), 0);
+
+	promise.resolve(5);
+	QVERIFY(future.isSucceeded());
+	QCOMPARE(future.result(), 5);
+	//Only the first result counts.
+	promise.resolve(6);
+	promise.reject(QNetworkReply::TimeoutError);
+	QCOMPARE(future.result(), 5);
+	QCOMPARE(future.error(), QNetworkReply::NoError);
+
+	QDiscordFuture<QString> resolved = QDiscordFuture<QString>::resolved("a");
+	QVERIFY(resolved.isSucceeded());
+	QCOMPARE(resolved.result(), QString("a"));
+}
+
+void tst_QDiscordFuture::testThen()
+{
+	QDiscordPromise<int> promise;
+	int seen = 0;
+	QDiscordFuture<int> passed = promise.future().then([&](int value){
+		seen = value;
+	});
+	QDiscordFuture<QString> mapped = passed.then([](int value){
+		return QString::number(value*2);
+	});
+	QVERIFY(!mapped.isFinished());
+
+	promise.resolve(21);
+	QCOMPARE(seen, 21);
+	QCOMPARE(passed.result(), 21);
+	QCOMPARE(mapped.result(), QString("42"));
+
+	//Functions chained to finished futures are called right away.
+	int calls = 0;
+	mapped.then([&](const QString&){
+		calls++;
+	});
+	QCOMPARE(calls, 1);
+}
+
+void tst_QDiscordFuture::testFlatten()
+{
+	QDiscordPromise<int> outer;
+	QDiscordPromise<QString> inner;
+	QDiscordFuture<QString> future = outer.future().then([&](int){
+		return inner.future();
+	});
+	outer.resolve(1);
+	QVERIFY(!future.isFinished());
+	inner.resolve("done");
+	QCOMPARE(future.result(), QString("done"));
+}
+
+void tst_QDiscordFuture::testFailure()
+{
+	QDiscordPromise<int> promise;
+	int thenCalls = 0;
+	QNetworkReply::NetworkError failure = QNetworkReply::NoError;
+	QDiscordFuture<int> future = promise.future()
+	.then([&](int value){
+		thenCalls++;
+		return value;
+	})
+	.fail([&](QNetworkReply::NetworkError error){
+		failure = error;
+	});
+	promise.reject(QNetworkReply::ContentNotFoundError);
+	QCOMPARE(thenCalls, 0);
+	QCOMPARE(failure, QNetworkReply::ContentNotFoundError);
+	QVERIFY(future.isFinished());
+	QVERIFY(!future.isSucceeded());
+	QCOMPARE(future.error(), QNetworkReply::ContentNotFoundError);
+
+	failure = QNetworkReply::NoError;
+	QDiscordFuture<int>::rejected(QNetworkReply::TimeoutError)
+	.fail([&](QNetworkReply::NetworkError error){
+		failure = error;
+	});
+	QCOMPARE(failure, QNetworkReply::TimeoutError);
+}
+
+void tst_QDiscordFuture::testCancel()
+{
+	QDiscordPromise<int> promise;
+	int calls = 0;
+	QDiscordFuture<int> future = promise.future();
+	future.then([&](int){
+		calls++;
+	})
+	.fail([&](QNetworkReply::NetworkError){
+		calls++;
+	});
+	future.cancel();
+	QVERIFY(promise.isCanceled());
+	QVERIFY(future.isCanceled());
+	QCOMPARE(future.error(), QNetworkReply::OperationCanceledError);
+	promise.resolve(1);
+	QCOMPARE(calls, 0);
+	QCOMPARE(future.result(), 0);
+
+	//Finished futures can no longer be canceled.
+	QDiscordFuture<int> resolved = QDiscordFuture<int>::resolved(1);
+	resolved.cancel();
+	QVERIFY(!resolved.isCanceled());
+	QCOMPARE(resolved.result(), 1);
+}
+
+void tst_QDiscordFuture::testCancelChained()
+{
+	//Canceling a chained future cancels the futures it was chained from.
+	QDiscordPromise<int> promise;
+	QDiscordFuture<QString> chained = promise.future()
+	.then([](int value){
+		return value + 1;
+	})
+	.then([](int value){
+		return QString::number(value);
+	});
+	chained.cancel();
+	QVERIFY(promise.isCanceled());
+
+	//And canceling the original future cancels the chained ones.
+	QDiscordPromise<int> other;
+	QDiscordFuture<int> first = other.future().then([](int value){
+		return value;
+	});
+	other.cancel();
+	QVERIFY(first.isCanceled());
+
+	//Including futures returned by the chained functions.
+	QDiscordPromise<int> outer;
+	QDiscordPromise<int> inner;
+	QDiscordFuture<int> flattened = outer.future().then([&](int){
+		return inner.future();
+	});
+	outer.resolve(1);
+	flattened.cancel();
+	QVERIFY(inner.isCanceled());
+}
+
+QTEST_MAIN(tst_QDiscordFuture)
+
+#include "tst_qdiscordfuture.moc"
@@ -13,6 +13,7 @@ private slots:
 	void testMentions();
 	void testOperatorEquals_data();
 	void testOperatorEquals();
+	void testSharing();
 private:
 	QJsonObject _nullMember;
 	QJsonObject _guildlessMember;
@@ -164,6 +165,49 @@ void tst_QDiscordMember::testOperatorEquals()
 	QVERIFY(!(null_member == null_member));
 }
 
+void tst_QDiscordMember::testSharing()
+{
+	QDiscordMember member(_testMember, _guild);
+	QSharedPointer<QDiscordUser> user = member.user();
+	QDiscordMember copy(member);
+	QCOMPARE(copy.nickname(), member.nickname());
+	QVERIFY(copy.user() == member.user());
+
+	//Detaching keeps the user shared, so earlier pointers stay up to date.
+	member.update(QJsonObject({
+								  {"nick", "changed"},
+								  {"user", QJsonObject({
+									   {"id", "111264179623531612"},
+									   {"username", "changed"}
+								   })}
+							  }), QSharedPointer<QDiscordGuild>());
+	QCOMPARE(member.nickname(), QString("changed"));
+	QCOMPARE(copy.nickname(), QString("testbot"));
+	QVERIFY(member.user() == user);
+	QVERIFY(copy.user() == user);
+	QCOMPARE(user->username(), QString("changed"));
+
+	//Only a different user replaces the shared one.
+	copy.update(QJsonObject({
+								{"user", QJsonObject({
+									 {"id", "1"},
+									 {"username", "other"}
+								 })}
+							}), QSharedPointer<QDiscordGuild>());
+	QCOMPARE(copy.user()->id(), QString("1"));
+	QVERIFY(member.user() == user);
+	QCOMPARE(user->username(), QString("changed"));
+
+	QDiscordMember userless(_userlessMember, _guild);
+	userless.update(_testMember, QSharedPointer<QDiscordGuild>());
+	QVERIFY(userless.user());
+	QCOMPARE(userless.user()->id(), QString("111264179623531612"));
+
+	QDiscordMember moved(std::move(copy));
+	QCOMPARE(moved.nickname(), QString("testbot"));
+	QCOMPARE(moved.user()->id(), QString("1"));
+}
+
 QTEST_MAIN(tst_QDiscordMember)
 
 #include "tst_qdiscordmember.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordmemberindex.cpp
+
+include(../auto.pri)
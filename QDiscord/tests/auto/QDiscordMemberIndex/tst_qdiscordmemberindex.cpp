@@ -0,0 +1,208 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordMemberIndex: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordMemberIndex();
+private slots:
+	void testPrefix();
+	void testSubstring();
+	void testLimit();
+	void testGuild();
+	void testGuildCopy();
+private:
+	QJsonObject member(const QString& id, const QString& username,
+					   const QString& nickname = QString());
+	QSharedPointer<QDiscordMember> memberPtr(const QString& id,
+											 const QString& username,
+											 const QString& nickname = QString());
+	QStringList ids(const QList<QSharedPointer<QDiscordMember>>& members);
+};
+
+tst_QDiscordMemberIndex::tst_QDiscordMemberIndex()
+{
+
+}
+
+QJsonObject tst_QDiscordMemberIndex::member(const QString& id,
+											const QString& username,
+											const QString& nickname)
+{
+	return QJsonObject({
+						   {"nick", nickname},
+						   {"user", QJsonObject({
+								{"id", id},
+								{"username", username}
+							})}
+					   });
+}
+
+QSharedPointer<QDiscordMember>
+tst_QDiscordMemberIndex::memberPtr(const QString& id,
+								   const QString& username,
+								   const QString& nickname)
+{
+	return QSharedPointer<QDiscordMember>(
+				new QDiscordMember(member(id, username, nickname),
+								   QSharedPointer<QDiscordGuild>())
+				);
+}
+
+QStringList
+tst_QDiscordMemberIndex::ids(const QList<QSharedPointer<QDiscordMember>>& members)
+{
+	QStringList ids;
+	for(const QSharedPointer<QDiscordMember>& item : members)
+		ids.append(item->user()->id());
+	ids.sort();
+	return ids;
+}
+
+void tst_QDiscordMemberIndex::testPrefix()
+{
+	QDiscordMemberIndex index;
+	index.insert(memberPtr("1", "Alice"));
+	index.insert(memberPtr("2", "alfred", "Alfie"));
+	index.insert(memberPtr("3", "Bob", "Alan"));
+	QCOMPARE(index.size(), 3);
+
+	QCOMPARE(ids(index.findByPrefix("AL")), QStringList({"1", "2", "3"}));
+	QCOMPARE(ids(index.findByPrefix("alf")), QStringList({"2"}));
+	QCOMPARE(ids(index.findByPrefix("bo")), QStringList({"3"}));
+	QVERIFY(index.findByPrefix("carol").isEmpty());
+
+	index.remove("2");
+	QCOMPARE(ids(index.findByPrefix("al")), QStringList({"1", "3"}));
+
+	//Reinserting a member replaces the names it was indexed under.
+	index.insert(memberPtr("3", "Bob"));
+	QCOMPARE(ids(index.findByPrefix("al")), QStringList({"1"}));
+}
+
+void tst_QDiscordMemberIndex::testSubstring()
+{
+	QDiscordMemberIndex index;
+	index.insert(memberPtr("1", "SuperBot"));
+	index.insert(memberPtr("2", "robot", "Botanist"));
+	index.insert(memberPtr("3", "someone"));
+
+	QCOMPARE(ids(index.findBySubstring("BOT")), QStringList({"1", "2"}));
+	QCOMPARE(ids(index.findBySubstring("erbo")), QStringList({"1"}));
+	QCOMPARE(ids(index.findBySubstring("ne")), QStringList({"3"}));
+	QCOMPARE(ids(index.findBySubstring("o")), QStringList({"1", "2", "3"}));
+	QVERIFY(index.findBySubstring("botx").isEmpty());
+
+	index.clear();
+	QCOMPARE(index.size(), 0);
+	QVERIFY(index.findBySubstring("bot").isEmpty());
+}
+
+void tst_QDiscordMemberIndex::testLimit()
+{
+	QDiscordMemberIndex index;
+	for(int i = 1; i <= 10; i++)
+		index.insert(memberPtr(QString::number(i), "user" + QString::number(i)));
+
+	QCOMPARE(index.findByPrefix("user").size(), 10);
+	QCOMPARE(index.findByPrefix("user", 3).size(), 3);
+	QCOMPARE(index.findBySubstring("ser", 4).size(), 4);
+	QCOMPARE(index.findBySubstring("s", 2).size(), 2);
+	QVERIFY(index.findBySubstring("ser", 0).isEmpty());
+}
+
+void tst_QDiscordMemberIndex::testGuild()
+{
+	QDiscordCachePolicy policy;
+	policy.setIndexMembers(true);
+	QDiscordGuild guild(QJsonObject({
+										{"id", "10"},
+										{"members", QJsonArray({
+											 member("1", "Alice"),
+											 member("2", "Bob")
+										 })}
+									}), policy);
+	QVERIFY(guild.memberIndexEnabled());
+	QCOMPARE(ids(guild.memberIndex()->findByPrefix("a")), QStringList({"1"}));
+
+	guild.addMember(memberPtr("3", "Anna"));
+	QCOMPARE(ids(guild.memberIndex()->findByPrefix("a")), QStringList({"1", "3"}));
+
+	guild.updateMember(guild.member("2"), QJsonObject({{"nick", "Archer"}}));
+	QCOMPARE(ids(guild.memberIndex()->findByPrefix("a")),
+			 QStringList({"1", "2", "3"}));
+
+	guild.updateMember(guild.member("1"),
+					   QJsonObject({{"user", QJsonObject({{"username", "Zed"}})}}));
+	QCOMPARE(ids(guild.memberIndex()->findByPrefix("a")), QStringList({"2", "3"}));
+
+	guild.removeMember(guild.member("3"));
+	QCOMPARE(ids(guild.memberIndex()->findByPrefix("a")), QStringList({"2"}));
+
+	guild.setMemberIndexEnabled(false);
+	QVERIFY(!guild.memberIndex());
+
+	QDiscordGuild unindexed(QJsonObject({{"id", "11"}}));
+	QVERIFY(!unindexed.memberIndexEnabled());
+	unindexed.addMember(memberPtr("1", "Alice"));
+	unindexed.setMemberIndexEnabled(true);
+	QCOMPARE(unindexed.memberIndex()->size(), 1);
+}
+
+void tst_QDiscordMemberIndex::testGuildCopy()
+{
+	QDiscordCachePolicy policy;
+	policy.setIndexMembers(true);
+	QDiscordGuild guild(QJsonObject({
+										{"id", "10"},
+										{"members", QJsonArray({
+											 member("1", "Alice"),
+											 member("2", "Bob")
+										 })},
+										{"channels", QJsonArray({
+											 QJsonObject({
+												 {"id", "5"},
+												 {"name", "general"},
+												 {"type", "text"}
+											 })
+										 })}
+									}), policy);
+	QSharedPointer<QDiscordMember> alice = guild.member("1");
+	QSharedPointer<QDiscordChannel> general = guild.channel("5");
+	QDiscordGuild copy = guild;
+
+	//Mutating the guild detaches it from the copy, which must not replace the
+	//members and channels handed out before.
+	guild.update(QJsonObject({{"name", "renamed"}}));
+	guild.addMember(memberPtr("3", "Anna"));
+	guild.addChannel(QSharedPointer<QDiscordChannel>(new QDiscordChannel(
+		QJsonObject({{"id", "6"}, {"name", "other"}, {"type", "text"}})
+	)));
+	guild.updateMember(alice, QJsonObject({{"nick", "Ace"}}));
+	QCOMPARE(guild.member("1"), alice);
+	QCOMPARE(guild.channel("5"), general);
+	QVERIFY(guild.orderedChannels().contains(general));
+	QCOMPARE(alice->nickname(), QString("Ace"));
+	QCOMPARE(ids(guild.memberIndex()->findByPrefix("a")),
+			 QStringList({"1", "3"}));
+
+	//The copy keeps its own properties but shares the contents, so its index
+	//and memory usage agree with the members it returns.
+	QCOMPARE(guild.name(), QString("renamed"));
+	QVERIFY(copy.name().isEmpty());
+	QCOMPARE(copy.member("1"), alice);
+	QCOMPARE(copy.member("3"), guild.member("3"));
+	QCOMPARE(copy.channel("6"), guild.channel("6"));
+	QCOMPARE(ids(copy.memberIndex()->findByPrefix("a")),
+			 QStringList({"1", "3"}));
+	QCOMPARE(ids(copy.memberIndex()->findByPrefix("ace")), QStringList({"1"}));
+	QCOMPARE(copy.memoryUsage().totalBytes(), guild.memoryUsage().totalBytes());
+	QVERIFY(guild.removeMember(alice));
+	QVERIFY(!copy.member("1"));
+	QCOMPARE(ids(copy.memberIndex()->findByPrefix("a")), QStringList({"3"}));
+}
+
+QTEST_MAIN(tst_QDiscordMemberIndex)
+
+#include "tst_qdiscordmemberindex.moc"
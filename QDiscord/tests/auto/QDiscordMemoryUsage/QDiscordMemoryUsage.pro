@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordmemoryusage.cpp
+
+include(../auto.pri)
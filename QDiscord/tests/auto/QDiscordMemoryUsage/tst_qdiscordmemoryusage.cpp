@@ -0,0 +1,103 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordMemoryUsage: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordMemoryUsage();
+private slots:
+	void testMember();
+	void testGuildIncremental();
+	void testMessageCache();
+private:
+	QJsonObject member(const QString& id, const QString& nick = "");
+};
+
+tst_QDiscordMemoryUsage::tst_QDiscordMemoryUsage()
+{
+
+}
+
+QJsonObject tst_QDiscordMemoryUsage::member(const QString& id,
+											const QString& nick)
+{
+	return QJsonObject({
+						   {"user", QJsonObject({
+								{"id", id},
+								{"username", "user"}
+							})},
+						   {"nick", nick}
+					   });
+}
+
+void tst_QDiscordMemoryUsage::testMember()
+{
+	QDiscordMemoryUsage usage =
+			QDiscordMemoryUsage::of(QDiscordMember(member("1", "nick"),
+												   QSharedPointer<QDiscordGuild>()));
+
+	QCOMPARE(usage.members, 1);
+	QCOMPARE(usage.users, 1);
+	QCOMPARE(usage.strings, 3);
+	QVERIFY(usage.memberBytes > 0);
+	QVERIFY(usage.userBytes > 0);
+	QCOMPARE(usage.totalBytes(), usage.memberBytes + usage.userBytes +
+			 usage.stringBytes);
+}
+
+void tst_QDiscordMemoryUsage::testGuildIncremental()
+{
+	QDiscordGuild guild(QJsonObject({
+										{"id", "10"},
+										{"members", QJsonArray({member("1")})},
+										{"channels", QJsonArray({
+											 QJsonObject({{"id", "100"}})
+										 })}
+									}));
+	QDiscordMemoryUsage initial = guild.memoryUsage();
+	QCOMPARE(initial.members, 1);
+	QCOMPARE(initial.channels, 1);
+
+	QSharedPointer<QDiscordMember> added(
+				new QDiscordMember(member("2", "a long nickname"),
+								   QSharedPointer<QDiscordGuild>()));
+	guild.addMember(added);
+	QCOMPARE(guild.memoryUsage().members, 2);
+	QVERIFY(guild.memoryUsage().totalBytes() > initial.totalBytes());
+
+	guild.updateMember(added, QJsonObject({{"nick", ""}}));
+	qint64 updated = guild.memoryUsage().stringBytes;
+	guild.updateMember(added, QJsonObject({{"nick", "a long nickname"}}));
+	QVERIFY(guild.memoryUsage().stringBytes > updated);
+
+	guild.removeMember(added);
+	QCOMPARE(guild.memoryUsage().members, initial.members);
+	QCOMPARE(guild.memoryUsage().totalBytes(), initial.totalBytes());
+}
+
+void tst_QDiscordMemoryUsage::testMessageCache()
+{
+	QDiscordMessageCache cache;
+	cache.setEnabled(true);
+	cache.insert(QDiscordMessage(QJsonObject({
+												 {"id", "1"},
+												 {"channel_id", "100"},
+												 {"content", "hello"}
+											 })));
+
+	QCOMPARE(cache.memoryUsage().messages, 1);
+	QCOMPARE(cache.memoryUsage(QString()).messages, 1);
+	qint64 bytes = cache.memoryUsage().totalBytes();
+
+	cache.update(QJsonObject({{"id", "1"}, {"content", "hello, world"}}));
+	QVERIFY(cache.memoryUsage().totalBytes() > bytes);
+
+	cache.take("1");
+	QCOMPARE(cache.memoryUsage().messages, 0);
+	QCOMPARE(cache.memoryUsage().totalBytes(), qint64(0));
+}
+
+QTEST_MAIN(tst_QDiscordMemoryUsage)
+
+#include "tst_qdiscordmemoryusage.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordmessagecache.cpp
+
+include(../auto.pri)
@@ -0,0 +1,168 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordMessageCache: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordMessageCache();
+private slots:
+	void testDisabled();
+	void testInsertAndTake();
+	void testChannelCapacity();
+	void testDeleteThenInsert();
+	void testGlobalLimit();
+	void testGuildCapacity();
+	void testUpdate();
+private:
+	QDiscordMessage message(const QString& id, const QString& channelId,
+							const QString& content = "");
+};
+
+tst_QDiscordMessageCache::tst_QDiscordMessageCache()
+{
+
+}
+
+QDiscordMessage tst_QDiscordMessageCache::message(const QString& id,
+												  const QString& channelId,
+												  const QString& content)
+{
+	return QDiscordMessage(QJsonObject({
+										   {"id", id},
+										   {"channel_id", channelId},
+										   {"content", content}
+									   }));
+}
+
+void tst_QDiscordMessageCache::testDisabled()
+{
+	QDiscordMessageCache cache;
+
+	QVERIFY(!cache.insert(message("1", "100")));
+	QCOMPARE(cache.count(), 0);
+}
+
+void tst_QDiscordMessageCache::testInsertAndTake()
+{
+	QDiscordMessageCache cache;
+	cache.setEnabled(true);
+
+	cache.insert(message("1", "100", "first"));
+	cache.insert(message("2", "100", "second"));
+
+	QCOMPARE(cache.count(), 2);
+	QCOMPARE(cache.message("1")->content(), QString("first"));
+
+	QSharedPointer<QDiscordMessage> taken = cache.take("1");
+	QVERIFY(taken);
+	QCOMPARE(taken->content(), QString("first"));
+	QVERIFY(!cache.message("1"));
+	QVERIFY(!cache.take("1"));
+	QCOMPARE(cache.count(), 1);
+	QCOMPARE(cache.channelMessages("100").size(), 1);
+}
+
+void tst_QDiscordMessageCache::testChannelCapacity()
+{
+	QDiscordMessageCache cache;
+	cache.setEnabled(true);
+	cache.setDefaultCapacity(3);
+
+	for(int i = 1; i <= 5; i++)
+		cache.insert(message(QString::number(i), "100"));
+
+	QList<QSharedPointer<QDiscordMessage>> messages =
+			cache.channelMessages("100");
+	QCOMPARE(messages.size(), 3);
+	QCOMPARE(messages.first()->id(), QString("3"));
+	QCOMPARE(messages.last()->id(), QString("5"));
+	QVERIFY(!cache.message("2"));
+}
+
+void tst_QDiscordMessageCache::testDeleteThenInsert()
+{
+	QDiscordMessageCache cache;
+	cache.setEnabled(true);
+	cache.setDefaultCapacity(3);
+
+	for(int i = 1; i <= 3; i++)
+		cache.insert(message(QString::number(i), "100"));
+	//The slot of a removed message is reused without evicting another one.
+	QVERIFY(cache.take("1"));
+	cache.insert(message("4", "100"));
+
+	QList<QSharedPointer<QDiscordMessage>> messages =
+			cache.channelMessages("100");
+	QCOMPARE(cache.count(), 3);
+	QCOMPARE(messages.size(), 3);
+	QCOMPARE(messages.first()->id(), QString("2"));
+	QCOMPARE(messages.last()->id(), QString("4"));
+
+	//Once full again, the oldest live message is evicted.
+	cache.insert(message("5", "100"));
+	QCOMPARE(cache.count(), 3);
+	QVERIFY(!cache.message("2"));
+	QVERIFY(cache.message("3"));
+}
+
+void tst_QDiscordMessageCache::testGlobalLimit()
+{
+	QDiscordMessageCache cache;
+	cache.setEnabled(true);
+	cache.setMaxMessages(4);
+
+	cache.insert(message("1", "100"));
+	cache.insert(message("2", "100"));
+	cache.insert(message("3", "200"));
+	cache.insert(message("4", "200"));
+	//Channel 100 is now the least recently used one.
+	cache.insert(message("5", "200"));
+
+	QCOMPARE(cache.count(), 4);
+	QVERIFY(!cache.message("1"));
+	QVERIFY(cache.message("2"));
+	QVERIFY(cache.message("5"));
+}
+
+void tst_QDiscordMessageCache::testGuildCapacity()
+{
+	QDiscordMessageCache cache;
+	cache.setEnabled(true);
+	cache.setGuildCapacity("", 0);
+
+	QVERIFY(!cache.insert(message("1", "100")));
+	cache.resetGuildCapacity("");
+	QVERIFY(cache.insert(message("1", "100")));
+}
+
+void tst_QDiscordMessageCache::testUpdate()
+{
+	QDiscordMessage original = message("1", "100", "before");
+	original.update(QJsonObject({{"content", "after"}}));
+
+	QCOMPARE(original.content(), QString("after"));
+	QCOMPARE(original.id(), QString("1"));
+
+	//A copy made before an update keeps the previous author.
+	original.update(QJsonObject({
+									{"author", QJsonObject({
+										 {"id", "2"},
+										 {"username", "before"}
+									 })}
+								}));
+	QDiscordMessage previous = original;
+	original.update(QJsonObject({
+									{"author", QJsonObject({
+										 {"id", "2"},
+										 {"username", "after"}
+									 })}
+								}));
+	QCOMPARE(original.author()->username(), QString("after"));
+	QCOMPARE(previous.author()->username(), QString("before"));
+	QCOMPARE(previous.content(), QString("after"));
+}
+
+QTEST_MAIN(tst_QDiscordMessageCache)
+
+#include "tst_qdiscordmessagecache.moc"
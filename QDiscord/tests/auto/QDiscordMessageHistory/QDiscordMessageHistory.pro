@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordmessagehistory.cpp
+
+include(../auto.pri)
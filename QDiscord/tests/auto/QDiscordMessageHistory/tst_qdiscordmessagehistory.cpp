@@ -0,0 +1,70 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordMessageHistory: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordMessageHistory();
+private slots:
+	void testHistory();
+	void testWalker();
+};
+
+tst_QDiscordMessageHistory::tst_QDiscordMessageHistory()
+{
+
+}
+
+void tst_QDiscordMessageHistory::testHistory()
+{
+	QDiscordRestComponent rest;
+	QDiscordMessageHistory history(&rest, "1");
+	QCOMPARE(history.pageSize(), 100);
+	history.setPageSize(500);
+	QCOMPARE(history.pageSize(), 100);
+	history.setPageSize(0);
+	QCOMPARE(history.pageSize(), 1);
+
+	//Failed pages do not end the history and can be requested again.
+	QDiscordFuture<QDiscordMessageHistory::Page> page = history.next();
+	QVERIFY(page.isFinished());
+	QCOMPARE(page.error(), QNetworkReply::AuthenticationRequiredError);
+	QVERIFY(!history.atEnd());
+	page = history.next();
+	QCOMPARE(page.error(), QNetworkReply::AuthenticationRequiredError);
+	QCOMPARE(history.messagesRead(), 0);
+}
+
+void tst_QDiscordMessageHistory::testWalker()
+{
+	qRegisterMetaType<QNetworkReply::NetworkError>();
+	QDiscordRestComponent rest;
+	QDiscordHistoryWalker walker(&rest);
+	QSignalSpy channels(&walker, &QDiscordHistoryWalker::channelFinished);
+	QSignalSpy finished(&walker, &QDiscordHistoryWalker::finished);
+	int pages = 0;
+	walker.setConsumer([&](const QString&,
+					   const QDiscordMessageHistory::Page&){
+		pages++;
+		return true;
+	});
+	walker.setConcurrency(2);
+	walker.addChannels(QStringList() << "1" << "2" << "3" << "4" << "5");
+
+	QCOMPARE(channels.count(), 5);
+	QCOMPARE(finished.count(), 1);
+	QCOMPARE(pages, 0);
+	QCOMPARE(walker.active(), 0);
+	QCOMPARE(walker.queued(), 0);
+	for(int i = 0; i < channels.count(); i++)
+	{
+		QCOMPARE(channels[i][0].toString(), QString::number(i + 1));
+		QCOMPARE(channels[i][1].value<QNetworkReply::NetworkError>(),
+				 QNetworkReply::AuthenticationRequiredError);
+	}
+}
+
+QTEST_MAIN(tst_QDiscordMessageHistory)
+
+#include "tst_qdiscordmessagehistory.moc"
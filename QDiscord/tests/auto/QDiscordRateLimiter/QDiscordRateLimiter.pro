@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordratelimiter.cpp
+
+include(../auto.pri)
@@ -0,0 +1,460 @@
+#include <QtTest>
+#include <QDiscord>
+
+class FakeReply: public QNetworkReply
+{
+public:
+	explicit FakeReply(QObject* parent = 0) : QNetworkReply(parent) {
+		open(QIODevice::ReadOnly);
+	}
+	void abort() override {}
+	void finish(const QByteArray& limit, const QByteArray& remaining,
+				const QByteArray& resetAfter,
+				const QByteArray& bucket = QByteArray()) {
+		setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+		if(!limit.isEmpty())
+		{
+			setRawHeader("X-RateLimit-Limit", limit);
+			setRawHeader("X-RateLimit-Remaining", remaining);
+			setRawHeader("X-RateLimit-Reset-After", resetAfter);
+		}
+		if(!bucket.isEmpty())
+			setRawHeader("X-RateLimit-Bucket", bucket);
+		setFinished(true);
+		emit finished();
+	}
+	void reject(const QByteArray& retryAfter, bool global) {
+		setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 429);
+		setRawHeader("Retry-After", retryAfter);
+		if(global)
+			setRawHeader("X-RateLimit-Global", "true");
+		setFinished(true);
+		emit finished();
+	}
+protected:
+	qint64 readData(char*, qint64) override {return -1;}
+};
+
+class tst_QDiscordRateLimiter: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordRateLimiter();
+private slots:
+	void testRoute();
+	void testUnknownBucket();
+	void testIndependentChannels();
+	void testReset();
+	void testSharedBucket();
+	void testUnlimited();
+	void testRetry();
+	void testGlobal();
+	void testMaxRetries();
+	void testDropped();
+	void testWeights();
+	void testInteractive();
+	void testWaitTime();
+	void testIdleBuckets();
+private:
+	void send(QDiscordRateLimiter& limiter,
+			  const QDiscordRateLimiter::Route& route,
+			  QDiscordRateLimiter::Priority priority =
+			  QDiscordRateLimiter::Priority::Normal);
+	QList<FakeReply*> _sent;
+	QList<int> _priorities;
+	int _finished;
+};
+
+tst_QDiscordRateLimiter::tst_QDiscordRateLimiter()
+{
+
+}
+
+void tst_QDiscordRateLimiter::send(QDiscordRateLimiter& limiter,
+								   const QDiscordRateLimiter::Route& route,
+								   QDiscordRateLimiter::Priority priority)
+{
+	limiter.enqueue(route, priority, [this, &limiter, priority](){
+		FakeReply* reply = new FakeReply(&limiter);
+		_sent.append(reply);
+		_priorities.append(int(priority));
+		return reply;
+	}, [this](QNetworkReply*){
+		_finished++;
+	});
+}
+
+void tst_QDiscordRateLimiter::testRoute()
+{
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/123/messages"));
+	QCOMPARE(route.name, QString("POST /channels/:major/messages"));
+	QCOMPARE(route.majorParameter, QString("123"));
+
+	route = QDiscordRateLimiter::Route::fromRequest(
+				"DELETE", QUrl(QDiscordUtilities::endPoints.channels +
+							   "/123/messages/456"));
+	QCOMPARE(route.name, QString("DELETE /channels/:major/messages/:id"));
+	QCOMPARE(route.majorParameter, QString("123"));
+
+	route = QDiscordRateLimiter::Route::fromRequest(
+				"PUT", QUrl(QDiscordUtilities::endPoints.channels +
+							"/1/messages/2/reactions/%F0%9F%91%8D/@me"));
+	QCOMPARE(route.name,
+			 QString("PUT /channels/:major/messages/:id/reactions/:emoji/@me"));
+
+	route = QDiscordRateLimiter::Route::fromRequest(
+				"GET", QUrl(QDiscordUtilities::endPoints.me));
+	QCOMPARE(route.name, QString("GET /users/@me"));
+	QVERIFY(route.majorParameter.isEmpty());
+}
+
+void tst_QDiscordRateLimiter::testUnknownBucket()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	for(int i = 0; i < 4; i++)
+		send(limiter, route);
+	//Only one request is in flight until the limits are known.
+	QCOMPARE(_sent.length(), 1);
+	QCOMPARE(limiter.queued(), 3);
+	QCOMPARE(limiter.queued(route), 3);
+
+	_sent[0]->finish("5", "4", "10");
+	QCOMPARE(_finished, 1);
+	QCOMPARE(_sent.length(), 4);
+	QCOMPARE(limiter.queued(), 0);
+
+	//One request of the window is left.
+	send(limiter, route);
+	send(limiter, route);
+	QCOMPARE(_sent.length(), 5);
+	QCOMPARE(limiter.queued(route), 1);
+}
+
+void tst_QDiscordRateLimiter::testIndependentChannels()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QDiscordRateLimiter::Route first =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	QDiscordRateLimiter::Route second =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/2/messages"));
+	send(limiter, first);
+	_sent[0]->finish("5", "0", "60");
+	for(int i = 0; i < 10; i++)
+		send(limiter, first);
+	QCOMPARE(_sent.length(), 1);
+	QCOMPARE(limiter.queued(first), 10);
+
+	send(limiter, second);
+	QCOMPARE(_sent.length(), 2);
+	QCOMPARE(limiter.queued(second), 0);
+}
+
+void tst_QDiscordRateLimiter::testReset()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"PATCH", QUrl(QDiscordUtilities::endPoints.channels + "/1"));
+	send(limiter, route);
+	_sent[0]->finish("2", "0", "0.05");
+	send(limiter, route);
+	send(limiter, route);
+	send(limiter, route);
+	QCOMPARE(_sent.length(), 1);
+	QTRY_COMPARE(_sent.length(), 3);
+	QCOMPARE(limiter.queued(route), 1);
+}
+
+void tst_QDiscordRateLimiter::testSharedBucket()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QDiscordRateLimiter::Route name =
+			QDiscordRateLimiter::Route::fromRequest(
+				"PATCH", QUrl(QDiscordUtilities::endPoints.channels + "/1"));
+	QDiscordRateLimiter::Route other =
+			QDiscordRateLimiter::Route::fromRequest(
+				"DELETE", QUrl(QDiscordUtilities::endPoints.channels + "/1"));
+	send(limiter, name);
+	send(limiter, other);
+	QCOMPARE(_sent.length(), 2);
+	_sent[0]->finish("2", "1", "60", "shared");
+	_sent[1]->finish("2", "0", "60", "shared");
+
+	send(limiter, name);
+	send(limiter, other);
+	QCOMPARE(_sent.length(), 2);
+	QCOMPARE(limiter.queued(name), 2);
+	QCOMPARE(limiter.queued(other), 2);
+}
+
+void tst_QDiscordRateLimiter::testUnlimited()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"GET", QUrl(QDiscordUtilities::endPoints.gateway));
+	send(limiter, route);
+	_sent[0]->finish(QByteArray(), QByteArray(), QByteArray());
+	for(int i = 0; i < 10; i++)
+		send(limiter, route);
+	QCOMPARE(_sent.length(), 11);
+	QCOMPARE(limiter.queued(), 0);
+	limiter.clear();
+}
+
+void tst_QDiscordRateLimiter::testRetry()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QSignalSpy spy(&limiter, &QDiscordRateLimiter::rateLimited);
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	send(limiter, route);
+	send(limiter, route);
+	_sent[0]->reject("0.05", false);
+	QCOMPARE(_finished, 0);
+	QCOMPARE(spy.count(), 1);
+	QCOMPARE(spy[0][0].toString(), route.name);
+	QCOMPARE(spy[0][1].toString(), QString("1"));
+	QCOMPARE(spy[0][2].toLongLong(), Q_INT64_C(50));
+	QCOMPARE(spy[0][3].toBool(), false);
+	QCOMPARE(limiter.queued(route), 2);
+
+	//The rejected request is retried before the one queued after it.
+	QTRY_COMPARE(_sent.length(), 2);
+	_sent[1]->finish("5", "4", "10");
+	QCOMPARE(_finished, 1);
+	QCOMPARE(_sent.length(), 3);
+}
+
+void tst_QDiscordRateLimiter::testGlobal()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QSignalSpy spy(&limiter, &QDiscordRateLimiter::rateLimited);
+	QDiscordRateLimiter::Route first =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	QDiscordRateLimiter::Route second =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/2/messages"));
+	send(limiter, first);
+	_sent[0]->reject("0.1", true);
+	QCOMPARE(spy.count(), 1);
+	QCOMPARE(spy[0][3].toBool(), true);
+	QVERIFY(limiter.globallyLimited());
+
+	send(limiter, second);
+	QCOMPARE(_sent.length(), 1);
+	QCOMPARE(limiter.queued(), 2);
+	QTRY_COMPARE(_sent.length(), 3);
+	QVERIFY(!limiter.globallyLimited());
+}
+
+void tst_QDiscordRateLimiter::testMaxRetries()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	limiter.setMaxRetries(0);
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	send(limiter, route);
+	_sent[0]->reject("10", false);
+	QCOMPARE(_finished, 1);
+	QCOMPARE(limiter.queued(), 0);
+}
+
+void tst_QDiscordRateLimiter::testDropped()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	send(limiter, route);
+	bool dropped = false;
+	limiter.enqueue(route, [&dropped]() -> QNetworkReply* {
+		dropped = true;
+		return nullptr;
+	}, [this](QNetworkReply*){
+		_finished++;
+	});
+	send(limiter, route);
+	QCOMPARE(limiter.queued(route), 2);
+
+	//The dropped request does not take the place of the next one.
+	_sent[0]->finish("5", "4", "10");
+	QVERIFY(dropped);
+	QCOMPARE(_sent.length(), 2);
+	QCOMPARE(limiter.queued(), 0);
+	_sent[1]->finish("5", "3", "10");
+	QCOMPARE(_finished, 2);
+}
+
+void tst_QDiscordRateLimiter::testWeights()
+{
+	typedef QDiscordRateLimiter::Priority Priority;
+	_sent.clear();
+	_priorities.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	limiter.setWeight(Priority::Normal, 2);
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	send(limiter, route);
+	for(int i = 0; i < 3; i++)
+		send(limiter, route, Priority::Bulk);
+	for(int i = 0; i < 3; i++)
+		send(limiter, route, Priority::Normal);
+	QCOMPARE(limiter.queued(Priority::Bulk), 3);
+	QCOMPARE(limiter.queued(Priority::Normal), 3);
+
+	//Normal requests get two turns for every bulk one, and only two bulk
+	//requests may be in flight.
+	_sent[0]->finish(QByteArray(), QByteArray(), QByteArray());
+	QList<int> expected;
+	expected<<int(Priority::Normal)<<int(Priority::Normal)
+		   <<int(Priority::Bulk)<<int(Priority::Normal)
+		   <<int(Priority::Normal)<<int(Priority::Bulk);
+	QCOMPARE(_priorities, expected);
+	QCOMPARE(limiter.inFlight(Priority::Bulk), 2);
+	QCOMPARE(limiter.queued(Priority::Bulk), 1);
+
+	_sent[2]->finish(QByteArray(), QByteArray(), QByteArray());
+	QCOMPARE(_sent.length(), 7);
+	QCOMPARE(_priorities.last(), int(Priority::Bulk));
+	QCOMPARE(limiter.queued(), 0);
+}
+
+void tst_QDiscordRateLimiter::testInteractive()
+{
+	typedef QDiscordRateLimiter::Priority Priority;
+	_sent.clear();
+	_priorities.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	limiter.setMaxInFlight(Priority::Bulk, 0);
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	for(int i = 0; i < 6; i++)
+		send(limiter, route, Priority::Bulk);
+	send(limiter, route, Priority::Interactive);
+	QCOMPARE(_sent.length(), 1);
+
+	//The interactive request does not wait for the bulk requests before it.
+	_sent[0]->finish(QByteArray(), QByteArray(), QByteArray());
+	QCOMPARE(_sent.length(), 7);
+	QCOMPARE(_priorities[1], int(Priority::Interactive));
+}
+
+void tst_QDiscordRateLimiter::testWaitTime()
+{
+	typedef QDiscordRateLimiter::Priority Priority;
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	QDiscordRateLimiter::Route route =
+			QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/1/messages"));
+	send(limiter, route, Priority::Interactive);
+	send(limiter, route, Priority::Interactive);
+	QTest::qWait(50);
+	_sent[0]->finish("5", "4", "10");
+	QCOMPARE(_sent.length(), 2);
+
+	const QDiscordRateLimiter::WaitTime& waited =
+			limiter.waitTime(Priority::Interactive);
+	QCOMPARE(waited.count, quint64(2));
+	QVERIFY(waited.longest >= 40);
+	QVERIFY(waited.average() <= waited.longest);
+	QCOMPARE(limiter.waitTime(Priority::Bulk).count, quint64(0));
+
+	limiter.resetWaitTimes();
+	QCOMPARE(limiter.waitTime(Priority::Interactive).count, quint64(0));
+}
+
+void tst_QDiscordRateLimiter::testIdleBuckets()
+{
+	_sent.clear();
+	_finished = 0;
+	QDiscordRateLimiter limiter;
+	for(int i = 1; i <= 50; i++)
+	{
+		send(limiter, QDiscordRateLimiter::Route::fromRequest(
+				 "POST", QUrl(QDiscordUtilities::endPoints.channels + "/" +
+							  QString::number(i) + "/messages")));
+	}
+	QCOMPARE(limiter.bucketCount(), 50);
+
+	//Buckets are dropped once nothing waits for them and their limit reset.
+	for(int i = 0; i < 48; i++)
+		_sent[i]->finish("5", "4", "0");
+	QCOMPARE(_finished, 48);
+	QCOMPARE(limiter.bucketCount(), 2);
+
+	//A bucket waiting for its reset is kept until then.
+	_sent[48]->finish("5", "4", "0.05");
+	QCOMPARE(limiter.bucketCount(), 2);
+	QTRY_COMPARE(limiter.bucketCount(), 1);
+
+	//Requests in flight keep their bucket.
+	QDiscordRateLimiter::Route last = QDiscordRateLimiter::Route::fromRequest(
+				"POST", QUrl(QDiscordUtilities::endPoints.channels +
+							 "/50/messages"));
+	send(limiter, last);
+	QCOMPARE(limiter.queued(last), 1);
+	_sent[49]->finish("5", "4", "0");
+	QCOMPARE(_sent.length(), 51);
+	QCOMPARE(limiter.bucketCount(), 1);
+	_sent[50]->finish("5", "3", "0");
+	QCOMPARE(limiter.bucketCount(), 0);
+
+	//Unlimited buckets are kept, so their requests are not serialized again.
+	QDiscordRateLimiter::Route unlimited =
+			QDiscordRateLimiter::Route::fromRequest(
+				"GET", QUrl(QDiscordUtilities::endPoints.gateway));
+	send(limiter, unlimited);
+	_sent.last()->finish(QByteArray(), QByteArray(), QByteArray());
+	QCOMPARE(limiter.bucketCount(), 1);
+}
+
+QTEST_MAIN(tst_QDiscordRateLimiter)
+
+#include "tst_qdiscordratelimiter.moc"
@@ -0,0 +1,6 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordrequestpipeline.cpp
+
+include(../auto.pri)
+include(../../mock/mock.pri)
@@ -0,0 +1,221 @@
+#include <QtTest>
+#include <QDiscord>
+#include "qdiscordmockserver.hpp"
+
+class HeaderInterceptor: public QDiscordRequestInterceptor
+{
+public:
+	HeaderInterceptor(const QByteArray& name, QList<QByteArray>& calls) :
+		_name(name), _calls(calls) {}
+	void request(QDiscordRequest& request) override {
+		_calls.append("request " + _name);
+		request.setRawHeader("X-Interceptor", _name);
+	}
+	void response(const QDiscordRequest& request,
+				  QDiscordResponse& response) override {
+		_calls.append("response " + _name);
+		QCOMPARE(request.rawHeaders().length(), 2);
+		response.setBody("{\"id\":\"" + _name + "\"}");
+	}
+private:
+	QByteArray _name;
+	QList<QByteArray>& _calls;
+};
+
+class tst_QDiscordRequestPipeline: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordRequestPipeline();
+private slots:
+	void testRequest();
+	void testNetworkRequest();
+	void testDecoder();
+	void testInterceptors();
+	void testCoalescing();
+	void testFuture();
+	void testUpload();
+};
+
+tst_QDiscordRequestPipeline::tst_QDiscordRequestPipeline()
+{
+
+}
+
+void tst_QDiscordRequestPipeline::testRequest()
+{
+	QJsonObject object;
+	object["content"] = "Hello";
+	QDiscordRequest request = QDiscordRequest::post(
+				QUrl(QDiscordUtilities::endPoints.channels + "/1/messages"),
+				object);
+	QCOMPARE(request.method(), QDiscordRequest::Method::Post);
+	QCOMPARE(request.methodName(), QByteArray("POST"));
+	QCOMPARE(request.body(), QByteArray("{\"content\":\"Hello\"}"));
+	QCOMPARE(request.contentType(), QByteArray("application/json"));
+	QCOMPARE(request.route().name, QString("POST /channels/:major/messages"));
+
+	request = QDiscordRequest::deleteResource(
+				QUrl(QDiscordUtilities::endPoints.channels + "/1/messages/2"));
+	QCOMPARE(request.methodName(), QByteArray("DELETE"));
+	QVERIFY(request.body().isEmpty());
+	QVERIFY(request.contentType().isEmpty());
+}
+
+void tst_QDiscordRequestPipeline::testNetworkRequest()
+{
+	QDiscordRequestPipeline pipeline;
+	QDiscordRequest request = QDiscordRequest::patch(
+				QUrl(QDiscordUtilities::endPoints.channels + "/1"),
+				QJsonObject());
+	request.setRawHeader("X-Audit-Log-Reason", "testing");
+
+	QNetworkRequest networkRequest = pipeline.networkRequest(request);
+	QCOMPARE(networkRequest.url(), request.url());
+	QVERIFY(!networkRequest.hasRawHeader("Authorization"));
+	QVERIFY(networkRequest.rawHeader("User-Agent")
+			.contains(QDiscordUtilities::libLink.toUtf8()));
+	QCOMPARE(networkRequest.rawHeader("content-type"),
+			 QByteArray("application/json"));
+	QCOMPARE(networkRequest.rawHeader("X-Audit-Log-Reason"),
+			 QByteArray("testing"));
+
+	pipeline.setAuthorization("Bot token");
+	QString botName = QDiscordUtilities::botName;
+	QDiscordUtilities::botName = "PipelineTest";
+	networkRequest = pipeline.networkRequest(request);
+	QCOMPARE(networkRequest.rawHeader("Authorization"),
+			 QByteArray("Bot token"));
+	QVERIFY(networkRequest.rawHeader("User-Agent").endsWith("PipelineTest"));
+	QDiscordUtilities::botName = botName;
+}
+
+void tst_QDiscordRequestPipeline::testDecoder()
+{
+	QDiscordResponse response;
+	response.setBody("{\"id\":\"123\",\"username\":\"Test\"}");
+	QCOMPARE(QDiscordResponseDecoder<QDiscordUser>::decode(response).id(),
+			 QString("123"));
+	QCOMPARE(QDiscordResponseDecoder<QJsonObject>::decode(response)
+			 .value("username").toString(), QString("Test"));
+	QCOMPARE(QDiscordResponseDecoder<QByteArray>::decode(response),
+			 response.body());
+
+	response.setRawHeader("X-RateLimit-Limit", "5");
+	response.setRawHeader("x-ratelimit-limit", "4");
+	QCOMPARE(response.rawHeaders().length(), 1);
+	QCOMPARE(response.rawHeader("X-RATELIMIT-LIMIT"), QByteArray("4"));
+}
+
+void tst_QDiscordRequestPipeline::testInterceptors()
+{
+	QDiscordRequestPipeline pipeline;
+	QList<QByteArray> calls;
+	HeaderInterceptor first("first", calls);
+	HeaderInterceptor second("second", calls);
+	pipeline.addInterceptor(&first);
+	pipeline.addInterceptor(&second);
+	pipeline.addInterceptor(&first);
+	QCOMPARE(pipeline.interceptors().length(), 2);
+
+	//Nothing listens on port 1, so the request fails without leaving the host.
+	QString id;
+	QNetworkReply::NetworkError error = QNetworkReply::NoError;
+	pipeline.send<QDiscordUser>(QDiscordRequest::get(QUrl("http://127.0.0.1:1/")),
+	[&](const QDiscordUser& user){
+		id = user.id();
+	},
+	[&](QNetworkReply::NetworkError e){
+		error = e;
+	});
+	QCOMPARE(calls, QList<QByteArray>()<<"request first"<<"request second");
+	QTRY_VERIFY(error != QNetworkReply::NoError);
+	QCOMPARE(calls, QList<QByteArray>()<<"request first"<<"request second"
+			 <<"response second"<<"response first");
+	QVERIFY(id.isEmpty());
+
+	pipeline.removeInterceptor(&first);
+	pipeline.removeInterceptor(&second);
+	QVERIFY(pipeline.interceptors().isEmpty());
+}
+
+void tst_QDiscordRequestPipeline::testCoalescing()
+{
+	QDiscordRequestPipeline pipeline;
+	QDiscordRequest request = QDiscordRequest::get(QUrl("http://127.0.0.1:1/"));
+	int failures = 0;
+	std::function<void(QNetworkReply::NetworkError)> failed =
+			[&](QNetworkReply::NetworkError){
+		failures++;
+	};
+	pipeline.send<QDiscordResponse>(request, nullptr, failed);
+	pipeline.send<QDiscordResponse>(request, nullptr, failed);
+	QCOMPARE(pipeline.coalescedRequests(), quint64(1));
+	QCOMPARE(pipeline.rateLimiter()->queued(), 0);
+	QTRY_COMPARE(failures, 2);
+
+	//Requests with different headers are sent separately.
+	QDiscordRequest other = request;
+	other.setRawHeader("X-Test", "1");
+	pipeline.send<QDiscordResponse>(request, nullptr, failed);
+	pipeline.send<QDiscordResponse>(other, nullptr, failed);
+	QCOMPARE(pipeline.coalescedRequests(), quint64(1));
+	QTRY_COMPARE(failures, 4);
+}
+
+void tst_QDiscordRequestPipeline::testFuture()
+{
+	QDiscordRequestPipeline pipeline;
+	QDiscordRequest request = QDiscordRequest::post(QUrl("http://127.0.0.1:1/"),
+													QJsonObject());
+	QDiscordFuture<QJsonObject> failed = pipeline.send<QJsonObject>(request);
+	QDiscordFuture<QJsonObject> canceled = pipeline.send<QJsonObject>(request);
+	//Only one request is in flight until the route's limits are known.
+	QCOMPARE(pipeline.rateLimiter()->queued(), 1);
+	canceled.cancel();
+	QTRY_VERIFY(failed.isFinished());
+	QCOMPARE(failed.error(), QNetworkReply::ConnectionRefusedError);
+	QVERIFY(canceled.isCanceled());
+	QCOMPARE(pipeline.rateLimiter()->queued(), 0);
+}
+
+void tst_QDiscordRequestPipeline::testUpload()
+{
+	QDiscordMockServer server;
+	QVERIFY(server.listen());
+	QDiscordRequestPipeline pipeline;
+	pipeline.setAuthorization("Bot token");
+
+	QDiscordUpload upload;
+	QJsonObject message;
+	message["content"] = QString("files");
+	upload.setPayload(message);
+	upload.addData("first file", "first.txt");
+	upload.addData("second file", "second.txt");
+	qint64 uploaded = 0;
+	upload.setProgressHandler([&uploaded](qint64 sent, qint64){
+		uploaded = sent;
+	});
+	QDiscordFuture<QJsonObject> sent = pipeline.send<QJsonObject>(
+				QDiscordRequest::post(QUrl(server.base() +
+										   "/api/channels/1/messages"),
+									  upload));
+	QTRY_VERIFY(sent.isFinished());
+	QVERIFY(sent.isSucceeded());
+	QCOMPARE(sent.result()["content"].toString(), QString("files"));
+
+	QVERIFY(server.lastContentType().startsWith("multipart/form-data"));
+	QVERIFY(server.lastContentType().contains("boundary="));
+	const QByteArray& body = server.lastBody();
+	QVERIFY(body.contains("name=\"payload_json\""));
+	QVERIFY(body.contains("name=\"files[0]\"; filename=\"first.txt\""));
+	QVERIFY(body.contains("name=\"files[1]\"; filename=\"second.txt\""));
+	QVERIFY(body.contains("first file"));
+	QVERIFY(body.contains("second file"));
+	QVERIFY(uploaded > 0);
+	QVERIFY(uploaded <= body.size());
+}
+
+QTEST_MAIN(tst_QDiscordRequestPipeline)
+
+#include "tst_qdiscordrequestpipeline.moc"
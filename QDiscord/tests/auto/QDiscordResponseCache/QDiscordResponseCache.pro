@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordresponsecache.cpp
+
+include(../auto.pri)
@@ -0,0 +1,201 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordResponseCache: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordResponseCache();
+private slots:
+	void testLookup();
+	void testRevalidation();
+	void testInvalidate();
+	void testGatewayInvalidation();
+	void testBounds();
+private:
+	QDiscordResponse response(const QByteArray& body,
+							  const QByteArray& etag = QByteArray());
+};
+
+tst_QDiscordResponseCache::tst_QDiscordResponseCache()
+{
+
+}
+
+QDiscordResponse tst_QDiscordResponseCache::response(const QByteArray& body,
+													 const QByteArray& etag)
+{
+	QDiscordResponse response;
+	response.setStatusCode(200);
+	response.setBody(body);
+	if(!etag.isEmpty())
+		response.setRawHeader("ETag", etag);
+	return response;
+}
+
+void tst_QDiscordResponseCache::testLookup()
+{
+	QDiscordResponseCache cache;
+	const QString key = QDiscordUtilities::endPoints.users + "/1";
+	QDiscordResponse found;
+	QVERIFY(!cache.lookup(key, found));
+	QCOMPARE(cache.misses(), quint64(1));
+
+	QDiscordResponse stored = response("{\"id\":\"1\"}");
+	cache.update(key, stored);
+	QCOMPARE(cache.count(), 1);
+	QVERIFY(cache.lookup(key, found));
+	QCOMPARE(found.body(), stored.body());
+	QCOMPARE(cache.hits(), quint64(1));
+
+	//Failed requests drop what was stored.
+	QDiscordResponse failed;
+	failed.setError(QNetworkReply::ContentNotFoundError);
+	failed.setStatusCode(404);
+	cache.update(key, failed);
+	QVERIFY(!cache.lookup(key, found));
+
+	QDiscordResponse noStore = response("{}");
+	noStore.setRawHeader("Cache-Control", "private, no-store");
+	cache.update(key, noStore);
+	QCOMPARE(cache.count(), 0);
+
+	cache.resetStatistics();
+	QCOMPARE(cache.hits(), quint64(0));
+	QCOMPARE(cache.misses(), quint64(0));
+}
+
+void tst_QDiscordResponseCache::testRevalidation()
+{
+	QDiscordResponseCache cache;
+	cache.setTimeToLive(20);
+	const QString key = QDiscordUtilities::endPoints.channels + "/1";
+	QDiscordResponse stored = response("{\"id\":\"1\"}", "\"abc\"");
+	cache.update(key, stored);
+	QDiscordResponse found;
+	QVERIFY(cache.lookup(key, found));
+
+	QTest::qWait(30);
+	QVERIFY(!cache.lookup(key, found));
+	QCOMPARE(cache.etag(key), QByteArray("\"abc\""));
+
+	QDiscordResponse notModified;
+	notModified.setStatusCode(304);
+	cache.update(key, notModified);
+	QCOMPARE(cache.revalidations(), quint64(1));
+	QCOMPARE(notModified.statusCode(), 200);
+	QCOMPARE(notModified.body(), stored.body());
+	QVERIFY(cache.lookup(key, found));
+
+	//Expired responses without an ETag cannot be revalidated.
+	const QString other = QDiscordUtilities::endPoints.channels + "/2";
+	QDiscordResponse plain = response("{}");
+	cache.update(other, plain);
+	QTest::qWait(30);
+	QVERIFY(!cache.lookup(other, found));
+	QVERIFY(cache.etag(other).isEmpty());
+	QCOMPARE(cache.count(), 1);
+
+	//A 304 for an evicted response must not pass as an empty success.
+	cache.clear();
+	QDiscordResponse evicted;
+	evicted.setStatusCode(304);
+	QVERIFY(!cache.update(key, evicted));
+	QVERIFY(!evicted.isSuccess());
+	QCOMPARE(evicted.error(), QNetworkReply::ContentReSendError);
+}
+
+void tst_QDiscordResponseCache::testInvalidate()
+{
+	QDiscordResponseCache cache;
+	const QString channel = QDiscordUtilities::endPoints.channels + "/1";
+	QDiscordResponse stored = response("{}");
+	cache.update(channel, stored);
+	cache.update(channel + "/messages?limit=50", stored);
+	cache.update(channel + "0", stored);
+	cache.update(QDiscordUtilities::endPoints.users + "/1", stored);
+	QCOMPARE(cache.count(), 4);
+
+	cache.invalidate(QUrl(channel));
+	QCOMPARE(cache.count(), 2);
+	QDiscordResponse found;
+	QVERIFY(cache.lookup(channel + "0", found));
+	QVERIFY(!cache.lookup(channel, found));
+
+	//Without descendants, only the URL itself and its queries are removed.
+	cache.update(channel, stored);
+	cache.update(channel + "?with_counts=true", stored);
+	cache.update(channel + "/messages", stored);
+	cache.invalidate(QUrl(channel), false);
+	QVERIFY(!cache.lookup(channel, found));
+	QVERIFY(!cache.lookup(channel + "?with_counts=true", found));
+	QVERIFY(cache.lookup(channel + "/messages", found));
+
+	cache.clear();
+	QCOMPARE(cache.count(), 0);
+}
+
+void tst_QDiscordResponseCache::testGatewayInvalidation()
+{
+	QDiscord discord;
+	QDiscordResponseCache* cache = discord.rest()->pipeline()->responseCache();
+	QDiscordEventBus* events = discord.state()->events();
+	//Invalidation must not keep the state from skipping unobserved events.
+	QVERIFY(!events->hasSubscribers<QDiscordEvent::ChannelUpdate>());
+	QVERIFY(!events->hasSubscribers<QDiscordEvent::GuildUpdate>());
+	QVERIFY(!events->hasSubscribers<QDiscordEvent::GuildMemberUpdate>());
+	QVERIFY(!events->hasSubscribers<QDiscordEvent::GuildMemberRemove>());
+
+	const QString channel = QDiscordUtilities::endPoints.channels + "/1";
+	const QString guild = QDiscordUtilities::endPoints.servers + "/2";
+	const QString user = QDiscordUtilities::endPoints.users + "/3";
+	QDiscordResponse stored = response("{}");
+	cache->update(channel, stored);
+	cache->update(guild, stored);
+	cache->update(guild + "/members/3", stored);
+	cache->update(user, stored);
+	QCOMPARE(cache->count(), 4);
+
+	QDiscordResponse found;
+	emit discord.ws()->channelUpdateReceived(QJsonObject({{"id", "1"}}));
+	QVERIFY(!cache->lookup(channel, found));
+	emit discord.ws()->guildMemberRemoveReceived(QJsonObject({
+		{"guild_id", "2"},
+		{"user", QJsonObject({{"id", "3"}})}
+	}));
+	QVERIFY(!cache->lookup(user, found));
+	QVERIFY(!cache->lookup(guild + "/members/3", found));
+	QVERIFY(cache->lookup(guild, found));
+	emit discord.ws()->guildUpdateReceived(QJsonObject({{"id", "2"}}));
+	QCOMPARE(cache->count(), 0);
+
+	//A new session may have missed any change.
+	cache->update(channel, stored);
+	emit discord.ws()->readyReceived(QJsonObject());
+	QCOMPARE(cache->count(), 0);
+}
+
+void tst_QDiscordResponseCache::testBounds()
+{
+	QDiscordResponseCache cache;
+	cache.setMaxSize(100);
+	QDiscordResponse stored = response(QByteArray(40, 'a'));
+	for(int i = 0; i < 5; i++)
+		cache.update(QString::number(i), stored);
+	QCOMPARE(cache.count(), 2);
+	QDiscordResponse found;
+	QVERIFY(cache.lookup("4", found));
+	QVERIFY(!cache.lookup("0", found));
+
+	QDiscordResponse large = response(QByteArray(200, 'a'));
+	cache.update("large", large);
+	QVERIFY(!cache.lookup("large", found));
+
+	cache.setTimeToLive(0);
+	cache.update("5", stored);
+	QVERIFY(!cache.lookup("5", found));
+}
+
+QTEST_MAIN(tst_QDiscordResponseCache)
+
+#include "tst_qdiscordresponsecache.moc"
@@ -0,0 +1,6 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordrestcomponent.cpp
+
+include(../auto.pri)
+include(../../mock/mock.pri)
@@ -0,0 +1,183 @@
+#include <QtTest>
+#include <QDiscord>
+#include "qdiscordmockserver.hpp"
+
+class tst_QDiscordRestComponent: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordRestComponent();
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void init();
+	void cleanup();
+	void testLogin();
+	void testMessage();
+	void testChannel();
+	void testWriteThenRead();
+	void testHistory();
+	void testUpload();
+	void testRateLimits();
+	void testRetry();
+private:
+	QDiscordMockServer _server;
+	QDiscordRestComponent* _rest;
+};
+
+tst_QDiscordRestComponent::tst_QDiscordRestComponent()
+{
+
+}
+
+void tst_QDiscordRestComponent::initTestCase()
+{
+	QVERIFY(_server.listen());
+	QDiscordUtilities::setEndPointBase(_server.base());
+}
+
+void tst_QDiscordRestComponent::cleanupTestCase()
+{
+	QDiscordUtilities::setEndPointBase("https://discordapp.com");
+}
+
+void tst_QDiscordRestComponent::init()
+{
+	_server.setRateLimit(0, 0);
+	_rest = new QDiscordRestComponent();
+	QSignalSpy spy(_rest, &QDiscordRestComponent::tokenVerified);
+	_rest->login("token");
+	QVERIFY(spy.wait());
+}
+
+void tst_QDiscordRestComponent::cleanup()
+{
+	delete _rest;
+}
+
+void tst_QDiscordRestComponent::testLogin()
+{
+	QDiscordRestComponent rest;
+	QSignalSpy spy(&rest, &QDiscordRestComponent::tokenVerified);
+	rest.login("other");
+	QVERIFY(spy.wait());
+	QCOMPARE(spy[0][0].toString(), QString("Bot other"));
+}
+
+void tst_QDiscordRestComponent::testMessage()
+{
+	QDiscordFuture<QDiscordMessage> message =
+			_rest->sendMessageFuture("Hello", "10");
+	QTRY_VERIFY(message.isFinished());
+	QVERIFY(message.isSucceeded());
+	QCOMPARE(message.result().content(), QString("Hello"));
+	QCOMPARE(message.result().channelId(), QString("10"));
+
+	QDiscordFuture<QString> deleted =
+			_rest->deleteMessageFuture(message.result().id(), "10");
+	QTRY_VERIFY(deleted.isFinished());
+	QCOMPARE(deleted.result(), message.result().id());
+}
+
+void tst_QDiscordRestComponent::testChannel()
+{
+	QDiscordFuture<QDiscordChannel> renamed =
+			_rest->setChannelNameFuture("renamed", "20");
+	QDiscordFuture<QDiscordUser> user = _rest->getUserFuture("7");
+	QDiscordFuture<QDiscordGuild> guild = _rest->getGuildFuture("5");
+	QTRY_VERIFY(renamed.isFinished() && user.isFinished() &&
+				guild.isFinished());
+	QCOMPARE(renamed.result().name(), QString("renamed"));
+	QCOMPARE(user.result().username(), QString("User 7"));
+	QCOMPARE(guild.result().name(), QString("Guild 5"));
+
+	QDiscordFuture<QDiscordChannel> missing = _rest->getChannelFuture("");
+	QTRY_VERIFY(missing.isFinished());
+	QCOMPARE(missing.error(), QNetworkReply::ContentNotFoundError);
+}
+
+void tst_QDiscordRestComponent::testWriteThenRead()
+{
+	QDiscordFuture<QDiscordChannel> before = _rest->getChannelFuture("70");
+	QTRY_VERIFY(before.isFinished());
+	QCOMPARE(before.result().name(), QString("channel-70"));
+
+	QDiscordFuture<QDiscordChannel> renamed =
+			_rest->setChannelNameFuture("renamed", "70");
+	QTRY_VERIFY(renamed.isFinished());
+	QVERIFY(renamed.isSucceeded());
+
+	//The cached channel was dropped by the write, so this reaches the server.
+	const int requests = _server.requests();
+	QDiscordFuture<QDiscordChannel> after = _rest->getChannelFuture("70");
+	QTRY_VERIFY(after.isFinished());
+	QCOMPARE(after.result().name(), QString("renamed"));
+	QCOMPARE(_server.requests(), requests + 1);
+}
+
+void tst_QDiscordRestComponent::testHistory()
+{
+	_server.setMessagesPerChannel(150);
+	QDiscordMessageHistory history(_rest, "50");
+	int read = 0;
+	while(!history.atEnd())
+	{
+		QDiscordFuture<QDiscordMessageHistory::Page> page = history.next();
+		QTRY_VERIFY(page.isFinished());
+		QVERIFY(page.isSucceeded());
+		read += page.result().length();
+	}
+	QCOMPARE(read, 150);
+	_server.setMessagesPerChannel(250);
+}
+
+void tst_QDiscordRestComponent::testUpload()
+{
+	QDiscordUpload upload;
+	upload.addData("attached data", "data.txt");
+	QVector<qint64> progress;
+	upload.setProgressHandler([&progress](qint64 sent, qint64){
+		progress.append(sent);
+	});
+	QDiscordFuture<QDiscordMessage> message =
+			_rest->sendMessageFuture("With a file", "40", upload);
+	QTRY_VERIFY(message.isFinished());
+	QVERIFY(message.isSucceeded());
+	QCOMPARE(message.result().content(), QString("With a file"));
+	QVERIFY(_server.lastBody().contains("attached data"));
+	QVERIFY(_server.lastBody().contains("filename=\"data.txt\""));
+	QVERIFY(!progress.isEmpty());
+}
+
+void tst_QDiscordRestComponent::testRateLimits()
+{
+	_server.setRateLimit(2, 100);
+	QSignalSpy spy(_rest, &QDiscordRestComponent::rateLimited);
+	QList<QDiscordFuture<QDiscordMessage>> messages;
+	for(int i = 0; i < 6; i++)
+		messages.append(_rest->sendMessageFuture("Limited", "30"));
+	//Requests beyond the limit wait for the bucket instead of failing.
+	for(const QDiscordFuture<QDiscordMessage>& message : messages)
+	{
+		QTRY_VERIFY(message.isFinished());
+		QVERIFY(message.isSucceeded());
+	}
+	QCOMPARE(spy.count(), _server.rateLimited());
+}
+
+void tst_QDiscordRestComponent::testRetry()
+{
+	QSignalSpy spy(_rest, &QDiscordRestComponent::rateLimited);
+	_server.rejectNext(1, 50);
+	QDiscordFuture<QDiscordMessage> message =
+			_rest->sendMessageFuture("Retried", "60");
+	QTRY_VERIFY(message.isFinished());
+	QVERIFY(message.isSucceeded());
+	QCOMPARE(spy.count(), 1);
+	QCOMPARE(spy[0][2].toLongLong(), Q_INT64_C(50));
+	QCOMPARE(spy[0][3].toBool(), false);
+}
+
+QTEST_MAIN(tst_QDiscordRestComponent)
+
+#include "tst_qdiscordrestcomponent.moc"
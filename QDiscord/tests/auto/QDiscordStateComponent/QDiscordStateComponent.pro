@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordstatecomponent.cpp
+
+include(../auto.pri)
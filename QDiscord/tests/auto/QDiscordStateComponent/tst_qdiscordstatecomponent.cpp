@@ -0,0 +1,283 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordStateComponent: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordStateComponent();
+private slots:
+	void testStaleModeDisabled();
+	void testReconcile();
+	void testReconcileRemoved();
+	void testGuildCreateNotStale();
+	void testStaleTimeout();
+private:
+	QJsonObject guild(const QString& name, const QStringList& channels,
+					  const QStringList& members);
+	QJsonObject ready(const QJsonArray& guilds);
+};
+
+tst_QDiscordStateComponent::tst_QDiscordStateComponent()
+{
+
+}
+
+QJsonObject tst_QDiscordStateComponent::guild(const QString& name,
+											  const QStringList& channels,
+											  const QStringList& members)
+{
+	//Channels and members are given as "id:name" pairs.
+	QJsonArray channelArray;
+	for(const QString& item : channels)
+	{
+		channelArray.append(QJsonObject({
+											{"id", item.section(':', 0, 0)},
+											{"name", item.section(':', 1)},
+											{"type", 0}
+										}));
+	}
+	QJsonArray memberArray;
+	for(const QString& item : members)
+	{
+		memberArray.append(QJsonObject({
+										   {"user", QJsonObject({
+												{"id", item.section(':', 0, 0)},
+												{"username", "user"}
+											})},
+										   {"nick", item.section(':', 1)}
+									   }));
+	}
+	return QJsonObject({
+						   {"id", "1"},
+						   {"name", name},
+						   {"member_count", members.size()},
+						   {"channels", channelArray},
+						   {"members", memberArray}
+					   });
+}
+
+QJsonObject tst_QDiscordStateComponent::ready(const QJsonArray& guilds)
+{
+	return QJsonObject({
+						   {"user", QJsonObject({
+								{"id", "100"},
+								{"username", "self"}
+							})},
+						   {"guilds", guilds},
+						   {"private_channels", QJsonArray()}
+					   });
+}
+
+void tst_QDiscordStateComponent::testStaleModeDisabled()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	QVERIFY(!state->staleModeEnabled());
+	emit discord.ws()->readyReceived(ready(QJsonArray()));
+	emit discord.ws()->guildCreateReceived(guild("guild", {"10:a"}, {"2:"}));
+	QVERIFY(state->guild("1"));
+
+	emit discord.ws()->disconnected("", 1000);
+	QVERIFY(!state->isStale());
+	QVERIFY(!state->guild("1"));
+	QVERIFY(!state->self());
+}
+
+void tst_QDiscordStateComponent::testReconcile()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	QDiscordEventBus* events = state->events();
+	state->setStaleModeEnabled(true);
+	emit discord.ws()->readyReceived(ready(QJsonArray()));
+	emit discord.ws()->guildCreateReceived(
+				guild("guild", {"10:a", "11:b", "12:c"}, {"2:x", "3:y", "4:z"}));
+	QSharedPointer<QDiscordGuild> stored = state->guild("1");
+	QSharedPointer<QDiscordChannel> unchangedChannel = stored->channel("10");
+	QSharedPointer<QDiscordChannel> changedChannel = stored->channel("11");
+	QSharedPointer<QDiscordMember> unchangedMember = stored->member("2");
+	QSharedPointer<QDiscordMember> changedMember = stored->member("3");
+
+	QList<bool> stale;
+	connect(state, &QDiscordStateComponent::staleChanged,
+			this, [&stale](bool value){stale.append(value);});
+	emit discord.ws()->disconnected("", 1000);
+	QVERIFY(state->isStale());
+	QCOMPARE(stale, QList<bool>({true}));
+	QCOMPARE(state->guild("1"), stored);
+
+	QStringList created, updated, deleted;
+	QList<QSharedPointer<QDiscordGuild>> announced;
+	events->on<QDiscordEvent::GuildCreate>(
+				[&](const QDiscordEvent::GuildCreate& event){
+		announced.append(event.guild);
+	});
+	events->on<QDiscordEvent::GuildAvailable>(
+				[&](const QDiscordEvent::GuildAvailable& event){
+		announced.append(event.guild);
+	});
+	events->on<QDiscordEvent::GuildUpdate>(
+				[&](const QDiscordEvent::GuildUpdate& event){
+		updated.append("guild:" + event.guild->id());
+	});
+	events->on<QDiscordEvent::ChannelCreate>(
+				[&](const QDiscordEvent::ChannelCreate& event){
+		created.append("channel:" + event.channel->id());
+	});
+	events->on<QDiscordEvent::ChannelUpdate>(
+				[&](const QDiscordEvent::ChannelUpdate& event){
+		updated.append("channel:" + event.channel->id());
+	});
+	events->on<QDiscordEvent::ChannelDelete>(
+				[&](const QDiscordEvent::ChannelDelete& event){
+		deleted.append("channel:" + event.channel.id());
+	});
+	events->on<QDiscordEvent::GuildMemberAdd>(
+				[&](const QDiscordEvent::GuildMemberAdd& event){
+		created.append("member:" + event.member->user()->id());
+	});
+	events->on<QDiscordEvent::GuildMemberUpdate>(
+				[&](const QDiscordEvent::GuildMemberUpdate& event){
+		updated.append("member:" + event.member->user()->id());
+	});
+	events->on<QDiscordEvent::GuildMemberRemove>(
+				[&](const QDiscordEvent::GuildMemberRemove& event){
+		deleted.append("member:" + event.member.user()->id());
+	});
+
+	//The guild stays until it becomes available again.
+	emit discord.ws()->readyReceived(ready(QJsonArray({
+		QJsonObject({{"id", "1"}, {"unavailable", true}})
+	})));
+	QVERIFY(state->isStale());
+	QCOMPARE(state->guild("1"), stored);
+	QVERIFY(announced.isEmpty());
+
+	emit discord.ws()->guildCreateReceived(
+				guild("renamed", {"10:a", "11:changed", "13:d"},
+					  {"2:x", "3:changed", "5:w"}));
+	QVERIFY(!state->isStale());
+	QCOMPARE(stale, QList<bool>({true, false}));
+
+	//Unchanged and changed objects keep their identity.
+	QCOMPARE(state->guild("1"), stored);
+	QCOMPARE(stored->name(), QString("renamed"));
+	QCOMPARE(stored->channel("10"), unchangedChannel);
+	QCOMPARE(stored->channel("11"), changedChannel);
+	QCOMPARE(changedChannel->name(), QString("changed"));
+	QCOMPARE(stored->member("2"), unchangedMember);
+	QCOMPARE(stored->member("3"), changedMember);
+	QCOMPARE(changedMember->nickname(), QString("changed"));
+	QVERIFY(!stored->channel("12"));
+	QVERIFY(stored->channel("13"));
+	QVERIFY(!stored->member("4"));
+	QVERIFY(stored->member("5"));
+
+	//Only the differences are reported.
+	created.sort();
+	updated.sort();
+	deleted.sort();
+	QCOMPARE(created, QStringList({"channel:13", "member:5"}));
+	QCOMPARE(updated, QStringList({"channel:11", "guild:1", "member:3"}));
+	QCOMPARE(deleted, QStringList({"channel:12", "member:4"}));
+	QCOMPARE(announced, QList<QSharedPointer<QDiscordGuild>>({stored, stored}));
+}
+
+void tst_QDiscordStateComponent::testReconcileRemoved()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	state->setStaleModeEnabled(true);
+	emit discord.ws()->readyReceived(ready(QJsonArray()));
+	emit discord.ws()->guildCreateReceived(guild("guild", {"10:a"}, {}));
+	emit discord.ws()->disconnected("", 1000);
+	QVERIFY(state->isStale());
+
+	//A guild missing from READY was left while disconnected.
+	QStringList deleted;
+	state->events()->on<QDiscordEvent::GuildDelete>(
+				[&](const QDiscordEvent::GuildDelete& event){
+		deleted.append(event.guild.id());
+	});
+	emit discord.ws()->readyReceived(ready(QJsonArray()));
+	QCOMPARE(deleted, QStringList({"1"}));
+	QVERIFY(!state->guild("1"));
+	QVERIFY(!state->isStale());
+}
+
+void tst_QDiscordStateComponent::testGuildCreateNotStale()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	state->setStaleModeEnabled(true);
+	emit discord.ws()->readyReceived(ready(QJsonArray()));
+	emit discord.ws()->guildCreateReceived(guild("guild", {"10:a"}, {}));
+	QSharedPointer<QDiscordGuild> stored = state->guild("1");
+
+	//Without a disconnect, GUILD_CREATE replaces the stored guild.
+	int updates = 0;
+	QList<QSharedPointer<QDiscordGuild>> announced;
+	state->events()->on<QDiscordEvent::GuildUpdate>(
+				[&](const QDiscordEvent::GuildUpdate&){
+		updates++;
+	});
+	state->events()->on<QDiscordEvent::GuildCreate>(
+				[&](const QDiscordEvent::GuildCreate& event){
+		announced.append(event.guild);
+	});
+	emit discord.ws()->guildCreateReceived(guild("renamed", {"10:a"}, {}));
+	QSharedPointer<QDiscordGuild> replaced = state->guild("1");
+	QVERIFY(replaced != stored);
+	QCOMPARE(replaced->name(), QString("renamed"));
+	QCOMPARE(stored->name(), QString("guild"));
+	QCOMPARE(updates, 0);
+	QCOMPARE(announced, QList<QSharedPointer<QDiscordGuild>>({replaced}));
+}
+
+void tst_QDiscordStateComponent::testStaleTimeout()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	state->setStaleModeEnabled(true);
+	state->setStaleTimeout(50);
+	emit discord.ws()->readyReceived(ready(QJsonArray()));
+	emit discord.ws()->guildCreateReceived(guild("guild", {"10:a"}, {"2:x"}));
+	QSharedPointer<QDiscordGuild> stored = state->guild("1");
+	QSharedPointer<QDiscordChannel> channel = stored->channel("10");
+	emit discord.ws()->disconnected("", 1000);
+
+	//A guild which stays unavailable does not keep the state stale forever.
+	QSignalSpy spy(state, &QDiscordStateComponent::staleChanged);
+	emit discord.ws()->readyReceived(ready(QJsonArray({
+		QJsonObject({{"id", "1"}, {"unavailable", true}})
+	})));
+	QVERIFY(state->isStale());
+	QVERIFY(!stored->unavailable());
+	QVERIFY(spy.wait(1000));
+	QCOMPARE(spy.count(), 1);
+	QCOMPARE(spy.first().first().toBool(), false);
+	QVERIFY(!state->isStale());
+	QCOMPARE(state->guild("1"), stored);
+	QVERIFY(stored->unavailable());
+	QCOMPARE(stored->channel("10"), channel);
+
+	//It is reconciled once it becomes available.
+	QList<QSharedPointer<QDiscordGuild>> available;
+	state->events()->on<QDiscordEvent::GuildAvailable>(
+				[&](const QDiscordEvent::GuildAvailable& event){
+		available.append(event.guild);
+	});
+	emit discord.ws()->guildCreateReceived(guild("guild", {"10:b"}, {"2:x"}));
+	QCOMPARE(state->guild("1"), stored);
+	QVERIFY(!stored->unavailable());
+	QCOMPARE(stored->channel("10"), channel);
+	QCOMPARE(channel->name(), QString("b"));
+	QCOMPARE(available, QList<QSharedPointer<QDiscordGuild>>({stored}));
+	QVERIFY(!state->isStale());
+	QCOMPARE(spy.count(), 1);
+}
+
+QTEST_MAIN(tst_QDiscordStateComponent)
+
+#include "tst_qdiscordstatecomponent.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordstatesnapshot.cpp
+
+include(../auto.pri)
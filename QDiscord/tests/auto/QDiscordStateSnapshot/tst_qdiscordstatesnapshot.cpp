@@ -0,0 +1,230 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordStateSnapshot: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordStateSnapshot();
+private slots:
+	void testRoundTrip();
+	void testRawGuild();
+	void testTruncated();
+	void testCorrupt();
+	void testVersionMismatch();
+	void testOverwriteMapped();
+private:
+	QJsonObject guild(const QString& id, const QString& channelId);
+	bool write(const QString& fileName);
+	bool patch(const QString& fileName, qint64 position, const QByteArray& data);
+	QTemporaryDir _directory;
+};
+
+tst_QDiscordStateSnapshot::tst_QDiscordStateSnapshot()
+{
+
+}
+
+QJsonObject tst_QDiscordStateSnapshot::guild(const QString& id,
+											 const QString& channelId)
+{
+	return QJsonObject({
+						   {"id", id},
+						   {"name", "guild-" + id},
+						   {"member_count", 2},
+						   {"channels", QJsonArray({
+								QJsonObject({
+									{"id", channelId},
+									{"name", "general"},
+									{"type", 0}
+								})
+							})}
+					   });
+}
+
+bool tst_QDiscordStateSnapshot::write(const QString& fileName)
+{
+	QDiscordStateSnapshotWriter writer(fileName);
+	if(!writer.open())
+		return false;
+	writer.writeSelf(QJsonObject({{"id", "100"}, {"username", "self"}}));
+	writer.writePrivateChannels(QJsonArray({
+											   QJsonObject({
+												   {"id", "200"},
+												   {"type", 1}
+											   })
+										   }));
+	writer.writeGuild("1", guild("1", "10"));
+	writer.writeGuild("2", guild("2", "20"));
+	return writer.commit();
+}
+
+bool tst_QDiscordStateSnapshot::patch(const QString& fileName,
+									  qint64 position,
+									  const QByteArray& data)
+{
+	QFile file(fileName);
+	if(!file.open(QFile::ReadWrite) || !file.seek(position))
+		return false;
+	return file.write(data) == data.size();
+}
+
+void tst_QDiscordStateSnapshot::testRoundTrip()
+{
+	QString fileName = _directory.filePath("roundtrip.snapshot");
+	qint64 before = QDateTime::currentMSecsSinceEpoch();
+	QVERIFY(write(fileName));
+
+	QDiscordStateSnapshot snapshot;
+	QVERIFY(snapshot.open(fileName));
+	QVERIFY(snapshot.isOpen());
+	QVERIFY(snapshot.createdAt() >= before);
+	QCOMPARE(snapshot.self()["username"].toString(), QString("self"));
+	QCOMPARE(snapshot.privateChannels().size(), 1);
+	QCOMPARE(snapshot.privateChannels()[0].toObject()["id"].toString(),
+			 QString("200"));
+	QStringList ids = snapshot.guildIds();
+	std::sort(ids.begin(), ids.end());
+	QCOMPARE(ids, QStringList({"1", "2"}));
+	QVERIFY(!snapshot.containsGuild("3"));
+	QCOMPARE(snapshot.channelGuild("20"), QString("2"));
+	QVERIFY(snapshot.channelGuild("30").isEmpty());
+	QCOMPARE(snapshot.guildChannelIds("1"), QStringList({"10"}));
+	QCOMPARE(snapshot.guild("1"), guild("1", "10"));
+	QCOMPARE(snapshot.guild("2"), guild("2", "20"));
+	QVERIFY(snapshot.guild("3").isEmpty());
+
+	snapshot.close();
+	QVERIFY(!snapshot.isOpen());
+	QVERIFY(snapshot.guildIds().isEmpty());
+	QVERIFY(snapshot.guild("1").isEmpty());
+}
+
+void tst_QDiscordStateSnapshot::testRawGuild()
+{
+	QString source = _directory.filePath("source.snapshot");
+	QString target = _directory.filePath("target.snapshot");
+	QVERIFY(write(source));
+	QDiscordStateSnapshot snapshot;
+	QVERIFY(snapshot.open(source));
+
+	//Guilds are copied between snapshots without being decoded.
+	QDiscordStateSnapshotWriter writer(target);
+	QVERIFY(writer.open());
+	writer.writeRawGuild("2", snapshot.rawGuild("2"),
+						 snapshot.guildChannelIds("2"));
+	QVERIFY(writer.commit());
+
+	QDiscordStateSnapshot copy;
+	QVERIFY(copy.open(target));
+	QCOMPARE(copy.guildIds(), QStringList({"2"}));
+	QCOMPARE(copy.channelGuild("20"), QString("2"));
+	QCOMPARE(copy.guild("2"), guild("2", "20"));
+	QVERIFY(copy.self().isEmpty());
+	QVERIFY(copy.privateChannels().isEmpty());
+}
+
+void tst_QDiscordStateSnapshot::testTruncated()
+{
+	QString fileName = _directory.filePath("truncated.snapshot");
+	QVERIFY(write(fileName));
+	QFile file(fileName);
+	qint64 size = file.size();
+
+	//The index is at the end of the file.
+	QVERIFY(file.resize(size - 4));
+	QDiscordStateSnapshot snapshot;
+	QVERIFY(!snapshot.open(fileName));
+	QVERIFY(!snapshot.isOpen());
+
+	//The index offset points past the end of the file.
+	QVERIFY(file.resize(30));
+	QVERIFY(!snapshot.open(fileName));
+
+	//Not even the header is complete.
+	QVERIFY(file.resize(10));
+	QVERIFY(!snapshot.open(fileName));
+	QVERIFY(file.resize(0));
+	QVERIFY(!snapshot.open(fileName));
+	QVERIFY(!snapshot.open(_directory.filePath("missing.snapshot")));
+}
+
+void tst_QDiscordStateSnapshot::testCorrupt()
+{
+	QString fileName = _directory.filePath("corrupt.snapshot");
+	QDiscordStateSnapshot snapshot;
+
+	QVERIFY(write(fileName));
+	QVERIFY(patch(fileName, 0, "XXXX"));
+	QVERIFY(!snapshot.open(fileName));
+
+	//An index offset inside the header.
+	QVERIFY(write(fileName));
+	QVERIFY(patch(fileName, 16, QByteArray(8, '\0')));
+	QVERIFY(!snapshot.open(fileName));
+
+	//A blob which is not valid CBOR only fails to decode on its own.
+	QVERIFY(write(fileName));
+	QVERIFY(snapshot.open(fileName));
+	QByteArray garbage(snapshot.rawGuild("1").size(), '\xff');
+	snapshot.close();
+	QVERIFY(write(fileName));
+	QByteArray contents;
+	{
+		QFile file(fileName);
+		QVERIFY(file.open(QFile::ReadOnly));
+		contents = file.readAll();
+	}
+	QDiscordStateSnapshot reader;
+	QVERIFY(reader.open(fileName));
+	qint64 offset = contents.indexOf(reader.rawGuild("1"));
+	reader.close();
+	QVERIFY(offset > 0);
+	QVERIFY(patch(fileName, offset, garbage));
+	QVERIFY(snapshot.open(fileName));
+	QVERIFY(snapshot.guild("1").isEmpty());
+	QCOMPARE(snapshot.guild("2"), guild("2", "20"));
+}
+
+void tst_QDiscordStateSnapshot::testVersionMismatch()
+{
+	QString fileName = _directory.filePath("version.snapshot");
+	QVERIFY(write(fileName));
+	QByteArray version;
+	QDataStream stream(&version, QIODevice::WriteOnly);
+	stream<<quint32(QDiscordStateSnapshot::version + 1);
+	QVERIFY(patch(fileName, 4, version));
+
+	QDiscordStateSnapshot snapshot;
+	QVERIFY(!snapshot.open(fileName));
+	QVERIFY(!snapshot.isOpen());
+	QVERIFY(snapshot.guildIds().isEmpty());
+}
+
+void tst_QDiscordStateSnapshot::testOverwriteMapped()
+{
+	QString fileName = _directory.filePath("state.snapshot");
+	QVERIFY(write(fileName));
+
+	//The loaded snapshot stays mapped until its guilds are requested.
+	QDiscordStateComponent state;
+	QVERIFY(state.loadSnapshot(fileName));
+	QCOMPARE(state.self()->username(), QString("self"));
+	QVERIFY(state.saveSnapshot(fileName));
+	QVERIFY(state.saveSnapshot(fileName));
+
+	QSharedPointer<QDiscordGuild> first = state.guild("1");
+	QVERIFY(first);
+	QCOMPARE(first->name(), QString("guild-1"));
+	QVERIFY(state.guild("2"));
+	QVERIFY(state.channel("20"));
+
+	QDiscordStateSnapshot snapshot;
+	QVERIFY(snapshot.open(fileName));
+	QCOMPARE(snapshot.guildIds().size(), 2);
+	QCOMPARE(snapshot.guild("1")["name"].toString(), QString("guild-1"));
+}
+
+QTEST_MAIN(tst_QDiscordStateSnapshot)
+
+#include "tst_qdiscordstatesnapshot.moc"
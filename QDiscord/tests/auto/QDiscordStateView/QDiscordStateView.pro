@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordstateview.cpp
+
+include(../auto.pri)
@@ -0,0 +1,245 @@
+#include <QtTest>
+#include <QDiscord>
+
+class ViewReaderThread: public QThread
+{
+public:
+	ViewReaderThread(QDiscordStateComponent* state): _state(state)
+	{
+		_stop = false;
+		_reads = 0;
+		_errors = 0;
+	}
+	void stop() {_stop = true;}
+	int reads() const {return _reads;}
+	int errors() const {return _errors;}
+protected:
+	void run() override
+	{
+		quint64 version = 0;
+		while(!_stop)
+		{
+			std::shared_ptr<const QDiscordStateView> view = _state->view();
+			if(!view)
+				continue;
+			if(view->version() < version)
+				_errors++;
+			version = view->version();
+			QSharedPointer<const QDiscordGuildView> guild = view->guild("1");
+			if(guild)
+			{
+				QSharedPointer<const QDiscordMemberView> member =
+						guild->member("2");
+				if(!member || !member->nickname().startsWith("nick-") ||
+						guild->members().size() != 100)
+				{
+					_errors++;
+				}
+			}
+			_reads++;
+		}
+	}
+private:
+	QDiscordStateComponent* _state;
+	QAtomicInt _stop;
+	QAtomicInt _reads;
+	QAtomicInt _errors;
+};
+
+class tst_QDiscordStateView: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordStateView();
+private slots:
+	void testSharedMembers();
+	void testRemovedGuild();
+	void testCopiedMembers();
+	void testConcurrentReader();
+private:
+	QJsonObject guild(const QString& id, int members);
+	QJsonObject member(const QString& guildId, const QString& userId,
+					   const QString& nickname);
+	std::shared_ptr<const QDiscordStateView> publish(QDiscordStateComponent* state);
+};
+
+tst_QDiscordStateView::tst_QDiscordStateView()
+{
+
+}
+
+QJsonObject tst_QDiscordStateView::guild(const QString& id, int members)
+{
+	QJsonArray memberArray;
+	for(int i = 0; i < members; i++)
+		memberArray.append(member(id, QString::number(i + 2), "nick-0"));
+	return QJsonObject({
+						   {"id", id},
+						   {"name", "guild-" + id},
+						   {"member_count", members},
+						   {"channels", QJsonArray({
+								QJsonObject({
+									{"id", id + "0"},
+									{"name", "general"},
+									{"type", 0}
+								})
+							})},
+						   {"members", memberArray}
+					   });
+}
+
+QJsonObject tst_QDiscordStateView::member(const QString& guildId,
+										  const QString& userId,
+										  const QString& nickname)
+{
+	return QJsonObject({
+						   {"guild_id", guildId},
+						   {"user", QJsonObject({
+								{"id", userId},
+								{"username", "user-" + userId}
+							})},
+						   {"nick", nickname}
+					   });
+}
+
+std::shared_ptr<const QDiscordStateView>
+tst_QDiscordStateView::publish(QDiscordStateComponent* state)
+{
+	//Views are published once per event loop iteration.
+	QSignalSpy spy(state, &QDiscordStateComponent::viewPublished);
+	if(!spy.wait(1000))
+		return std::shared_ptr<const QDiscordStateView>();
+	return state->view();
+}
+
+void tst_QDiscordStateView::testSharedMembers()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	state->setViewEnabled(true);
+	emit discord.ws()->guildCreateReceived(guild("1", 100));
+	emit discord.ws()->guildCreateReceived(guild("2", 10));
+	std::shared_ptr<const QDiscordStateView> first = publish(state);
+	QVERIFY(first);
+	QSharedPointer<const QDiscordGuildView> firstGuild = first->guild("1");
+	QVERIFY(firstGuild);
+	QCOMPARE(firstGuild->members().size(), 100);
+
+	emit discord.ws()->guildMemberUpdateReceived(member("1", "2", "nick-1"));
+	std::shared_ptr<const QDiscordStateView> second = publish(state);
+	QVERIFY(second);
+	QVERIFY(second->version() > first->version());
+	QSharedPointer<const QDiscordGuildView> secondGuild = second->guild("1");
+	QVERIFY(secondGuild != firstGuild);
+
+	//The changed member is replaced, the previous view keeps the old copy.
+	QVERIFY(secondGuild->member("2") != firstGuild->member("2"));
+	QCOMPARE(secondGuild->member("2")->nickname(), QString("nick-1"));
+	QCOMPARE(firstGuild->member("2")->nickname(), QString("nick-0"));
+
+	//All other members are shared with the previous view.
+	for(int i = 3; i < 102; i++)
+	{
+		QString id = QString::number(i);
+		QVERIFY(secondGuild->member(id));
+		QCOMPARE(secondGuild->member(id), firstGuild->member(id));
+	}
+	QCOMPARE(secondGuild->channel("10"), firstGuild->channel("10"));
+
+	//Guilds without changes are shared entirely.
+	QCOMPARE(second->guild("2"), first->guild("2"));
+}
+
+void tst_QDiscordStateView::testRemovedGuild()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	state->setViewEnabled(true);
+	emit discord.ws()->guildCreateReceived(guild("1", 5));
+	emit discord.ws()->guildCreateReceived(guild("2", 5));
+	std::shared_ptr<const QDiscordStateView> first = publish(state);
+	QVERIFY(first);
+	QCOMPARE(first->guilds().size(), 2);
+
+	emit discord.ws()->guildDeleteReceived(QJsonObject({{"id", "1"}}));
+	std::shared_ptr<const QDiscordStateView> second = publish(state);
+	QVERIFY(second);
+	QVERIFY(!second->guild("1"));
+	QCOMPARE(second->guilds().keys(), QStringList({"2"}));
+	QCOMPARE(second->guild("2"), first->guild("2"));
+	QVERIFY(first->guild("1"));
+}
+
+void tst_QDiscordStateView::testCopiedMembers()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	state->setViewEnabled(true);
+	emit discord.ws()->guildCreateReceived(guild("1", 20000));
+	std::shared_ptr<const QDiscordStateView> first = publish(state);
+	QVERIFY(first);
+	QCOMPARE(first->guild("1")->members().size(), 20000);
+	QCOMPARE(first->guild("1")->copiedMemberSlots(), 0);
+
+	//Only the nodes on the path to a changed member are copied, each of which
+	//has at most 32 slots. 20000 members fit in far less than five levels.
+	emit discord.ws()->guildMemberUpdateReceived(member("1", "500", "nick-1"));
+	std::shared_ptr<const QDiscordStateView> updated = publish(state);
+	QVERIFY(updated);
+	QSharedPointer<const QDiscordGuildView> updatedGuild = updated->guild("1");
+	QVERIFY(updatedGuild->copiedMemberSlots() > 0);
+	QVERIFY(updatedGuild->copiedMemberSlots() <= 32 * 5);
+	QCOMPARE(updatedGuild->member("500")->nickname(), QString("nick-1"));
+	QCOMPARE(first->guild("1")->member("500")->nickname(), QString("nick-0"));
+
+	emit discord.ws()->guildMemberAddReceived(member("1", "30000", "nick-2"));
+	emit discord.ws()->guildMemberRemoveReceived(member("1", "600", ""));
+	std::shared_ptr<const QDiscordStateView> changed = publish(state);
+	QVERIFY(changed);
+	QSharedPointer<const QDiscordGuildView> changedGuild = changed->guild("1");
+	QVERIFY(changedGuild->copiedMemberSlots() <= 2 * 32 * 5);
+	QCOMPARE(changedGuild->members().size(), 20000);
+	QCOMPARE(changedGuild->member("30000")->nickname(), QString("nick-2"));
+	QVERIFY(!changedGuild->member("600"));
+	QVERIFY(updatedGuild->member("600"));
+	QVERIFY(!updatedGuild->member("30000"));
+	for(int i = 2; i < 20002; i += 997)
+	{
+		QString id = QString::number(i);
+		if(id != "500" && id != "600")
+			QCOMPARE(changedGuild->member(id), first->guild("1")->member(id));
+	}
+}
+
+void tst_QDiscordStateView::testConcurrentReader()
+{
+	QDiscord discord;
+	QDiscordStateComponent* state = discord.state();
+	state->setViewEnabled(true);
+	emit discord.ws()->guildCreateReceived(guild("1", 100));
+	QVERIFY(publish(state));
+
+	ViewReaderThread reader(state);
+	reader.start();
+	for(int i = 1; i <= 200; i++)
+	{
+		QString nickname = "nick-" + QString::number(i);
+		emit discord.ws()->guildMemberUpdateReceived(
+					member("1", QString::number(2 + i % 100), nickname));
+		emit discord.ws()->guildUpdateReceived(
+					QJsonObject({{"id", "1"}, {"name", nickname}}));
+		QVERIFY(publish(state));
+	}
+	reader.stop();
+	QVERIFY(reader.wait(5000));
+	QVERIFY(reader.reads() > 0);
+	QCOMPARE(reader.errors(), 0);
+
+	std::shared_ptr<const QDiscordStateView> view = state->view();
+	QCOMPARE(view->guild("1")->name(), QString("nick-200"));
+	QCOMPARE(view->guild("1")->member("2")->nickname(), QString("nick-200"));
+}
+
+QTEST_MAIN(tst_QDiscordStateView)
+
+#include "tst_qdiscordstateview.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordstringpool.cpp
+
+include(../auto.pri)
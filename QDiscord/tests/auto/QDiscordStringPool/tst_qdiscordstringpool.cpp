@@ -0,0 +1,61 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordStringPool: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordStringPool();
+private slots:
+	void testIntern();
+	void testPurge();
+	void testModels();
+};
+
+tst_QDiscordStringPool::tst_QDiscordStringPool()
+{
+
+}
+
+void tst_QDiscordStringPool::testIntern()
+{
+	QDiscordStringPool::resetStatistics();
+	QString first = QDiscordStringPool::intern(QString("general"));
+	QString second = QDiscordStringPool::intern(QString("gen") + "eral");
+
+	QCOMPARE(first, QString("general"));
+	QVERIFY(first.isSharedWith(second));
+	QVERIFY(QDiscordStringPool::intern("").isEmpty());
+
+	QDiscordStringPool::Statistics statistics =
+			QDiscordStringPool::statistics();
+	QCOMPARE(statistics.lookups, quint64(2));
+	QCOMPARE(statistics.hits, quint64(1));
+	QVERIFY(statistics.bytesSaved > 0);
+	QCOMPARE(statistics.hitRate(), 0.5);
+}
+
+void tst_QDiscordStringPool::testPurge()
+{
+	QDiscordStringPool::purge();
+	int before = QDiscordStringPool::statistics().strings;
+	{
+		QString pooled = QDiscordStringPool::intern(QString("temporary"));
+		QCOMPARE(QDiscordStringPool::statistics().strings, before + 1);
+		QCOMPARE(QDiscordStringPool::purge(), 0);
+	}
+	QCOMPARE(QDiscordStringPool::purge(), 1);
+	QCOMPARE(QDiscordStringPool::statistics().strings, before);
+}
+
+void tst_QDiscordStringPool::testModels()
+{
+	QDiscordChannel first(QJsonObject({{"id", "1"}, {"name", "off-topic"}}));
+	QDiscordChannel second(QJsonObject({{"id", "2"}, {"name", "off-topic"}}));
+
+	QVERIFY(first.name().isSharedWith(second.name()));
+}
+
+QTEST_MAIN(tst_QDiscordStringPool)
+
+#include "tst_qdiscordstringpool.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordtimestamp.cpp
+
+include(../auto.pri)
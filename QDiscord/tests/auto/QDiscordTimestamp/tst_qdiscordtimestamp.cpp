@@ -0,0 +1,137 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordTimestamp: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordTimestamp();
+private slots:
+	void testParse_data();
+	void testParse();
+	void testMatchesQDateTime_data();
+	void testMatchesQDateTime();
+	void testSnowflake_data();
+	void testSnowflake();
+	void testModels();
+};
+
+tst_QDiscordTimestamp::tst_QDiscordTimestamp()
+{
+
+}
+
+void tst_QDiscordTimestamp::testParse_data()
+{
+	QTest::addColumn<QString>("input_timestamp");
+	QTest::addColumn<qint64>("output_msecs");
+
+	const qint64 invalid = QDiscordUtilities::invalidTimestamp;
+
+	QTest::newRow("microseconds") << "2016-07-22T18:15:12.448000+00:00" <<
+									 Q_INT64_C(1469211312448);
+	QTest::newRow("noFraction") << "2016-07-22T18:15:12+00:00" <<
+								   Q_INT64_C(1469211312000);
+	QTest::newRow("zulu") << "2016-07-22T18:15:12.448Z" <<
+							 Q_INT64_C(1469211312448);
+	QTest::newRow("noOffset") << "2016-07-22T18:15:12.4" <<
+								 Q_INT64_C(1469211312400);
+	QTest::newRow("positiveOffset") << "2016-07-22T20:45:12.448+02:30" <<
+									   Q_INT64_C(1469211312448);
+	QTest::newRow("negativeOffset") << "2016-07-22T13:15:12.448-0500" <<
+									   Q_INT64_C(1469211312448);
+	QTest::newRow("epoch") << "1970-01-01T00:00:00+00:00" << Q_INT64_C(0);
+	QTest::newRow("beforeEpoch") << "1969-12-31T23:59:59.999+00:00" <<
+									Q_INT64_C(-1);
+	QTest::newRow("leapDay") << "2016-02-29T00:00:00+00:00" <<
+								Q_INT64_C(1456704000000);
+	QTest::newRow("empty") << "" << invalid;
+	QTest::newRow("dateOnly") << "2016-07-22" << invalid;
+	QTest::newRow("badMonth") << "2016-13-22T18:15:12+00:00" << invalid;
+	QTest::newRow("badDay") << "2015-02-29T18:15:12+00:00" << invalid;
+	QTest::newRow("badHour") << "2016-07-22T24:15:12+00:00" << invalid;
+	QTest::newRow("emptyFraction") << "2016-07-22T18:15:12.+00:00" << invalid;
+	QTest::newRow("trailing") << "2016-07-22T18:15:12+00:00x" << invalid;
+	QTest::newRow("letters") << "2016-0a-22T18:15:12+00:00" << invalid;
+}
+
+void tst_QDiscordTimestamp::testParse()
+{
+	QFETCH(QString, input_timestamp);
+	QFETCH(qint64, output_msecs);
+
+	QCOMPARE(QDiscordUtilities::parseTimestamp(input_timestamp), output_msecs);
+}
+
+void tst_QDiscordTimestamp::testMatchesQDateTime_data()
+{
+	QTest::addColumn<QString>("input_timestamp");
+
+	QTest::newRow("microseconds") << "2017-03-05T09:08:07.654321+00:00";
+	QTest::newRow("milliseconds") << "2020-12-31T23:59:59.999+00:00";
+	QTest::newRow("offset") << "2018-06-15T01:02:03.004+05:00";
+	QTest::newRow("zulu") << "2000-02-29T12:00:00Z";
+}
+
+void tst_QDiscordTimestamp::testMatchesQDateTime()
+{
+	QFETCH(QString, input_timestamp);
+
+	QDateTime expected = QDateTime::fromString(input_timestamp, Qt::ISODateWithMs);
+	QVERIFY(expected.isValid());
+	qint64 msecs = QDiscordUtilities::parseTimestamp(input_timestamp);
+	QCOMPARE(msecs, expected.toMSecsSinceEpoch());
+	QCOMPARE(QDiscordUtilities::timestampToDateTime(msecs), expected);
+}
+
+void tst_QDiscordTimestamp::testSnowflake_data()
+{
+	QTest::addColumn<QString>("input_id");
+	QTest::addColumn<qint64>("output_msecs");
+
+	QTest::newRow("documented") << "175928847299117063" <<
+								   Q_INT64_C(1462015105796);
+	QTest::newRow("epoch") << "4194304" <<
+							  QDiscordUtilities::discordEpoch + 1;
+	QTest::newRow("empty") << "" << QDiscordUtilities::invalidTimestamp;
+	QTest::newRow("zero") << "0" << QDiscordUtilities::invalidTimestamp;
+	QTest::newRow("notANumber") << "abc" << QDiscordUtilities::invalidTimestamp;
+}
+
+void tst_QDiscordTimestamp::testSnowflake()
+{
+	QFETCH(QString, input_id);
+	QFETCH(qint64, output_msecs);
+
+	QCOMPARE(QDiscordUtilities::snowflakeTimestamp(input_id), output_msecs);
+}
+
+void tst_QDiscordTimestamp::testModels()
+{
+	QDiscordMessage message(QJsonObject({
+											{"id", "175928847299117063"},
+											{"timestamp", "2016-04-30T11:18:25.796000+00:00"}
+										}), QSharedPointer<QDiscordChannel>());
+	QCOMPARE(message.timestampMSecs(), Q_INT64_C(1462015105796));
+	QCOMPARE(message.timestamp(), message.createdAt());
+	QCOMPARE(message.timestamp().timeSpec(), Qt::UTC);
+
+	QDiscordMessage empty;
+	QCOMPARE(empty.timestampMSecs(), QDiscordUtilities::invalidTimestamp);
+	QVERIFY(!empty.timestamp().isValid());
+	QVERIFY(!empty.createdAt().isValid());
+
+	QDiscordMember member(QJsonObject({
+										  {"joined_at", "2016-07-22T18:15:12.448000+00:00"}
+									  }), QSharedPointer<QDiscordGuild>());
+	QCOMPARE(member.joinedAtMSecs(), Q_INT64_C(1469211312448));
+	QCOMPARE(member.toJson()["joined_at"].toString(),
+			 QString("2016-07-22T18:15:12.448Z"));
+
+	QDiscordUser user(QJsonObject({{"id", "175928847299117063"}}));
+	QCOMPARE(user.createdAt().toMSecsSinceEpoch(), Q_INT64_C(1462015105796));
+}
+
+QTEST_MAIN(tst_QDiscordTimestamp)
+
+#include "tst_qdiscordtimestamp.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordtrace.cpp
+
+include(../auto.pri)
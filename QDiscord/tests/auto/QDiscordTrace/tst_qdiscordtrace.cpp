@@ -0,0 +1,180 @@
+#include <QtTest>
+#include <QDiscord>
+
+class UserThread: public QThread
+{
+protected:
+	void run() override
+	{
+		for(int i = 0; i < 100; i++)
+			QDiscordUser user;
+	}
+};
+
+class ScopeThread: public QThread
+{
+protected:
+	void run() override
+	{
+		for(int i = 0; i < 200; i++)
+		{
+			QDISCORD_TRACE_SCOPE(State, Debug, "outer");
+			for(int j = 0; j < 100; j++)
+			{
+				QDISCORD_TRACE_SCOPE(State, Debug, "inner");
+				QDISCORD_TRACE(State, Debug, "instant", j);
+			}
+		}
+	}
+};
+
+class tst_QDiscordTrace: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordTrace();
+private slots:
+	void testLevels();
+	void testCapture();
+	void testThreads();
+	void testOverflow();
+private:
+	QJsonArray capture(const std::function<void()>& function);
+};
+
+tst_QDiscordTrace::tst_QDiscordTrace()
+{
+
+}
+
+QJsonArray tst_QDiscordTrace::capture(const std::function<void()>& function)
+{
+	QTemporaryDir directory;
+	QString fileName = directory.filePath("trace.json");
+	if(!QDiscordTrace::startCapture(fileName))
+		return QJsonArray();
+	function();
+	QDiscordTrace::stopCapture();
+	QFile file(fileName);
+	file.open(QFile::ReadOnly);
+	QJsonParseError error;
+	QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+	if(error.error != QJsonParseError::NoError)
+		return QJsonArray();
+	return document.object()["traceEvents"].toArray();
+}
+
+void tst_QDiscordTrace::testLevels()
+{
+	QDiscordTrace::setLevel(QDiscordTrace::Level::Off);
+	QVERIFY(!QDiscordTrace::enabled(QDiscordTrace::Category::Gateway,
+									QDiscordTrace::Level::Error));
+
+	QDiscordTrace::setLevel(QDiscordTrace::Category::Gateway,
+							QDiscordTrace::Level::Info);
+	QCOMPARE(QDiscordTrace::level(QDiscordTrace::Category::Gateway),
+			 QDiscordTrace::Level::Info);
+	QVERIFY(QDiscordTrace::enabled(QDiscordTrace::Category::Gateway,
+								   QDiscordTrace::Level::Error));
+	QVERIFY(QDiscordTrace::enabled(QDiscordTrace::Category::Gateway,
+								   QDiscordTrace::Level::Info));
+	QVERIFY(!QDiscordTrace::enabled(QDiscordTrace::Category::Gateway,
+									QDiscordTrace::Level::Debug));
+	QVERIFY(!QDiscordTrace::enabled(QDiscordTrace::Category::State,
+									QDiscordTrace::Level::Error));
+	QDiscordTrace::setLevel(QDiscordTrace::Level::Off);
+}
+
+void tst_QDiscordTrace::testCapture()
+{
+	QDiscordTrace::setLevel(QDiscordTrace::Level::Off);
+	QDiscordTrace::setLevel(QDiscordTrace::Category::State,
+							QDiscordTrace::Level::Debug);
+	QJsonArray events = capture([](){
+		QDISCORD_TRACE(State, Info, "instant", 42);
+		QDISCORD_TRACE(State, Verbose, "filtered", 0);
+		QDISCORD_TRACE(Gateway, Error, "disabled", 0);
+		QDISCORD_TRACE_SCOPE(State, Debug, QDiscordTrace::intern("scope"));
+	});
+	QDiscordTrace::setLevel(QDiscordTrace::Level::Off);
+
+	QCOMPARE(events.size(), 3);
+	QJsonObject instant = events[0].toObject();
+	QCOMPARE(instant["name"].toString(), QString("instant"));
+	QCOMPARE(instant["cat"].toString(), QString("state"));
+	QCOMPARE(instant["ph"].toString(), QString("i"));
+	QCOMPARE(instant["args"].toObject()["value"].toInt(), 42);
+	QCOMPARE(events[1].toObject()["ph"].toString(), QString("B"));
+	QCOMPARE(events[2].toObject()["ph"].toString(), QString("E"));
+	QCOMPARE(events[2].toObject()["name"].toString(), QString("scope"));
+	QVERIFY(events[1].toObject()["ts"].toDouble() <=
+			events[2].toObject()["ts"].toDouble());
+}
+
+void tst_QDiscordTrace::testThreads()
+{
+	QDiscordTrace::setLevel(QDiscordTrace::Category::Model,
+							QDiscordTrace::Level::Verbose);
+	quint64 dropped = QDiscordTrace::droppedRecords();
+	QJsonArray events = capture([](){
+		UserThread threads[4];
+		for(UserThread& thread : threads)
+			thread.start();
+		for(UserThread& thread : threads)
+			thread.wait();
+	});
+	QDiscordTrace::setLevel(QDiscordTrace::Level::Off);
+
+	QSet<int> threadIds;
+	int constructed = 0;
+	for(const QJsonValue& item : events)
+	{
+		QJsonObject event = item.toObject();
+		if(event["name"].toString() != "QDiscordUser constructed")
+			continue;
+		constructed++;
+		threadIds.insert(event["tid"].toInt());
+	}
+	QCOMPARE(QDiscordTrace::droppedRecords(), dropped);
+	QCOMPARE(constructed, 400);
+	QCOMPARE(threadIds.size(), 4);
+}
+
+void tst_QDiscordTrace::testOverflow()
+{
+	QDiscordTrace::setLevel(QDiscordTrace::Category::State,
+							QDiscordTrace::Level::Debug);
+	quint64 dropped = QDiscordTrace::droppedRecords();
+	QJsonArray events = capture([](){
+		ScopeThread thread;
+		thread.start();
+		thread.wait();
+	});
+	QDiscordTrace::setLevel(QDiscordTrace::Level::Off);
+
+	//The thread writes far more records than its buffer holds, but every
+	//written scope is still closed by an end of the same name.
+	QVERIFY(QDiscordTrace::droppedRecords() > dropped);
+	QStringList scopes;
+	int written = 0;
+	for(const QJsonValue& item : events)
+	{
+		QJsonObject event = item.toObject();
+		if(event["ph"].toString() == "B")
+		{
+			scopes.append(event["name"].toString());
+			written++;
+		}
+		else if(event["ph"].toString() == "E")
+		{
+			QVERIFY(!scopes.isEmpty());
+			QCOMPARE(event["name"].toString(), scopes.takeLast());
+		}
+	}
+	QVERIFY(scopes.isEmpty());
+	QVERIFY(written > 0);
+}
+
+QTEST_MAIN(tst_QDiscordTrace)
+
+#include "tst_qdiscordtrace.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordtypingtracker.cpp
+
+include(../auto.pri)
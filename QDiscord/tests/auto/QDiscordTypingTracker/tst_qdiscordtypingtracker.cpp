@@ -0,0 +1,86 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordTypingTracker: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordTypingTracker();
+private slots:
+	void testStartStop();
+	void testExpiry();
+	void testRefresh();
+	void testManyTypers();
+};
+
+tst_QDiscordTypingTracker::tst_QDiscordTypingTracker()
+{
+
+}
+
+void tst_QDiscordTypingTracker::testStartStop()
+{
+	QDiscordTypingTracker tracker;
+	QSignalSpy started(&tracker, &QDiscordTypingTracker::typingStarted);
+	QSignalSpy stopped(&tracker, &QDiscordTypingTracker::typingStopped);
+
+	QVERIFY(tracker.start("100", "1"));
+	QVERIFY(!tracker.start("100", "1"));
+	QVERIFY(tracker.isTyping("100", "1"));
+	QVERIFY(!tracker.isTyping("100", "2"));
+	QCOMPARE(started.count(), 1);
+
+	QVERIFY(tracker.stop("100", "1"));
+	QVERIFY(!tracker.stop("100", "1"));
+	QVERIFY(!tracker.isTyping("100", "1"));
+	QCOMPARE(stopped.count(), 1);
+	QCOMPARE(stopped.first().at(0).toString(), QString("100"));
+	QCOMPARE(stopped.first().at(1).toString(), QString("1"));
+}
+
+void tst_QDiscordTypingTracker::testExpiry()
+{
+	QDiscordTypingTracker tracker;
+	tracker.setTimeout(300);
+	QSignalSpy stopped(&tracker, &QDiscordTypingTracker::typingStopped);
+
+	tracker.start("100", "1");
+	QTRY_COMPARE_WITH_TIMEOUT(stopped.count(), 1, 2000);
+	QVERIFY(!tracker.isTyping("100", "1"));
+	QCOMPARE(tracker.count(), 0);
+}
+
+void tst_QDiscordTypingTracker::testRefresh()
+{
+	QDiscordTypingTracker tracker;
+	tracker.setTimeout(500);
+	QSignalSpy stopped(&tracker, &QDiscordTypingTracker::typingStopped);
+
+	tracker.start("100", "1");
+	QTest::qWait(300);
+	tracker.start("100", "1");
+	QTest::qWait(300);
+	QCOMPARE(stopped.count(), 0);
+	QVERIFY(tracker.isTyping("100", "1"));
+	QTRY_COMPARE_WITH_TIMEOUT(stopped.count(), 1, 2000);
+}
+
+void tst_QDiscordTypingTracker::testManyTypers()
+{
+	QDiscordTypingTracker tracker;
+	tracker.setTimeout(8000);
+	QSignalSpy stopped(&tracker, &QDiscordTypingTracker::typingStopped);
+
+	for(int i = 1; i <= 50000; i++)
+		tracker.start(QString::number(i % 100 + 1), QString::number(i));
+	QCOMPARE(tracker.count(), 50000);
+	QVERIFY(tracker.isTyping("2", "1"));
+
+	tracker.clear();
+	QCOMPARE(tracker.count(), 0);
+	QCOMPARE(stopped.count(), 0);
+}
+
+QTEST_MAIN(tst_QDiscordTypingTracker)
+
+#include "tst_qdiscordtypingtracker.moc"
@@ -0,0 +1,105 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordUpload: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordUpload();
+private slots:
+	void testPayload();
+	void testFiles();
+	void testDevice();
+	void testRequest();
+};
+
+tst_QDiscordUpload::tst_QDiscordUpload()
+{
+
+}
+
+void tst_QDiscordUpload::testPayload()
+{
+	QDiscordUpload upload;
+	QJsonObject message;
+	message["content"] = QString("files");
+	upload.setPayload(message);
+	upload.addData("first", "first.txt");
+	upload.addData("second", "second.png");
+	QCOMPARE(upload.count(), 2);
+	QCOMPARE(upload.size(), qint64(11));
+
+	QJsonObject payload = upload.payload();
+	QCOMPARE(payload["content"].toString(), QString("files"));
+	QJsonArray attachments = payload["attachments"].toArray();
+	QCOMPARE(attachments.size(), 2);
+	QCOMPARE(attachments[1].toObject()["id"].toInt(), 1);
+	QCOMPARE(attachments[1].toObject()["filename"].toString(),
+			 QString("second.png"));
+}
+
+void tst_QDiscordUpload::testFiles()
+{
+	QTemporaryFile file;
+	QVERIFY(file.open());
+	file.write(QByteArray(4096, 'a'));
+	file.close();
+
+	QDiscordUpload upload;
+	QVERIFY(!upload.addFile(file.fileName() + ".missing"));
+	QCOMPARE(upload.count(), 0);
+	QVERIFY(upload.addFile(file.fileName(), "read.bin"));
+	QVERIFY(upload.addFile(file.fileName(), "mapped.bin", true));
+	QCOMPARE(upload.count(), 2);
+	QCOMPARE(upload.size(), qint64(8192));
+
+	QHttpMultiPart* multiPart = upload.multiPart();
+	QVERIFY(!multiPart->boundary().isEmpty());
+	delete multiPart;
+}
+
+void tst_QDiscordUpload::testDevice()
+{
+	QBuffer buffer;
+	buffer.setData("skippeddata");
+	QVERIFY(buffer.open(QIODevice::ReadOnly));
+	buffer.seek(7);
+
+	QDiscordUpload upload;
+	upload.addDevice(&buffer, "data.txt");
+	QCOMPARE(upload.size(), qint64(4));
+
+	//Every multipart starts reading where the device was when it was added.
+	buffer.readAll();
+	QHttpMultiPart* multiPart = upload.multiPart();
+	QCOMPARE(buffer.pos(), qint64(7));
+	delete multiPart;
+}
+
+void tst_QDiscordUpload::testRequest()
+{
+	QDiscordUpload upload;
+	upload.addData("data", "data.txt");
+	QDiscordRequest request =
+			QDiscordRequest::post(QUrl("http://127.0.0.1:1/"), upload);
+	QVERIFY(request.hasUpload());
+	QVERIFY(request.body().isEmpty());
+	QVERIFY(request.contentType().isEmpty());
+	QCOMPARE(request.upload().count(), 1);
+
+	request.setBody("{}");
+	QVERIFY(!request.hasUpload());
+
+	request.setUpload(upload);
+	QDiscordRequestPipeline pipeline;
+	bool finished = false;
+	pipeline.send(request, [&finished](const QDiscordResponse& response){
+		finished = true;
+		QCOMPARE(response.error(), QNetworkReply::ConnectionRefusedError);
+	});
+	QTRY_VERIFY(finished);
+}
+
+QTEST_MAIN(tst_QDiscordUpload)
+
+#include "tst_qdiscordupload.moc"
@@ -13,6 +13,8 @@ private slots:
 	void testUpdate();
 	void testOperatorEquals_data();
 	void testOperatorEquals();
+	void testAvatar_data();
+	void testAvatar();
 private:
 	QJsonObject _testUser;
 	QJsonObject _nullUser;
@@ -164,6 +166,55 @@ void tst_QDiscordUser::testOperatorEquals()
 	QVERIFY(!(nullUser == testUser));
 }
 
+void tst_QDiscordUser::testAvatar_data()
+{
+	QTest::addColumn<QString>("avatar");
+	QTest::addColumn<QString>("discriminator");
+	QTest::addColumn<QString>("output_discriminator");
+
+	QTest::newRow("hash") << "0123456789abcdef0123456789abcdef" <<
+							 "0042" << "0042";
+	QTest::newRow("animated") << "a_fedcba9876543210fedcba9876543210" <<
+								 "9999" << "9999";
+	QTest::newRow("uppercase") << "0123456789ABCDEF0123456789ABCDEF" <<
+								  "0000" << "0000";
+	QTest::newRow("short") << "577444852b" << "12" << "12";
+	QTest::newRow("invalid") << "not a hash" << "+123" << "+123";
+	QTest::newRow("migrated") << "" << "0" << "0";
+	QTest::newRow("empty") << "" << "" << "";
+}
+
+void tst_QDiscordUser::testAvatar()
+{
+	QFETCH(QString, avatar);
+	QFETCH(QString, discriminator);
+	QFETCH(QString, output_discriminator);
+
+	QDiscordUser user(QJsonObject({
+									  {"avatar", avatar},
+									  {"discriminator", discriminator}
+								  }));
+
+	QCOMPARE(user.avatar(), avatar);
+	QCOMPARE(user.discriminator(), output_discriminator);
+	QCOMPARE(user.toJson()["avatar"].toString(), avatar);
+
+	//The stored string is returned, equal avatars share it.
+	QDiscordUser other(QJsonObject({{"avatar", avatar}}));
+	if(!avatar.isEmpty())
+	{
+		QCOMPARE(user.avatar().constData(), user.avatar().constData());
+		QCOMPARE(other.avatar().constData(), user.avatar().constData());
+	}
+	QCOMPARE(user.toJson()["discriminator"].toString(), output_discriminator);
+
+	//Updates replace the kept string.
+	user.update(QJsonObject({{"discriminator", "1234"}}));
+	QCOMPARE(user.discriminator(), QString("1234"));
+	user.update(QJsonObject({{"discriminator", discriminator}}));
+	QCOMPARE(user.discriminator(), output_discriminator);
+}
+
 QTEST_MAIN(tst_QDiscordUser)
 
 #include "tst_qdiscorduser.moc"
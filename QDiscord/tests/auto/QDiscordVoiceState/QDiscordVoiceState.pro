@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_qdiscordvoicestate.cpp
+
+include(../auto.pri)
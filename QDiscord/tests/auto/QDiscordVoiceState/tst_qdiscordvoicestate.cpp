@@ -0,0 +1,92 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_QDiscordVoiceState: public QObject
+{
+	Q_OBJECT
+public:
+	tst_QDiscordVoiceState();
+private slots:
+	void testConstructor();
+	void testGuildCreate();
+	void testOccupancy();
+private:
+	QJsonObject voiceState(const QString& userId, const QJsonValue& channelId);
+};
+
+tst_QDiscordVoiceState::tst_QDiscordVoiceState()
+{
+
+}
+
+QJsonObject tst_QDiscordVoiceState::voiceState(const QString& userId,
+											   const QJsonValue& channelId)
+{
+	return QJsonObject({
+						   {"guild_id", "10"},
+						   {"channel_id", channelId},
+						   {"user_id", userId},
+						   {"session_id", "session" + userId},
+						   {"self_mute", true}
+					   });
+}
+
+void tst_QDiscordVoiceState::testConstructor()
+{
+	QDiscordVoiceState state(voiceState("1", "100"));
+
+	QCOMPARE(state.guildId(), QString("10"));
+	QCOMPARE(state.channelId(), QString("100"));
+	QCOMPARE(state.userId(), QString("1"));
+	QCOMPARE(state.sessionId(), QString("session1"));
+	QVERIFY(state.selfMute());
+	QVERIFY(!state.deaf());
+
+	QDiscordVoiceState disconnected(voiceState("1", QJsonValue::Null));
+	QCOMPARE(disconnected.channelId(), QString(""));
+}
+
+void tst_QDiscordVoiceState::testGuildCreate()
+{
+	QJsonObject first = voiceState("1", "100");
+	first.remove("guild_id");
+	QDiscordGuild guild(QJsonObject({
+										{"id", "10"},
+										{"voice_states", QJsonArray({first})}
+									}));
+
+	QVERIFY(guild.voiceState("1"));
+	QCOMPARE(guild.voiceState("1")->guildId(), QString("10"));
+	QCOMPARE(guild.voiceChannelOccupants("100").size(), 1);
+}
+
+void tst_QDiscordVoiceState::testOccupancy()
+{
+	QDiscordGuild guild(QJsonObject({{"id", "10"}}));
+	for(const QString& userId : {"1", "2", "3"})
+	{
+		guild.updateVoiceState(QSharedPointer<QDiscordVoiceState>(
+								   new QDiscordVoiceState(voiceState(userId, "100"))
+								   ));
+	}
+	QCOMPARE(guild.voiceChannelUserIds("100").size(), 3);
+
+	QSharedPointer<QDiscordVoiceState> previous =
+			guild.updateVoiceState(QSharedPointer<QDiscordVoiceState>(
+									   new QDiscordVoiceState(voiceState("2", "200"))
+									   ));
+	QCOMPARE(previous->channelId(), QString("100"));
+	QCOMPARE(guild.voiceChannelUserIds("100"), QSet<QString>({"1", "3"}));
+	QCOMPARE(guild.voiceChannelOccupants("200").first()->userId(), QString("2"));
+
+	guild.updateVoiceState(QSharedPointer<QDiscordVoiceState>(
+							   new QDiscordVoiceState(voiceState("2", QJsonValue::Null))
+							   ));
+	QVERIFY(!guild.voiceState("2"));
+	QVERIFY(guild.voiceChannelOccupants("200").isEmpty());
+	QCOMPARE(guild.voiceStates().size(), 2);
+}
+
+QTEST_MAIN(tst_QDiscordVoiceState)
+
+#include "tst_qdiscordvoicestate.moc"
@@ -2,3 +2,27 @@ TEMPLATE = subdirs
 
 SUBDIRS += QDiscordUser
 SUBDIRS += QDiscordMember
+SUBDIRS += QDiscordMessageCache
+SUBDIRS += QDiscordStateSnapshot
+SUBDIRS += QDiscordStateComponent
+SUBDIRS += QDiscordStateView
+SUBDIRS += QDiscordCachePolicy
+SUBDIRS += QDiscordMemoryUsage
+SUBDIRS += QDiscordStringPool
+SUBDIRS += QDiscordVoiceState
+SUBDIRS += QDiscordTypingTracker
+SUBDIRS += QDiscordChannelOrder
+SUBDIRS += QDiscordMemberIndex
+SUBDIRS += QDiscordTrace
+SUBDIRS += QDiscordTimestamp
+SUBDIRS += QDiscordEventBus
+SUBDIRS += QDiscordRateLimiter
+SUBDIRS += QDiscordRequestPipeline
+SUBDIRS += QDiscordResponseCache
+SUBDIRS += QDiscordFuture
+SUBDIRS += QDiscordMessageHistory
+SUBDIRS += QDiscordUpload
+SUBDIRS += QDiscordRestComponent
+CONFIG(qdiscord_coroutines) {
+    SUBDIRS += QDiscordCoroutine
+}
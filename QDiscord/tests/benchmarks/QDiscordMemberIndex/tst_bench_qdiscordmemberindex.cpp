@@ -0,0 +1,159 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_Bench_QDiscordMemberIndex: public QObject
+{
+	Q_OBJECT
+public:
+	tst_Bench_QDiscordMemberIndex();
+private slots:
+	void initTestCase();
+	void prefix_data();
+	void prefix();
+	void substring_data();
+	void substring();
+private:
+	QList<QSharedPointer<QDiscordMember>>
+	scanPrefix(const QString& prefix, int limit);
+	QList<QSharedPointer<QDiscordMember>>
+	scanSubstring(const QString& text, int limit);
+	QSharedPointer<QDiscordGuild> _guild;
+};
+
+tst_Bench_QDiscordMemberIndex::tst_Bench_QDiscordMemberIndex()
+{
+
+}
+
+void tst_Bench_QDiscordMemberIndex::initTestCase()
+{
+	const int memberCount = 200000;
+	static const char* syllables[] = {
+		"ka", "lo", "mi", "ra", "to", "ne", "shi", "vu", "dar", "el", "fin", "go"
+	};
+	const int syllableCount = sizeof(syllables)/sizeof(syllables[0]);
+	QJsonArray members;
+	for(int i = 0; i < memberCount; i++)
+	{
+		QString username;
+		for(int j = 0, k = i; j < 4; j++, k /= syllableCount)
+			username += syllables[(k + j*7) % syllableCount];
+		username += QString::number(i % 1000);
+		members.append(QJsonObject({
+									   {"nick", i % 5 == 0 ?
+										QJsonValue("Nick" + username) :
+										QJsonValue()},
+									   {"user", QJsonObject({
+											{"id", QString::number(100000 + i)},
+											{"username", username}
+										})}
+								   }));
+	}
+	QDiscordCachePolicy policy;
+	policy.setIndexMembers(true);
+	_guild = QSharedPointer<QDiscordGuild>(
+				new QDiscordGuild(QJsonObject({
+												  {"id", "1"},
+												  {"members", members}
+											  }), policy)
+				);
+	QCOMPARE(_guild->members().size(), memberCount);
+}
+
+QList<QSharedPointer<QDiscordMember>>
+tst_Bench_QDiscordMemberIndex::scanPrefix(const QString& prefix, int limit)
+{
+	QList<QSharedPointer<QDiscordMember>> results;
+	for(const QSharedPointer<QDiscordMember>& item : _guild->members())
+	{
+		if(results.size() >= limit)
+			break;
+		if(item->user()->username().startsWith(prefix, Qt::CaseInsensitive) ||
+				item->nickname().startsWith(prefix, Qt::CaseInsensitive))
+		{
+			results.append(item);
+		}
+	}
+	return results;
+}
+
+QList<QSharedPointer<QDiscordMember>>
+tst_Bench_QDiscordMemberIndex::scanSubstring(const QString& text, int limit)
+{
+	QList<QSharedPointer<QDiscordMember>> results;
+	for(const QSharedPointer<QDiscordMember>& item : _guild->members())
+	{
+		if(results.size() >= limit)
+			break;
+		if(item->user()->username().contains(text, Qt::CaseInsensitive) ||
+				item->nickname().contains(text, Qt::CaseInsensitive))
+		{
+			results.append(item);
+		}
+	}
+	return results;
+}
+
+void tst_Bench_QDiscordMemberIndex::prefix_data()
+{
+	QTest::addColumn<bool>("indexed");
+	QTest::addColumn<QString>("query");
+	QTest::newRow("scan-common") << false << "ka";
+	QTest::newRow("index-common") << true << "ka";
+	QTest::newRow("scan-rare") << false << "kalomira9";
+	QTest::newRow("index-rare") << true << "kalomira9";
+}
+
+void tst_Bench_QDiscordMemberIndex::prefix()
+{
+	QFETCH(bool, indexed);
+	QFETCH(QString, query);
+	QSharedPointer<const QDiscordMemberIndex> index = _guild->memberIndex();
+	if(indexed)
+	{
+		QBENCHMARK {
+			index->findByPrefix(query, 25);
+		}
+	}
+	else
+	{
+		QBENCHMARK {
+			scanPrefix(query, 25);
+		}
+	}
+}
+
+void tst_Bench_QDiscordMemberIndex::substring_data()
+{
+	QTest::addColumn<bool>("indexed");
+	QTest::addColumn<QString>("query");
+	QTest::newRow("scan-common") << false << "shi";
+	QTest::newRow("index-common") << true << "shi";
+	QTest::newRow("scan-rare") << false << "ickdar";
+	QTest::newRow("index-rare") << true << "ickdar";
+	QTest::newRow("scan-missing") << false << "xyz";
+	QTest::newRow("index-missing") << true << "xyz";
+}
+
+void tst_Bench_QDiscordMemberIndex::substring()
+{
+	QFETCH(bool, indexed);
+	QFETCH(QString, query);
+	QSharedPointer<const QDiscordMemberIndex> index = _guild->memberIndex();
+	if(indexed)
+	{
+		QBENCHMARK {
+			index->findBySubstring(query, 25);
+		}
+	}
+	else
+	{
+		QBENCHMARK {
+			scanSubstring(query, 25);
+		}
+	}
+}
+
+QTEST_MAIN(tst_Bench_QDiscordMemberIndex)
+
+#include "tst_bench_qdiscordmemberindex.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_bench_qdiscordrequestpipeline.cpp
+
+include(../../auto/auto.pri)
@@ -0,0 +1,99 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_Bench_QDiscordRequestPipeline: public QObject
+{
+	Q_OBJECT
+public:
+	tst_Bench_QDiscordRequestPipeline();
+private slots:
+	void initTestCase();
+	void prepare_data();
+	void prepare();
+private:
+	QList<QUrl> _urls;
+	QJsonObject _object;
+};
+
+tst_Bench_QDiscordRequestPipeline::tst_Bench_QDiscordRequestPipeline()
+{
+
+}
+
+void tst_Bench_QDiscordRequestPipeline::initTestCase()
+{
+	const int count = 1000;
+	for(int i = 0; i < count; i++)
+	{
+		_urls.append(QUrl(QDiscordUtilities::endPoints.channels + "/" +
+						  QString::number(Q_UINT64_C(81384788765712384) + i) +
+						  "/messages"));
+	}
+	_object["content"] = "Hello, world!";
+	_object["tts"] = false;
+}
+
+void tst_Bench_QDiscordRequestPipeline::prepare_data()
+{
+	QTest::addColumn<bool>("pipeline");
+
+	QTest::newRow("per-request headers") << false;
+	QTest::newRow("QDiscordRequestPipeline") << true;
+}
+
+void tst_Bench_QDiscordRequestPipeline::prepare()
+{
+	QFETCH(bool, pipeline);
+
+	//Measures everything done for a request before it reaches the rate
+	//limiter: serializing the body, building the headers and the route.
+	QString authentication = "Bot token";
+	int size = 0;
+	if(pipeline)
+	{
+		QDiscordRequestPipeline requests;
+		requests.setAuthorization(authentication);
+		QBENCHMARK
+		{
+			for(const QUrl& url : _urls)
+			{
+				QDiscordRequest request = QDiscordRequest::post(url, _object);
+				QNetworkRequest networkRequest = requests.networkRequest(request);
+				size += request.body().size() +
+						request.route().majorParameter.size() +
+						networkRequest.rawHeaderList().size();
+			}
+		}
+	}
+	else
+	{
+		QBENCHMARK
+		{
+			//The helpers QDiscordRestComponent used before the pipeline existed.
+			for(const QUrl& url : _urls)
+			{
+				QString userAgent = "DiscordBot (" + QDiscordUtilities::libLink +
+									", v" + QDiscordUtilities::libMajor + ":" +
+									QDiscordUtilities::libMinor + ")" +
+									"; " + QDiscordUtilities::botName;
+				QJsonDocument document;
+				document.setObject(_object);
+				QNetworkRequest networkRequest(url);
+				networkRequest.setRawHeader("Authorization",
+											authentication.toUtf8());
+				networkRequest.setRawHeader("User-Agent", userAgent.toUtf8());
+				networkRequest.setRawHeader("content-type", "application/json");
+				QByteArray body = document.toJson(QJsonDocument::Compact);
+				QDiscordRateLimiter::Route route =
+						QDiscordRateLimiter::Route::fromRequest("POST", url);
+				size += body.size() + route.majorParameter.size() +
+						networkRequest.rawHeaderList().size();
+			}
+		}
+	}
+	QVERIFY(size != 0);
+}
+
+QTEST_MAIN(tst_Bench_QDiscordRequestPipeline)
+
+#include "tst_bench_qdiscordrequestpipeline.moc"
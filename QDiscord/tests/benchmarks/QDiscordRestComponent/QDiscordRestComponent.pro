@@ -0,0 +1,6 @@
+TEMPLATE = app
+
+SOURCES += tst_bench_qdiscordrestcomponent.cpp
+
+include(../../auto/auto.pri)
+include(../../mock/mock.pri)
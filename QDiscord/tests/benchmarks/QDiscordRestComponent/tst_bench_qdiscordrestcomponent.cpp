@@ -0,0 +1,101 @@
+#include <QtTest>
+#include <QDiscord>
+#include <algorithm>
+#include "qdiscordmockserver.hpp"
+
+class tst_Bench_QDiscordRestComponent: public QObject
+{
+	Q_OBJECT
+public:
+	tst_Bench_QDiscordRestComponent();
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void sustained_data();
+	void sustained();
+private:
+	QDiscordMockServer _server;
+};
+
+tst_Bench_QDiscordRestComponent::tst_Bench_QDiscordRestComponent()
+{
+
+}
+
+void tst_Bench_QDiscordRestComponent::initTestCase()
+{
+	QVERIFY(_server.listen());
+	QDiscordUtilities::setEndPointBase(_server.base());
+}
+
+void tst_Bench_QDiscordRestComponent::cleanupTestCase()
+{
+	QDiscordUtilities::setEndPointBase("https://discordapp.com");
+}
+
+void tst_Bench_QDiscordRestComponent::sustained_data()
+{
+	QTest::addColumn<int>("channels");
+	QTest::addColumn<int>("limit");
+	QTest::addColumn<int>("latency");
+
+	QTest::newRow("1 channel") << 1 << 0 << 0;
+	QTest::newRow("16 channels") << 16 << 0 << 0;
+	QTest::newRow("16 channels, rate limit headers") << 16 << 1000 << 0;
+	QTest::newRow("16 channels, 5-10 ms latency") << 16 << 0 << 5;
+}
+
+void tst_Bench_QDiscordRestComponent::sustained()
+{
+	QFETCH(int, channels);
+	QFETCH(int, limit);
+	QFETCH(int, latency);
+
+	//Sends messages through the whole REST stack to the local mock server,
+	//measuring each request from the call to its future finishing.
+	_server.setRateLimit(limit, 60000);
+	_server.setLatency(latency, latency);
+	QDiscordRestComponent rest;
+	QSignalSpy spy(&rest, &QDiscordRestComponent::tokenVerified);
+	rest.login("token");
+	QVERIFY(spy.wait());
+
+	const int count = 400;
+	QVector<qint64> latencies;
+	latencies.reserve(count);
+	int failed = 0;
+	QElapsedTimer clock;
+	qint64 elapsed = 0;
+	QBENCHMARK_ONCE
+	{
+		latencies.clear();
+		failed = 0;
+		clock.start();
+		for(int i = 0; i < count; i++)
+		{
+			const qint64 sentAt = clock.nsecsElapsed();
+			rest.sendMessageFuture("Benchmark",
+								   QString::number(100 + i % channels))
+			.then([&latencies, &clock, sentAt](const QDiscordMessage&){
+				latencies.append(clock.nsecsElapsed() - sentAt);
+			})
+			.fail([&failed](QNetworkReply::NetworkError){
+				failed++;
+			});
+		}
+		QTRY_COMPARE_WITH_TIMEOUT(latencies.length() + failed, count, 60000);
+		elapsed = clock.nsecsElapsed();
+	}
+	QCOMPARE(failed, 0);
+
+	std::sort(latencies.begin(), latencies.end());
+	qDebug().nospace()<<count*1000000000.0/elapsed<<" requests/s, latency p50 "
+					 <<latencies[count/2]/1000000.0<<" ms, p99 "
+					 <<latencies[count*99/100]/1000000.0<<" ms, max "
+					 <<latencies.last()/1000000.0<<" ms";
+	_server.setLatency(0);
+}
+
+QTEST_MAIN(tst_Bench_QDiscordRestComponent)
+
+#include "tst_bench_qdiscordrestcomponent.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+
+SOURCES += tst_bench_qdiscordtimestamp.cpp
+
+include(../../auto/auto.pri)
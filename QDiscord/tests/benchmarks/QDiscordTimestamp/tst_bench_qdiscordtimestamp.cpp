@@ -0,0 +1,108 @@
+#include <QtTest>
+#include <QDiscord>
+
+class tst_Bench_QDiscordTimestamp: public QObject
+{
+	Q_OBJECT
+public:
+	tst_Bench_QDiscordTimestamp();
+private slots:
+	void initTestCase();
+	void parse_data();
+	void parse();
+	void createdAt_data();
+	void createdAt();
+private:
+	QStringList _timestamps;
+	QStringList _ids;
+};
+
+tst_Bench_QDiscordTimestamp::tst_Bench_QDiscordTimestamp()
+{
+
+}
+
+void tst_Bench_QDiscordTimestamp::initTestCase()
+{
+	const int count = 10000;
+	QDateTime start = QDateTime::fromMSecsSinceEpoch(Q_INT64_C(1462015105796),
+													 Qt::UTC);
+	for(int i = 0; i < count; i++)
+	{
+		QDateTime time = start.addMSecs(qint64(i)*7919*1000 + i % 1000);
+		_timestamps.append(time.toString("yyyy-MM-ddTHH:mm:ss.zzz000+00:00"));
+		quint64 id = quint64(time.toMSecsSinceEpoch() -
+							 QDiscordUtilities::discordEpoch) << 22;
+		_ids.append(QString::number(id + quint64(i)));
+	}
+}
+
+void tst_Bench_QDiscordTimestamp::parse_data()
+{
+	QTest::addColumn<bool>("fromString");
+
+	QTest::newRow("QDateTime::fromString") << true;
+	QTest::newRow("QDiscordUtilities::parseTimestamp") << false;
+}
+
+void tst_Bench_QDiscordTimestamp::parse()
+{
+	QFETCH(bool, fromString);
+
+	qint64 sum = 0;
+	if(fromString)
+	{
+		QBENCHMARK
+		{
+			for(const QString& item : _timestamps)
+				sum += QDateTime::fromString(item, Qt::ISODate).toMSecsSinceEpoch();
+		}
+	}
+	else
+	{
+		QBENCHMARK
+		{
+			for(const QString& item : _timestamps)
+				sum += QDiscordUtilities::parseTimestamp(item);
+		}
+	}
+	QVERIFY(sum != 0);
+}
+
+void tst_Bench_QDiscordTimestamp::createdAt_data()
+{
+	QTest::addColumn<bool>("fromString");
+
+	QTest::newRow("QDateTime::fromString") << true;
+	QTest::newRow("QDiscordUtilities::snowflakeTimestamp") << false;
+}
+
+void tst_Bench_QDiscordTimestamp::createdAt()
+{
+	QFETCH(bool, fromString);
+
+	//Compares deriving a message's creation time from its ID with parsing the
+	//timestamp the message was sent with.
+	qint64 sum = 0;
+	if(fromString)
+	{
+		QBENCHMARK
+		{
+			for(const QString& item : _timestamps)
+				sum += QDateTime::fromString(item, Qt::ISODate).toMSecsSinceEpoch();
+		}
+	}
+	else
+	{
+		QBENCHMARK
+		{
+			for(const QString& item : _ids)
+				sum += QDiscordUtilities::snowflakeTimestamp(item);
+		}
+	}
+	QVERIFY(sum != 0);
+}
+
+QTEST_MAIN(tst_Bench_QDiscordTimestamp)
+
+#include "tst_bench_qdiscordtimestamp.moc"
@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+SUBDIRS += QDiscordMemberIndex
+SUBDIRS += QDiscordTimestamp
+SUBDIRS += QDiscordRequestPipeline
+SUBDIRS += QDiscordRestComponent
@@ -0,0 +1,6 @@
+QT += network
+
+INCLUDEPATH += $$PWD
+
+HEADERS += $$PWD/qdiscordmockserver.hpp
+SOURCES += $$PWD/qdiscordmockserver.cpp
@@ -0,0 +1,500 @@
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStringList>
+#include <QTimer>
+#include <QUrlQuery>
+#include <QDiscord>
+#include "qdiscordmockserver.hpp"
+
+QDiscordMockServer::Response::Response()
+{
+	status = 200;
+}
+
+void QDiscordMockServer::Response::setJson(const QJsonObject& object)
+{
+	body = QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+void QDiscordMockServer::Response::setJson(const QJsonArray& array)
+{
+	body = QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+QDiscordMockServer::Bucket::Bucket()
+{
+	remaining = 0;
+	resetAt = 0;
+}
+
+QDiscordMockServer::Connection::Connection()
+{
+	busy = false;
+}
+
+QDiscordMockServer::QDiscordMockServer(QObject* parent) : QObject(parent)
+{
+	_clock.start();
+	_limit = 5;
+	_window = 5000;
+	_latency = 0;
+	_jitter = 0;
+	_seed = 2463534242u;
+	_rejections = 0;
+	_rejectionRetryAfter = 0;
+	_rejectionGlobal = false;
+	_globalResetAt = 0;
+	_messagesPerChannel = 250;
+	_nextId = Q_UINT64_C(1000000);
+	_requests = 0;
+	_rateLimited = 0;
+	connect(&_server, &QTcpServer::newConnection,
+			this, &QDiscordMockServer::incomingConnection);
+}
+
+bool QDiscordMockServer::listen()
+{
+	return _server.listen(QHostAddress::LocalHost);
+}
+
+QString QDiscordMockServer::base() const
+{
+	return "http://127.0.0.1:" + QString::number(_server.serverPort());
+}
+
+void QDiscordMockServer::setRateLimit(int limit, int window)
+{
+	_limit = limit;
+	_window = window;
+	_buckets.clear();
+}
+
+void QDiscordMockServer::setLatency(int latency, int jitter)
+{
+	_latency = latency;
+	_jitter = jitter;
+}
+
+void QDiscordMockServer::rejectNext(int count, int retryAfter, bool global)
+{
+	_rejections = count;
+	_rejectionRetryAfter = retryAfter;
+	_rejectionGlobal = global;
+}
+
+void QDiscordMockServer::incomingConnection()
+{
+	while(_server.hasPendingConnections())
+	{
+		QTcpSocket* socket = _server.nextPendingConnection();
+		_connections.insert(socket, Connection());
+		connect(socket, &QTcpSocket::readyRead, this, [this, socket](){
+			readRequests(socket);
+		});
+		connect(socket, &QTcpSocket::disconnected, this, [this, socket](){
+			_connections.remove(socket);
+			socket->deleteLater();
+		});
+	}
+}
+
+void QDiscordMockServer::readRequests(QTcpSocket* socket)
+{
+	QHash<QTcpSocket*, Connection>::iterator connection =
+			_connections.find(socket);
+	if(connection == _connections.end())
+		return;
+	connection->buffer += socket->readAll();
+	//Requests on a connection are answered in order, one at a time.
+	if(connection->busy)
+		return;
+	Request request;
+	if(!parse(connection->buffer, request))
+		return;
+	connection->busy = true;
+	int delay = _latency;
+	if(_jitter > 0)
+	{
+		_seed ^= _seed << 13;
+		_seed ^= _seed >> 17;
+		_seed ^= _seed << 5;
+		delay += int(_seed % quint32(_jitter + 1));
+	}
+	if(delay <= 0)
+	{
+		respond(socket, request);
+		return;
+	}
+	QTimer::singleShot(delay, socket, [this, socket, request](){
+		respond(socket, request);
+	});
+}
+
+bool QDiscordMockServer::parse(QByteArray& buffer, Request& request)
+{
+	int headerEnd = buffer.indexOf("\r\n\r\n");
+	if(headerEnd < 0)
+		return false;
+	QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+	QList<QByteArray> requestLine = lines.takeFirst().trimmed().split(' ');
+	if(requestLine.length() < 2)
+	{
+		buffer.clear();
+		return false;
+	}
+	request.method = requestLine[0];
+	request.url = QUrl::fromEncoded(requestLine[1]);
+	for(const QByteArray& line : lines)
+	{
+		int colon = line.indexOf(':');
+		if(colon > 0)
+		{
+			request.headers.insert(line.left(colon).trimmed().toLower(),
+								   line.mid(colon + 1).trimmed());
+		}
+	}
+	int length = request.headers.value("content-length").toInt();
+	if(buffer.length() < headerEnd + 4 + length)
+		return false;
+	request.body = buffer.mid(headerEnd + 4, length);
+	buffer.remove(0, headerEnd + 4 + length);
+	return true;
+}
+
+void QDiscordMockServer::respond(QTcpSocket* socket, const Request& request)
+{
+	write(socket, route(request));
+	QHash<QTcpSocket*, Connection>::iterator connection =
+			_connections.find(socket);
+	if(connection == _connections.end())
+		return;
+	connection->busy = false;
+	if(!connection->buffer.isEmpty())
+		readRequests(socket);
+}
+
+QDiscordMockServer::Response
+QDiscordMockServer::route(const Request& request)
+{
+	_requests++;
+	const QString path = request.url.path();
+	emit requestReceived(request.method, path);
+	if(!request.body.isEmpty())
+	{
+		_lastBody = request.body;
+		_lastContentType = request.headers.value("content-type");
+	}
+
+	Response response;
+	if(limit(request, response))
+		return response;
+
+	QStringList segments = path.split('/', Qt::SkipEmptyParts);
+	if(segments.isEmpty() || segments.takeFirst() != "api")
+		segments.clear();
+	const QByteArray& method = request.method;
+	const QString resource = segments.value(0);
+	const int length = segments.length();
+
+	if(resource == "auth" && method == "POST")
+	{
+		if(segments.value(1) == "login")
+		{
+			QJsonObject object;
+			object["token"] = QString("mock-token");
+			response.setJson(object);
+			return response;
+		}
+		if(segments.value(1) == "logout")
+		{
+			response.status = 204;
+			return response;
+		}
+	}
+	if(request.headers.value("authorization").isEmpty())
+	{
+		QJsonObject object;
+		object["message"] = QString("401: Unauthorized");
+		object["code"] = 0;
+		response.status = 401;
+		response.setJson(object);
+		return response;
+	}
+	if(method == "GET" && resource == "gateway" && length == 1)
+	{
+		QJsonObject object;
+		object["url"] = "ws://127.0.0.1:" + QString::number(_server.serverPort());
+		response.setJson(object);
+		return response;
+	}
+	if(method == "GET" && resource == "users" && length == 2)
+	{
+		response.setJson(user(segments[1] == "@me"?"1":segments[1]));
+		return response;
+	}
+	if(method == "GET" && resource == "guilds" && length == 2)
+	{
+		response.setJson(guild(segments[1]));
+		return response;
+	}
+	if(resource == "channels" && length == 2)
+	{
+		if(method == "GET")
+		{
+			response.setJson(channel(segments[1]));
+			return response;
+		}
+		if(method == "PATCH")
+		{
+			QJsonObject object = channel(segments[1]);
+			QJsonObject changes = QJsonDocument::fromJson(request.body).object();
+			for(QJsonObject::const_iterator i = changes.begin();
+				i != changes.end(); ++i)
+				object[i.key()] = i.value();
+			_channels.insert(segments[1], object);
+			response.setJson(object);
+			return response;
+		}
+	}
+	if(resource == "channels" && length >= 3 && segments[2] == "messages")
+	{
+		const QString& channelId = segments[1];
+		if(method == "GET" && length == 3)
+		{
+			//Messages of every channel have the IDs 1 to messagesPerChannel.
+			QUrlQuery query(request.url);
+			int count = 50;
+			if(query.hasQueryItem("limit"))
+				count = qBound(1, query.queryItemValue("limit").toInt(), 100);
+			qint64 newest = _messagesPerChannel;
+			if(query.hasQueryItem("before"))
+				newest = query.queryItemValue("before").toLongLong() - 1;
+			else if(query.hasQueryItem("after"))
+			{
+				newest = qMin<qint64>(query.queryItemValue("after").toLongLong() +
+									  count, _messagesPerChannel);
+			}
+			else if(query.hasQueryItem("around"))
+			{
+				newest = qMin<qint64>(query.queryItemValue("around").toLongLong() +
+									  count/2, _messagesPerChannel);
+			}
+			qint64 oldest = newest - count + 1;
+			if(query.hasQueryItem("after"))
+			{
+				oldest = qMax(oldest,
+							  query.queryItemValue("after").toLongLong() + 1);
+			}
+			QJsonArray array;
+			for(qint64 id = newest; id >= qMax<qint64>(oldest, 1); id--)
+			{
+				array.append(message(QString::number(id), channelId,
+									 "Message " + QString::number(id)));
+			}
+			response.setJson(array);
+			return response;
+		}
+		if(method == "POST" && length == 3)
+		{
+			QJsonObject object = QJsonDocument::fromJson(payload(request))
+					.object();
+			QJsonObject created = message(QString::number(_nextId++),
+										  channelId,
+										  object["content"].toString());
+			created["tts"] = object["tts"].toBool(false);
+			created["attachments"] = object["attachments"].toArray();
+			response.setJson(created);
+			return response;
+		}
+		if((method == "POST" && length == 4 && segments[3] == "bulk-delete") ||
+		   (method == "DELETE" && length == 4))
+		{
+			response.status = 204;
+			return response;
+		}
+	}
+
+	QJsonObject object;
+	object["message"] = QString("404: Not Found");
+	object["code"] = 0;
+	response.status = 404;
+	response.setJson(object);
+	return response;
+}
+
+bool QDiscordMockServer::limit(const Request& request, Response& response)
+{
+	const qint64 now = _clock.elapsed();
+	qint64 retryAfter = 0;
+	bool global = false;
+	if(_rejections > 0)
+	{
+		_rejections--;
+		retryAfter = _rejectionRetryAfter;
+		global = _rejectionGlobal;
+		if(global)
+			_globalResetAt = now + retryAfter;
+	}
+	else if(now < _globalResetAt)
+	{
+		retryAfter = _globalResetAt - now;
+		global = true;
+	}
+	else if(_limit > 0)
+	{
+		QDiscordRateLimiter::Route route =
+				QDiscordRateLimiter::Route::fromRequest(request.method,
+														request.url);
+		Bucket& bucket = _buckets[route.name + '|' + route.majorParameter];
+		if(now >= bucket.resetAt)
+		{
+			bucket.remaining = _limit;
+			bucket.resetAt = now + _window;
+		}
+		const qint64 resetAfter = bucket.resetAt - now;
+		if(bucket.remaining > 0)
+		{
+			bucket.remaining--;
+			response.headers.append(qMakePair(
+				QByteArray("X-RateLimit-Limit"), QByteArray::number(_limit)));
+			response.headers.append(qMakePair(
+				QByteArray("X-RateLimit-Remaining"),
+				QByteArray::number(bucket.remaining)));
+			response.headers.append(qMakePair(
+				QByteArray("X-RateLimit-Reset-After"),
+				QByteArray::number(resetAfter/1000.0, 'f', 3)));
+			response.headers.append(qMakePair(
+				QByteArray("X-RateLimit-Reset"),
+				QByteArray::number((QDateTime::currentMSecsSinceEpoch() +
+									resetAfter)/1000.0, 'f', 3)));
+			response.headers.append(qMakePair(
+				QByteArray("X-RateLimit-Bucket"),
+				QByteArray::number(qHash(route.name), 16)));
+			return false;
+		}
+		retryAfter = resetAfter;
+	}
+	else
+		return false;
+
+	_rateLimited++;
+	const double seconds = retryAfter/1000.0;
+	response.status = 429;
+	response.headers.append(qMakePair(QByteArray("Retry-After"),
+									  QByteArray::number(seconds, 'f', 3)));
+	response.headers.append(qMakePair(QByteArray("X-RateLimit-Scope"),
+									  QByteArray(global?"global":"user")));
+	if(global)
+	{
+		response.headers.append(qMakePair(QByteArray("X-RateLimit-Global"),
+										  QByteArray("true")));
+	}
+	QJsonObject object;
+	object["message"] = QString("You are being rate limited.");
+	object["retry_after"] = seconds;
+	object["global"] = global;
+	response.setJson(object);
+	return true;
+}
+
+void QDiscordMockServer::write(QTcpSocket* socket, const Response& response)
+{
+	QByteArray reason;
+	switch(response.status)
+	{
+	case 200: reason = "OK"; break;
+	case 204: reason = "No Content"; break;
+	case 401: reason = "Unauthorized"; break;
+	case 404: reason = "Not Found"; break;
+	case 429: reason = "Too Many Requests"; break;
+	default: reason = "Unknown"; break;
+	}
+	QByteArray data = "HTTP/1.1 " + QByteArray::number(response.status) + ' ' +
+			reason + "\r\n";
+	for(const QPair<QByteArray, QByteArray>& header : response.headers)
+		data += header.first + ": " + header.second + "\r\n";
+	if(!response.body.isEmpty())
+		data += "Content-Type: application/json\r\n";
+	data += "Content-Length: " + QByteArray::number(response.body.size()) +
+			"\r\nConnection: keep-alive\r\n\r\n" + response.body;
+	socket->write(data);
+}
+
+QJsonObject QDiscordMockServer::user(const QString& id) const
+{
+	QJsonObject object;
+	object["id"] = id;
+	object["username"] = "User " + id;
+	object["discriminator"] = QString("0001");
+	object["avatar"] = QJsonValue();
+	object["bot"] = id == "1";
+	return object;
+}
+
+QJsonObject QDiscordMockServer::channel(const QString& id) const
+{
+	if(_channels.contains(id))
+		return _channels.value(id);
+	QJsonObject object;
+	object["id"] = id;
+	object["guild_id"] = QString("1");
+	object["name"] = "channel-" + id;
+	object["type"] = QString("text");
+	object["position"] = 0;
+	object["topic"] = QString();
+	object["is_private"] = false;
+	object["last_message_id"] = QString::number(_messagesPerChannel);
+	return object;
+}
+
+QJsonObject QDiscordMockServer::guild(const QString& id) const
+{
+	QJsonObject object;
+	object["id"] = id;
+	object["name"] = "Guild " + id;
+	object["owner_id"] = QString("1");
+	object["channels"] = QJsonArray();
+	object["members"] = QJsonArray();
+	object["roles"] = QJsonArray();
+	return object;
+}
+
+QJsonObject QDiscordMockServer::message(const QString& id,
+										const QString& channelId,
+										const QString& content) const
+{
+	QJsonObject object;
+	object["id"] = id;
+	object["channel_id"] = channelId;
+	object["content"] = content;
+	object["author"] = user("1");
+	object["timestamp"] =
+			QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+	object["tts"] = false;
+	object["mention_everyone"] = false;
+	object["mentions"] = QJsonArray();
+	object["attachments"] = QJsonArray();
+	return object;
+}
+
+QByteArray QDiscordMockServer::payload(const Request& request)
+{
+	const QByteArray type = request.headers.value("content-type");
+	if(!type.startsWith("multipart/"))
+		return request.body;
+	//Only the payload_json part matters, the files are skipped.
+	int boundaryAt = type.indexOf("boundary=");
+	if(boundaryAt < 0)
+		return QByteArray();
+	QByteArray boundary = "--" + type.mid(boundaryAt + 9);
+	boundary.replace('"', "");
+	int part = request.body.indexOf("name=\"payload_json\"");
+	if(part < 0)
+		return QByteArray();
+	int start = request.body.indexOf("\r\n\r\n", part);
+	int end = request.body.indexOf("\r\n" + boundary, start);
+	if(start < 0 || end < 0)
+		return QByteArray();
+	return request.body.mid(start + 4, end - start - 4);
+}
@@ -0,0 +1,129 @@
+#ifndef QDISCORDMOCKSERVER_HPP
+#define QDISCORDMOCKSERVER_HPP
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrl>
+
+/*!
+ * \brief A local fake of the Discord REST API for tests and benchmarks.
+ *
+ * Implements the routes QDiscordRestComponent uses, generating users,
+ * channels, guilds and messages from the requested IDs. Channel changes are
+ * kept, so reads after writes see them. Every route has a
+ * bucket per major parameter which answers with the same rate limit headers as
+ * Discord and with `429 Too Many Requests` when exceeded. Responses can be
+ * delayed and rate limits forced to test retries.\n
+ * Point the library at it with
+ * `QDiscordUtilities::setEndPointBase(server.base())`.
+ */
+class QDiscordMockServer : public QObject
+{
+	Q_OBJECT
+public:
+	explicit QDiscordMockServer(QObject* parent = 0);
+	///\brief Starts listening on a free port of the loopback interface.
+	bool listen();
+	///\brief Returns the base to pass to QDiscordUtilities::setEndPointBase.
+	QString base() const;
+	/*!
+	 * \brief Sets how many requests a bucket accepts per window of `window`
+	 * ms.
+	 *
+	 * A limit of 0 disables rate limits. Defaults to 5 requests per 5000 ms.
+	 */
+	void setRateLimit(int limit, int window);
+	/*!
+	 * \brief Delays every response by `latency` plus up to `jitter` ms.
+	 *
+	 * The jitter sequence is the same in every run.
+	 */
+	void setLatency(int latency, int jitter = 0);
+	/*!
+	 * \brief Answers the next `count` requests with
+	 * `429 Too Many Requests`, asking to retry after `retryAfter` ms.
+	 */
+	void rejectNext(int count, int retryAfter, bool global = false);
+	///\brief Sets how many messages every channel holds, from newest to oldest.
+	void setMessagesPerChannel(int messages) {_messagesPerChannel = messages;}
+	///\brief Returns the amount of requests answered.
+	int requests() const {return _requests;}
+	///\brief Returns the amount of requests answered with a 429.
+	int rateLimited() const {return _rateLimited;}
+	///\brief Returns the body of the last request with one.
+	const QByteArray& lastBody() const {return _lastBody;}
+	///\brief Returns the `Content-Type` of the last request with a body.
+	const QByteArray& lastContentType() const {return _lastContentType;}
+signals:
+	///\brief Emitted for every request received.
+	void requestReceived(const QByteArray& method, const QString& path);
+private:
+	struct Request
+	{
+		QByteArray method;
+		QUrl url;
+		QHash<QByteArray, QByteArray> headers;
+		QByteArray body;
+	};
+	struct Response
+	{
+		Response();
+		int status;
+		QList<QPair<QByteArray, QByteArray>> headers;
+		QByteArray body;
+		void setJson(const QJsonObject& object);
+		void setJson(const QJsonArray& array);
+	};
+	struct Bucket
+	{
+		Bucket();
+		int remaining;
+		qint64 resetAt;
+	};
+	struct Connection
+	{
+		Connection();
+		QByteArray buffer;
+		bool busy;
+	};
+	void incomingConnection();
+	void readRequests(QTcpSocket* socket);
+	bool parse(QByteArray& buffer, Request& request);
+	void respond(QTcpSocket* socket, const Request& request);
+	Response route(const Request& request);
+	bool limit(const Request& request, Response& response);
+	void write(QTcpSocket* socket, const Response& response);
+	QJsonObject user(const QString& id) const;
+	QJsonObject channel(const QString& id) const;
+	QJsonObject guild(const QString& id) const;
+	QJsonObject message(const QString& id, const QString& channelId,
+						const QString& content) const;
+	static QByteArray payload(const Request& request);
+	QTcpServer _server;
+	QHash<QTcpSocket*, Connection> _connections;
+	QHash<QString, Bucket> _buckets;
+	//Channels changed by PATCH requests, by ID.
+	QHash<QString, QJsonObject> _channels;
+	QElapsedTimer _clock;
+	int _limit;
+	int _window;
+	int _latency;
+	int _jitter;
+	//Jitter is pseudo random with a fixed seed, so runs are repeatable.
+	quint32 _seed;
+	int _rejections;
+	int _rejectionRetryAfter;
+	bool _rejectionGlobal;
+	qint64 _globalResetAt;
+	int _messagesPerChannel;
+	quint64 _nextId;
+	int _requests;
+	int _rateLimited;
+	QByteArray _lastBody;
+	QByteArray _lastContentType;
+};
+
+#endif // QDISCORDMOCKSERVER_HPP